@@ -0,0 +1,89 @@
+#pragma once
+#include "MipGenerator.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Imagen RGBA8 de entrada para el atlas.
+ */
+struct
+    AtlasImage {
+    std::string name;                      /**< Identificador (solo informativo). */
+    const unsigned char* pixels = nullptr; /**< Texeles RGBA8. */
+    unsigned int width = 0;                /**< Ancho en texeles. */
+    unsigned int height = 0;               /**< Alto en texeles. */
+    unsigned int rowPitch = 0;             /**< Bytes por fila (0 = width * 4). */
+};
+
+/**
+ * @brief Ubicacion de una imagen dentro del atlas.
+ *
+ * Las coordenadas de textura originales (0..1) se transforman con
+ * uv' = uv * uvScale + uvOffset.
+ */
+struct
+    AtlasRegion {
+    bool valid = false;        /**< false si la imagen no cabe en una pagina. */
+    unsigned int page = 0;     /**< Pagina del atlas. */
+    unsigned int x = 0;        /**< Esquina del contenido (sin gutter) en texeles. */
+    unsigned int y = 0;
+    unsigned int width = 0;    /**< Tamano del contenido en texeles. */
+    unsigned int height = 0;
+    float uvScale[2] = { 1.0f, 1.0f };
+    float uvOffset[2] = { 0.0f, 0.0f };
+
+    /**
+     * @brief Aplica la transformacion de la region a un par (u, v).
+     */
+    void
+        remap(float& u, float& v) const {
+        u = u * uvScale[0] + uvOffset[0];
+        v = v * uvScale[1] + uvOffset[1];
+    }
+};
+
+/**
+ * @brief Parametros del empaquetado.
+ */
+struct
+    AtlasOptions {
+    unsigned int pageWidth = 2048;  /**< Ancho de cada pagina. */
+    unsigned int pageHeight = 2048; /**< Alto de cada pagina. */
+    unsigned int gutter = 4;        /**< Texeles de borde extruido alrededor de cada imagen. */
+    unsigned int alignment = 4;     /**< Alineacion de cada rectangulo (4 = bloques BC). */
+};
+
+/**
+ * @class AtlasPacker
+ * @brief Empaqueta muchas imagenes pequenas en pocas paginas grandes (MaxRects).
+ *
+ * Usa MaxRects con la heuristica "best short side fit". Cada imagen se rodea
+ * de un gutter donde se repiten sus texeles de borde, de modo que el filtrado
+ * bilineal y los mips no mezclan imagenes vecinas. Con gutter y alineacion de
+ * 2^k texeles, los primeros k niveles de mip quedan libres de sangrado.
+ * Solo vale para UVs dentro de 0..1: las mallas con UVs repetidas (tiling)
+ * no pueden usar un atlas.
+ *
+ * No depende de Windows ni de DirectX.
+ */
+class
+    AtlasPacker {
+public:
+    AtlasPacker() = default;
+    ~AtlasPacker() = default;
+
+    /**
+     * @brief Empaqueta las imagenes y compone las paginas.
+     *
+     * @param images Imagenes de entrada.
+     * @param options Parametros del empaquetado.
+     * @param pages Recibe las paginas RGBA8.
+     * @param regions Recibe una region por imagen, en el mismo orden.
+     * @return false si alguna imagen no cabe en una pagina (su region queda invalida).
+     */
+    bool
+        build(const std::vector<AtlasImage>& images,
+            const AtlasOptions& options,
+            std::vector<ImageLevel>& pages,
+            std::vector<AtlasRegion>& regions) const;
+};
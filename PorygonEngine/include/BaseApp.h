@@ -12,6 +12,13 @@
 #include "MeshComponent.h"
 #include "Buffer.h"
 #include "SamplerState.h"
+#include "ThreadPool.h"
+#include "TextureStreamer.h"
+#include "TextureResidency.h"
+#include "UploadManager.h"
+#include "ConstantBuffer.h"
+#include "GeometryPool.h"
+#include "BufferPool.h"
 
 #include "ModelLoader.h"
 
@@ -98,13 +105,20 @@ private:
 	Viewport                            m_viewport;
 	ShaderProgram                       m_shaderProgram;
 	MeshComponent												m_mesh;
-	Buffer															m_vertexBuffer;
-	Buffer															m_indexBuffer;
-	Buffer															m_cbNeverChanges;
-	Buffer															m_cbChangeOnResize;
-	Buffer															m_cbChangesEveryFrame;
+	GeometryPool                        m_geometryPool;
+	unsigned int                        m_meshId = 0;
+	BufferPool                          m_bufferPool;
+	ConstantBuffer<CBNeverChanges>      m_cbNeverChanges;
+	ConstantBuffer<CBChangeOnResize>    m_cbChangeOnResize;
+	ConstantBuffer<CBChangesEveryFrame> m_cbChangesEveryFrame;
 	Texture 														m_textureCube;
 	SamplerState                        m_samplerState;
+	ThreadPool                          m_threadPool;
+	TextureStreamer                     m_textureStreamer{ m_threadPool };
+	TextureResidency                    m_textureResidency;
+	UploadManager                       m_uploadManager;
+	ConstantBufferRing                  m_constantRing;
+	ConstantUploadStats                 m_constantStats; // Subidas de constantes del ultimo frame
 
 	ModelLoader                         m_modelLoader;
 	LoadData                            LD;
@@ -112,6 +126,8 @@ private:
 	XMMATRIX                            m_World;
 	XMMATRIX                            m_View;
 	XMMATRIX                            m_Projection;
+	unsigned int                        m_projectionWidth = 0;  // Tamano con el que se calculo m_Projection
+	unsigned int                        m_projectionHeight = 0;
 	XMFLOAT4                            m_vMeshColor; // (0.7f, 0.7f, 0.7f, 1.0f);
 
 	CBChangeOnResize cbChangesOnResize;
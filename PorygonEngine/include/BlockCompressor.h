@@ -0,0 +1,105 @@
+#pragma once
+#include "MipGenerator.h"
+#include <vector>
+
+/**
+ * @brief Formatos de compresion por bloques 4x4 soportados.
+ */
+enum
+    BlockFormat {
+    BC1_FORMAT = 0, /**< RGB 5:6:5 + alfa de 1 bit, 8 bytes por bloque. */
+    BC3_FORMAT = 1, /**< Color BC1 + alfa interpolado (BC4), 16 bytes por bloque. */
+    BC4_FORMAT = 2, /**< Un canal (R), 8 bytes por bloque. */
+    BC5_FORMAT = 3, /**< Dos canales (R, G), 16 bytes por bloque. */
+    BC7_FORMAT = 4  /**< RGBA alta calidad (modo 6), 16 bytes por bloque. */
+};
+
+/**
+ * @brief Presets de calidad / velocidad del compresor.
+ */
+enum
+    CompressionQuality {
+    QUALITY_FAST = 0,   /**< Extremos por caja envolvente, una sola pasada de indices. */
+    QUALITY_NORMAL = 1, /**< Eje principal (PCA) + un refinamiento por minimos cuadrados. */
+    QUALITY_HIGH = 2    /**< PCA + refinamiento + busqueda local de extremos y p-bits. */
+};
+
+/**
+ * @brief Imagen comprimida por bloques (un nivel de mip).
+ */
+struct
+    CompressedImage {
+    BlockFormat format = BC1_FORMAT;
+    unsigned int width = 0;            /**< Ancho en texeles. */
+    unsigned int height = 0;           /**< Alto en texeles. */
+    unsigned int blocksX = 0;          /**< Bloques por fila. */
+    unsigned int blocksY = 0;          /**< Filas de bloques. */
+    unsigned int rowPitch = 0;         /**< Bytes por fila de bloques. */
+    std::vector<unsigned char> data;   /**< Bloques contiguos. */
+};
+
+/**
+ * @class BlockCompressor
+ * @brief Codificador BC1/BC3/BC4/BC5/BC7 en CPU y su decodificador de referencia.
+ *
+ * Los bloques se reparten entre hilos por filas de bloques. La busqueda de
+ * indices evalua cuatro entradas de la paleta a la vez con SSE2 (ver SimdConfig.h).
+ * BC7 usa solo el modo 6 (un subconjunto, RGBA 7.7.7.7 + p-bit, indices de 4 bits),
+ * que es el modo de mayor calidad para bloques sin particiones; el decodificador
+ * de referencia solo acepta ese modo.
+ *
+ * No depende de Windows ni de DirectX.
+ */
+class
+    BlockCompressor {
+public:
+    BlockCompressor() = default;
+    ~BlockCompressor() = default;
+
+    /**
+     * @brief Bytes por bloque 4x4 del formato.
+     */
+    static unsigned int
+        blockSize(BlockFormat format);
+
+    /**
+     * @brief Comprime un nivel RGBA8.
+     *
+     * @param source Imagen de entrada (RGBA8). Los bloques parciales de los bordes
+     *        se completan repitiendo el ultimo texel.
+     * @param format Formato de salida.
+     * @param quality Preset de calidad.
+     * @param output Recibe los bloques comprimidos.
+     * @param threadCount Hilos de trabajo (0 = hardware_concurrency).
+     * @return true si la compresion termino correctamente.
+     */
+    bool
+        compress(const ImageLevel& source,
+            BlockFormat format,
+            CompressionQuality quality,
+            CompressedImage& output,
+            unsigned int threadCount = 0) const;
+
+    /**
+     * @brief Decodificador de referencia: expande una imagen comprimida a RGBA8.
+     *
+     * Los canales ausentes se rellenan como en D3D: BC4 -> (R,0,0,1), BC5 -> (R,G,0,1).
+     * @return false si algun bloque usa un modo no soportado.
+     */
+    bool
+        decompress(const CompressedImage& source, ImageLevel& output) const;
+
+    /**
+     * @brief Comprime un bloque 4x4 de texeles RGBA8 (64 bytes).
+     */
+    static void
+        compressBlock(const unsigned char* rgba, BlockFormat format,
+            CompressionQuality quality, unsigned char* block);
+
+    /**
+     * @brief Decodifica un bloque a 16 texeles RGBA8.
+     * @return false si el bloque usa un modo no soportado.
+     */
+    static bool
+        decompressBlock(const unsigned char* block, BlockFormat format, unsigned char* rgba);
+};
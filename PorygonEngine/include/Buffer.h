@@ -4,6 +4,17 @@
 
 class Device;
 class DeviceContext;
+class BufferPool;
+
+/**
+ * @brief Uso y flags de un buffer creado desde datos arbitrarios.
+ */
+struct
+    BufferOptions {
+    D3D11_USAGE usage = D3D11_USAGE_DEFAULT; /**< IMMUTABLE exige datos; DYNAMIC anade CPU_ACCESS_WRITE si falta. */
+    unsigned int cpuAccessFlags = 0;         /**< D3D11_CPU_ACCESS_FLAG combinados. */
+    unsigned int miscFlags = 0;              /**< BUFFER_STRUCTURED usa el stride como StructureByteStride; ALLOW_RAW_VIEWS exige multiplos de 4 bytes. */
+};
 
 class
     Buffer {
@@ -11,12 +22,77 @@ public:
     Buffer() = default;
     ~Buffer() = default;
 
+    /**
+     * @brief Crea un vertex o index buffer con la geometria de una malla.
+     */
     HRESULT
         init(Device& device, const MeshComponent& mesh, unsigned int bindFlag);
 
+    /**
+     * @brief Crea un buffer de count elementos de stride bytes sin copiar los datos.
+     *
+     * Sirve para vertices de cualquier formato, instancias (enlazadas en otro
+     * slot con render), buffers structured o raw.
+     *
+     * @param device Dispositivo de DirectX.
+     * @param data Elementos contiguos, o nullptr para un buffer sin inicializar (no IMMUTABLE).
+     * @param stride Bytes por elemento; es el stride de IASetVertexBuffers.
+     * @param count Numero de elementos.
+     * @param bindFlag D3D11_BIND_FLAG combinados.
+     * @param options Uso, acceso de CPU y flags varios.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device,
+            const void* data,
+            unsigned int stride,
+            unsigned int count,
+            unsigned int bindFlag,
+            const BufferOptions& options = BufferOptions());
+
+    /**
+     * @brief Como el anterior, con el stride del tipo de los elementos.
+     */
+    template <typename T>
+    HRESULT
+        init(Device& device,
+            const T* data,
+            size_t count,
+            unsigned int bindFlag,
+            const BufferOptions& options = BufferOptions()) {
+        return init(device, static_cast<const void*>(data), sizeof(T), static_cast<unsigned int>(count), bindFlag, options);
+    }
+
+    /**
+     * @brief Como el anterior, con los elementos de un vector.
+     */
+    template <typename T>
+    HRESULT
+        init(Device& device,
+            const std::vector<T>& data,
+            unsigned int bindFlag,
+            const BufferOptions& options = BufferOptions()) {
+        return init(device, data.data(), data.size(), bindFlag, options);
+    }
+
+    /**
+     * @brief Crea un buffer de constantes.
+     *
+     * @param dynamic D3D11_USAGE_DYNAMIC: update lo reescribe entero con
+     *        Map(WRITE_DISCARD) en lugar de UpdateSubresource.
+     */
     HRESULT
-        init(Device& device, unsigned int ByteWidth);
+        init(Device& device, unsigned int ByteWidth, bool dynamic = false);
 
+    /**
+     * @brief Copia datos al buffer.
+     *
+     * En un buffer DYNAMIC, sin pDstBox se copian ByteWidth bytes de pSrcData
+     * con Map(WRITE_DISCARD). Con pDstBox se copian right - left bytes en
+     * left; si la caja no cubre todo el buffer se mapea con WRITE_NO_OVERWRITE
+     * y el resto se conserva, asi que el llamador no debe escribir un rango
+     * que la GPU aun este leyendo. Los buffers de constantes no admiten cajas.
+     */
     void
         update(DeviceContext& deviceContext,
             ID3D11Resource* pDstResource,
@@ -26,6 +102,12 @@ public:
             unsigned int    SrcRowPitch,
             unsigned int    SrcDepthPitch);
 
+    /**
+     * @brief Enlaza el buffer segun su bind flag: vertices (con su stride, en
+     *        StartSlot; las instancias van en un slot propio), constantes o indices.
+     *
+     * @param format Formato de los indices (R16_UINT o R32_UINT) si es un index buffer.
+     */
     void
         render(DeviceContext& deviceContext,
             unsigned int   StartSlot,
@@ -41,6 +123,14 @@ public:
             D3D11_BUFFER_DESC& desc,
             D3D11_SUBRESOURCE_DATA* initData);
 
+    /**
+     * @brief Pide los buffers a un BufferPool y se los devuelve en destroy (nullptr = Device).
+     *
+     * Llamar antes de init. El buffer del pool puede ser mayor que ByteWidth.
+     */
+    void
+        setPool(BufferPool* pool) { m_pool = pool; }
+
 private:
 
     ID3D11Buffer* m_buffer = nullptr;
@@ -51,4 +141,10 @@ private:
 
     unsigned int m_bindFlag = 0;
 
+    unsigned int m_byteWidth = 0;
+
+    bool m_dynamic = false;
+
+    BufferPool* m_pool = nullptr;
+
 };
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include "Prerequisites.h"
+#include "BufferRecycler.h"
+
+class
+    Device;
+
+class
+    DeviceContext;
+
+/**
+ * @class BufferPool
+ * @brief Reutiliza ID3D11Buffer en lugar de crear y destruir uno por peticion.
+ *
+ * La contabilidad es de BufferRecycler: cubos por bind flags, usage, acceso
+ * de CPU y clase de tamano (potencia de dos), espera de unos frames antes de
+ * reutilizar un buffer devuelto y recorte de los que no se usan. Esta clase
+ * solo crea los buffers que faltan y destruye los que el recycler descarta.
+ *
+ * Los buffers entregados miden 2^sizeClass bytes, no desc.ByteWidth. Los
+ * IMMUTABLE, los que tienen MiscFlags (structured, raw, indirect) y los de
+ * staging no se agrupan: se crean y destruyen como siempre.
+ */
+class
+    BufferPool {
+public:
+    BufferPool() = default;
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief Prepara el pool vacio.
+     *
+     * @param device Dispositivo con el que se crean los buffers.
+     * @param deviceContext Contexto con el que se suben los datos iniciales de un buffer reciclado.
+     * @param options Retrasos y limites del reciclaje.
+     */
+    void
+        init(Device& device, DeviceContext& deviceContext, const BufferRecyclerOptions& options = BufferRecyclerOptions());
+
+    /**
+     * @brief Entrega un buffer compatible con desc, reciclado o nuevo.
+     *
+     * @param desc Descripcion pedida; ByteWidth se redondea a la clase de tamano.
+     * @param initData Datos iniciales (desc.ByteWidth bytes) o nullptr.
+     * @param buffer Recibe el buffer, con una referencia para el llamador.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        acquire(const D3D11_BUFFER_DESC& desc, const D3D11_SUBRESOURCE_DATA* initData, ID3D11Buffer** buffer);
+
+    /**
+     * @brief Devuelve un buffer entregado por @ref acquire; los ajenos se liberan sin mas.
+     */
+    void
+        release(ID3D11Buffer* buffer);
+
+    /**
+     * @brief Avanza un frame y destruye los buffers recortados. Llamar una vez por frame.
+     */
+    void
+        beginFrame();
+
+    BufferRecyclerStats
+        stats() const { return m_recycler.stats(); }
+
+    /**
+     * @brief Destruye los buffers libres o en espera. Los entregados siguen siendo del llamador.
+     */
+    void
+        destroy();
+
+private:
+    /**
+     * @brief Cubo del buffer; false si no se debe agrupar.
+     */
+    bool
+        poolKey(const D3D11_BUFFER_DESC& desc, BufferPoolKey& key) const;
+
+    Device* m_device = nullptr;
+    DeviceContext* m_deviceContext = nullptr;
+    BufferRecycler m_recycler;
+};
@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Cubo de reciclaje: buffers intercambiables entre si.
+ */
+struct
+    BufferPoolKey {
+    unsigned int bindFlags = 0;      /**< D3D11_BIND_FLAG combinados. */
+    unsigned int usage = 0;          /**< D3D11_USAGE. */
+    unsigned int cpuAccessFlags = 0; /**< D3D11_CPU_ACCESS_FLAG combinados. */
+    unsigned int sizeClass = 0;      /**< log2 del tamano real del buffer. */
+
+    bool
+        operator<(const BufferPoolKey& other) const {
+        if (bindFlags != other.bindFlags) return bindFlags < other.bindFlags;
+        if (usage != other.usage) return usage < other.usage;
+        if (cpuAccessFlags != other.cpuAccessFlags) return cpuAccessFlags < other.cpuAccessFlags;
+        return sizeClass < other.sizeClass;
+    }
+};
+
+/**
+ * @brief Limites del reciclaje.
+ */
+struct
+    BufferRecyclerOptions {
+    unsigned int frameDelay = 3;      /**< Frames que un buffer liberado espera antes de reutilizarse (la GPU aun puede leerlo). */
+    unsigned int trimFrames = 300;    /**< Frames sin uso tras los que un buffer libre se destruye. */
+    size_t maxPooledBytes = 64 << 20; /**< Bytes libres maximos; por encima se destruyen los mas antiguos. */
+    unsigned int minSizeClass = 8;    /**< Clase minima (2^8 = 256 bytes). */
+};
+
+/**
+ * @brief Metricas del reciclaje.
+ */
+struct
+    BufferRecyclerStats {
+    unsigned int hits = 0;       /**< Peticiones servidas con un buffer reciclado. */
+    unsigned int misses = 0;     /**< Peticiones que crearon un buffer. */
+    unsigned int trimmed = 0;    /**< Buffers destruidos por inactividad o por el limite de bytes. */
+    unsigned int live = 0;       /**< Buffers entregados y no devueltos. */
+    unsigned int pooled = 0;     /**< Buffers libres o esperando su retraso. */
+    size_t liveBytes = 0;        /**< Bytes reales de los buffers entregados. */
+    size_t pooledBytes = 0;      /**< Bytes de los buffers libres o esperando. */
+    size_t wastedBytes = 0;      /**< Relleno de los buffers entregados (tamano real - pedido). */
+
+    double
+        hitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+};
+
+/**
+ * @class BufferRecycler
+ * @brief Contabilidad de un pool de buffers de GPU por clases de tamano.
+ *
+ * Cada peticion se redondea a la siguiente potencia de dos y se busca en el
+ * cubo de sus flags y su clase. Un buffer devuelto con @ref release pasa
+ * frameDelay frames en espera (la GPU puede seguir leyendolo) antes de poder
+ * entregarse de nuevo; los que pasan trimFrames frames libres, o que superan
+ * maxPooledBytes, se entregan al llamador para destruirlos.
+ *
+ * Los buffers son punteros opacos: esta clase no crea ni destruye nada, asi
+ * que no depende de Windows ni de DirectX y se puede probar con punteros falsos.
+ */
+class
+    BufferRecycler {
+public:
+    BufferRecycler() = default;
+    ~BufferRecycler() = default;
+
+    /**
+     * @brief Vacia el pool (los buffers que tuviera se olvidan; ver @ref clear).
+     */
+    void
+        init(const BufferRecyclerOptions& options = BufferRecyclerOptions());
+
+    /**
+     * @brief Clase de tamano (log2) para una peticion, al menos minSizeClass.
+     */
+    unsigned int
+        sizeClassOf(size_t size) const;
+
+    /**
+     * @brief Busca un buffer libre del cubo.
+     *
+     * @param key Cubo, con sizeClass de @ref sizeClassOf.
+     * @param requested Bytes pedidos (para wastedBytes).
+     * @return El buffer, ya contado como entregado, o nullptr si hay que crear
+     *         uno de 2^sizeClass bytes y registrarlo con @ref track.
+     */
+    void*
+        acquire(const BufferPoolKey& key, size_t requested);
+
+    /**
+     * @brief Registra como entregado un buffer creado tras un fallo de @ref acquire.
+     */
+    void
+        track(void* buffer, const BufferPoolKey& key, size_t requested);
+
+    /**
+     * @brief Devuelve un buffer entregado; se podra reutilizar tras frameDelay frames.
+     *
+     * @return false si el buffer no es del pool (el llamador debe destruirlo).
+     */
+    bool
+        release(void* buffer);
+
+    /**
+     * @brief Avanza un frame: libera las esperas cumplidas y recorta el pool.
+     *
+     * @param expired Recibe los buffers que el llamador debe destruir.
+     */
+    void
+        beginFrame(std::vector<void*>& expired);
+
+    /**
+     * @brief Saca todos los buffers libres o en espera para destruirlos.
+     */
+    void
+        clear(std::vector<void*>& expired);
+
+    uint64_t
+        frame() const { return m_frame; }
+
+    BufferRecyclerStats
+        stats() const { return m_stats; }
+
+private:
+    struct LiveBuffer {
+        BufferPoolKey key;
+        size_t requested = 0;
+    };
+
+    struct PooledBuffer {
+        void* buffer = nullptr;
+        BufferPoolKey key;
+        uint64_t frame = 0; /**< Frame de la devolucion. */
+    };
+
+    size_t
+        classBytes(const BufferPoolKey& key) const { return static_cast<size_t>(1) << key.sizeClass; }
+
+    /**
+     * @brief Quita un buffer libre de la lista de su cubo y de la contabilidad.
+     */
+    void
+        unpool(const PooledBuffer& entry);
+
+    BufferRecyclerOptions m_options;
+    std::unordered_map<void*, LiveBuffer> m_live;
+    std::deque<PooledBuffer> m_pending;                     /**< Devueltos en espera, en orden de frame. */
+    std::map<BufferPoolKey, std::vector<PooledBuffer>> m_free; /**< Listos, el mas reciente al final. */
+    uint64_t m_frame = 0;
+    BufferRecyclerStats m_stats;
+};
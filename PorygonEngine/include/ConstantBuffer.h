@@ -0,0 +1,156 @@
+#pragma once
+#include "Prerequisites.h"
+#include "Buffer.h"
+#include "ConstantBufferRing.h"
+#include <cstring>
+
+/**
+ * @brief Frecuencia con la que se espera que cambien unas constantes (solo agrupa metricas).
+ */
+enum
+    ConstantUpdateFrequency {
+    UPDATE_NEVER = 0,
+    UPDATE_ON_RESIZE,
+    UPDATE_PER_FRAME,
+    UPDATE_FREQUENCY_COUNT
+};
+
+/**
+ * @brief Subidas hechas y evitadas por frecuencia; @ref reset al empezar cada frame.
+ */
+struct
+    ConstantUploadStats {
+    unsigned int uploads[UPDATE_FREQUENCY_COUNT] = {}; /**< Subidas hechas. */
+    unsigned int skipped[UPDATE_FREQUENCY_COUNT] = {}; /**< Subidas evitadas por no haber cambios. */
+    size_t bytes[UPDATE_FREQUENCY_COUNT] = {};         /**< Bytes subidos. */
+
+    void
+        reset() { *this = ConstantUploadStats(); }
+};
+
+/**
+ * @class ConstantBuffer
+ * @brief Buffer de constantes tipado que solo sube su contenido cuando cambia.
+ *
+ * @ref set compara los datos nuevos con la copia de lo ultimo subido y marca
+ * el buffer como sucio solo si difieren; @ref upload no hace nada mientras no
+ * este sucio y la GPU conserve la copia. Con un ConstantBufferRing las
+ * constantes se escriben en el anillo y siguen validas hasta el siguiente
+ * DISCARD; sin anillo (o si no hay sitio) van al Buffer dinamico propio.
+ *
+ * @tparam T Estructura de constantes (XMMATRIX, XMFLOAT4...), copiada con
+ *         memcpy y comparada byte a byte.
+ */
+template <typename T>
+class
+    ConstantBuffer {
+public:
+    ConstantBuffer() = default;
+    ~ConstantBuffer() = default;
+
+    /**
+     * @brief Crea el buffer propio.
+     *
+     * @param device Dispositivo de DirectX.
+     * @param frequency Frecuencia con la que se agrupan sus metricas.
+     * @param ring Anillo donde escribir las constantes (nullptr = solo el buffer propio).
+     * @param pool Pool del que sale el buffer propio y al que vuelve en destroy (nullptr = Device).
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device, ConstantUpdateFrequency frequency, ConstantBufferRing* ring = nullptr,
+            BufferPool* pool = nullptr) {
+        m_buffer.setPool(pool);
+        m_frequency = frequency;
+        m_ring = ring;
+        m_dirty = true;
+        m_bufferValid = false;
+        m_range = ConstantBufferRange();
+        std::memset(&m_data, 0, sizeof(T));
+        return m_buffer.init(device, sizeof(T), true);
+    }
+
+    /**
+     * @brief Cambia el contenido; solo queda sucio si difiere de lo ultimo subido.
+     */
+    void
+        set(const T& data) {
+        if (std::memcmp(&data, &m_data, sizeof(T)) != 0) {
+            std::memcpy(&m_data, &data, sizeof(T));
+            m_dirty = true;
+        }
+    }
+
+    /**
+     * @brief Sube el contenido si esta sucio o si la copia de la GPU se perdio.
+     *
+     * @param deviceContext Contexto con el que se escribe.
+     * @param stats Recibe la subida hecha o evitada.
+     */
+    void
+        upload(DeviceContext& deviceContext, ConstantUploadStats& stats) {
+        const bool ringValid = m_ring && m_ring->valid(m_range);
+        if (!m_dirty && (ringValid || (m_bufferValid && !m_range.numConstants))) {
+            ++stats.skipped[m_frequency];
+            return;
+        }
+
+        if (!m_ring || !m_ring->write(deviceContext, &m_data, sizeof(T), m_range)) {
+            // numConstants = 0: se enlaza el buffer propio
+            m_range = ConstantBufferRange();
+            m_buffer.update(deviceContext, nullptr, 0, nullptr, &m_data, 0, 0);
+            m_bufferValid = true;
+        }
+        m_dirty = false;
+        ++stats.uploads[m_frequency];
+        stats.bytes[m_frequency] += sizeof(T);
+    }
+
+    /**
+     * @brief Enlaza la ultima copia subida en el vertex shader y, opcionalmente, en el pixel shader.
+     *
+     * Si el anillo perdio el bloque despues de @ref upload (dio la vuelta en
+     * un beginFrame entre ambas llamadas), las constantes se suben antes al
+     * buffer propio.
+     */
+    void
+        render(DeviceContext& deviceContext, unsigned int slot, bool setPixelShader = false) {
+        if (m_range.numConstants > 0 && !m_ring->valid(m_range)) {
+            m_range = ConstantBufferRange();
+            m_buffer.update(deviceContext, nullptr, 0, nullptr, &m_data, 0, 0);
+            m_bufferValid = true;
+        }
+        if (m_range.numConstants > 0) {
+            m_ring->bind(deviceContext, slot, m_range, setPixelShader);
+        }
+        else {
+            m_buffer.render(deviceContext, slot, 1, setPixelShader);
+        }
+    }
+
+    /**
+     * @brief Libera el buffer propio.
+     */
+    void
+        destroy() {
+        m_buffer.destroy();
+        m_range = ConstantBufferRange();
+        m_bufferValid = false;
+        m_dirty = true;
+    }
+
+    const T&
+        data() const { return m_data; }
+
+    bool
+        dirty() const { return m_dirty; }
+
+private:
+    Buffer m_buffer;
+    ConstantBufferRing* m_ring = nullptr;
+    ConstantBufferRange m_range;
+    ConstantUpdateFrequency m_frequency = UPDATE_PER_FRAME;
+    T m_data;
+    bool m_dirty = true;
+    bool m_bufferValid = false; /**< El buffer propio tiene m_data. */
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include "Prerequisites.h"
+#include "ConstantRing.h"
+
+/**
+ * PORYGON_D3D11_1 vale 1 cuando el d3d11.h del build es el del Windows SDK 8
+ * o posterior (define D3D11_1_UAV_SLOT_COUNT) y se puede incluir d3d11_1.h.
+ * Con el d3d11.h del DirectX SDK de junio de 2010 vale 0 y el anillo queda
+ * desactivado. Se puede forzar definiendolo antes de incluir este header.
+ */
+#ifndef PORYGON_D3D11_1
+#if defined(D3D11_1_UAV_SLOT_COUNT)
+#define PORYGON_D3D11_1 1
+#else
+#define PORYGON_D3D11_1 0
+#endif
+#endif
+
+struct
+    ID3D11DeviceContext1;
+
+class
+    Device;
+
+class
+    DeviceContext;
+
+/**
+ * @brief Bloque del anillo listo para enlazar con *SetConstantBuffers1.
+ */
+struct
+    ConstantBufferRange {
+    unsigned int firstConstant = 0; /**< Primera constante de 16 bytes (multiplo de 16). */
+    unsigned int numConstants = 0;  /**< Constantes visibles para el shader (multiplo de 16). */
+    uint64_t generation = 0;        /**< Generacion del anillo al escribirlo. */
+};
+
+/**
+ * @class ConstantBufferRing
+ * @brief Constantes por draw en un unico buffer D3D11_USAGE_DYNAMIC.
+ *
+ * En lugar de un buffer DEFAULT por tipo de constantes actualizado con
+ * UpdateSubresource (una copia y una version nueva en el driver por llamada),
+ * cada @ref write reserva un bloque en ConstantRing, lo mapea con
+ * WRITE_NO_OVERWRITE (o WRITE_DISCARD al dar la vuelta) y copia los datos;
+ * @ref bind lo enlaza con un desplazamiento mediante VSSetConstantBuffers1.
+ *
+ * Necesita el runtime de Direct3D 11.1 con ConstantBufferOffsetting y
+ * MapNoOverwriteOnDynamicConstantBuffer. Si faltan, @ref supported devuelve
+ * false y el llamador debe usar sus buffers de constantes propios.
+ */
+class
+    ConstantBufferRing {
+public:
+    ConstantBufferRing() = default;
+    ~ConstantBufferRing();
+
+    ConstantBufferRing(const ConstantBufferRing&) = delete;
+    ConstantBufferRing& operator=(const ConstantBufferRing&) = delete;
+
+    /**
+     * @brief Comprueba el soporte y crea el buffer del anillo.
+     *
+     * Sin soporte de Direct3D 11.1 no crea nada y devuelve S_OK con
+     * @ref supported a false.
+     * @param device Dispositivo de DirectX.
+     * @param deviceContext Contexto con el que se enlazaran los bloques.
+     * @param capacity Bytes del anillo; conviene que cubra las constantes de un frame.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device, DeviceContext& deviceContext, unsigned int capacity = 1024 * 1024);
+
+    /**
+     * @brief El runtime admite desplazamientos en los buffers de constantes.
+     */
+    bool
+        supported() const { return m_buffer != nullptr; }
+
+    /**
+     * @brief Empieza un frame: si hace falta, el anillo da la vuelta aqui y no a mitad de frame.
+     *
+     * Llamar una vez por frame antes de la primera @ref write. Sin esta llamada
+     * el anillo nunca da la vuelta y, una vez lleno, @ref write falla.
+     */
+    void
+        beginFrame() { m_ring.beginFrame(); }
+
+    /**
+     * @brief Copia constantes a un bloque nuevo del anillo.
+     *
+     * @param deviceContext Contexto con el que se mapea.
+     * @param data Constantes a copiar.
+     * @param size Bytes (como mucho 4096 constantes).
+     * @param range Recibe el bloque para @ref bind.
+     * @return false sin soporte, si el bloque no cabe en lo que queda del frame o si falla Map.
+     */
+    bool
+        write(DeviceContext& deviceContext, const void* data, unsigned int size, ConstantBufferRange& range);
+
+    /**
+     * @brief Enlaza un bloque en el vertex shader y, opcionalmente, en el pixel shader.
+     */
+    void
+        bind(DeviceContext& deviceContext,
+            unsigned int slot,
+            const ConstantBufferRange& range,
+            bool setPixelShader = false);
+
+    /**
+     * @brief El bloque sigue conteniendo lo que se escribio (no hubo DISCARD desde entonces).
+     */
+    bool
+        valid(const ConstantBufferRange& range) const {
+        return m_buffer && range.numConstants > 0 && range.generation == m_ring.generation();
+    }
+
+    ConstantRingStats
+        stats() const { return m_ring.stats(); }
+
+    /**
+     * @brief Libera el buffer y la interfaz de Direct3D 11.1.
+     */
+    void
+        destroy();
+
+private:
+    ID3D11Buffer* m_buffer = nullptr;
+    ID3D11DeviceContext1* m_context1 = nullptr;
+    ConstantRing m_ring;
+};
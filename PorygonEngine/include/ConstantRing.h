@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Bloque reservado en el anillo de constantes.
+ */
+struct
+    ConstantRingAllocation {
+    size_t offset = 0;       /**< Inicio en bytes, multiplo de la alineacion. */
+    size_t size = 0;         /**< Bytes reservados, redondeados a la alineacion. */
+    bool discard = false;    /**< Primer bloque tras una vuelta: mapear con WRITE_DISCARD en lugar de NO_OVERWRITE. */
+    uint64_t generation = 0; /**< Generacion del anillo tras esta reserva (ver ConstantRing::generation). */
+};
+
+/**
+ * @brief Metricas acumuladas del anillo.
+ */
+struct
+    ConstantRingStats {
+    unsigned int allocations = 0; /**< Reservas servidas. */
+    unsigned int wraps = 0;       /**< Vueltas al inicio (cada una es un WRITE_DISCARD). */
+    unsigned int failures = 0;    /**< Reservas rechazadas por ser mayores que el anillo. */
+    unsigned int overflows = 0;   /**< Reservas rechazadas por no caber en lo que quedaba del anillo en su frame. */
+    size_t requested = 0;         /**< Bytes pedidos, sin el relleno de alineacion. */
+    size_t allocated = 0;         /**< Bytes reservados, con el relleno. */
+    size_t peakFrameDemand = 0;   /**< Mayor demanda de un frame terminado; decide cuando dar la vuelta. */
+};
+
+/**
+ * @class ConstantRing
+ * @brief Reparto lineal de un buffer de constantes dinamico entre los draws.
+ *
+ * Cada reserva avanza la cabeza del anillo; la memoria ya entregada no se
+ * vuelve a escribir, asi que se mapea con D3D11_MAP_WRITE_NO_OVERWRITE sin
+ * esperar a la GPU. La vuelta al inicio solo ocurre en @ref beginFrame,
+ * cuando lo que queda no cubre el frame mas exigente visto: la siguiente
+ * reserva se marca con discard y mapear con D3D11_MAP_WRITE_DISCARD hace que
+ * el driver entregue memoria nueva mientras la GPU termina con la anterior.
+ * Por eso no hacen falta fences.
+ *
+ * Dentro de un frame nunca se da la vuelta: un DISCARD a mitad de frame
+ * dejaria sin contenido los bloques que el frame ya dio por validos. Una
+ * reserva que no cabe falla y el llamador usa su propio buffer.
+ *
+ * La alineacion por defecto es la de *SetConstantBuffers1: 16 constantes de
+ * 16 bytes. No depende de Windows ni de DirectX.
+ */
+class
+    ConstantRing {
+public:
+    ConstantRing() = default;
+    ~ConstantRing() = default;
+
+    /**
+     * @brief Prepara el anillo vacio; la primera reserva pedira un DISCARD.
+     *
+     * @param capacity Bytes del buffer.
+     * @param alignment Alineacion de inicio y tamano de cada bloque (potencia de dos).
+     */
+    void
+        init(size_t capacity, size_t alignment = 256);
+
+    /**
+     * @brief Reserva un bloque contiguo.
+     *
+     * @param size Bytes a reservar (mayor que 0).
+     * @param allocation Recibe el desplazamiento, el tamano redondeado y el modo de mapeo.
+     * @return false si el bloque redondeado es mayor que el anillo o no cabe
+     *         en lo que queda hasta el final.
+     */
+    bool
+        allocate(size_t size, ConstantRingAllocation& allocation);
+
+    /**
+     * @brief Empieza un frame; da la vuelta si lo que queda no cubre el frame mas exigente visto.
+     *
+     * Llamar antes de la primera reserva del frame. Al dar la vuelta cambia
+     * @ref generation, asi que las constantes de frames anteriores dejan de
+     * ser validas antes de que nadie las compruebe.
+     */
+    void
+        beginFrame();
+
+    /**
+     * @brief Vuelve al inicio: la siguiente reserva pedira un DISCARD.
+     *
+     * Necesario si el contenido del buffer se perdio (por ejemplo, al recrearlo).
+     * Invalida todos los bloques, asi que no se debe llamar a mitad de frame.
+     */
+    void
+        reset();
+
+    /**
+     * @brief La siguiente reserva vuelve a pedir el DISCARD, sin cambiar de generacion.
+     *
+     * Para cuando falla el Map del bloque marcado con discard: ese era el
+     * primer bloque de la generacion, asi que aun no hay ninguno valido que
+     * el DISCARD pueda borrar.
+     */
+    void
+        repeatDiscard() { m_discardPending = true; }
+
+    size_t
+        capacity() const { return m_capacity; }
+
+    size_t
+        alignment() const { return m_alignment; }
+
+    /**
+     * @brief Bytes entregados desde el ultimo DISCARD.
+     */
+    size_t
+        used() const { return m_head; }
+
+    /**
+     * @brief Numero de vueltas al inicio hasta ahora.
+     *
+     * Un bloque conserva su contenido mientras la generacion no cambie, asi
+     * que unas constantes que no varian pueden enlazarse de nuevo sin reescribirlas.
+     */
+    uint64_t
+        generation() const { return m_generation; }
+
+    ConstantRingStats
+        stats() const { return m_stats; }
+
+private:
+    size_t m_capacity = 0;
+    size_t m_alignment = 256;
+    size_t m_head = 0;
+    size_t m_frameDemand = 0; /**< Bytes pedidos en el frame actual, incluidas las reservas que no cupieron. */
+    bool m_discardPending = true;
+    uint64_t m_generation = 0;
+    ConstantRingStats m_stats;
+};
@@ -128,6 +128,28 @@ public:
             unsigned int SrcRowPitch,
             unsigned int SrcDepthPitch);
 
+    /**
+     * @brief Copia una region de un subrecurso a otro en la GPU.
+     *
+     * @param pDstResource Recurso de destino.
+     * @param DstSubresource Subrecurso de destino.
+     * @param DstX Coordenada X de destino.
+     * @param DstY Coordenada Y de destino.
+     * @param DstZ Coordenada Z de destino.
+     * @param pSrcResource Recurso de origen.
+     * @param SrcSubresource Subrecurso de origen.
+     * @param pSrcBox Region de origen (nullptr = subrecurso completo).
+     */
+    void
+        CopySubresourceRegion(ID3D11Resource* pDstResource,
+            unsigned int DstSubresource,
+            unsigned int DstX,
+            unsigned int DstY,
+            unsigned int DstZ,
+            ID3D11Resource* pSrcResource,
+            unsigned int SrcSubresource,
+            const D3D11_BOX* pSrcBox);
+
     /**
      * @brief Limpia un render target con un color espec�fico.
      *
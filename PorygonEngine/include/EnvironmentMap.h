@@ -0,0 +1,121 @@
+#pragma once
+#include "Prerequisites.h"
+#include "EnvironmentPrefilter.h"
+#include "Texture.h"
+
+class
+    Device;
+
+class
+    DeviceContext;
+
+/**
+ * @brief Opciones de carga y prefiltrado de un mapa de entorno.
+ */
+struct
+    EnvironmentMapOptions {
+    EnvironmentPrefilterOptions prefilter; /**< Tamano, niveles y muestras del especular. */
+    unsigned int faceSize = 0;             /**< Lado de las caras al proyectar una imagen equirectangular (0 = ancho / 4). */
+    bool srgb = true;                      /**< Las imagenes fuente estan codificadas en sRGB. */
+    unsigned int lutSize = 128;            /**< Lado de la tabla de la BRDF. */
+    unsigned int lutSamples = 512;         /**< Muestras por texel de la tabla de la BRDF. */
+    unsigned int decodeThreads = 0;        /**< Hilos para decodificar un JPEG (0 = hardware_concurrency). */
+    std::string cacheDirectory;            /**< Carpeta de la cache de resultados (vacio = prefiltrar siempre). */
+};
+
+/**
+ * @class EnvironmentMap
+ * @brief Iluminacion basada en imagen: especular prefiltrado, irradiancia y tabla de la BRDF.
+ *
+ * Carga un cubemap (seis caras o una imagen equirectangular), lo prefiltra en
+ * CPU con EnvironmentPrefilter y sube el resultado:
+ *  - @ref m_specular: cubemap R16G16B16A16_FLOAT cuyo mip m corresponde a la
+ *    rugosidad m / (niveles - 1).
+ *  - @ref m_brdfLut: textura R16G16_FLOAT (escala, sesgo) indexada por (NdotV, rugosidad).
+ *  - @ref m_irradiance: 9 armonicos esfericos para el difuso, listos para un constant buffer.
+ *
+ * Con cacheDirectory los tres resultados se guardan en la TextureCache; la
+ * clave combina el contenido de las imagenes y las opciones, asi que un
+ * arranque con la cache llena no prefiltra nada. La tabla de la BRDF no
+ * depende del entorno y se comparte entre todos los mapas.
+ */
+class
+    EnvironmentMap {
+public:
+    EnvironmentMap() = default;
+    ~EnvironmentMap() = default;
+
+    /**
+     * @brief Carga y prefiltra una imagen equirectangular.
+     *
+     * @param device Dispositivo de DirectX.
+     * @param textureName Ruta sin extension.
+     * @param extensionType PNG, JPG o HDR (float lineal, se ignora srgb).
+     * @param options Opciones de carga y prefiltrado.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device,
+            const std::string& textureName,
+            ExtensionType extensionType,
+            const EnvironmentMapOptions& options = EnvironmentMapOptions());
+
+    /**
+     * @brief Carga y prefiltra seis caras cuadradas en el orden de CubeFace.
+     *
+     * @param device Dispositivo de DirectX.
+     * @param faceNames Rutas sin extension.
+     * @param extensionType PNG, JPG o HDR.
+     * @param options Opciones de carga y prefiltrado.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device,
+            const std::vector<std::string>& faceNames,
+            ExtensionType extensionType,
+            const EnvironmentMapOptions& options = EnvironmentMapOptions());
+
+    /**
+     * @brief Enlaza el especular en startSlot y la tabla de la BRDF en startSlot + 1.
+     */
+    void
+        render(DeviceContext& deviceContext, unsigned int startSlot);
+
+    /**
+     * @brief Libera las texturas.
+     */
+    void
+        destroy();
+
+    Texture m_specular;               /**< Cubemap especular prefiltrado. */
+    Texture m_brdfLut;                /**< Tabla de la BRDF (split-sum). */
+    float m_irradiance[9][4] = {};    /**< Armonicos esfericos del difuso (ver EnvironmentPrefilter::irradiance). */
+    unsigned int m_specularMips = 0;  /**< Niveles del especular (la rugosidad 1 es el ultimo). */
+    bool m_fromCache = false;         /**< El ultimo init leyo el especular y la irradiancia de la cache. */
+
+private:
+    /**
+     * @brief Carga el especular y la irradiancia de la cache, o los prefiltra y los guarda.
+     *
+     * @param loadSource Decodifica la fuente como cubemap lineal; solo se llama si falla la cache.
+     */
+    template <typename LoadSource>
+    HRESULT
+        initEnvironment(Device& device,
+            uint64_t sourceKey,
+            bool cacheable,
+            const EnvironmentMapOptions& options,
+            LoadSource loadSource);
+
+    /**
+     * @brief Carga la tabla de la BRDF de la cache, o la integra y la guarda.
+     */
+    HRESULT
+        initBrdfLut(Device& device, const EnvironmentMapOptions& options);
+
+    /**
+     * @brief Valor que identifica las opciones de prefiltrado en la clave de la cache.
+     */
+    static uint64_t
+        cacheSalt(const EnvironmentMapOptions& options);
+};
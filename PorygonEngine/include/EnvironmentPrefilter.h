@@ -0,0 +1,148 @@
+#pragma once
+#include "MipGenerator.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Caras de un cubemap en el orden de subrecursos de D3D11.
+ */
+enum
+    CubeFace {
+    CUBE_POSITIVE_X = 0,
+    CUBE_NEGATIVE_X = 1,
+    CUBE_POSITIVE_Y = 2,
+    CUBE_NEGATIVE_Y = 3,
+    CUBE_POSITIVE_Z = 4,
+    CUBE_NEGATIVE_Z = 5,
+    CUBE_FACE_COUNT = 6
+};
+
+/**
+ * @brief Un nivel de cubemap en punto flotante lineal (RGBA float por texel).
+ */
+struct
+    CubeImage {
+    unsigned int size = 0;       /**< Lado de cada cara en texeles. */
+    std::vector<float> texels;   /**< Caras contiguas: (cara * size + y) * size + x, 4 floats por texel. */
+
+    float*
+        face(unsigned int index) { return texels.data() + static_cast<size_t>(index) * size * size * 4; }
+
+    const float*
+        face(unsigned int index) const { return texels.data() + static_cast<size_t>(index) * size * size * 4; }
+};
+
+/**
+ * @brief Calidad del prefiltrado especular.
+ */
+struct
+    EnvironmentPrefilterOptions {
+    unsigned int specularSize = 256;  /**< Lado del nivel 0 especular (se limita al de la fuente). */
+    unsigned int specularMips = 6;    /**< Niveles de rugosidad: el nivel m tiene rugosidad m / (niveles - 1). */
+    unsigned int sampleCount = 128;   /**< Muestras GGX por texel (multiplo de 4). */
+    unsigned int threadCount = 0;     /**< Hilos (0 = hardware_concurrency). */
+};
+
+/**
+ * @class EnvironmentPrefilter
+ * @brief Prefiltrado en CPU de cubemaps de entorno para iluminacion basada en imagen.
+ *
+ * Produce los tres terminos de la aproximacion split-sum:
+ *  - @ref specular: una cadena de mips donde cada nivel es la radiancia
+ *    convolucionada con GGX para una rugosidad (muestreo por importancia
+ *    filtrado: cada muestra lee el mip de la fuente que cubre su angulo solido).
+ *  - @ref irradiance: la irradiancia difusa como armonicos esfericos de orden 2.
+ *  - @ref brdfLut: la tabla (escala, sesgo) del termino de Fresnel integrado.
+ *
+ * El trabajo se reparte entre hilos por filas de todas las caras. Las cuatro
+ * muestras de cada paso se transforman a la vez y los texeles se filtran con
+ * SSE2 (ver SimdConfig.h). No depende de Windows ni de DirectX.
+ */
+class
+    EnvironmentPrefilter {
+public:
+    EnvironmentPrefilter() = default;
+    ~EnvironmentPrefilter() = default;
+
+    /**
+     * @brief Convierte seis caras RGBA8 cuadradas del mismo lado a un cubemap lineal.
+     *
+     * @param faces Caras en el orden de CubeFace.
+     * @param srgb true si el color esta codificado en sRGB.
+     * @param cube Recibe el cubemap.
+     * @return false si las caras no son cuadradas o no comparten lado.
+     */
+    static bool
+        fromFaces(const ImageLevel faces[CUBE_FACE_COUNT], bool srgb, CubeImage& cube);
+
+    /**
+     * @brief Proyecta una imagen equirectangular RGBA float lineal sobre un cubemap.
+     *
+     * El centro de la imagen mira hacia +Z y la fila superior es +Y.
+     *
+     * @param rgba Texeles RGBA float contiguos.
+     * @param width Ancho de la imagen (360 grados).
+     * @param height Alto de la imagen (180 grados).
+     * @param faceSize Lado de las caras (0 = width / 4).
+     * @param cube Recibe el cubemap.
+     * @param threadCount Hilos (0 = hardware_concurrency).
+     */
+    static bool
+        fromEquirect(const float* rgba,
+            unsigned int width,
+            unsigned int height,
+            unsigned int faceSize,
+            CubeImage& cube,
+            unsigned int threadCount = 0);
+
+    /**
+     * @brief Convierte texeles RGBA8 a RGBA float lineal.
+     */
+    static void
+        toLinear(const ImageLevel& image, bool srgb, std::vector<float>& rgba);
+
+    /**
+     * @brief Convierte un cubemap lineal a seis caras RGBA8 (codificadas en sRGB si se pide).
+     */
+    static void
+        toFaces(const CubeImage& cube, bool srgb, ImageLevel faces[CUBE_FACE_COUNT]);
+
+    /**
+     * @brief Genera la cadena de mips especular convolucionada con GGX.
+     *
+     * @param source Cubemap de radiancia lineal.
+     * @param options Tamano, niveles, muestras e hilos.
+     * @param mips Recibe los niveles, del menos al mas rugoso.
+     * @return false si la fuente esta vacia.
+     */
+    static bool
+        specular(const CubeImage& source, const EnvironmentPrefilterOptions& options, std::vector<CubeImage>& mips);
+
+    /**
+     * @brief Proyecta la irradiancia difusa sobre 9 armonicos esfericos.
+     *
+     * Los coeficientes ya incluyen la convolucion con el coseno y la division
+     * por pi, asi que el color difuso es albedo * sum(coefficients[i] * Y_i(n)),
+     * con Y_i en el orden (0,0), (1,-1), (1,0), (1,1), (2,-2), (2,-1), (2,0), (2,1), (2,2).
+     *
+     * @param source Cubemap de radiancia lineal.
+     * @param coefficients Recibe 9 coeficientes RGBA (alfa = 0).
+     * @param threadCount Hilos (0 = hardware_concurrency).
+     */
+    static bool
+        irradiance(const CubeImage& source, float coefficients[9][4], unsigned int threadCount = 0);
+
+    /**
+     * @brief Integra la BRDF de GGX para la aproximacion split-sum.
+     *
+     * La columna es NdotV y la fila la rugosidad, ambas en el centro del
+     * texel; especular = prefiltrado * (F0 * lut.r + lut.g).
+     *
+     * @param size Lado de la tabla.
+     * @param sampleCount Muestras por texel.
+     * @param lut Recibe size * size pares (escala, sesgo).
+     * @param threadCount Hilos (0 = hardware_concurrency).
+     */
+    static void
+        brdfLut(unsigned int size, unsigned int sampleCount, std::vector<float>& lut, unsigned int threadCount = 0);
+};
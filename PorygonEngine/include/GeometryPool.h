@@ -0,0 +1,190 @@
+#pragma once
+#include "Prerequisites.h"
+#include "RangeAllocator.h"
+
+class
+    Device;
+
+class
+    DeviceContext;
+
+class
+    MeshComponent;
+
+class
+    UploadManager;
+
+/**
+ * @brief Capacidad de los buffers compartidos.
+ */
+struct
+    GeometryPoolOptions {
+    unsigned int vertexCapacity = 1024 * 1024;    /**< Vertices SimpleVertex del vertex buffer. */
+    unsigned int indexCapacity = 3 * 1024 * 1024; /**< Indices de 32 bits del index buffer. */
+};
+
+/**
+ * @brief Posicion de una malla dentro de los buffers, lista para DrawIndexed.
+ */
+struct
+    GeometryRange {
+    unsigned int baseVertex = 0;  /**< BaseVertexLocation: los indices de la malla son locales. */
+    unsigned int vertexCount = 0; /**< Vertices reservados. */
+    unsigned int startIndex = 0;  /**< StartIndexLocation. */
+    unsigned int indexCount = 0;  /**< Indices a dibujar. */
+};
+
+/**
+ * @brief Ocupacion del pool.
+ */
+struct
+    GeometryPoolStats {
+    unsigned int meshes = 0;            /**< Mallas vivas. */
+    size_t vertexUsed = 0;              /**< Vertices reservados. */
+    size_t indexUsed = 0;               /**< Indices reservados. */
+    size_t vertexFreeBlocks = 0;        /**< Huecos en el vertex buffer (1 = sin fragmentar). */
+    size_t indexFreeBlocks = 0;         /**< Huecos en el index buffer. */
+    unsigned int defragmentations = 0;  /**< Compactaciones hechas. */
+    unsigned int failures = 0;          /**< Mallas que no cupieron ni compactando. */
+};
+
+/**
+ * @class GeometryPool
+ * @brief Muchas mallas en un unico par de vertex e index buffers.
+ *
+ * En lugar de un ID3D11Buffer por malla (y un IASetVertexBuffers e
+ * IASetIndexBuffer por draw), cada malla ocupa un rango de vertices y otro de
+ * indices repartidos con RangeAllocator. Tras un @ref bind, todas las mallas
+ * del pool se dibujan con @ref draw, que solo pasa startIndex y baseVertex a
+ * DrawIndexed.
+ *
+ * Las mallas se identifican por un id estable: @ref defragment copia los
+ * rangos vivos, juntos, a buffers nuevos y actualiza sus posiciones, asi que
+ * hay que consultar @ref range de nuevo despues. @ref add compacta solo
+ * cuando hay sitio libre pero fragmentado.
+ *
+ * Con @ref setUploadManager los datos suben por el anillo de staging (las
+ * copias salen en UploadManager::flush); si no, con UpdateSubresource.
+ */
+class
+    GeometryPool {
+public:
+    GeometryPool() = default;
+    ~GeometryPool();
+
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    /**
+     * @brief Crea los buffers compartidos, vacios.
+     *
+     * @param device Dispositivo de DirectX (se guarda para @ref defragment).
+     * @param options Capacidad de los buffers.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device, const GeometryPoolOptions& options = GeometryPoolOptions());
+
+    /**
+     * @brief Sube los datos a traves de un UploadManager (nullptr = UpdateSubresource).
+     */
+    void
+        setUploadManager(UploadManager* uploadManager) { m_uploadManager = uploadManager; }
+
+    /**
+     * @brief Copia una malla al pool.
+     *
+     * @param deviceContext Contexto con el que se suben los datos.
+     * @param vertex Vertices de la malla.
+     * @param index Indices locales a vertex.
+     * @param meshId Recibe el id de la malla.
+     * @return HRESULT E_OUTOFMEMORY si no cabe ni compactando.
+     */
+    HRESULT
+        add(DeviceContext& deviceContext,
+            const std::vector<SimpleVertex>& vertex,
+            const std::vector<unsigned int>& index,
+            unsigned int& meshId);
+
+    /**
+     * @brief Copia la geometria de un MeshComponent al pool.
+     */
+    HRESULT
+        add(DeviceContext& deviceContext, const MeshComponent& mesh, unsigned int& meshId);
+
+    /**
+     * @brief Libera los rangos de una malla; su id se puede reutilizar.
+     */
+    void
+        remove(unsigned int meshId);
+
+    /**
+     * @brief Posicion actual de una malla (cambia tras @ref defragment).
+     */
+    const GeometryRange&
+        range(unsigned int meshId) const { return m_meshes[meshId].range; }
+
+    /**
+     * @brief Junta las mallas vivas al principio de buffers nuevos.
+     *
+     * @param deviceContext Contexto con el que se copian los rangos en la GPU.
+     * @return HRESULT Codigo de resultado; si falla, el pool queda como estaba.
+     */
+    HRESULT
+        defragment(DeviceContext& deviceContext);
+
+    /**
+     * @brief Enlaza los buffers compartidos (topologia e input layout son del llamador).
+     */
+    void
+        bind(DeviceContext& deviceContext);
+
+    /**
+     * @brief Dibuja una malla; requiere @ref bind antes.
+     */
+    void
+        draw(DeviceContext& deviceContext, unsigned int meshId);
+
+    GeometryPoolStats
+        stats() const;
+
+    /**
+     * @brief Libera los buffers y olvida todas las mallas.
+     */
+    void
+        destroy();
+
+private:
+    struct Mesh {
+        GeometryRange range;
+        bool live = false;
+    };
+
+    /**
+     * @brief Crea un buffer DEFAULT vacio de la capacidad dada.
+     */
+    HRESULT
+        createBuffer(unsigned int byteWidth, unsigned int bindFlags, ID3D11Buffer** buffer);
+
+    /**
+     * @brief Sube bytes a un rango de un buffer compartido.
+     */
+    void
+        upload(DeviceContext& deviceContext,
+            ID3D11Buffer* buffer,
+            unsigned int offset,
+            const void* data,
+            unsigned int size);
+
+    Device* m_device = nullptr;
+    UploadManager* m_uploadManager = nullptr;
+    GeometryPoolOptions m_options;
+    ID3D11Buffer* m_vertexBuffer = nullptr;
+    ID3D11Buffer* m_indexBuffer = nullptr;
+    RangeAllocator m_vertexRanges;
+    RangeAllocator m_indexRanges;
+    std::vector<Mesh> m_meshes;
+    std::vector<unsigned int> m_freeIds;
+    unsigned int m_defragmentations = 0;
+    unsigned int m_failures = 0;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class HdrPacker
+ * @brief Conversion de texeles RGBA float a formatos HDR compactos de la GPU.
+ *
+ *  - RGB9E5 (DXGI_FORMAT_R9G9B9E5_SHAREDEXP): 4 bytes por texel, tres
+ *    mantisas de 9 bits con un exponente compartido de 5 bits. Sin alfa ni
+ *    negativos; el maximo es 65408.
+ *  - Half (DXGI_FORMAT_R16G16B16A16_FLOAT): 8 bytes por texel con alfa.
+ *
+ * Frente a RGBA float (16 bytes) ahorran 4x y 2x. Ambas conversiones procesan
+ * cuatro valores a la vez con SSE2 (ver SimdConfig.h) y redondean al mas
+ * cercano; la ruta escalar da exactamente el mismo resultado.
+ *
+ * No depende de Windows ni de DirectX.
+ */
+class
+    HdrPacker {
+public:
+    /**
+     * @brief Empaqueta texeles RGBA float en RGB9E5 (se ignora el alfa).
+     *
+     * Los negativos y NaN se convierten en 0 y los valores mayores que 65408 se limitan.
+     *
+     * @param rgba Texeles RGBA float contiguos.
+     * @param count Numero de texeles.
+     * @param packed Recibe un uint32_t por texel.
+     */
+    static void
+        packRgb9e5(const float* rgba, size_t count, uint32_t* packed);
+
+    /**
+     * @brief Desempaqueta RGB9E5 a RGBA float (alfa = 1).
+     */
+    static void
+        unpackRgb9e5(const uint32_t* packed, size_t count, float* rgba);
+
+    /**
+     * @brief Convierte floats a half (IEEE 754 binary16), redondeando al par mas cercano.
+     *
+     * Los valores con modulo mayor que 65504 (incluido el infinito) se limitan
+     * al maximo finito; NaN se conserva.
+     *
+     * @param values Floats a convertir.
+     * @param count Numero de floats.
+     * @param halves Recibe un uint16_t por float.
+     */
+    static void
+        packHalf(const float* values, size_t count, uint16_t* halves);
+
+    /**
+     * @brief Convierte halves a float.
+     */
+    static void
+        unpackHalf(const uint16_t* halves, size_t count, float* values);
+};
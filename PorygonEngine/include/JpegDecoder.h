@@ -0,0 +1,79 @@
+#pragma once
+#include "MipGenerator.h"
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Datos de una decodificacion, utiles para medir y depurar.
+ */
+struct
+    JpegDecodeInfo {
+    bool progressive = false;          /**< JPEG progresivo (se decodifica en un solo hilo). */
+    unsigned int restartInterval = 0;  /**< MCUs por intervalo de reinicio (0 = sin marcadores RST). */
+    unsigned int segments = 0;         /**< Intervalos decodificados en paralelo (0 = ninguno). */
+    unsigned int threads = 1;          /**< Hilos usados tras limitar por tamano. */
+};
+
+/**
+ * @class JpegDecoder
+ * @brief Decodificador JPEG a RGBA8 que reparte el trabajo de una imagen entre hilos.
+ *
+ * Usa los mismos kernels que stb_image (IDCT, sobremuestreo y conversion
+ * YCbCr -> RGB con SSE2 o NEON cuando stb_image los detecta), por lo que el resultado es
+ * identico bit a bit al de stbi_load(..., 4). Lo que cambia es el reparto:
+ *  - En los escaneos baseline con marcadores de reinicio (DRI), cada intervalo
+ *    empieza con el estado de entropia limpio, asi que los intervalos se
+ *    localizan buscando los marcadores RSTn y se decodifican en paralelo.
+ *  - El sobremuestreo del croma y la conversion de color se hacen por
+ *    bandas de filas en paralelo, para cualquier JPEG.
+ * Los JPEG progresivos y los que no tienen marcadores de reinicio
+ * decodifican la entropia en serie, como stb_image.
+ *
+ * No depende de Windows ni de DirectX.
+ */
+class
+    JpegDecoder {
+public:
+    JpegDecoder() = default;
+    ~JpegDecoder() = default;
+
+    /**
+     * @brief Decodifica un JPEG en memoria.
+     *
+     * @param data Bytes del archivo.
+     * @param size Tamano en bytes.
+     * @param image Recibe los texeles RGBA8.
+     * @param channels Recibe los canales del archivo (1 gris, 3 color), como stbi_load.
+     * @param threadCount Hilos de trabajo (0 = hardware_concurrency). Se limita a
+     *        uno por cada 64K pixeles.
+     * @param info Opcional: recibe como se decodifico.
+     * @return false si el archivo no es un JPEG valido; ver failureReason().
+     *
+     * Con datos corruptos el resultado puede diferir del de stb_image: cada
+     * intervalo de reinicio se resincroniza en su marcador en lugar de
+     * arrastrar el error hasta el final del escaneo.
+     */
+    bool
+        decode(const unsigned char* data,
+            size_t size,
+            ImageLevel& image,
+            unsigned int& channels,
+            unsigned int threadCount = 0,
+            JpegDecodeInfo* info = nullptr) const;
+
+    /**
+     * @brief Proyecta el archivo en memoria y lo decodifica.
+     */
+    bool
+        decodeFile(const std::string& fileName,
+            ImageLevel& image,
+            unsigned int& channels,
+            unsigned int threadCount = 0,
+            JpegDecodeInfo* info = nullptr) const;
+
+    /**
+     * @brief Motivo del ultimo fallo en el hilo que llama.
+     */
+    static const char*
+        failureReason();
+};
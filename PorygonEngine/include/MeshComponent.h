@@ -1,5 +1,6 @@
 #pragma once
 #include "Prerequisites.h"
+#include "AtlasPacker.h"
 
 class DeviceContext;
 
@@ -26,6 +27,14 @@ public:
     void
         destroy();
 
+    // Reescribe las UVs (0..1) para muestrear la region de un atlas
+    void
+        applyAtlasRegion(const AtlasRegion& region) {
+        for (SimpleVertex& vertex : m_vertex) {
+            region.remap(vertex.Tex.x, vertex.Tex.y);
+        }
+    }
+
 public:
 
     std::string m_name;
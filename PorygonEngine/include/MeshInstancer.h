@@ -0,0 +1,95 @@
+#pragma once
+#include "Prerequisites.h"
+#include <map>
+
+/**
+ * @brief Geometria unica en espacio canonico, compartida por varias instancias.
+ */
+struct
+    MeshPrototype {
+    std::string name;                   /**< Nombre del primer objeto que la produjo. */
+    std::vector<SimpleVertex> vertex;   /**< Vertices en espacio canonico (centrado y orientado). */
+    std::vector<unsigned int> index;    /**< Indices locales al prototipo. */
+    unsigned int instanceCount = 0;     /**< Numero de objetos que usan este prototipo. */
+};
+
+/**
+ * @brief Objeto del archivo expresado como prototipo + transformacion.
+ */
+struct
+    MeshInstance {
+    std::string name;          /**< Nombre del objeto original ('o'). */
+    unsigned int prototype;    /**< Indice en InstancedModel::prototypes. */
+    XMFLOAT4X4 transform;      /**< Matriz mundo (convencion fila, como XMMATRIX). */
+};
+
+/**
+ * @brief Resultado de la deteccion de instancias de un LoadData.
+ */
+struct
+    InstancedModel {
+    std::vector<MeshPrototype> prototypes;
+    std::vector<MeshInstance> instances;
+    size_t sourceVertexCount = 0;   /**< Vertices del LoadData de entrada. */
+    size_t sourceIndexCount = 0;    /**< Indices del LoadData de entrada. */
+    size_t uniqueVertexCount = 0;   /**< Vertices almacenados tras deduplicar. */
+    size_t uniqueIndexCount = 0;    /**< Indices almacenados tras deduplicar. */
+};
+
+/**
+ * @class MeshInstancer
+ * @brief Paso de importacion que detecta objetos con geometria identica.
+ *
+ * Cada objeto de LoadData::objects se lleva a un espacio canonico: se centra en
+ * su centroide y se rota a un marco de referencia derivado de sus propios vertices.
+ * Los objetos se agrupan por un hash de su topologia (que no depende de la
+ * tolerancia) y dentro del grupo se comparan vertice a vertice con tolerancia;
+ * los que coinciden se guardan una sola vez con una lista de transformaciones
+ * por instancia.
+ */
+class
+    MeshInstancer {
+public:
+    MeshInstancer() = default;
+    ~MeshInstancer() = default;
+
+    /**
+     * @brief Agrupa los objetos del modelo en prototipos e instancias.
+     * @param data Modelo cargado por ModelLoader (con su lista de objetos).
+     * @param tolerance Distancia maxima, relativa al radio del objeto, para considerar
+     *        dos vertices iguales (mas unos ulps de la posicion del objeto, para
+     *        absorber el redondeo de copias alejadas del origen).
+     * @return Prototipos unicos y sus instancias.
+     */
+    InstancedModel
+        build(const LoadData& data, float tolerance = 1.0e-4f);
+
+private:
+    /**
+     * @brief Objeto extraido del LoadData y llevado a espacio canonico.
+     */
+    struct CanonicalMesh {
+        std::vector<SimpleVertex> vertex;
+        std::vector<unsigned int> index;
+        XMFLOAT4X4 transform;
+        float radius = 0.0f;
+    };
+
+    /**
+     * @brief Extrae los vertices de un objeto y los lleva a espacio canonico.
+     */
+    CanonicalMesh
+        canonicalize(const LoadData& data, const LoadObject& object) const;
+
+    /**
+     * @brief Hash FNV-1a de la topologia: numero de vertices e indices locales.
+     */
+    unsigned long long
+        hashMesh(const CanonicalMesh& mesh) const;
+
+    /**
+     * @brief Compara un objeto canonico con un prototipo existente.
+     */
+    bool
+        matches(const CanonicalMesh& mesh, const MeshPrototype& prototype, float epsilon) const;
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <vector>
+
+/**
+ * @brief Filtros disponibles para generar niveles de mip en CPU.
+ */
+enum
+    MipFilter {
+    BOX_FILTER = 0,     /**< Promedio 2x2 (el mas rapido). */
+    KAISER_FILTER = 1,  /**< Sinc con ventana de Kaiser (radio 3, alpha 4). */
+    LANCZOS_FILTER = 2  /**< Lanczos-3. */
+};
+
+/**
+ * @brief Un nivel de imagen RGBA8 en memoria de CPU.
+ */
+struct
+    ImageLevel {
+    unsigned int width = 0;              /**< Ancho en texeles. */
+    unsigned int height = 0;             /**< Alto en texeles. */
+    unsigned int rowPitch = 0;           /**< Bytes por fila. */
+    std::vector<unsigned char> pixels;   /**< Texeles RGBA8 contiguos. */
+};
+
+/**
+ * @brief Un nivel de imagen HDR en memoria de CPU (RGBA float lineal).
+ */
+struct
+    HdrImageLevel {
+    unsigned int width = 0;              /**< Ancho en texeles. */
+    unsigned int height = 0;             /**< Alto en texeles. */
+    std::vector<float> texels;           /**< Texeles RGBA float contiguos. */
+};
+
+/**
+ * @class MipGenerator
+ * @brief Genera cadenas de mips completas en CPU a partir de una imagen RGBA8.
+ *
+ * Los filtros son separables y se evaluan en punto flotante con SSE2 cuando
+ * esta disponible (ver SimdConfig.h). Para contenido sRGB el promedio se hace
+ * en espacio lineal y el resultado se vuelve a codificar en sRGB, de modo que
+ * los mips no se oscurecen. El alfa siempre se filtra en lineal.
+ *
+ * No depende de Windows ni de DirectX.
+ */
+class
+    MipGenerator {
+public:
+    MipGenerator() = default;
+    ~MipGenerator() = default;
+
+    /**
+     * @brief Numero de niveles de una cadena completa (hasta 1x1).
+     */
+    static unsigned int
+        calcMipCount(unsigned int width, unsigned int height);
+
+    /**
+     * @brief Genera la cadena de mips. El nivel 0 es una copia de la imagen de entrada.
+     *
+     * @param pixels Texeles RGBA8 de la imagen original.
+     * @param width Ancho de la imagen original.
+     * @param height Alto de la imagen original.
+     * @param rowPitch Bytes por fila de la imagen original.
+     * @param filter Filtro de reduccion.
+     * @param srgb true si el color esta codificado en sRGB.
+     * @param levels Recibe los niveles, del mas detallado al mas pequeno.
+     * @param maxLevels Numero maximo de niveles (0 = cadena completa).
+     * @return true si la cadena se genero correctamente.
+     */
+    bool
+        generate(const unsigned char* pixels,
+            unsigned int width,
+            unsigned int height,
+            unsigned int rowPitch,
+            MipFilter filter,
+            bool srgb,
+            std::vector<ImageLevel>& levels,
+            unsigned int maxLevels = 0) const;
+
+    /**
+     * @brief Reescala una imagen a cualquier tamano menor o igual con el filtro indicado.
+     *
+     * Usa los mismos filtros separables que @ref generate, con el soporte
+     * ampliado segun la proporcion, asi que una reduccion 4:1 promedia 4x4
+     * texeles (o mas con Kaiser y Lanczos) en una sola pasada.
+     *
+     * @param pixels Texeles RGBA8 de la imagen original.
+     * @param width Ancho de la imagen original.
+     * @param height Alto de la imagen original.
+     * @param rowPitch Bytes por fila de la imagen original.
+     * @param targetWidth Ancho de salida (1..width).
+     * @param targetHeight Alto de salida (1..height).
+     * @param filter Filtro de reduccion.
+     * @param srgb true si el color esta codificado en sRGB.
+     * @param result Recibe la imagen reducida.
+     * @return true si se reescalo correctamente.
+     */
+    bool
+        resize(const unsigned char* pixels,
+            unsigned int width,
+            unsigned int height,
+            unsigned int rowPitch,
+            unsigned int targetWidth,
+            unsigned int targetHeight,
+            MipFilter filter,
+            bool srgb,
+            ImageLevel& result) const;
+
+    /**
+     * @brief Genera la cadena de mips de una imagen HDR (RGBA float lineal).
+     *
+     * Mismos filtros que @ref generate, sin conversion de espacio de color. Los
+     * lobulos negativos de Kaiser y Lanczos se recortan a 0 en cada nivel.
+     *
+     * @param rgba Texeles RGBA float contiguos del nivel 0.
+     * @param width Ancho de la imagen.
+     * @param height Alto de la imagen.
+     * @param filter Filtro de reduccion.
+     * @param levels Recibe los niveles, del mas detallado al mas pequeno.
+     * @param maxLevels Numero maximo de niveles (0 = cadena completa).
+     * @return true si la cadena se genero correctamente.
+     */
+    bool
+        generateHdr(const float* rgba,
+            unsigned int width,
+            unsigned int height,
+            MipFilter filter,
+            std::vector<HdrImageLevel>& levels,
+            unsigned int maxLevels = 0) const;
+
+    /**
+     * @brief Reescala una imagen HDR a cualquier tamano menor o igual (ver @ref resize).
+     */
+    bool
+        resizeHdr(const float* rgba,
+            unsigned int width,
+            unsigned int height,
+            unsigned int targetWidth,
+            unsigned int targetHeight,
+            MipFilter filter,
+            HdrImageLevel& result) const;
+};
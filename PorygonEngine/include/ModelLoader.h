@@ -9,6 +9,51 @@
 #include <map>
 #include <tuple> // Opcional, pero util para comparaciones
 
+/**
+ * @brief Estadisticas de una carga OBJ: tiempos por etapa y contadores.
+ *
+ * Los tiempos estan en milisegundos. Las etapas no se solapan, por lo que
+ * su suma es aproximadamente totalMs (la diferencia es el coste de medir).
+ */
+struct
+	ModelLoadStats {
+	double ioMs = 0.0;              /**< Lectura del archivo completo a memoria. */
+	double tokenizeMs = 0.0;        /**< Separacion de lineas, tokens y de indices de cara. */
+	double floatParseMs = 0.0;      /**< Conversion de los valores de v / vt / vn a float. */
+	double dedupMs = 0.0;           /**< Busquedas e inserciones en el cache de vertices. */
+	double triangulationMs = 0.0;   /**< Triangulacion fan y validacion de indices. */
+	double finalizeMs = 0.0;        /**< Cierre del LoadData (contadores finales). */
+	double totalMs = 0.0;           /**< Tiempo total de Load. */
+
+	size_t bytesRead = 0;           /**< Bytes leidos del archivo. */
+	size_t linesTotal = 0;          /**< Lineas totales del archivo. */
+	size_t linesPosition = 0;       /**< Lineas 'v'. */
+	size_t linesTexCoord = 0;       /**< Lineas 'vt'. */
+	size_t linesNormal = 0;         /**< Lineas 'vn'. */
+	size_t linesFace = 0;           /**< Lineas 'f'. */
+	size_t linesObject = 0;         /**< Lineas 'o'. */
+	size_t linesSkipped = 0;        /**< Comentarios, vacias y comandos ignorados. */
+
+	size_t cacheLookups = 0;        /**< Busquedas en el cache de vertices unicos. */
+	size_t cacheHits = 0;           /**< Busquedas que reutilizaron un vertice existente. */
+	size_t ngonsTriangulated = 0;   /**< Caras con mas de 3 vertices que se triangularon. */
+	size_t trianglesEmitted = 0;    /**< Triangulos generados en total. */
+	size_t invalidIndices = 0;      /**< Vertices de cara descartados por indice invalido. */
+
+	/**
+	 * @brief Proporcion de aciertos del cache de vertices (0..1).
+	 */
+	double
+		cacheHitRate() const;
+
+	/**
+	 * @brief Serializa las estadisticas como un objeto JSON de una sola linea.
+	 * @param fileName Nombre del archivo que se incluye en el campo "file".
+	 */
+	std::string
+		toJson(const std::string& fileName) const;
+};
+
 /**
  * @class ModelLoader
  * @brief Clase encargada de gestionar la carga de modelos 3D con un parser OBJ manual.
@@ -27,6 +72,21 @@ public:
 	LoadData
 		Load(const std::string& objFileName);
 
+	/**
+	 * @brief Carga un archivo OBJ y devuelve tambien las estadisticas de la carga.
+	 * @param objFileName Nombre o ruta del archivo OBJ a cargar.
+	 * @param stats Recibe los tiempos por etapa y los contadores de la carga.
+	 * @return Estructura LoadData que contiene los datos del modelo cargado.
+	 */
+	LoadData
+		Load(const std::string& objFileName, ModelLoadStats& stats);
+
+public:
+	/**
+	 * @brief Si es true, cada carga escribe sus estadisticas en JSON en la salida de depuracion.
+	 */
+	bool m_emitStatsJson = false;
+
 private:
 	/**
 	 * @brief Estructura auxiliar que almacena los ndices de Posicin (v),
@@ -42,4 +102,4 @@ private:
 			return vn < other.vn;
 		}
 	};
-};
\ No newline at end of file
+};
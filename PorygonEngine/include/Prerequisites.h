@@ -78,11 +78,22 @@ struct
     XMFLOAT3 Normal; /**< Vector normal del v�rtice (para iluminaci�n). */
 };
 
+/**
+ * @brief Rango de indices que pertenece a un objeto ('o') de un archivo OBJ.
+ */
+struct
+    LoadObject {
+    std::string name;         /**< Nombre del objeto en el archivo. */
+    unsigned int startIndex;  /**< Primer indice del objeto dentro de LoadData::index. */
+    unsigned int indexCount;  /**< Numero de indices del objeto. */
+};
+
 struct
     LoadData {
     std::string name;
     std::vector <SimpleVertex> vertex;
     std::vector <unsigned int> index;
+    std::vector <LoadObject> objects; /**< Objetos del archivo en orden de aparicion. */
     int numVertex;
     int numIndex;
 };
@@ -119,7 +130,8 @@ enum
     ExtensionType {
     DDS = 0, /**< Textura en formato DDS (DirectDraw Surface). */
     PNG = 1, /**< Textura en formato PNG (Portable Network Graphics). */
-    JPG = 2  /**< Textura en formato JPG (Joint Photographic Experts Group). */
+    JPG = 2, /**< Textura en formato JPG (Joint Photographic Experts Group). */
+    HDR = 3  /**< Imagen HDR Radiance (.hdr), cargada en float y guardada como RGB9E5 o half. */
 };
 
 enum
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <map>
+
+/**
+ * @class RangeAllocator
+ * @brief Reparto de un rango [0, capacity) con una lista libre ordenada.
+ *
+ * Cada reserva toma el hueco libre mas pequeno donde cabe (best-fit) y se
+ * queda con su inicio; al liberar, el bloque se une con los huecos vecinos,
+ * asi que la lista solo crece con la fragmentacion real. Las unidades las
+ * decide el llamador (vertices, indices, bytes).
+ *
+ * No depende de Windows ni de DirectX.
+ */
+class
+    RangeAllocator {
+public:
+    RangeAllocator() = default;
+    ~RangeAllocator() = default;
+
+    /**
+     * @brief Deja todo el rango libre.
+     */
+    void
+        init(size_t capacity);
+
+    /**
+     * @brief Reserva un bloque contiguo.
+     *
+     * @param size Unidades a reservar (mayor que 0).
+     * @param offset Recibe el inicio del bloque.
+     * @return false si ningun hueco es lo bastante grande (puede haber sitio
+     *         fragmentado: ver @ref freeSpace y @ref largestFreeBlock).
+     */
+    bool
+        allocate(size_t size, size_t& offset);
+
+    /**
+     * @brief Devuelve un bloque reservado con @ref allocate.
+     */
+    void
+        free(size_t offset, size_t size);
+
+    size_t
+        capacity() const { return m_capacity; }
+
+    /**
+     * @brief Unidades libres en total.
+     */
+    size_t
+        freeSpace() const { return m_freeSpace; }
+
+    /**
+     * @brief Mayor bloque que se puede reservar ahora.
+     */
+    size_t
+        largestFreeBlock() const;
+
+    /**
+     * @brief Numero de huecos de la lista libre.
+     */
+    size_t
+        freeBlocks() const { return m_free.size(); }
+
+private:
+    std::map<size_t, size_t> m_free; /**< Inicio -> tamano de cada hueco. */
+    size_t m_capacity = 0;
+    size_t m_freeSpace = 0;
+};
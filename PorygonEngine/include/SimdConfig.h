@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * @file SimdConfig.h
+ * @brief Deteccion de SIMD en tiempo de compilacion para el codigo de CPU del motor.
+ *
+ * Este header no depende de Windows ni de DirectX para que los modulos de
+ * procesamiento de imagen y asignadores puedan compilarse en cualquier plataforma.
+ * PORYGON_SSE2 vale 1 cuando el compilador garantiza SSE2 (siempre en x64);
+ * en otro caso el codigo usa su ruta escalar.
+ */
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PORYGON_SSE2 1
+#include <emmintrin.h>
+#else
+#define PORYGON_SSE2 0
+#endif
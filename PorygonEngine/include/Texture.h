@@ -1,5 +1,8 @@
 ﻿#pragma once
 #include "Prerequisites.h"
+#include "MipGenerator.h"
+#include "BlockCompressor.h"
+#include "TextureCache.h"
 
 class
     Device;
@@ -7,6 +10,109 @@ class
 class
     DeviceContext;
 
+class
+    TextureResidency;
+
+/**
+ * @brief Uso de una textura importada; decide el formato de la GPU.
+ */
+enum
+    TextureUsage {
+    COLOR_USAGE = 0,      /**< Color en R8G8B8A8_UNORM (el shader trabaja en espacio de la imagen). */
+    SRGB_COLOR_USAGE = 1, /**< Color en R8G8B8A8_UNORM_SRGB: el hardware linealiza al muestrear. */
+    DATA_USAGE = 2,       /**< Datos lineales segun los canales: 1 -> R8, 2 -> R8G8 (valor, alfa), 3/4 -> RGBA8. */
+    NORMAL_USAGE = 3,     /**< Normales de dos canales en R8G8 (X, Y); Z se reconstruye en el shader. */
+    AUTO_USAGE = 4        /**< DATA para fuentes de 1 o 2 canales, COLOR para el resto. */
+};
+
+/**
+ * @brief Formato de GPU de las texturas HDR.
+ */
+enum
+    HdrFormat {
+    HDR_AUTO_FORMAT = 0,   /**< RGB9E5 si la fuente no tiene alfa, half en otro caso. */
+    HDR_RGB9E5_FORMAT = 1, /**< R9G9B9E5_SHAREDEXP: 4 bytes por texel, sin alfa ni negativos. */
+    HDR_HALF_FORMAT = 2    /**< R16G16B16A16_FLOAT: 8 bytes por texel. */
+};
+
+/**
+ * @brief Categoria de una textura; cada una tiene su lado maximo en TextureSizeCaps.
+ */
+enum
+    TextureCategory {
+    GENERIC_CATEGORY = 0,      /**< Sin categoria (sin limite en PC). */
+    PROP_CATEGORY = 1,         /**< Objetos del escenario. */
+    CHARACTER_CATEGORY = 2,    /**< Personajes. */
+    ENVIRONMENT_CATEGORY = 3,  /**< Terreno, edificios y cielos. */
+    UI_CATEGORY = 4,           /**< Interfaz. */
+    TEXTURE_CATEGORY_COUNT = 5
+};
+
+/**
+ * @brief Lado maximo de las texturas de cada categoria en una plataforma.
+ */
+struct
+    TextureSizeCaps {
+    unsigned int maxSize[TEXTURE_CATEGORY_COUNT] = { 0, 2048, 2048, 4096, 512 }; /**< Por categoria (0 = sin limite). */
+
+    /**
+     * @brief Limites para PC (los valores por defecto).
+     */
+    static TextureSizeCaps
+        desktop();
+
+    /**
+     * @brief Limites para equipos con poca memoria de video.
+     */
+    static TextureSizeCaps
+        lowEnd();
+};
+
+/**
+ * @brief Opciones de importacion para texturas cargadas desde imagen (PNG/JPG).
+ */
+struct
+    TextureImportOptions {
+    bool generateMips = true;          /**< Genera la cadena de mips completa en CPU. */
+    MipFilter mipFilter = BOX_FILTER;  /**< Filtro usado para reducir cada nivel. */
+    bool srgb = true;                  /**< El color esta en sRGB: los mips se promedian en lineal. */
+    bool compress = false;             /**< Comprime por bloques en CPU (requiere ancho y alto multiplos de 4). */
+    BlockFormat compressFormat = BC1_FORMAT;            /**< Formato BC de destino. */
+    CompressionQuality compressQuality = QUALITY_NORMAL; /**< Preset de calidad del compresor. */
+    TextureUsage usage = COLOR_USAGE;  /**< Uso de la textura: elige R8, R8G8, RGBA8 o su variante sRGB. */
+    unsigned int decodeThreads = 0;    /**< Hilos para decodificar un JPEG (0 = hardware_concurrency). */
+    unsigned int compressThreads = 0;  /**< Hilos para comprimir cada nivel (0 = hardware_concurrency). */
+    TextureCategory category = GENERIC_CATEGORY; /**< Categoria: elige el lado maximo en sizeCaps. */
+    TextureSizeCaps sizeCaps;          /**< Lados maximos de la plataforma. */
+    unsigned int maxSize = 0;          /**< Lado maximo de esta textura; si no es 0 manda sobre la categoria. */
+    MipFilter downscaleFilter = KAISER_FILTER; /**< Filtro para reducir las imagenes que superan el lado maximo. */
+    HdrFormat hdrFormat = HDR_AUTO_FORMAT; /**< Formato de las imagenes HDR (se ignoran srgb, compress y usage). */
+    std::string cacheDirectory;        /**< Carpeta de la cache de texturas ya procesadas (vacio = sin cache). */
+};
+
+/**
+ * @brief Resultado del trabajo de CPU de una importacion (mips y compresion).
+ *
+ * Lo genera Texture::prepare sin usar DirectX, por lo que puede construirse en
+ * un hilo de trabajo y entregarse despues al hilo de render. Solo se puede mover:
+ * @ref levels apunta a los buffers propios.
+ */
+struct
+    PreparedTexture {
+    PreparedTexture() = default;
+    PreparedTexture(const PreparedTexture&) = delete;
+    PreparedTexture& operator=(const PreparedTexture&) = delete;
+    PreparedTexture(PreparedTexture&&) = default;
+    PreparedTexture& operator=(PreparedTexture&&) = default;
+
+    unsigned int width = 0;                          /**< Ancho del nivel 0. */
+    unsigned int height = 0;                         /**< Alto del nivel 0. */
+    DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM; /**< Formato de todos los niveles. */
+    std::vector<TextureCacheLevel> levels;           /**< Vista de cada nivel, del mas detallado al mas pequeno. */
+    std::vector<ImageLevel> mipLevels;               /**< Niveles sin compresion (RGBA8, R8G8, R8 o HDR empaquetado). */
+    std::vector<CompressedImage> compressed;         /**< Niveles comprimidos por bloques. */
+};
+
 /**
  * @class Texture
  * @brief Representa una textura en DirectX 11.
@@ -41,6 +147,250 @@ public:
             const std::string& textureName,
             ExtensionType extensionType);
 
+    /**
+     * @brief Inicializa la textura desde un archivo de imagen con opciones de importacion.
+     *
+     * @param device Referencia al dispositivo de DirectX.
+     * @param textureName Nombre o ruta del archivo de la textura (sin extension).
+     * @param extensionType Tipo de extension de la textura (ej. PNG, JPG).
+     * @param options Opciones de importacion (mips, filtro, sRGB).
+     * @return HRESULT Codigo de resultado (S_OK si se cargo correctamente).
+     */
+    HRESULT
+        init(Device& device,
+            const std::string& textureName,
+            ExtensionType extensionType,
+            const TextureImportOptions& options);
+
+    /**
+     * @brief Inicializa la textura desde texeles ya procesados por @ref prepare.
+     *
+     * @param device Referencia al dispositivo de DirectX.
+     * @param prepared Niveles listos para la GPU.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device, const PreparedTexture& prepared);
+
+    /**
+     * @brief Inicializa la textura desde una entrada proyectada de la cache de texturas.
+     *
+     * @param device Referencia al dispositivo de DirectX.
+     * @param entry Entrada cargada con TextureCache::load.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device, const TextureCacheEntry& entry);
+
+    /**
+     * @brief Trabajo de CPU de una importacion: genera mips, comprime y empaqueta los canales segun las opciones.
+     *
+     * No usa DirectX; es seguro llamarla desde hilos de trabajo.
+     *
+     * @param pixels Texeles RGBA8 del nivel 0.
+     * @param width Ancho de la imagen.
+     * @param height Alto de la imagen.
+     * @param options Opciones de importacion.
+     * @param prepared Recibe los niveles listos para la GPU.
+     * @param sourceChannels Canales del archivo original (1 gris, 2 gris + alfa, 3 RGB, 4 RGBA).
+     * @return HRESULT Codigo de resultado.
+     */
+    static HRESULT
+        prepare(const unsigned char* pixels,
+            unsigned int width,
+            unsigned int height,
+            const TextureImportOptions& options,
+            PreparedTexture& prepared,
+            unsigned int sourceChannels = 4);
+
+    /**
+     * @brief Trabajo de CPU de una importacion HDR: reduce, genera mips en float y empaqueta.
+     *
+     * El formato sale de options.hdrFormat (ver HdrPacker). No usa DirectX; es
+     * seguro llamarla desde hilos de trabajo.
+     *
+     * @param rgba Texeles RGBA float lineales del nivel 0.
+     * @param width Ancho de la imagen.
+     * @param height Alto de la imagen.
+     * @param options Opciones de importacion.
+     * @param prepared Recibe los niveles listos para la GPU.
+     * @param sourceChannels Canales del archivo original (con 4 HDR_AUTO_FORMAT elige half).
+     * @return HRESULT Codigo de resultado.
+     */
+    static HRESULT
+        prepareHdr(const float* rgba,
+            unsigned int width,
+            unsigned int height,
+            const TextureImportOptions& options,
+            PreparedTexture& prepared,
+            unsigned int sourceChannels = 3);
+
+    /**
+     * @brief Inicializa un Texture2DArray con una capa por textura preparada.
+     *
+     * Todas las capas deben compartir tamano, formato y numero de mips. En el
+     * shader se muestrea con Texture2DArray y el indice de capa como tercera
+     * coordenada, que puede llegar por draw o por instancia.
+     *
+     * @param device Referencia al dispositivo de DirectX.
+     * @param slices Capas del arreglo, en orden.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device, const std::vector<PreparedTexture>& slices);
+
+    /**
+     * @brief Carga varias imagenes del mismo tamano como capas de un Texture2DArray.
+     *
+     * @param device Referencia al dispositivo de DirectX.
+     * @param textureNames Rutas sin extension; la capa de cada una es su posicion.
+     * @param extensionType PNG, JPG o HDR.
+     * @param options Opciones de importacion (iguales para todas las capas).
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device,
+            const std::vector<std::string>& textureNames,
+            ExtensionType extensionType,
+            const TextureImportOptions& options = TextureImportOptions());
+
+    /**
+     * @brief Inicializa un cubemap con seis caras preparadas en el orden de CubeFace (+X, -X, +Y, -Y, +Z, -Z).
+     *
+     * Las caras deben ser cuadradas y compartir tamano, formato y numero de mips.
+     *
+     * @param device Referencia al dispositivo de DirectX.
+     * @param faces Seis caras preparadas.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        initCube(Device& device, const std::vector<PreparedTexture>& faces);
+
+    /**
+     * @brief Inicializa un cubemap desde niveles ya listos para la GPU.
+     *
+     * @param device Referencia al dispositivo de DirectX.
+     * @param size Lado del nivel 0 de cada cara.
+     * @param format Formato de todos los niveles.
+     * @param levels Niveles ordenados por cara: cara * numMips + mip.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        initCube(Device& device,
+            unsigned int size,
+            DXGI_FORMAT format,
+            const std::vector<TextureCacheLevel>& levels);
+
+    /**
+     * @brief Carga un cubemap desde seis imagenes cuadradas del mismo tamano.
+     *
+     * @param device Referencia al dispositivo de DirectX.
+     * @param faceNames Rutas sin extension en el orden de CubeFace.
+     * @param extensionType PNG, JPG o HDR.
+     * @param options Opciones de importacion (iguales para todas las caras).
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        initCube(Device& device,
+            const std::vector<std::string>& faceNames,
+            ExtensionType extensionType,
+            const TextureImportOptions& options = TextureImportOptions());
+
+    /**
+     * @brief Carga un cubemap desde una imagen equirectangular (2:1, el centro mira hacia +Z).
+     *
+     * @param device Referencia al dispositivo de DirectX.
+     * @param textureName Ruta sin extension.
+     * @param extensionType PNG, JPG o HDR.
+     * @param faceSize Lado de las caras (0 = ancho / 4).
+     * @param options Opciones de importacion de las caras.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        initCube(Device& device,
+            const std::string& textureName,
+            ExtensionType extensionType,
+            unsigned int faceSize = 0,
+            const TextureImportOptions& options = TextureImportOptions());
+
+    /**
+     * @brief Capa de un Texture2DArray que contiene la textura indicada.
+     * @return Indice de la capa, o -1 si no esta en el arreglo.
+     */
+    int
+        findSlice(const std::string& textureName) const;
+
+    /**
+     * @brief Decodifica un archivo PNG/JPG/HDR y lo procesa con @ref prepare o @ref prepareHdr.
+     *
+     * No usa DirectX; es seguro llamarla desde hilos de trabajo.
+     *
+     * @param fileName Ruta completa del archivo (con extension).
+     * @param options Opciones de importacion.
+     * @param prepared Recibe los niveles listos para la GPU.
+     * @return HRESULT Codigo de resultado.
+     */
+    static HRESULT
+        decodeFile(const std::string& fileName,
+            const TextureImportOptions& options,
+            PreparedTexture& prepared);
+
+    /**
+     * @brief Decodifica un archivo PNG/JPG a RGBA8 sin procesarlo.
+     *
+     * No usa DirectX; es seguro llamarla desde hilos de trabajo.
+     *
+     * @param fileName Ruta completa del archivo (con extension).
+     * @param decodeThreads Hilos para decodificar un JPEG (0 = hardware_concurrency).
+     * @param image Recibe los texeles.
+     * @param channels Recibe los canales del archivo original.
+     * @return HRESULT Codigo de resultado.
+     */
+    static HRESULT
+        decodeImage(const std::string& fileName,
+            unsigned int decodeThreads,
+            ImageLevel& image,
+            unsigned int& channels);
+
+    /**
+     * @brief Decodifica un archivo PNG/JPG/HDR a RGBA float lineal.
+     *
+     * Los HDR se leen con stbi_loadf; el resto se decodifica con @ref decodeImage
+     * y se linealiza si srgb es true. No usa DirectX.
+     *
+     * @param fileName Ruta completa del archivo (con extension).
+     * @param srgb Las imagenes de 8 bits estan codificadas en sRGB.
+     * @param decodeThreads Hilos para decodificar un JPEG (0 = hardware_concurrency).
+     * @param rgba Recibe los texeles.
+     * @param width Recibe el ancho.
+     * @param height Recibe el alto.
+     * @param channels Recibe los canales del archivo original.
+     * @return HRESULT Codigo de resultado.
+     */
+    static HRESULT
+        decodeLinear(const std::string& fileName,
+            bool srgb,
+            unsigned int decodeThreads,
+            std::vector<float>& rgba,
+            unsigned int& width,
+            unsigned int& height,
+            unsigned int& channels);
+
+    /**
+     * @brief Lado maximo que aplican las opciones (0 = sin limite).
+     *
+     * Las imagenes mayores se reducen en @ref prepare antes de generar los
+     * mips; los DDS empiezan en el primer mip que cabe.
+     */
+    static unsigned int
+        maxImportSize(const TextureImportOptions& options);
+
+    /**
+     * @brief Valor que identifica las opciones de importacion en la clave de la cache.
+     */
+    static uint64_t
+        cacheSalt(const TextureImportOptions& options);
+
     /**
      * @brief Inicializa la textura como un recurso vac�o en memoria.
      *
@@ -93,10 +443,32 @@ public:
 
     /**
      * @brief Libera los recursos asociados a la textura.
+     *
+     * Tambien olvida las capas y la marca de cubemap; el nombre y el gestor
+     * de residencia se conservan para poder recargarla.
      */
     void
         destroy();
 
+private:
+    /**
+     * @brief Crea la textura con todos sus niveles (y capas) y la SRV que los cubre.
+     *
+     * @param levels Niveles ordenados por capa: capa * numMips + mip.
+     * @param arraySize Numero de capas.
+     * @param cube true para crear un cubemap (arraySize debe ser 6).
+     * @param array true para crear la vista como Texture2DArray aunque tenga
+     *        una sola capa (los shaders del camino por arreglos la declaran asi).
+     */
+    HRESULT
+        createShaderResource(Device& device,
+            unsigned int width,
+            unsigned int height,
+            DXGI_FORMAT format,
+            const std::vector<TextureCacheLevel>& levels,
+            unsigned int arraySize = 1,
+            bool cube = false,
+            bool array = false);
 
 public:
     /**
@@ -113,4 +485,29 @@ public:
      * @brief Nombre o ruta de la textura cargada.
      */
     std::string m_textureName;
+
+    /**
+     * @brief Bytes de texeles subidos a la GPU (0 si se desconoce, p. ej. DDS).
+     */
+    size_t m_memoryBytes = 0;
+
+    /**
+     * @brief Numero de capas si la textura es un Texture2DArray (0 = textura simple).
+     */
+    unsigned int m_arraySize = 0;
+
+    /**
+     * @brief true si la textura es un cubemap (se muestrea con TextureCube).
+     */
+    bool m_cubemap = false;
+
+    /**
+     * @brief Nombre de cada capa del Texture2DArray, en orden.
+     */
+    std::vector<std::string> m_sliceNames;
+
+    /**
+     * @brief Gestor de residencia que controla esta textura (nullptr = siempre residente).
+     */
+    TextureResidency* m_residency = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+#include "Prerequisites.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+class
+    Device;
+
+/**
+ * @brief Una textura a cargar dentro de un lote.
+ */
+struct
+    TextureLoadRequest {
+    Texture* target = nullptr;         /**< Textura que recibe el resultado. */
+    std::string textureName;           /**< Ruta sin extension (como en Texture::init). */
+    ExtensionType extensionType = PNG; /**< PNG, JPG y HDR se decodifican en paralelo; DDS se carga en el hilo de render. */
+    TextureImportOptions options;      /**< Opciones de importacion. */
+};
+
+/**
+ * @brief Metricas de un lote de carga de texturas.
+ */
+struct
+    TextureBatchStats {
+    unsigned int submitted = 0;        /**< Texturas encoladas. */
+    unsigned int created = 0;          /**< Texturas creadas correctamente en la GPU. */
+    unsigned int failed = 0;           /**< Texturas que fallaron al decodificar o al crearse. */
+    unsigned int cacheHits = 0;        /**< Texturas servidas por la cache de texturas. */
+    size_t sourceBytes = 0;            /**< Bytes de los archivos fuente decodificados. */
+    size_t decodedBytes = 0;           /**< Bytes RGBA8 decodificados. */
+    size_t peakBudgetBytes = 0;        /**< Maximo de bytes decodificados retenidos a la vez. */
+    double decodeMs = 0.0;             /**< Tiempo de CPU sumado en hilos de trabajo (decodificacion + mips + compresion). */
+    double budgetWaitMs = 0.0;         /**< Tiempo sumado que las texturas esperaron presupuesto antes de decodificarse. */
+    double createMs = 0.0;             /**< Tiempo del hilo de render creando recursos. */
+    double wallMs = 0.0;               /**< Tiempo real desde el primer encolado hasta la ultima creacion. */
+
+    /**
+     * @brief Texturas completadas por segundo de tiempo real.
+     */
+    double
+        imagesPerSecond() const;
+
+    /**
+     * @brief Megabytes decodificados por segundo de tiempo real.
+     */
+    double
+        megabytesPerSecond() const;
+};
+
+/**
+ * @class TextureBatchLoader
+ * @brief Carga lotes de texturas decodificando en paralelo en un ThreadPool.
+ *
+ * Una primera tarea lee la cabecera de la imagen y reserva su tamano RGBA8
+ * contra el presupuesto de memoria; la decodificacion (stb_image y el trabajo
+ * de CPU de Texture::prepare) solo se encola en el grupo cuando la reserva
+ * cabe, asi que ningun hilo de trabajo se bloquea esperando presupuesto. Los
+ * resultados quedan en una cola de listos que el hilo de render vacia con
+ * @ref pump, donde se crean los recursos D3D11 y se libera el presupuesto.
+ */
+class
+    TextureBatchLoader {
+public:
+    /**
+     * @param pool Hilos de trabajo usados para decodificar.
+     * @param memoryBudget Bytes decodificados que pueden estar retenidos a la vez.
+     */
+    TextureBatchLoader(ThreadPool& pool, size_t memoryBudget = 256u * 1024u * 1024u);
+    ~TextureBatchLoader();
+
+    /**
+     * @brief Encola una textura. Se puede llamar en cualquier momento.
+     */
+    void
+        submit(const TextureLoadRequest& request);
+
+    /**
+     * @brief Crea en la GPU las texturas que ya estan listas. Llamar desde el hilo de render.
+     *
+     * @param device Dispositivo de DirectX.
+     * @param maxTextures Maximo de texturas a crear en esta llamada (0 = todas las listas).
+     * @return Numero de texturas procesadas (creadas o fallidas).
+     */
+    unsigned int
+        pump(Device& device, unsigned int maxTextures = 0);
+
+    /**
+     * @brief Encola el lote completo y bombea hasta que todas las texturas esten creadas.
+     * @return S_OK si todas se crearon, o el HRESULT del primer fallo.
+     */
+    HRESULT
+        loadAll(Device& device, const std::vector<TextureLoadRequest>& requests);
+
+    /**
+     * @brief true si no quedan texturas pendientes de decodificar ni de crear.
+     */
+    bool
+        done() const;
+
+    /**
+     * @brief Copia de las metricas acumuladas.
+     */
+    TextureBatchStats
+        stats() const;
+
+private:
+    /**
+     * @brief Resultado de un hilo de trabajo esperando al hilo de render.
+     */
+    struct ReadyTexture {
+        TextureLoadRequest request;
+        HRESULT result = S_OK;
+        bool fromCache = false;
+        size_t budgetBytes = 0;
+        PreparedTexture prepared;
+        TextureCacheEntry cacheEntry;
+    };
+
+    /**
+     * @brief Decodificacion que espera presupuesto para encolarse.
+     */
+    struct PendingDecode {
+        ReadyTexture ready;
+        bool cacheable = false;
+        uint64_t cacheKey = 0;
+        size_t decodedBytes = 0;
+        double workerMs = 0.0; /**< Tiempo ya gastado en el hilo de trabajo (cabecera y cache). */
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    /**
+     * @brief Tarea de trabajo: consulta la cache y la cabecera y pide presupuesto.
+     */
+    void
+        probe(const TextureLoadRequest& request);
+
+    /**
+     * @brief Encola en el grupo las decodificaciones que caben en el presupuesto. Requiere m_mutex.
+     */
+    void
+        dispatchWaiting();
+
+    /**
+     * @brief Tarea de trabajo: decodifica y prepara una textura con su presupuesto ya reservado.
+     */
+    void
+        decode(PendingDecode& pending);
+
+    /**
+     * @brief Publica un resultado en la cola de listos.
+     */
+    void
+        publish(PendingDecode& pending, double workerMs, size_t sourceBytes);
+
+    ThreadPool& m_pool;
+    size_t m_memoryBudget;
+    size_t m_budgetInUse = 0;
+    unsigned int m_pending = 0;      /**< Encoladas y aun no creadas. */
+    unsigned int m_inFlight = 0;     /**< Tareas de decodificacion que no han publicado su resultado. */
+    HRESULT m_firstError = S_OK;
+    std::deque<ReadyTexture> m_ready;
+    std::deque<std::shared_ptr<PendingDecode>> m_waiting; /**< Esperando presupuesto, en orden de llegada. */
+    TextureBatchStats m_stats;
+    std::chrono::steady_clock::time_point m_batchStart;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_readyAvailable;
+};
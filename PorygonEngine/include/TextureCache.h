@@ -0,0 +1,142 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class MappedFile
+ * @brief Archivo de solo lectura proyectado en memoria.
+ *
+ * Usa CreateFileMapping/MapViewOfFile en Windows y mmap en el resto de
+ * plataformas. Solo se puede mover, no copiar.
+ */
+class
+    MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Proyecta el archivo completo.
+     * @return true si el archivo existe, no esta vacio y se pudo proyectar.
+     */
+    bool
+        open(const std::string& path);
+
+    /**
+     * @brief Libera la proyeccion y el archivo.
+     */
+    void
+        close();
+
+    const unsigned char*
+        data() const { return m_data; }
+
+    size_t
+        size() const { return m_size; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+/**
+ * @brief Un nivel de mip listo para la GPU (ya sea para escribirlo o leido de la cache).
+ */
+struct
+    TextureCacheLevel {
+    unsigned int width = 0;               /**< Ancho en texeles. */
+    unsigned int height = 0;              /**< Alto en texeles. */
+    unsigned int rowPitch = 0;            /**< Bytes por fila (o por fila de bloques en BC). */
+    const unsigned char* data = nullptr;  /**< Inicio del nivel. */
+    size_t size = 0;                      /**< Bytes del nivel. */
+};
+
+/**
+ * @brief Entrada de la cache proyectada en memoria.
+ *
+ * Los punteros de @ref levels apuntan dentro de @ref file y son validos
+ * mientras la entrada siga viva.
+ */
+struct
+    TextureCacheEntry {
+    unsigned int format = 0;                /**< Valor de DXGI_FORMAT. */
+    unsigned int width = 0;                 /**< Ancho del nivel 0. */
+    unsigned int height = 0;                /**< Alto del nivel 0. */
+    std::vector<TextureCacheLevel> levels;  /**< Niveles del mas detallado al mas pequeno. */
+    MappedFile file;                        /**< Proyeccion que respalda los niveles. */
+};
+
+/**
+ * @class TextureCache
+ * @brief Cache en disco del payload final de las texturas importadas.
+ *
+ * Cada entrada es un archivo "<clave>.ptc" con una cabecera (formato, tamano,
+ * numero de mips), una tabla de niveles (offset, tamano, pitch) y los datos
+ * alineados a 16 bytes. La clave es un hash del archivo fuente combinado con
+ * las opciones de importacion, de modo que cambiar la imagen o las opciones
+ * invalida la entrada. Al cargar, el archivo se proyecta en memoria y los
+ * niveles se pasan directamente a D3D11_SUBRESOURCE_DATA sin decodificar.
+ *
+ * No depende de DirectX: el formato se guarda como un entero.
+ */
+class
+    TextureCache {
+public:
+    TextureCache() = default;
+
+    /**
+     * @param directory Carpeta donde se guardan las entradas.
+     */
+    explicit TextureCache(const std::string& directory) : m_directory(directory) {}
+
+    ~TextureCache() = default;
+
+    /**
+     * @brief Calcula la clave de un archivo fuente (FNV-1a de 64 bits sobre su contenido).
+     *
+     * @param sourcePath Ruta del archivo fuente.
+     * @param salt Valor que identifica las opciones de importacion.
+     * @param key Recibe la clave.
+     * @return false si el archivo no se pudo leer.
+     */
+    static bool
+        makeKey(const std::string& sourcePath, uint64_t salt, uint64_t& key);
+
+    /**
+     * @brief Ruta del archivo de cache para una clave.
+     */
+    std::string
+        entryPath(uint64_t key) const;
+
+    /**
+     * @brief Busca y proyecta una entrada.
+     * @return false si no existe o esta corrupta (se trata como un fallo de cache).
+     */
+    bool
+        load(uint64_t key, TextureCacheEntry& entry) const;
+
+    /**
+     * @brief Escribe una entrada. Se escribe a un archivo temporal y luego se renombra.
+     *
+     * @param key Clave de la entrada.
+     * @param format Valor de DXGI_FORMAT de los niveles.
+     * @param levels Niveles a guardar (data/size deben ser validos).
+     * @return true si la entrada quedo escrita.
+     */
+    bool
+        store(uint64_t key, unsigned int format, const std::vector<TextureCacheLevel>& levels) const;
+
+private:
+    std::string m_directory;
+};
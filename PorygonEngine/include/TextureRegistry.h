@@ -0,0 +1,122 @@
+#pragma once
+#include "Prerequisites.h"
+#include "Texture.h"
+#include <map>
+#include <memory>
+
+class
+    Device;
+
+/**
+ * @brief Referencia compartida a una textura del registro.
+ *
+ * La textura se destruye (destroy + delete) cuando se suelta el ultimo handle.
+ */
+using TextureHandle = std::shared_ptr<Texture>;
+
+/**
+ * @brief Metricas de busqueda del registro de texturas.
+ */
+struct
+    TextureRegistryStats {
+    unsigned int lookups = 0;      /**< Llamadas a acquire. */
+    unsigned int pathHits = 0;     /**< Resueltas por ruta normalizada. */
+    unsigned int contentHits = 0;  /**< Resueltas por hash de contenido (otra ruta, mismo archivo). */
+    unsigned int loads = 0;        /**< Texturas cargadas desde disco. */
+    unsigned int failures = 0;     /**< Cargas fallidas. */
+    unsigned int released = 0;     /**< Texturas liberadas al soltar su ultimo handle. */
+
+    /**
+     * @brief Fraccion de busquedas resueltas sin cargar (0..1).
+     */
+    double
+        hitRate() const {
+        return lookups > 0 ? static_cast<double>(pathHits + contentHits) / lookups : 0.0;
+    }
+};
+
+/**
+ * @brief Descripcion de una textura residente.
+ */
+struct
+    ResidentTextureInfo {
+    std::string name;          /**< Ruta normalizada con extension. */
+    size_t memoryBytes = 0;    /**< Bytes de texeles en la GPU (0 si se desconoce). */
+    long useCount = 0;         /**< Handles vivos fuera del registro. */
+};
+
+/**
+ * @class TextureRegistry
+ * @brief Registro central de texturas compartidas con conteo de referencias.
+ *
+ * Las texturas se identifican por su ruta normalizada (minusculas, '/' como
+ * separador, sin "./" ni ".."), su tipo y sus opciones de importacion. Si la
+ * ruta no esta registrada, se busca ademas por el hash del contenido del
+ * archivo, de modo que dos rutas al mismo archivo comparten la textura.
+ * El registro solo guarda referencias debiles: no mantiene vivas las texturas.
+ *
+ * Se usa desde el hilo de render, igual que Texture.
+ */
+class
+    TextureRegistry {
+public:
+    TextureRegistry() = default;
+    ~TextureRegistry() = default;
+
+    /**
+     * @brief Devuelve la textura compartida, cargandola si no esta residente.
+     *
+     * @param device Dispositivo de DirectX.
+     * @param textureName Ruta sin extension (como en Texture::init).
+     * @param extensionType Tipo de imagen.
+     * @param options Opciones de importacion (forman parte de la clave).
+     * @return Handle compartido, o nullptr si la carga fallo.
+     */
+    TextureHandle
+        acquire(Device& device,
+            const std::string& textureName,
+            ExtensionType extensionType,
+            const TextureImportOptions& options = TextureImportOptions());
+
+    /**
+     * @brief Lista las texturas residentes con su memoria y sus usuarios.
+     */
+    std::vector<ResidentTextureInfo>
+        residentTextures();
+
+    /**
+     * @brief Suma de la memoria de las texturas residentes.
+     */
+    size_t
+        residentBytes();
+
+    /**
+     * @brief Copia de las metricas acumuladas.
+     */
+    TextureRegistryStats
+        stats() const { return m_stats; }
+
+    /**
+     * @brief Normaliza una ruta para usarla como clave.
+     */
+    static std::string
+        normalizePath(const std::string& path);
+
+private:
+    /**
+     * @brief Quita las entradas cuyas texturas ya se liberaron.
+     */
+    void
+        collect();
+
+    struct Entry {
+        std::string name;
+        uint64_t contentKey = 0;
+        bool owner = false;            /**< Entrada que cargo la textura (las demas son alias). */
+        std::weak_ptr<Texture> texture;
+    };
+
+    std::map<std::string, Entry> m_byPath;
+    std::map<uint64_t, std::string> m_byContent;
+    TextureRegistryStats m_stats;
+};
@@ -0,0 +1,181 @@
+#pragma once
+#include "Prerequisites.h"
+#include "Texture.h"
+#include <unordered_map>
+
+class
+    Device;
+
+class
+    DeviceContext;
+
+/**
+ * @brief Parametros del gestor de residencia de texturas.
+ */
+struct
+    TextureResidencyOptions {
+    size_t budgetBytes = 256 * 1024 * 1024; /**< Memoria de GPU maxima para las texturas registradas. */
+    unsigned int evictAfterFrames = 120;    /**< Frames sin usarse antes de poder expulsar una textura completa. */
+    unsigned int minResidentSize = 128;     /**< Lado minimo del nivel 0 al quitar mips. */
+};
+
+/**
+ * @brief Actividad del gestor (en un frame o acumulada).
+ */
+struct
+    TextureResidencyStats {
+    unsigned long long frame = 0;   /**< Frame al que corresponden los datos. */
+    size_t budgetBytes = 0;         /**< Presupuesto configurado. */
+    size_t residentBytes = 0;       /**< Memoria de las texturas registradas al cerrar el frame. */
+    unsigned int tracked = 0;       /**< Texturas registradas. */
+    unsigned int resident = 0;      /**< Texturas registradas con datos en la GPU. */
+    unsigned int evictions = 0;     /**< Texturas expulsadas por completo. */
+    unsigned int mipDrops = 0;      /**< Niveles de mip quitados. */
+    unsigned int reloads = 0;       /**< Texturas recargadas (expulsadas o con mips quitados). */
+    unsigned int failedReloads = 0; /**< Recargas fallidas. */
+};
+
+/**
+ * @class TextureResidency
+ * @brief Mantiene la memoria de las texturas registradas bajo un presupuesto.
+ *
+ * Texture::render avisa al gestor cada vez que se enlaza una textura
+ * registrada, de modo que se conoce el ultimo frame en que se uso. Al cerrar
+ * el frame (@ref endFrame), si la memoria supera el presupuesto:
+ *  1. se expulsan, de la menos a la mas recientemente usada, las texturas
+ *     que llevan al menos evictAfterFrames sin usarse;
+ *  2. se quita el mip mas grande de las texturas en orden LRU, una ronda
+ *     tras otra, hasta minResidentSize (copia en GPU, sin releer el archivo);
+ *  3. se expulsan las que no se usaron en este frame.
+ * Una textura expulsada se recarga desde su archivo (o desde la cache de
+ * texturas) la proxima vez que se enlaza. A una textura con mips quitados se
+ * le devuelven al cerrar un frame en que se uso, si caben en el presupuesto.
+ *
+ * Se usa desde el hilo de render, igual que Texture. Las texturas registradas
+ * deben salir del gestor (@ref untrack o @ref release) antes de destruirse.
+ */
+class
+    TextureResidency {
+public:
+    TextureResidency() = default;
+    ~TextureResidency();
+
+    TextureResidency(const TextureResidency&) = delete;
+    TextureResidency& operator=(const TextureResidency&) = delete;
+
+    /**
+     * @brief Configura el gestor.
+     *
+     * @param device Dispositivo usado para recargar y rehacer texturas.
+     * @param options Presupuesto y politica de expulsion.
+     */
+    void
+        init(Device& device, const TextureResidencyOptions& options = TextureResidencyOptions());
+
+    /**
+     * @brief Carga una textura desde archivo y la registra.
+     *
+     * Mismos parametros que Texture::init; la ruta y las opciones se guardan
+     * para poder recargarla.
+     */
+    HRESULT
+        load(Texture& texture,
+            const std::string& textureName,
+            ExtensionType extensionType,
+            const TextureImportOptions& options = TextureImportOptions());
+
+    /**
+     * @brief Registra una textura ya cargada con Texture::init desde ese archivo.
+     */
+    void
+        track(Texture& texture,
+            const std::string& textureName,
+            ExtensionType extensionType,
+            const TextureImportOptions& options = TextureImportOptions());
+
+    /**
+     * @brief Saca la textura del gestor sin liberarla.
+     */
+    void
+        untrack(Texture& texture);
+
+    /**
+     * @brief Saca la textura del gestor y la destruye.
+     */
+    void
+        release(Texture& texture);
+
+    /**
+     * @brief Marca la textura como usada en este frame; si estaba expulsada, la recarga.
+     *
+     * La llama Texture::render.
+     * @return false si la textura no tiene datos en la GPU (recarga fallida).
+     */
+    bool
+        touch(Texture& texture);
+
+    /**
+     * @brief Aplica el presupuesto, cierra las metricas del frame y avanza el contador.
+     *
+     * @param deviceContext Contexto donde se copian los mips al reducir texturas.
+     */
+    void
+        endFrame(DeviceContext& deviceContext);
+
+    /**
+     * @brief Metricas del ultimo frame cerrado.
+     */
+    TextureResidencyStats
+        frameStats() const { return m_frameStats; }
+
+    /**
+     * @brief Metricas acumuladas desde init.
+     */
+    TextureResidencyStats
+        totalStats() const { return m_totalStats; }
+
+    /**
+     * @brief Memoria actual de las texturas registradas.
+     */
+    size_t
+        residentBytes() const;
+
+private:
+    struct Entry {
+        Texture* texture = nullptr;
+        std::string textureName;
+        ExtensionType extensionType = PNG;
+        TextureImportOptions options;
+        unsigned long long lastUsedFrame = 0;
+        size_t fullBytes = 0;          /**< Memoria con todos los mips. */
+        unsigned int droppedMips = 0;  /**< Mips quitados del nivel 0. */
+        bool evicted = false;
+        bool failed = false;           /**< La ultima recarga fallo: no se reintenta. */
+    };
+
+    /**
+     * @brief Vuelve a cargar la textura completa desde su archivo.
+     */
+    bool
+        reload(Entry& entry);
+
+    /**
+     * @brief Rehace la textura sin su nivel 0 copiando los demas niveles en la GPU.
+     */
+    bool
+        dropTopMip(Entry& entry, DeviceContext& deviceContext);
+
+    /**
+     * @brief Libera la textura en la GPU manteniendola registrada.
+     */
+    void
+        evict(Entry& entry);
+
+    Device* m_device = nullptr;
+    TextureResidencyOptions m_options;
+    std::unordered_map<Texture*, Entry> m_entries;
+    unsigned long long m_frame = 0;
+    TextureResidencyStats m_current;
+    TextureResidencyStats m_frameStats;
+    TextureResidencyStats m_totalStats;
+};
@@ -0,0 +1,152 @@
+#pragma once
+#include "Prerequisites.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <mutex>
+
+class
+    Device;
+
+class
+    DeviceContext;
+
+class
+    UploadManager;
+
+/**
+ * @brief Opciones de una textura con streaming de mips.
+ */
+struct
+    TextureStreamingOptions {
+    unsigned int residentSize = 64;                 /**< Lado maximo de los mips que se suben al activarse la textura. */
+    size_t uploadBytesPerFrame = 4u * 1024u * 1024u; /**< Bytes de mips que puede subir cada llamada a update. */
+    TextureImportOptions import;                    /**< Opciones de importacion (siempre con mips). */
+};
+
+/**
+ * @brief Metricas acumuladas del streaming de mips.
+ */
+struct
+    TextureStreamingStats {
+    unsigned int requested = 0;      /**< Texturas pedidas. */
+    unsigned int fullyResident = 0;  /**< Texturas con todos sus mips subidos. */
+    unsigned int failed = 0;         /**< Texturas que no se pudieron cargar. */
+    unsigned int cacheHits = 0;      /**< Texturas activadas directamente desde la cache. */
+    unsigned int levelsUploaded = 0; /**< Niveles de mip subidos. */
+    size_t bytesUploaded = 0;        /**< Bytes de mips subidos. */
+};
+
+/**
+ * @class TextureStreamer
+ * @brief Streaming progresivo de mips: primero los niveles pequenos, despues el detalle.
+ *
+ * @ref request crea la textura con su cadena completa de mips pero solo sube
+ * los niveles de lado <= residentSize; la SRV se crea con MostDetailedMip en el
+ * primer nivel residente, asi que la textura se puede usar de inmediato. Cada
+ * llamada a @ref update sube los siguientes niveles (del pequeno al grande)
+ * dentro del presupuesto por frame y recrea la SRV bajando MostDetailedMip.
+ *
+ * Si la textura esta en la cache de texturas, los niveles residentes se suben
+ * en la misma llamada a @ref request. Si no, la imagen se decodifica en el
+ * ThreadPool y, mientras tanto, la textura muestra un texel gris de 1x1.
+ */
+class
+    TextureStreamer {
+public:
+    explicit TextureStreamer(ThreadPool& pool) : m_pool(pool) {}
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /**
+     * @brief Empieza el streaming de una textura PNG/JPG. DDS y HDR se cargan completas al momento.
+     *
+     * @param device Dispositivo de DirectX.
+     * @param deviceContext Contexto usado para subir los niveles residentes.
+     * @param target Textura que recibe la SRV. Debe vivir hasta que termine el streaming.
+     * @param textureName Ruta sin extension.
+     * @param extensionType Tipo de imagen.
+     * @param options Opciones de streaming.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        request(Device& device,
+            DeviceContext& deviceContext,
+            Texture& target,
+            const std::string& textureName,
+            ExtensionType extensionType,
+            const TextureStreamingOptions& options = TextureStreamingOptions());
+
+    /**
+     * @brief Sube los mips a traves de los anillos de staging en lugar de UpdateSubresource.
+     *
+     * Los niveles llegan a la GPU en el siguiente UploadManager::flush, que debe
+     * llamarse antes de dibujar. nullptr vuelve a UpdateSubresource.
+     */
+    void
+        setUploadManager(UploadManager* uploadManager) { m_uploadManager = uploadManager; }
+
+    /**
+     * @brief Sube los mips pendientes dentro del presupuesto. Llamar una vez por frame.
+     */
+    void
+        update(Device& device, DeviceContext& deviceContext);
+
+    /**
+     * @brief true si todas las texturas tienen su cadena completa residente.
+     */
+    bool
+        done() const;
+
+    /**
+     * @brief Copia de las metricas acumuladas.
+     */
+    TextureStreamingStats
+        stats() const;
+
+    /**
+     * @brief Espera a las decodificaciones en curso y descarta el streaming pendiente.
+     */
+    void
+        destroy();
+
+private:
+    /**
+     * @brief Estado de una textura en streaming.
+     */
+    struct StreamingEntry {
+        Texture* target = nullptr;
+        std::string fileName;
+        TextureStreamingOptions options;
+        bool payloadReady = false;          /**< El hilo de trabajo (o la cache) entrego los niveles. */
+        bool decoding = false;              /**< Hay una tarea de decodificacion en vuelo. */
+        HRESULT result = S_OK;
+        PreparedTexture prepared;
+        TextureCacheEntry cacheEntry;
+        std::vector<TextureCacheLevel> levels;
+        DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        ID3D11Texture2D* texture = nullptr; /**< Recurso con la cadena completa (propiedad de target). */
+        unsigned int residentMip = 0;       /**< Nivel mas detallado ya subido. */
+    };
+
+    HRESULT
+        activate(Device& device, DeviceContext& deviceContext, StreamingEntry& entry);
+
+    HRESULT
+        uploadLevel(DeviceContext& deviceContext, StreamingEntry& entry, unsigned int level);
+
+    HRESULT
+        updateView(Device& device, StreamingEntry& entry);
+
+    static HRESULT
+        createPlaceholder(Device& device, Texture& target);
+
+    ThreadPool& m_pool;
+    UploadManager* m_uploadManager = nullptr;
+    std::vector<std::unique_ptr<StreamingEntry>> m_entries;
+    TextureStreamingStats m_stats;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_decodeFinished;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Grupo fijo de hilos de trabajo que ejecuta tareas en orden FIFO.
+ *
+ * Las tareas no devuelven valor; quien las encola se encarga de publicar sus
+ * resultados (por ejemplo en una cola protegida por mutex). El destructor
+ * termina las tareas pendientes y une los hilos.
+ *
+ * No depende de Windows ni de DirectX.
+ */
+class
+    ThreadPool {
+public:
+    /**
+     * @param threadCount Numero de hilos (0 = hardware_concurrency, minimo 1).
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Encola una tarea.
+     */
+    void
+        submit(std::function<void()> task);
+
+    /**
+     * @brief Bloquea hasta que la cola este vacia y ningun hilo este ejecutando tareas.
+     */
+    void
+        wait();
+
+    /**
+     * @brief Numero de hilos de trabajo.
+     */
+    unsigned int
+        size() const { return static_cast<unsigned int>(m_threads.size()); }
+
+private:
+    void
+        workerLoop();
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_idle;
+    unsigned int m_active = 0;
+    bool m_stopping = false;
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief Bloque reservado para el frame actual.
+ */
+struct
+    TransientAllocation {
+    size_t offset = 0; /**< Inicio dentro del buffer completo (incluye el segmento del frame). */
+    size_t size = 0;   /**< Unidades reservadas. */
+};
+
+/**
+ * @brief Uso del allocator para dimensionar los buffers.
+ */
+struct
+    TransientAllocatorStats {
+    size_t frameUsed = 0;       /**< Unidades usadas en el frame actual, con el relleno de alineacion. */
+    size_t lastFrameUsed = 0;   /**< Unidades usadas en el frame anterior. */
+    size_t highWater = 0;       /**< Maximo usado en un frame desde init. */
+    size_t requestedPeak = 0;   /**< Maximo pedido en un frame, contando lo que no cupo. */
+    unsigned int failures = 0;  /**< Reservas que no cupieron en su frame. */
+};
+
+/**
+ * @class TransientAllocator
+ * @brief Reparto lineal por frame de un buffer dividido en un segmento por frame en vuelo.
+ *
+ * El buffer tiene frameCount segmentos de frameSize unidades. @ref beginFrame
+ * pasa al siguiente segmento y lo vacia; @ref allocate solo avanza un puntero
+ * dentro de el. Un segmento no se reutiliza hasta frameCount frames despues,
+ * asi que, si el llamador espera a que la GPU termine ese frame, se puede
+ * escribir con D3D11_MAP_WRITE_NO_OVERWRITE.
+ *
+ * requestedPeak frente a frameSize indica cuanto hay que agrandar el
+ * segmento cuando hay fallos. No depende de Windows ni de DirectX.
+ */
+class
+    TransientAllocator {
+public:
+    TransientAllocator() = default;
+    ~TransientAllocator() = default;
+
+    /**
+     * @brief Prepara los segmentos vacios; el primer frame empieza en el segmento 0.
+     *
+     * @param frameCount Frames en vuelo (segmentos).
+     * @param frameSize Unidades de cada segmento.
+     */
+    void
+        init(unsigned int frameCount, size_t frameSize);
+
+    /**
+     * @brief Cierra el frame actual y vacia el segmento del siguiente.
+     */
+    void
+        beginFrame();
+
+    /**
+     * @brief Reserva un bloque del frame actual.
+     *
+     * @param size Unidades a reservar (mayor que 0).
+     * @param alignment Alineacion del inicio, relativa al inicio del buffer (0 o 1 = sin alinear).
+     * @param allocation Recibe el desplazamiento y el tamano.
+     * @return false si no queda sitio en el segmento del frame.
+     */
+    bool
+        allocate(size_t size, size_t alignment, TransientAllocation& allocation);
+
+    /**
+     * @brief Segmento del frame actual, en [0, frameCount).
+     */
+    unsigned int
+        frameSegment() const { return m_segment; }
+
+    unsigned int
+        frameCount() const { return m_frameCount; }
+
+    size_t
+        frameSize() const { return m_frameSize; }
+
+    TransientAllocatorStats
+        stats() const { return m_stats; }
+
+private:
+    unsigned int m_frameCount = 0;
+    size_t m_frameSize = 0;
+    unsigned int m_segment = 0;
+    size_t m_head = 0;        /**< Unidades usadas del segmento actual. */
+    size_t m_requested = 0;   /**< Unidades pedidas en el frame actual. */
+    TransientAllocatorStats m_stats;
+};
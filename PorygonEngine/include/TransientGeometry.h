@@ -0,0 +1,163 @@
+#pragma once
+#include "Prerequisites.h"
+#include "TransientAllocator.h"
+
+class
+    Device;
+
+class
+    DeviceContext;
+
+/**
+ * @brief Tamano de los buffers transitorios.
+ */
+struct
+    TransientGeometryOptions {
+    unsigned int framesInFlight = 3;             /**< Segmentos por buffer (frames que la GPU puede llevar de retraso). */
+    unsigned int vertexBytesPerFrame = 1 << 20;  /**< Bytes de vertices por frame. */
+    unsigned int indexBytesPerFrame = 256 << 10; /**< Bytes de indices por frame. */
+};
+
+/**
+ * @brief Datos escritos para este frame, listos para IASetVertexBuffers/IASetIndexBuffer.
+ */
+struct
+    TransientBufferRange {
+    ID3D11Buffer* buffer = nullptr; /**< Buffer compartido (sin referencia propia). */
+    unsigned int offset = 0;        /**< Byte de inicio. */
+    unsigned int size = 0;          /**< Bytes escritos. */
+};
+
+/**
+ * @brief Metricas de los buffers transitorios.
+ */
+struct
+    TransientGeometryStats {
+    TransientAllocatorStats vertex; /**< Uso del vertex buffer, en bytes. */
+    TransientAllocatorStats index;  /**< Uso del index buffer, en bytes. */
+    unsigned int stalls = 0;        /**< Frames que esperaron a la GPU para reutilizar un segmento. */
+};
+
+/**
+ * @class TransientGeometry
+ * @brief Vertices e indices generados cada frame (lineas de depuracion, UI, particulas).
+ *
+ * Dos buffers D3D11_USAGE_DYNAMIC, uno de vertices y otro de indices,
+ * divididos en un segmento por frame en vuelo (ver TransientAllocator). Cada
+ * escritura avanza dentro del segmento del frame y se mapea con
+ * WRITE_NO_OVERWRITE, sin crear buffers ni copias en el driver.
+ *
+ * @ref beginFrame cierra el frame anterior con una consulta D3D11_QUERY_EVENT
+ * y, antes de reutilizar un segmento, espera a que la GPU haya completado el
+ * frame que lo uso (normalmente ya lo ha hecho). Los highWater de @ref stats
+ * indican el tamano por frame que necesita la aplicacion.
+ *
+ * La crea quien genere geometria cada frame; si nadie escribe, solo cuesta
+ * una consulta por frame, asi que no conviene tenerla sin consumidores. Uso:
+ *
+ * @code
+ * transient.beginFrame(context);          // una vez por frame, antes de escribir
+ * TransientBufferRange vertices, indices;
+ * if (transient.writeVertices(context, lines.data(), sizeof(SimpleVertex), count, vertices) &&
+ *     transient.writeIndices(context, lineIndices.data(), DXGI_FORMAT_R16_UINT, indexCount, indices)) {
+ *     const unsigned int stride = sizeof(SimpleVertex);
+ *     context.m_deviceContext->IASetVertexBuffers(0, 1, &vertices.buffer, &stride, &vertices.offset);
+ *     context.m_deviceContext->IASetIndexBuffer(indices.buffer, DXGI_FORMAT_R16_UINT, indices.offset);
+ *     context.m_deviceContext->DrawIndexed(indexCount, 0, 0);
+ * }
+ * @endcode
+ *
+ * Si una escritura falla (el segmento del frame esta lleno) el llamador
+ * puede omitir ese dibujo o usar un Buffer propio.
+ */
+class
+    TransientGeometry {
+public:
+    TransientGeometry() = default;
+    ~TransientGeometry();
+
+    TransientGeometry(const TransientGeometry&) = delete;
+    TransientGeometry& operator=(const TransientGeometry&) = delete;
+
+    /**
+     * @brief Crea los buffers y las consultas de cada segmento.
+     *
+     * @param device Dispositivo de DirectX.
+     * @param options Tamano de los buffers.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device, const TransientGeometryOptions& options = TransientGeometryOptions());
+
+    /**
+     * @brief Empieza un frame: lo escrito en el anterior deja de ser valido.
+     *
+     * Llamar una vez por frame, antes de escribir datos transitorios.
+     */
+    void
+        beginFrame(DeviceContext& deviceContext);
+
+    /**
+     * @brief Copia vertices al segmento del frame.
+     *
+     * @param deviceContext Contexto con el que se mapea.
+     * @param data Vertices.
+     * @param stride Bytes por vertice; el inicio queda alineado a el.
+     * @param count Numero de vertices.
+     * @param range Recibe el buffer y el desplazamiento.
+     * @return false si no hay sitio en el frame o falla Map.
+     */
+    bool
+        writeVertices(DeviceContext& deviceContext,
+            const void* data,
+            unsigned int stride,
+            unsigned int count,
+            TransientBufferRange& range);
+
+    /**
+     * @brief Copia indices de 16 o 32 bits al segmento del frame.
+     *
+     * @param format DXGI_FORMAT_R16_UINT o DXGI_FORMAT_R32_UINT.
+     * @return false si no hay sitio en el frame, el formato no es valido o falla Map.
+     */
+    bool
+        writeIndices(DeviceContext& deviceContext,
+            const void* data,
+            DXGI_FORMAT format,
+            unsigned int count,
+            TransientBufferRange& range);
+
+    TransientGeometryStats
+        stats() const;
+
+    /**
+     * @brief Libera los buffers y las consultas.
+     */
+    void
+        destroy();
+
+private:
+    /**
+     * @brief Reserva en un allocator, mapea y copia.
+     */
+    bool
+        write(DeviceContext& deviceContext,
+            TransientAllocator& allocator,
+            ID3D11Buffer* buffer,
+            bool& discardPending,
+            const void* data,
+            unsigned int size,
+            unsigned int alignment,
+            TransientBufferRange& range);
+
+    ID3D11Buffer* m_vertexBuffer = nullptr;
+    ID3D11Buffer* m_indexBuffer = nullptr;
+    TransientAllocator m_vertexAllocator;
+    TransientAllocator m_indexAllocator;
+    std::vector<ID3D11Query*> m_frameQueries; /**< Fin del ultimo frame que uso cada segmento. */
+    std::vector<bool> m_queryIssued;
+    bool m_frameOpen = false;
+    bool m_vertexDiscard = true; /**< El primer Map tras crear el buffer es WRITE_DISCARD. */
+    bool m_indexDiscard = true;
+    unsigned int m_stalls = 0;
+};
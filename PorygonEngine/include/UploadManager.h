@@ -0,0 +1,205 @@
+#pragma once
+#include "Prerequisites.h"
+#include "UploadRing.h"
+#include <deque>
+#include <map>
+
+class
+    Device;
+
+class
+    DeviceContext;
+
+/**
+ * @brief Tamano de los anillos de staging.
+ */
+struct
+    UploadManagerOptions {
+    size_t bufferPageSize = 4 * 1024 * 1024; /**< Bytes de cada buffer de staging. */
+    unsigned int bufferPages = 4;            /**< Buffers de staging en el anillo. */
+    unsigned int texturePageWidth = 2048;    /**< Ancho en texeles de cada textura de staging. */
+    unsigned int texturePageHeight = 1024;   /**< Alto en texeles de cada textura de staging. */
+    unsigned int texturePages = 3;           /**< Texturas de staging por formato. */
+};
+
+/**
+ * @brief Metricas acumuladas de las subidas.
+ */
+struct
+    UploadManagerStats {
+    unsigned int bufferUploads = 0;  /**< Subidas a buffers a traves del anillo. */
+    unsigned int textureUploads = 0; /**< Subidas a texturas a traves del anillo. */
+    unsigned int fallbacks = 0;      /**< Subidas hechas con UpdateSubresource (sin sitio o sin soporte). */
+    unsigned int flushes = 0;        /**< Llamadas a flush con copias pendientes. */
+    size_t bytesStaged = 0;          /**< Bytes escritos en los recursos de staging. */
+    uint64_t submittedFence = 0;     /**< Ultimo fence enviado a la GPU. */
+    uint64_t completedFence = 0;     /**< Ultimo fence que la GPU completo. */
+};
+
+/**
+ * @class UploadManager
+ * @brief Sube datos a recursos D3D11_USAGE_DEFAULT a traves de anillos de staging.
+ *
+ * Los datos se escriben con Map en buffers o texturas D3D11_USAGE_STAGING y
+ * se copian al destino con CopySubresourceRegion. El reparto de las paginas
+ * lo hace UploadRing: un anillo de bytes para buffers y uno de filas de
+ * bloques por cada formato de textura. Cada @ref flush desmapea las paginas,
+ * emite las copias pendientes y cierra las paginas con un fence (una consulta
+ * D3D11_QUERY_EVENT); una pagina no se vuelve a mapear hasta que la consulta
+ * indica que la GPU termino con ella, asi que Map nunca espera a la GPU.
+ *
+ * Las copias se emiten en @ref flush, que debe llamarse antes de dibujar con
+ * los recursos actualizados. Si una subida no cabe en el anillo o el formato
+ * no se puede copiar por regiones, se hace con UpdateSubresource en el acto.
+ */
+class
+    UploadManager {
+public:
+    UploadManager() = default;
+    ~UploadManager();
+
+    UploadManager(const UploadManager&) = delete;
+    UploadManager& operator=(const UploadManager&) = delete;
+
+    /**
+     * @brief Crea el anillo de buffers de staging.
+     *
+     * Las texturas de staging se crean la primera vez que se sube un formato.
+     * @param device Dispositivo de DirectX.
+     * @param options Tamano de los anillos.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device, const UploadManagerOptions& options = UploadManagerOptions());
+
+    /**
+     * @brief Sube bytes a un buffer de uso DEFAULT.
+     *
+     * @param deviceContext Contexto usado si hay que recurrir a UpdateSubresource.
+     * @param destination Buffer destino (sin D3D11_BIND_CONSTANT_BUFFER).
+     * @param destinationOffset Byte de inicio en el destino.
+     * @param data Datos a subir; se copian antes de volver.
+     * @param size Bytes a subir.
+     */
+    void
+        uploadBuffer(DeviceContext& deviceContext,
+            ID3D11Buffer* destination,
+            unsigned int destinationOffset,
+            const void* data,
+            unsigned int size);
+
+    /**
+     * @brief Sube un rectangulo (por defecto el subrecurso completo) de una textura 2D de uso DEFAULT.
+     *
+     * @param deviceContext Contexto usado si hay que recurrir a UpdateSubresource.
+     * @param destination Textura destino.
+     * @param subresource Subrecurso destino (D3D11CalcSubresource).
+     * @param format Formato de la textura destino.
+     * @param width Ancho del rectangulo en texeles.
+     * @param height Alto del rectangulo en texeles.
+     * @param data Texeles a subir; se copian antes de volver.
+     * @param rowPitch Bytes por fila de texeles (o de bloques en BC) en data.
+     * @param x Columna de destino en texeles (multiplo de 4 en BC).
+     * @param y Fila de destino en texeles (multiplo de 4 en BC).
+     */
+    void
+        uploadTexture(DeviceContext& deviceContext,
+            ID3D11Texture2D* destination,
+            unsigned int subresource,
+            DXGI_FORMAT format,
+            unsigned int width,
+            unsigned int height,
+            const void* data,
+            unsigned int rowPitch,
+            unsigned int x = 0,
+            unsigned int y = 0);
+
+    /**
+     * @brief Emite las copias pendientes y libera las paginas que la GPU ya leyo.
+     *
+     * Llamar una vez por frame, despues de las subidas y antes de dibujar.
+     */
+    void
+        flush(DeviceContext& deviceContext);
+
+    /**
+     * @brief Copia de las metricas acumuladas.
+     */
+    UploadManagerStats
+        stats() const { return m_stats; }
+
+    /**
+     * @brief Libera los recursos de staging y las consultas. Descarta las copias sin emitir.
+     */
+    void
+        destroy();
+
+private:
+    /**
+     * @brief Recurso de staging de una pagina y su mapeo mientras esta abierta.
+     */
+    struct StagingPage {
+        ID3D11Resource* resource = nullptr;
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        bool isMapped = false;
+    };
+
+    /**
+     * @brief Anillo de texturas de staging de un formato.
+     */
+    struct TextureRing {
+        UploadRing ring;
+        std::vector<StagingPage> pages;
+        unsigned int blockSize = 1;     /**< Lado del bloque en texeles (4 en BC). */
+        unsigned int bytesPerBlock = 4; /**< Bytes por texel o por bloque. */
+    };
+
+    /**
+     * @brief Copia registrada hasta el siguiente flush.
+     */
+    struct PendingCopy {
+        ID3D11Resource* destination = nullptr; /**< Con una referencia propia hasta emitir la copia. */
+        unsigned int subresource = 0;
+        unsigned int x = 0;
+        unsigned int y = 0;
+        ID3D11Resource* source = nullptr;
+        D3D11_BOX box = {};
+    };
+
+    /**
+     * @brief Consulta de evento que senala un fence.
+     */
+    struct Fence {
+        uint64_t value = 0;
+        ID3D11Query* query = nullptr;
+    };
+
+    /**
+     * @brief Mapea la pagina si aun no lo esta.
+     */
+    bool
+        mapPage(DeviceContext& deviceContext, StagingPage& page);
+
+    /**
+     * @brief Anillo del formato, creandolo la primera vez; nullptr si el formato no se admite.
+     */
+    TextureRing*
+        textureRing(DXGI_FORMAT format);
+
+    /**
+     * @brief Consulta los fences en vuelo y libera las paginas ya leidas.
+     */
+    void
+        retire(DeviceContext& deviceContext);
+
+    Device* m_device = nullptr;
+    UploadManagerOptions m_options;
+    UploadRing m_bufferRing;
+    std::vector<StagingPage> m_bufferPages;
+    std::map<DXGI_FORMAT, TextureRing> m_textureRings;
+    std::vector<PendingCopy> m_pending;
+    std::deque<Fence> m_inFlight;
+    std::vector<ID3D11Query*> m_freeQueries;
+    uint64_t m_nextFence = 0;
+    UploadManagerStats m_stats;
+};
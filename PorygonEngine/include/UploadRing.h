@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Bloque reservado dentro de una pagina del anillo.
+ */
+struct
+    UploadRingAllocation {
+    unsigned int page = 0; /**< Pagina (recurso de staging) que contiene el bloque. */
+    size_t offset = 0;     /**< Inicio dentro de la pagina, en las unidades del anillo. */
+    size_t size = 0;       /**< Tamano reservado, en las unidades del anillo. */
+};
+
+/**
+ * @brief Metricas acumuladas del anillo.
+ */
+struct
+    UploadRingStats {
+    unsigned int allocations = 0; /**< Reservas servidas. */
+    unsigned int failures = 0;    /**< Reservas rechazadas (sin paginas libres o bloque mayor que una pagina). */
+    unsigned int pagesOpened = 0; /**< Paginas empezadas a llenar. */
+    size_t allocated = 0;         /**< Unidades reservadas, sin contar el relleno de alineacion. */
+};
+
+/**
+ * @class UploadRing
+ * @brief Reparto de un anillo de paginas de staging con seguimiento por fences.
+ *
+ * Cada pagina representa un recurso de staging de pageSize unidades (bytes en
+ * un buffer, filas de bloques en una textura). Las reservas se sirven de forma
+ * lineal en la pagina abierta; cuando no caben se abre la siguiente pagina
+ * libre en orden circular. @ref close entrega a la GPU las paginas escritas
+ * desde el cierre anterior con un valor de fence, y @ref retire las libera
+ * cuando la GPU alcanza ese valor. Una pagina en vuelo nunca se vuelve a
+ * escribir, asi que mapearla no espera a la GPU.
+ *
+ * No depende de Windows ni de DirectX: los fences son enteros crecientes que
+ * el llamador asocia a sus consultas de GPU (o a un contador de frames).
+ */
+class
+    UploadRing {
+public:
+    UploadRing() = default;
+    ~UploadRing() = default;
+
+    /**
+     * @brief Prepara el anillo con todas las paginas libres.
+     *
+     * @param pageCount Numero de paginas.
+     * @param pageSize Capacidad de cada pagina, en unidades.
+     */
+    void
+        init(unsigned int pageCount, size_t pageSize);
+
+    /**
+     * @brief Reserva un bloque contiguo.
+     *
+     * @param size Unidades a reservar (mayor que 0 y no mayor que pageSize).
+     * @param alignment Alineacion del inicio del bloque (potencia de dos; 0 o 1 = sin alinear).
+     * @param allocation Recibe la pagina y el desplazamiento.
+     * @return false si no hay una pagina libre donde quepa; el llamador debe
+     *         usar otra via o esperar a @ref retire.
+     */
+    bool
+        allocate(size_t size, size_t alignment, UploadRingAllocation& allocation);
+
+    /**
+     * @brief Entrega a la GPU las paginas escritas desde el ultimo cierre.
+     *
+     * @param fence Valor que la GPU senalara al terminar de leerlas. Debe crecer en cada llamada.
+     */
+    void
+        close(uint64_t fence);
+
+    /**
+     * @brief Libera las paginas cuyo fence ya alcanzo la GPU.
+     *
+     * @param completedFence Ultimo valor de fence completado.
+     */
+    void
+        retire(uint64_t completedFence);
+
+    /**
+     * @brief Paginas escritas desde el ultimo cierre, en el orden en que se abrieron.
+     */
+    const std::vector<unsigned int>&
+        openPages() const { return m_open; }
+
+    /**
+     * @brief Paginas que se pueden abrir sin esperar a la GPU.
+     */
+    unsigned int
+        freePages() const;
+
+    unsigned int
+        pageCount() const { return static_cast<unsigned int>(m_pages.size()); }
+
+    size_t
+        pageSize() const { return m_pageSize; }
+
+    UploadRingStats
+        stats() const { return m_stats; }
+
+private:
+    enum PageState {
+        FREE_PAGE = 0,
+        OPEN_PAGE,
+        IN_FLIGHT_PAGE
+    };
+
+    struct Page {
+        PageState state = FREE_PAGE;
+        size_t used = 0;
+        uint64_t fence = 0;
+    };
+
+    std::vector<Page> m_pages;
+    std::vector<unsigned int> m_open;
+    size_t m_pageSize = 0;
+    unsigned int m_next = 0;  /**< Siguiente pagina candidata en orden circular. */
+    bool m_hasCurrent = false;
+    unsigned int m_current = 0; /**< Pagina abierta donde se sirven las reservas. */
+    UploadRingStats m_stats;
+};
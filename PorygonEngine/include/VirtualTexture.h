@@ -0,0 +1,149 @@
+#pragma once
+#include "Prerequisites.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include "VirtualTextureCache.h"
+#include "VirtualTextureFile.h"
+#include <condition_variable>
+#include <mutex>
+
+class
+    Device;
+
+class
+    DeviceContext;
+
+class
+    UploadManager;
+
+/**
+ * @brief Tamano de la cache fisica y ritmo de carga de una textura virtual.
+ */
+struct
+    VirtualTextureOptions {
+    unsigned int cacheTilesX = 16;      /**< Paginas por fila de la textura de cache fisica. */
+    unsigned int cacheTilesY = 16;      /**< Paginas por columna de la textura de cache fisica. */
+    unsigned int requestsPerFrame = 32; /**< Paginas nuevas que puede pedir cada llamada a feedback. */
+    unsigned int uploadsPerFrame = 16;  /**< Paginas cargadas que puede copiar cada llamada a update. */
+};
+
+/**
+ * @brief Metricas de una textura virtual.
+ */
+struct
+    VirtualTextureStats {
+    VirtualTextureCacheStats cache;   /**< Tabla de paginas y cache fisica. */
+    unsigned int loadsInFlight = 0;   /**< Paginas leyendose en los hilos de trabajo. */
+    unsigned int loadsWaiting = 0;    /**< Paginas leidas esperando a update. */
+    unsigned int pagesUploaded = 0;   /**< Paginas copiadas a la cache fisica. */
+    unsigned int failedLoads = 0;     /**< Paginas que no se pudieron leer. */
+};
+
+/**
+ * @class VirtualTexture
+ * @brief Textura virtual con paginas cargadas bajo demanda desde un archivo ".pvt".
+ *
+ * Se compone de dos texturas que el shader muestrea juntas:
+ *  - @ref m_pageTable: un texel RGBA8 por pagina y nivel (ver
+ *    VirtualTextureCache) que indica donde esta la pagina en la cache fisica.
+ *  - @ref m_physical: la cache fisica, una rejilla de paginas con bordes.
+ *
+ * Cada frame el llamador entrega el feedback leido de la GPU (paginas que se
+ * muestrearon, empaquetadas con VirtualTextureCache::packPage) a
+ * @ref feedback, que decide que paginas faltan y las lee del archivo en el
+ * ThreadPool. @ref update copia a la cache fisica las paginas ya leidas y sube
+ * las regiones modificadas de la tabla de paginas.
+ *
+ * El ultimo nivel se pide en @ref init y no se expulsa nunca, asi que en
+ * cuanto llega la textura siempre tiene datos. Se usa desde el hilo de render;
+ * solo la lectura de paginas ocurre en los hilos del grupo.
+ */
+class
+    VirtualTexture {
+public:
+    explicit VirtualTexture(ThreadPool& pool) : m_pool(pool) {}
+    ~VirtualTexture();
+
+    VirtualTexture(const VirtualTexture&) = delete;
+    VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+    /**
+     * @brief Abre el archivo, crea las texturas y pide el ultimo nivel.
+     *
+     * @param device Dispositivo de DirectX.
+     * @param fileName Archivo ".pvt" (ver VirtualTextureFile::build).
+     * @param options Tamano de la cache fisica y ritmo de carga.
+     * @return HRESULT Codigo de resultado.
+     */
+    HRESULT
+        init(Device& device, const std::string& fileName, const VirtualTextureOptions& options = VirtualTextureOptions());
+
+    /**
+     * @brief Analiza el feedback del frame y pide las paginas que faltan.
+     *
+     * @param entries Paginas empaquetadas (VirtualTextureCache::EMPTY_FEEDBACK = nada).
+     * @param count Numero de entradas.
+     */
+    void
+        feedback(const uint32_t* entries, size_t count);
+
+    /**
+     * @brief Copia las paginas leidas a la cache fisica y actualiza la tabla. Llamar una vez por frame.
+     *
+     * @param deviceContext Contexto de DirectX.
+     * @param uploadManager Opcional: sube a traves de los anillos de staging
+     *        (las copias salen en su siguiente flush).
+     */
+    void
+        update(DeviceContext& deviceContext, UploadManager* uploadManager = nullptr);
+
+    /**
+     * @brief Enlaza la tabla de paginas en startSlot y la cache fisica en startSlot + 1.
+     */
+    void
+        render(DeviceContext& deviceContext, unsigned int startSlot);
+
+    const VirtualTextureLayout&
+        layout() const { return m_file.layout(); }
+
+    VirtualTextureStats
+        stats() const;
+
+    /**
+     * @brief Espera a las lecturas en curso y libera las texturas.
+     */
+    void
+        destroy();
+
+    Texture m_pageTable; /**< Tabla de paginas (RGBA8 con un nivel por nivel virtual). */
+    Texture m_physical;  /**< Cache fisica de paginas. */
+
+private:
+    /**
+     * @brief Pagina leida por un hilo de trabajo.
+     */
+    struct LoadedPage {
+        VirtualPage page;
+        bool ok = false;
+        std::vector<unsigned char> pixels;
+    };
+
+    /**
+     * @brief Lanza la lectura de las paginas en el ThreadPool.
+     */
+    void
+        submitLoads(const std::vector<VirtualPage>& pages);
+
+    ThreadPool& m_pool;
+    VirtualTextureOptions m_options;
+    VirtualTextureFile m_file;
+    VirtualTextureCache m_cache;
+    DXGI_FORMAT m_physicalFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+    std::vector<VirtualPage> m_requests;
+    std::vector<LoadedPage> m_loaded;
+    unsigned int m_loadsInFlight = 0;
+    unsigned int m_pagesUploaded = 0;
+    unsigned int m_failedLoads = 0;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_loadFinished;
+};
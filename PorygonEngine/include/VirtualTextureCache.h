@@ -0,0 +1,244 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Pagina de una textura virtual: nivel de mip y posicion en paginas.
+ */
+struct
+    VirtualPage {
+    unsigned int mip = 0; /**< Nivel de mip. */
+    unsigned int x = 0;   /**< Columna de la pagina en ese nivel. */
+    unsigned int y = 0;   /**< Fila de la pagina en ese nivel. */
+};
+
+/**
+ * @brief Geometria de una textura virtual.
+ */
+struct
+    VirtualTextureLayout {
+    unsigned int width = 0;    /**< Ancho virtual del nivel 0 en texeles. */
+    unsigned int height = 0;   /**< Alto virtual del nivel 0 en texeles. */
+    unsigned int tileSize = 0; /**< Texeles utiles por lado de pagina. */
+    unsigned int border = 0;   /**< Texeles de borde a cada lado (para el filtrado). */
+    unsigned int mipCount = 0; /**< Niveles; el ultimo cabe en una sola pagina. */
+
+    /**
+     * @brief Paginas por fila del nivel.
+     */
+    unsigned int
+        tilesX(unsigned int mip) const;
+
+    /**
+     * @brief Paginas por columna del nivel.
+     */
+    unsigned int
+        tilesY(unsigned int mip) const;
+
+    /**
+     * @brief Lado de una pagina con sus bordes.
+     */
+    unsigned int
+        paddedTileSize() const { return tileSize + 2 * border; }
+
+    /**
+     * @brief Niveles necesarios para que el ultimo quepa en una pagina.
+     */
+    static unsigned int
+        calcMipCount(unsigned int width, unsigned int height, unsigned int tileSize);
+};
+
+/**
+ * @brief Region de un nivel de la tabla de paginas modificada desde @ref VirtualTextureCache::clearDirty.
+ */
+struct
+    VirtualTableRegion {
+    unsigned int x = 0;      /**< Primera columna. */
+    unsigned int y = 0;      /**< Primera fila. */
+    unsigned int width = 0;  /**< Columnas (0 = sin cambios). */
+    unsigned int height = 0; /**< Filas. */
+};
+
+/**
+ * @brief Metricas acumuladas de la cache de paginas.
+ */
+struct
+    VirtualTextureCacheStats {
+    size_t feedbackEntries = 0;   /**< Entradas de feedback analizadas (sin contar las vacias). */
+    size_t uniquePages = 0;       /**< Paginas distintas vistas en el feedback. */
+    unsigned int requested = 0;   /**< Paginas pedidas para cargar. */
+    unsigned int inserted = 0;    /**< Paginas colocadas en la cache fisica. */
+    unsigned int evictions = 0;   /**< Paginas sacadas para hacer sitio. */
+    unsigned int rejected = 0;    /**< Paginas cargadas sin sitio (toda la cache se uso en el frame). */
+    unsigned int resident = 0;    /**< Paginas residentes ahora. */
+    unsigned int pending = 0;     /**< Paginas pedidas que aun no llegan. */
+};
+
+/**
+ * @class VirtualTextureCache
+ * @brief Tabla de paginas, cache fisica LRU y analisis de feedback de una textura virtual.
+ *
+ * La cache fisica es una rejilla de slotsX x slotsY paginas. La tabla de
+ * paginas tiene un texel por pagina y nivel (RGBA8 empaquetado en un
+ * uint32_t: R = columna del slot, G = fila del slot, B = nivel realmente
+ * residente, A = 255 si hay alguno). Una pagina que no esta residente apunta
+ * a su antecesor residente mas cercano, asi que el muestreo siempre encuentra
+ * datos en cuanto llega el ultimo nivel, que nunca se expulsa.
+ *
+ * El feedback es un arreglo de paginas empaquetadas con @ref packPage (por
+ * ejemplo, el contenido de un render target R32_UINT de baja resolucion leido
+ * en CPU). @ref analyzeFeedback marca como usadas las paginas residentes y
+ * sus antecesores, y pide las que faltan: primero los niveles gruesos y, en
+ * cada nivel, las paginas con mas apariciones.
+ *
+ * No depende de Windows ni de DirectX.
+ */
+class
+    VirtualTextureCache {
+public:
+    /**
+     * @brief Entrada de feedback vacia (ninguna pagina en ese pixel).
+     */
+    static const uint32_t EMPTY_FEEDBACK = 0xFFFFFFFFu;
+
+    VirtualTextureCache() = default;
+    ~VirtualTextureCache() = default;
+
+    /**
+     * @brief Empaqueta una pagina: bits 0-11 columna, 12-23 fila, 24-30 nivel.
+     */
+    static uint32_t
+        packPage(const VirtualPage& page) {
+        return (page.x & 0xFFFu) | ((page.y & 0xFFFu) << 12) | ((page.mip & 0x7Fu) << 24);
+    }
+
+    static VirtualPage
+        unpackPage(uint32_t packed) {
+        VirtualPage page;
+        page.x = packed & 0xFFFu;
+        page.y = (packed >> 12) & 0xFFFu;
+        page.mip = (packed >> 24) & 0x7Fu;
+        return page;
+    }
+
+    /**
+     * @brief Prepara la tabla y la cache vacias.
+     *
+     * @param layout Geometria de la textura virtual (hasta 4096 paginas por lado y 127 niveles).
+     * @param slotsX Columnas de la cache fisica (hasta 256).
+     * @param slotsY Filas de la cache fisica (hasta 256).
+     * @return false si la geometria no cabe en el empaquetado de paginas o de la tabla.
+     */
+    bool
+        init(const VirtualTextureLayout& layout, unsigned int slotsX, unsigned int slotsY);
+
+    /**
+     * @brief Analiza un buffer de feedback y decide que paginas pedir.
+     *
+     * @param entries Paginas empaquetadas; las vacias o fuera de rango se ignoran.
+     * @param count Numero de entradas.
+     * @param maxRequests Maximo de paginas nuevas a pedir.
+     * @param requests Recibe las paginas pedidas, en orden de prioridad. Quedan
+     *        pendientes hasta @ref insert o @ref cancel.
+     */
+    void
+        analyzeFeedback(const uint32_t* entries,
+            size_t count,
+            unsigned int maxRequests,
+            std::vector<VirtualPage>& requests);
+
+    /**
+     * @brief Coloca en la cache fisica una pagina ya cargada.
+     *
+     * Usa un slot libre o expulsa la pagina menos usada que no se uso en este
+     * frame; las del ultimo nivel no se expulsan nunca.
+     * @param page Pagina cargada.
+     * @param slot Recibe el slot donde copiar sus texeles.
+     * @return false si no hay slot disponible; la pagina se podra volver a pedir.
+     */
+    bool
+        insert(const VirtualPage& page, unsigned int& slot);
+
+    /**
+     * @brief Quita la pagina de las pendientes (la carga fallo).
+     */
+    void
+        cancel(const VirtualPage& page);
+
+    /**
+     * @brief Avanza el contador de frames usado por el LRU.
+     */
+    void
+        endFrame() { ++m_frame; }
+
+    bool
+        isResident(const VirtualPage& page) const;
+
+    bool
+        isPending(const VirtualPage& page) const;
+
+    /**
+     * @brief Texeles de un nivel de la tabla de paginas, tilesX(mip) por fila.
+     */
+    const uint32_t*
+        pageTable(unsigned int mip) const { return m_table.data() + m_mipOffsets[mip]; }
+
+    /**
+     * @brief Region de un nivel de la tabla modificada desde el ultimo @ref clearDirty.
+     */
+    const VirtualTableRegion&
+        dirtyRegion(unsigned int mip) const { return m_dirty[mip]; }
+
+    void
+        clearDirty();
+
+    /**
+     * @brief Posicion del slot en la rejilla de la cache fisica, en paginas.
+     */
+    void
+        slotPosition(unsigned int slot, unsigned int& x, unsigned int& y) const {
+        x = slot % m_slotsX;
+        y = slot / m_slotsX;
+    }
+
+    const VirtualTextureLayout&
+        layout() const { return m_layout; }
+
+    VirtualTextureCacheStats
+        stats() const;
+
+private:
+    static const uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t page = NO_SLOT;        /**< Indice de la pagina (ver pageIndex), NO_SLOT si esta libre. */
+        unsigned long long lastUsed = 0;
+    };
+
+    /**
+     * @brief Indice plano de la pagina (niveles consecutivos); false si esta fuera de rango.
+     */
+    bool
+        pageIndex(const VirtualPage& page, size_t& index) const;
+
+    /**
+     * @brief Rehace las entradas de la tabla cubiertas por la pagina, en su nivel y los mas finos.
+     */
+    void
+        refreshFootprint(const VirtualPage& page);
+
+    VirtualTextureLayout m_layout;
+    unsigned int m_slotsX = 0;
+    unsigned int m_slotsY = 0;
+    std::vector<size_t> m_mipOffsets;     /**< Inicio de cada nivel en los arreglos planos. */
+    std::vector<uint32_t> m_slotOf;       /**< Slot de cada pagina, NO_SLOT si no esta residente. */
+    std::vector<unsigned char> m_pending; /**< 1 si la pagina esta pedida. */
+    std::vector<uint32_t> m_table;        /**< Tabla de paginas de todos los niveles. */
+    std::vector<VirtualTableRegion> m_dirty;
+    std::vector<Slot> m_slots;
+    std::vector<unsigned int> m_freeSlots;
+    std::vector<uint32_t> m_scratch;      /**< Feedback ordenado del ultimo analisis. */
+    unsigned long long m_frame = 1;
+    VirtualTextureCacheStats m_stats;
+};
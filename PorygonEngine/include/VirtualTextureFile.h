@@ -0,0 +1,89 @@
+#pragma once
+#include "MipGenerator.h"
+#include "TextureCache.h"
+#include "VirtualTextureCache.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class VirtualTextureFile
+ * @brief Archivo en disco de una textura virtual dividida en paginas (".pvt").
+ *
+ * Contiene una cabecera (tamano virtual, lado de pagina, borde, niveles), una
+ * tabla con el offset de cada pagina y las paginas RGBA8 con sus bordes,
+ * alineadas a 16 bytes, nivel tras nivel y fila a fila. Al abrirlo se
+ * proyecta en memoria; @ref readPage copia una pagina y se puede llamar desde
+ * varios hilos a la vez.
+ *
+ * No depende de Windows ni de DirectX.
+ */
+class
+    VirtualTextureFile {
+public:
+    VirtualTextureFile() = default;
+    ~VirtualTextureFile() = default;
+
+    /**
+     * @brief Genera los mips de una imagen, la corta en paginas y escribe el archivo.
+     *
+     * Los bordes repiten los texeles vecinos (o el del borde de la imagen),
+     * de modo que el filtrado bilineal no mezcla paginas ajenas.
+     * @param pixels Texeles RGBA8 del nivel 0.
+     * @param width Ancho de la imagen.
+     * @param height Alto de la imagen.
+     * @param rowPitch Bytes por fila de la imagen.
+     * @param tileSize Texeles utiles por lado de pagina.
+     * @param border Texeles de borde a cada lado.
+     * @param srgb true si el color esta en sRGB (afecta a los mips y al formato en GPU).
+     * @param filter Filtro de reduccion de los mips.
+     * @param path Archivo de salida; se escribe a un temporal y luego se renombra.
+     * @return true si el archivo quedo escrito.
+     */
+    static bool
+        build(const unsigned char* pixels,
+            unsigned int width,
+            unsigned int height,
+            unsigned int rowPitch,
+            unsigned int tileSize,
+            unsigned int border,
+            bool srgb,
+            MipFilter filter,
+            const std::string& path);
+
+    /**
+     * @brief Proyecta el archivo y valida su tabla de paginas.
+     */
+    bool
+        open(const std::string& path);
+
+    void
+        close();
+
+    /**
+     * @brief Copia los texeles RGBA8 de una pagina (paddedTileSize() al cuadrado).
+     * @return false si la pagina no existe o el archivo no esta abierto.
+     */
+    bool
+        readPage(const VirtualPage& page, std::vector<unsigned char>& pixels) const;
+
+    const VirtualTextureLayout&
+        layout() const { return m_layout; }
+
+    bool
+        srgb() const { return m_srgb; }
+
+    /**
+     * @brief Bytes de una pagina con sus bordes.
+     */
+    size_t
+        pageBytes() const {
+        return static_cast<size_t>(m_layout.paddedTileSize()) * m_layout.paddedTileSize() * 4;
+    }
+
+private:
+    MappedFile m_file;
+    VirtualTextureLayout m_layout;
+    bool m_srgb = false;
+    std::vector<size_t> m_mipOffsets; /**< Primera pagina de cada nivel en la tabla. */
+    const unsigned char* m_table = nullptr;
+};
@@ -0,0 +1,176 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    struct Rect {
+        unsigned int x, y, w, h;
+    };
+
+    unsigned int alignUp(unsigned int value, unsigned int alignment) {
+        return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+    }
+
+    bool overlaps(const Rect& a, const Rect& b) {
+        return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+    }
+
+    bool contains(const Rect& outer, const Rect& inner) {
+        return inner.x >= outer.x && inner.y >= outer.y &&
+            inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+    }
+
+    /**
+     * @brief Parte los rectangulos libres que se solapan con el recien ocupado (MaxRects).
+     */
+    void splitFreeRects(std::vector<Rect>& freeRects, const Rect& used) {
+        std::vector<Rect> next;
+        next.reserve(freeRects.size() + 4);
+        for (const Rect& f : freeRects) {
+            if (!overlaps(f, used)) {
+                next.push_back(f);
+                continue;
+            }
+            if (used.x > f.x) {
+                next.push_back({ f.x, f.y, used.x - f.x, f.h });
+            }
+            if (used.x + used.w < f.x + f.w) {
+                next.push_back({ used.x + used.w, f.y, f.x + f.w - (used.x + used.w), f.h });
+            }
+            if (used.y > f.y) {
+                next.push_back({ f.x, f.y, f.w, used.y - f.y });
+            }
+            if (used.y + used.h < f.y + f.h) {
+                next.push_back({ f.x, used.y + used.h, f.w, f.y + f.h - (used.y + used.h) });
+            }
+        }
+
+        // Quitar los rectangulos contenidos en otros
+        freeRects.clear();
+        for (size_t i = 0; i < next.size(); ++i) {
+            bool redundant = false;
+            for (size_t j = 0; j < next.size() && !redundant; ++j) {
+                if (i == j || !contains(next[j], next[i])) continue;
+                // Con rectangulos identicos se conserva solo el primero
+                redundant = !contains(next[i], next[j]) || j < i;
+            }
+            if (!redundant) {
+                freeRects.push_back(next[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Copia una imagen a la pagina y extruye sus bordes sobre el gutter.
+     */
+    void blitWithGutter(const AtlasImage& image, unsigned int gutter, unsigned int x, unsigned int y,
+        ImageLevel& page) {
+        const unsigned int srcPitch = image.rowPitch ? image.rowPitch : image.width * 4;
+        const int g = static_cast<int>(gutter);
+        const int w = static_cast<int>(image.width);
+        const int h = static_cast<int>(image.height);
+        for (int py = -g; py < h + g; ++py) {
+            const int sy = (std::min)((std::max)(py, 0), h - 1);
+            const unsigned char* src = image.pixels + static_cast<size_t>(sy) * srcPitch;
+            unsigned char* dst = &page.pixels[static_cast<size_t>(y + py) * page.rowPitch + static_cast<size_t>(x) * 4];
+            for (int px = -g; px < 0; ++px) {
+                std::memcpy(dst + px * 4, src, 4);
+            }
+            std::memcpy(dst, src, static_cast<size_t>(w) * 4);
+            for (int px = w; px < w + g; ++px) {
+                std::memcpy(dst + px * 4, src + (w - 1) * 4, 4);
+            }
+        }
+    }
+}
+
+bool
+AtlasPacker::build(const std::vector<AtlasImage>& images,
+    const AtlasOptions& options,
+    std::vector<ImageLevel>& pages,
+    std::vector<AtlasRegion>& regions) const {
+    pages.clear();
+    regions.assign(images.size(), AtlasRegion());
+    if (options.pageWidth == 0 || options.pageHeight == 0) {
+        return false;
+    }
+
+    // Las imagenes grandes primero empaquetan mejor
+    std::vector<size_t> order(images.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&images](size_t a, size_t b) {
+        const unsigned int sideA = (std::max)(images[a].width, images[a].height);
+        const unsigned int sideB = (std::max)(images[b].width, images[b].height);
+        if (sideA != sideB) return sideA > sideB;
+        return images[a].width * images[a].height > images[b].width * images[b].height;
+        });
+
+    std::vector<std::vector<Rect>> freeRects;
+    bool allPlaced = true;
+
+    for (size_t index : order) {
+        const AtlasImage& image = images[index];
+        if (!image.pixels || image.width == 0 || image.height == 0) {
+            allPlaced = false;
+            continue;
+        }
+        const unsigned int w = alignUp(image.width + 2 * options.gutter, options.alignment);
+        const unsigned int h = alignUp(image.height + 2 * options.gutter, options.alignment);
+        if (w > options.pageWidth || h > options.pageHeight) {
+            allPlaced = false;
+            continue;
+        }
+
+        // Best short side fit en todas las paginas abiertas
+        size_t bestPage = freeRects.size();
+        Rect best = { 0, 0, w, h };
+        unsigned int bestShort = ~0u, bestLong = ~0u;
+        for (size_t p = 0; p < freeRects.size(); ++p) {
+            for (const Rect& f : freeRects[p]) {
+                if (f.w < w || f.h < h) continue;
+                const unsigned int shortSide = (std::min)(f.w - w, f.h - h);
+                const unsigned int longSide = (std::max)(f.w - w, f.h - h);
+                if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+                    bestShort = shortSide;
+                    bestLong = longSide;
+                    bestPage = p;
+                    best.x = f.x;
+                    best.y = f.y;
+                }
+            }
+        }
+        if (bestPage == freeRects.size()) {
+            freeRects.push_back({ Rect{ 0, 0, options.pageWidth, options.pageHeight } });
+            best.x = 0;
+            best.y = 0;
+        }
+
+        splitFreeRects(freeRects[bestPage], best);
+
+        AtlasRegion& region = regions[index];
+        region.valid = true;
+        region.page = static_cast<unsigned int>(bestPage);
+        region.x = best.x + options.gutter;
+        region.y = best.y + options.gutter;
+        region.width = image.width;
+        region.height = image.height;
+        region.uvScale[0] = static_cast<float>(image.width) / options.pageWidth;
+        region.uvScale[1] = static_cast<float>(image.height) / options.pageHeight;
+        region.uvOffset[0] = static_cast<float>(region.x) / options.pageWidth;
+        region.uvOffset[1] = static_cast<float>(region.y) / options.pageHeight;
+    }
+
+    pages.resize(freeRects.size());
+    for (ImageLevel& page : pages) {
+        page.width = options.pageWidth;
+        page.height = options.pageHeight;
+        page.rowPitch = options.pageWidth * 4;
+        page.pixels.assign(static_cast<size_t>(page.rowPitch) * page.height, 0);
+    }
+    for (size_t i = 0; i < images.size(); ++i) {
+        if (regions[i].valid) {
+            blitWithGutter(images[i], options.gutter, regions[i].x, regions[i].y, pages[regions[i].page]);
+        }
+    }
+    return allPlaced;
+}
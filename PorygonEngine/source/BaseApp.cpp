@@ -165,18 +165,16 @@ BaseApp::init() {
     m_mesh.m_numVertex = m_mesh.m_vertex.size();
     m_mesh.m_numIndex = m_mesh.m_index.size();
 
-    //La creacion del Vertex Buffer
-    // Create vertex buffer
-    hr = m_vertexBuffer.init(m_device, m_mesh, D3D11_BIND_VERTEX_BUFFER);
+    // Vertices e indices van a los buffers compartidos del pool: las mallas
+    // que se anadan despues se dibujan sin volver a enlazar buffers
+    hr = m_geometryPool.init(m_device);
     if (FAILED(hr)) {
-        ERROR("BaseApp", "init", "Failed to initialize VertexBuffer.");
+        ERROR("BaseApp", "init", "Failed to initialize geometry pool.");
         return hr;
     }
-
-    //Creacion del IndexBuffer
-    hr = m_indexBuffer.init(m_device, m_mesh, D3D11_BIND_INDEX_BUFFER);
+    hr = m_geometryPool.add(m_deviceContext, m_mesh, m_meshId);
     if (FAILED(hr)) {
-        ERROR("BaseApp", "init", "Failed to initialize IndexBuffer.");
+        ERROR("BaseApp", "init", "Failed to add mesh to geometry pool.");
         return hr;
     }
 
@@ -184,31 +182,61 @@ BaseApp::init() {
     m_deviceContext.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 
+    // Los buffers que se creen y destruyan en marcha se reciclan por clases de tamano;
+    // debe existir antes que los buffers de constantes, que salen de el
+    m_bufferPool.init(m_device, m_deviceContext);
+
     // Create the constant buffers
-    hr = m_cbNeverChanges.init(m_device, sizeof(CBNeverChanges));
+    // Las constantes van al anillo dinamico si el runtime admite desplazamientos
+    // (Direct3D 11.1); si no, cada buffer es dinamico y se reescribe con DISCARD
+    hr = m_constantRing.init(m_device, m_deviceContext);
+    if (FAILED(hr)) {
+        ERROR("BaseApp", "InitDevice",
+            ("Failed to initialize constant ring. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+
+    hr = m_cbNeverChanges.init(m_device, UPDATE_NEVER, &m_constantRing, &m_bufferPool);
     if (FAILED(hr)) {
         ERROR("BaseApp", "InitDevice",
             ("Failed to initialize NeverChanges Buffer. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
 
-    hr = m_cbChangeOnResize.init(m_device, sizeof(CBChangeOnResize));
+    hr = m_cbChangeOnResize.init(m_device, UPDATE_ON_RESIZE, &m_constantRing, &m_bufferPool);
     if (FAILED(hr)) {
         ERROR("BaseApp", "InitDevice",
             ("Failed to initialize ChangeOnResize Buffer. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
 
-    hr = m_cbChangesEveryFrame.init(m_device, sizeof(CBChangesEveryFrame));
+    hr = m_cbChangesEveryFrame.init(m_device, UPDATE_PER_FRAME, &m_constantRing, &m_bufferPool);
     if (FAILED(hr)) {
         ERROR("BaseApp", "InitDevice",
             ("Failed to initialize ChangesEveryFrame Buffer. HRESULT: " + std::to_string(hr)).c_str());
         return hr;
     }
 
+    // Las texturas registradas en el gestor se mantienen bajo su presupuesto
+    m_textureResidency.init(m_device);
+
+    // Los mips en streaming se suben por staging; las copias salen en render()
+    hr = m_uploadManager.init(m_device);
+    if (FAILED(hr)) {
+        ERROR("BaseApp", "InitDevice",
+            ("Failed to initialize upload manager. HRESULT: " + std::to_string(hr)).c_str());
+        return hr;
+    }
+    m_textureStreamer.setUploadManager(&m_uploadManager);
+    m_geometryPool.setUploadManager(&m_uploadManager);
+
     // Load the Texture
     //hr = m_textureCube.init(m_device, "seafloor", ExtensionType::DDS);
-    hr = m_textureCube.init(m_device, "Assets/UltraTTexture", ExtensionType::JPG);
+    // Los mips pequenos quedan residentes ya; el detalle llega en update()
+    TextureStreamingOptions textureOptions;
+    textureOptions.import.cacheDirectory = "Cache/Textures";
+    hr = m_textureStreamer.request(m_device, m_deviceContext, m_textureCube,
+        "Assets/UltraTTexture", ExtensionType::JPG, textureOptions);
     if (FAILED(hr)) {
         ERROR("Main", "InitDevice",
             ("Failed to initialize texture Cube. HRESULT: " + std::to_string(hr)).c_str());
@@ -232,16 +260,17 @@ BaseApp::init() {
     m_View = XMMatrixLookAtLH(Eye, At, Up);
 
 
-    // Initialize the projection matrix
+    // La vista no cambia; la proyeccion se calcula en update() al cambiar el tamano
     cbNeverChanges.mView = XMMatrixTranspose(m_View);
-    m_Projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, m_window.m_width / (FLOAT)m_window.m_height, 0.01f, 100.0f);
-    cbChangesOnResize.mProjection = XMMatrixTranspose(m_Projection);
+    m_cbNeverChanges.set(cbNeverChanges);
 
     return S_OK;
 }
 
 void
 BaseApp::update(float deltaTime) {
+    // Subir los mips de texturas en streaming
+    m_textureStreamer.update(m_device, m_deviceContext);
 
     // Update our time
     static float t = 0.0f;
@@ -258,12 +287,14 @@ BaseApp::update(float deltaTime) {
         t = (dwTimeCur - dwTimeStart) / 1000.0f;
     }
 
-    // Actualizar la matriz de proyecci�n y vista
-    cbNeverChanges.mView = XMMatrixTranspose(m_View);
-    m_cbNeverChanges.update(m_deviceContext, nullptr, 0, nullptr, &cbNeverChanges, 0, 0);
-    m_Projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, m_window.m_width / (FLOAT)m_window.m_height, 0.01f, 100.0f);
-    cbChangesOnResize.mProjection = XMMatrixTranspose(m_Projection);
-    m_cbChangeOnResize.update(m_deviceContext, nullptr, 0, nullptr, &cbChangesOnResize, 0, 0);
+    // Actualizar la matriz de proyecci�n solo si cambio el tamano de la ventana
+    if (m_window.m_width != m_projectionWidth || m_window.m_height != m_projectionHeight) {
+        m_projectionWidth = m_window.m_width;
+        m_projectionHeight = m_window.m_height;
+        m_Projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, m_window.m_width / (FLOAT)m_window.m_height, 0.01f, 100.0f);
+        cbChangesOnResize.mProjection = XMMatrixTranspose(m_Projection);
+        m_cbChangeOnResize.set(cbChangesOnResize);
+    }
 
     // Modify the color
     //m_vMeshColor.x = (sinf(t * 1.0f) + 1.0f) * 0.5f;
@@ -301,11 +332,22 @@ BaseApp::update(float deltaTime) {
 
     cb.mWorld = XMMatrixTranspose(m_World);
     cb.vMeshColor = m_vMeshColor;
-    m_cbChangesEveryFrame.update(m_deviceContext, nullptr, 0, nullptr, &cb, 0, 0);
+    m_cbChangesEveryFrame.set(cb);
+
+    // Solo se suben los buffers cuyo contenido cambio (ver m_constantStats).
+    // El anillo solo da la vuelta aqui, antes de comprobar si alguno sigue valido
+    m_constantRing.beginFrame();
+    m_constantStats.reset();
+    m_cbNeverChanges.upload(m_deviceContext, m_constantStats);
+    m_cbChangeOnResize.upload(m_deviceContext, m_constantStats);
+    m_cbChangesEveryFrame.upload(m_deviceContext, m_constantStats);
 }
 
 void
 BaseApp::render() {
+    // Copiar a la GPU lo subido en update() antes de dibujar
+    m_uploadManager.flush(m_deviceContext);
+    m_bufferPool.beginFrame();
 
     // Set Render Target View
     float ClearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
@@ -326,24 +368,25 @@ BaseApp::render() {
 
     // Render the cube
    // Asignar buffers Vertex e Index
-    m_vertexBuffer.render(m_deviceContext, 0, 1);
-    m_indexBuffer.render(m_deviceContext, 0, 1, false, DXGI_FORMAT_R32_UINT);
+    m_geometryPool.bind(m_deviceContext);
 
     // Asignar buffers constantes
-    m_cbNeverChanges.render(m_deviceContext, 0, 1);
-    m_cbChangeOnResize.render(m_deviceContext, 1, 1);
-    m_cbChangesEveryFrame.render(m_deviceContext, 2, 1);
-    m_cbChangesEveryFrame.render(m_deviceContext, 2, 1, true);
+    m_cbNeverChanges.render(m_deviceContext, 0);
+    m_cbChangeOnResize.render(m_deviceContext, 1);
+    m_cbChangesEveryFrame.render(m_deviceContext, 2, true);
 
     // Asignar textura y sampler
     m_textureCube.render(m_deviceContext, 0, 1);
     m_samplerState.render(m_deviceContext, 0, 1);
-    m_deviceContext.DrawIndexed(m_mesh.m_numIndex, 0, 0);
+    m_geometryPool.draw(m_deviceContext, m_meshId);
 
     //
     // Present our back buffer to our front buffer
     //
     m_swapChain.present();
+
+    // Expulsiones y recargas del frame en m_textureResidency.frameStats()
+    m_textureResidency.endFrame(m_deviceContext);
 }
 
 void
@@ -351,13 +394,16 @@ BaseApp::destroy() {
     if (m_deviceContext.m_deviceContext) m_deviceContext.m_deviceContext->ClearState();
 
     m_samplerState.destroy();
+    m_textureStreamer.destroy();
+    m_uploadManager.destroy();
     m_textureCube.destroy();
 
+    m_constantRing.destroy();
     m_cbNeverChanges.destroy();
     m_cbChangeOnResize.destroy();
     m_cbChangesEveryFrame.destroy();
-    m_vertexBuffer.destroy();
-    m_indexBuffer.destroy();
+    m_geometryPool.destroy();
+    m_bufferPool.destroy();
     m_shaderProgram.destroy();
     m_depthStencil.destroy();
     m_depthStencilView.destroy();
@@ -0,0 +1,782 @@
+#include "BlockCompressor.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace {
+    const float kHugeError = 1.0e30f;
+    const int kBC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    /**
+     * @brief Texeles de un bloque en float (0..255) y mascara de texeles a codificar.
+     */
+    struct BlockPixels {
+        float px[16][4];
+        bool active[16];
+    };
+
+    /**
+     * @brief Paleta en formato SoA (un arreglo por canal) para la busqueda SIMD.
+     * Las entradas sin usar se rellenan con un valor enorme para que nunca ganen.
+     */
+    struct Palette {
+        float soa[4][16];
+        int size = 0;
+
+        void clear() {
+            for (int c = 0; c < 4; ++c) {
+                for (int i = 0; i < 16; ++i) soa[c][i] = 1.0e9f;
+            }
+            size = 0;
+        }
+
+        void set(int i, float r, float g, float b, float a) {
+            soa[0][i] = r; soa[1][i] = g; soa[2][i] = b; soa[3][i] = a;
+            size = (std::max)(size, i + 1);
+        }
+    };
+
+    // ------------------------------------------------------------------------------
+    // Escritura / lectura de bits (LSB primero, como en la especificacion de BC)
+    // ------------------------------------------------------------------------------
+    struct BitWriter {
+        unsigned char* out;
+        unsigned int pos = 0;
+
+        void write(unsigned int value, unsigned int bits) {
+            for (unsigned int i = 0; i < bits; ++i, ++pos) {
+                if ((value >> i) & 1u) out[pos >> 3] |= static_cast<unsigned char>(1u << (pos & 7));
+            }
+        }
+    };
+
+    struct BitReader {
+        const unsigned char* in;
+        unsigned int pos = 0;
+
+        unsigned int read(unsigned int bits) {
+            unsigned int value = 0;
+            for (unsigned int i = 0; i < bits; ++i, ++pos) {
+                value |= ((in[pos >> 3] >> (pos & 7)) & 1u) << i;
+            }
+            return value;
+        }
+    };
+
+    // ------------------------------------------------------------------------------
+    // Busqueda de indices: distancia ponderada de cada texel a cada entrada
+    // ------------------------------------------------------------------------------
+    float findIndices(const BlockPixels& block, const Palette& palette, const float weights[4],
+        unsigned char indices[16]) {
+        float total = 0.0f;
+        for (int p = 0; p < 16; ++p) {
+            if (!block.active[p]) continue;
+            const float* x = block.px[p];
+            float dist[16] = {};
+#if PORYGON_SSE2
+            const __m128 xr = _mm_set1_ps(x[0]), xg = _mm_set1_ps(x[1]);
+            const __m128 xb = _mm_set1_ps(x[2]), xa = _mm_set1_ps(x[3]);
+            const __m128 wr = _mm_set1_ps(weights[0]), wg = _mm_set1_ps(weights[1]);
+            const __m128 wb = _mm_set1_ps(weights[2]), wa = _mm_set1_ps(weights[3]);
+            for (int base = 0; base < palette.size; base += 4) {
+                const __m128 dr = _mm_sub_ps(_mm_loadu_ps(&palette.soa[0][base]), xr);
+                const __m128 dg = _mm_sub_ps(_mm_loadu_ps(&palette.soa[1][base]), xg);
+                const __m128 db = _mm_sub_ps(_mm_loadu_ps(&palette.soa[2][base]), xb);
+                const __m128 da = _mm_sub_ps(_mm_loadu_ps(&palette.soa[3][base]), xa);
+                __m128 d = _mm_mul_ps(wr, _mm_mul_ps(dr, dr));
+                d = _mm_add_ps(d, _mm_mul_ps(wg, _mm_mul_ps(dg, dg)));
+                d = _mm_add_ps(d, _mm_mul_ps(wb, _mm_mul_ps(db, db)));
+                d = _mm_add_ps(d, _mm_mul_ps(wa, _mm_mul_ps(da, da)));
+                _mm_storeu_ps(&dist[base], d);
+            }
+#else
+            for (int i = 0; i < palette.size; ++i) {
+                float d = 0.0f;
+                for (int c = 0; c < 4; ++c) {
+                    const float diff = palette.soa[c][i] - x[c];
+                    d += weights[c] * diff * diff;
+                }
+                dist[i] = d;
+            }
+#endif
+            int best = 0;
+            for (int i = 1; i < palette.size; ++i) {
+                if (dist[i] < dist[best]) best = i;
+            }
+            indices[p] = static_cast<unsigned char>(best);
+            total += dist[best];
+        }
+        return total;
+    }
+
+    // ------------------------------------------------------------------------------
+    // Eleccion de extremos
+    // ------------------------------------------------------------------------------
+    void boundingBox(const BlockPixels& block, int channels, float e0[4], float e1[4]) {
+        for (int c = 0; c < 4; ++c) { e0[c] = 255.0f; e1[c] = 0.0f; }
+        for (int p = 0; p < 16; ++p) {
+            if (!block.active[p]) continue;
+            for (int c = 0; c < channels; ++c) {
+                e0[c] = (std::min)(e0[c], block.px[p][c]);
+                e1[c] = (std::max)(e1[c], block.px[p][c]);
+            }
+        }
+        // Recortar 1/16 del rango hacia dentro reduce el error medio
+        for (int c = 0; c < channels; ++c) {
+            const float inset = (e1[c] - e0[c]) / 16.0f;
+            e0[c] += inset;
+            e1[c] -= inset;
+        }
+    }
+
+    void principalAxis(const BlockPixels& block, int channels, float e0[4], float e1[4]) {
+        float mean[4] = { 0, 0, 0, 0 };
+        int count = 0;
+        for (int p = 0; p < 16; ++p) {
+            if (!block.active[p]) continue;
+            for (int c = 0; c < channels; ++c) mean[c] += block.px[p][c];
+            ++count;
+        }
+        for (int c = 0; c < channels; ++c) mean[c] /= static_cast<float>((std::max)(count, 1));
+
+        float cov[4][4] = {};
+        for (int p = 0; p < 16; ++p) {
+            if (!block.active[p]) continue;
+            for (int i = 0; i < channels; ++i) {
+                for (int j = 0; j < channels; ++j) {
+                    cov[i][j] += (block.px[p][i] - mean[i]) * (block.px[p][j] - mean[j]);
+                }
+            }
+        }
+
+        // Iteracion de potencia para el autovector dominante
+        float axis[4] = { 1, 1, 1, 1 };
+        for (int iter = 0; iter < 8; ++iter) {
+            float next[4] = { 0, 0, 0, 0 };
+            for (int i = 0; i < channels; ++i) {
+                for (int j = 0; j < channels; ++j) next[i] += cov[i][j] * axis[j];
+            }
+            float len = 0.0f;
+            for (int i = 0; i < channels; ++i) len += next[i] * next[i];
+            len = std::sqrt(len);
+            if (len < 1.0e-6f) break;
+            for (int i = 0; i < channels; ++i) axis[i] = next[i] / len;
+        }
+
+        float tMin = 0.0f, tMax = 0.0f;
+        for (int p = 0; p < 16; ++p) {
+            if (!block.active[p]) continue;
+            float t = 0.0f;
+            for (int c = 0; c < channels; ++c) t += (block.px[p][c] - mean[c]) * axis[c];
+            tMin = (std::min)(tMin, t);
+            tMax = (std::max)(tMax, t);
+        }
+        for (int c = 0; c < 4; ++c) {
+            e0[c] = c < channels ? (std::min)((std::max)(mean[c] + tMin * axis[c], 0.0f), 255.0f) : 255.0f;
+            e1[c] = c < channels ? (std::min)((std::max)(mean[c] + tMax * axis[c], 0.0f), 255.0f) : 255.0f;
+        }
+    }
+
+    /**
+     * @brief Minimos cuadrados: extremos optimos para los indices actuales.
+     * @param t Posicion (0..1) entre e0 y e1 asociada a cada indice.
+     */
+    bool refineEndpoints(const BlockPixels& block, int channels, const unsigned char indices[16],
+        const float* t, float e0[4], float e1[4]) {
+        float a = 0, b = 0, c = 0;
+        float x0[4] = { 0, 0, 0, 0 }, x1[4] = { 0, 0, 0, 0 };
+        for (int p = 0; p < 16; ++p) {
+            if (!block.active[p]) continue;
+            const float w1 = t[indices[p]];
+            const float w0 = 1.0f - w1;
+            a += w0 * w0;
+            b += w0 * w1;
+            c += w1 * w1;
+            for (int ch = 0; ch < channels; ++ch) {
+                x0[ch] += w0 * block.px[p][ch];
+                x1[ch] += w1 * block.px[p][ch];
+            }
+        }
+        const float det = a * c - b * b;
+        if (std::fabs(det) < 1.0e-6f) return false;
+        for (int ch = 0; ch < channels; ++ch) {
+            e0[ch] = (std::min)((std::max)((c * x0[ch] - b * x1[ch]) / det, 0.0f), 255.0f);
+            e1[ch] = (std::min)((std::max)((a * x1[ch] - b * x0[ch]) / det, 0.0f), 255.0f);
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------------
+    // BC1 (y la parte de color de BC3)
+    // ------------------------------------------------------------------------------
+    unsigned int expand5(unsigned int v) { return (v << 3) | (v >> 2); }
+    unsigned int expand6(unsigned int v) { return (v << 2) | (v >> 4); }
+
+    void bc1Palette(unsigned int c0, unsigned int c1, bool forceFourColor, unsigned char pal[4][4]) {
+        const unsigned int r0 = expand5((c0 >> 11) & 31), g0 = expand6((c0 >> 5) & 63), b0 = expand5(c0 & 31);
+        const unsigned int r1 = expand5((c1 >> 11) & 31), g1 = expand6((c1 >> 5) & 63), b1 = expand5(c1 & 31);
+        const unsigned int e[2][3] = { { r0, g0, b0 }, { r1, g1, b1 } };
+        for (int ch = 0; ch < 3; ++ch) {
+            pal[0][ch] = static_cast<unsigned char>(e[0][ch]);
+            pal[1][ch] = static_cast<unsigned char>(e[1][ch]);
+            if (forceFourColor || c0 > c1) {
+                pal[2][ch] = static_cast<unsigned char>((2 * e[0][ch] + e[1][ch]) / 3);
+                pal[3][ch] = static_cast<unsigned char>((e[0][ch] + 2 * e[1][ch]) / 3);
+            }
+            else {
+                pal[2][ch] = static_cast<unsigned char>((e[0][ch] + e[1][ch]) / 2);
+                pal[3][ch] = 0;
+            }
+        }
+        pal[0][3] = pal[1][3] = pal[2][3] = 255;
+        pal[3][3] = (forceFourColor || c0 > c1) ? 255 : 0;
+    }
+
+    unsigned int packColor565(const float color[4]) {
+        const unsigned int r = static_cast<unsigned int>(color[0] * 31.0f / 255.0f + 0.5f);
+        const unsigned int g = static_cast<unsigned int>(color[1] * 63.0f / 255.0f + 0.5f);
+        const unsigned int b = static_cast<unsigned int>(color[2] * 31.0f / 255.0f + 0.5f);
+        return (r << 11) | (g << 5) | b;
+    }
+
+    /**
+     * @brief Evalua un par de extremos BC1 ya ordenado tal como se guardaria.
+     */
+    float evaluateBC1(const BlockPixels& block, unsigned int c0, unsigned int c1, bool forceFourColor,
+        unsigned char indices[16]) {
+        static const float weights[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+        unsigned char pal[4][4];
+        bc1Palette(c0, c1, forceFourColor, pal);
+
+        Palette palette;
+        palette.clear();
+        const bool threeColor = !forceFourColor && c0 <= c1;
+        const int entries = threeColor ? 3 : 4; // El negro transparente no se usa para texeles opacos
+        for (int i = 0; i < entries; ++i) {
+            palette.set(i, pal[i][0], pal[i][1], pal[i][2], 0.0f);
+        }
+        for (int i = entries; i < 4; ++i) palette.soa[0][i] = 1.0e9f;
+        palette.size = 4;
+        return findIndices(block, palette, weights, indices);
+    }
+
+    /**
+     * @brief Ordena los extremos segun el modo: 4 colores -> c0 > c1, 3 colores -> c0 <= c1.
+     */
+    void orderBC1(unsigned int& c0, unsigned int& c1, bool threeColor) {
+        if (threeColor ? (c0 > c1) : (c0 < c1)) std::swap(c0, c1);
+    }
+
+    void encodeColorBlock(const unsigned char* rgba, CompressionQuality quality, bool forceFourColor,
+        unsigned char* out) {
+        BlockPixels block;
+        bool anyTransparent = false;
+        int activeCount = 0;
+        for (int p = 0; p < 16; ++p) {
+            for (int c = 0; c < 4; ++c) block.px[p][c] = rgba[p * 4 + c];
+            block.active[p] = forceFourColor || rgba[p * 4 + 3] >= 128;
+            anyTransparent |= !block.active[p];
+            activeCount += block.active[p] ? 1 : 0;
+        }
+
+        std::memset(out, 0, 8);
+        if (activeCount == 0) {
+            // Bloque totalmente transparente: modo de 3 colores con todos los indices en 3
+            out[4] = out[5] = out[6] = out[7] = 0xFF;
+            return;
+        }
+
+        const bool threeColor = anyTransparent;
+        const float tFour[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        const float tThree[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+        float e0[4], e1[4];
+        if (quality == QUALITY_FAST) boundingBox(block, 3, e0, e1);
+        else principalAxis(block, 3, e0, e1);
+
+        unsigned int best0 = packColor565(e0), best1 = packColor565(e1);
+        orderBC1(best0, best1, threeColor);
+        unsigned char bestIndices[16] = {};
+        float bestError = evaluateBC1(block, best0, best1, forceFourColor, bestIndices);
+
+        // Refinamiento por minimos cuadrados
+        const int refinePasses = quality == QUALITY_FAST ? 0 : (quality == QUALITY_NORMAL ? 1 : 2);
+        for (int pass = 0; pass < refinePasses; ++pass) {
+            // Los indices se refieren a (c0, c1) tal como estan guardados
+            const bool bestThree = !forceFourColor && best0 <= best1;
+            if (!refineEndpoints(block, 3, bestIndices, bestThree ? tThree : tFour, e0, e1)) break;
+            unsigned int c0 = packColor565(e0), c1 = packColor565(e1);
+            orderBC1(c0, c1, threeColor);
+            unsigned char indices[16] = {};
+            const float error = evaluateBC1(block, c0, c1, forceFourColor, indices);
+            if (error >= bestError) break;
+            bestError = error;
+            best0 = c0;
+            best1 = c1;
+            std::memcpy(bestIndices, indices, 16);
+        }
+
+        // Busqueda local: mover cada componente 5:6:5 de cada extremo un paso
+        if (quality == QUALITY_HIGH) {
+            static const unsigned int shifts[3] = { 11, 5, 0 };
+            static const unsigned int masks[3] = { 31, 63, 31 };
+            for (int round = 0; round < 4 && bestError > 0.0f; ++round) {
+                bool improved = false;
+                for (int endpoint = 0; endpoint < 2; ++endpoint) {
+                    for (int ch = 0; ch < 3; ++ch) {
+                        for (int delta = -1; delta <= 1; delta += 2) {
+                            unsigned int c[2] = { best0, best1 };
+                            const int v = static_cast<int>((c[endpoint] >> shifts[ch]) & masks[ch]) + delta;
+                            if (v < 0 || v > static_cast<int>(masks[ch])) continue;
+                            c[endpoint] = (c[endpoint] & ~(masks[ch] << shifts[ch])) | (static_cast<unsigned int>(v) << shifts[ch]);
+                            orderBC1(c[0], c[1], threeColor);
+                            unsigned char indices[16] = {};
+                            const float error = evaluateBC1(block, c[0], c[1], forceFourColor, indices);
+                            if (error < bestError) {
+                                bestError = error;
+                                best0 = c[0];
+                                best1 = c[1];
+                                std::memcpy(bestIndices, indices, 16);
+                                improved = true;
+                            }
+                        }
+                    }
+                }
+                if (!improved) break;
+            }
+        }
+
+        out[0] = static_cast<unsigned char>(best0 & 0xFF);
+        out[1] = static_cast<unsigned char>(best0 >> 8);
+        out[2] = static_cast<unsigned char>(best1 & 0xFF);
+        out[3] = static_cast<unsigned char>(best1 >> 8);
+        unsigned int bits = 0;
+        for (int p = 0; p < 16; ++p) {
+            const unsigned int index = block.active[p] ? bestIndices[p] : 3u;
+            bits |= index << (p * 2);
+        }
+        out[4] = static_cast<unsigned char>(bits & 0xFF);
+        out[5] = static_cast<unsigned char>((bits >> 8) & 0xFF);
+        out[6] = static_cast<unsigned char>((bits >> 16) & 0xFF);
+        out[7] = static_cast<unsigned char>(bits >> 24);
+    }
+
+    // ------------------------------------------------------------------------------
+    // BC4 (canal unico; tambien alfa de BC3 y cada canal de BC5)
+    // ------------------------------------------------------------------------------
+    void bc4Palette(unsigned int e0, unsigned int e1, unsigned char pal[8]) {
+        pal[0] = static_cast<unsigned char>(e0);
+        pal[1] = static_cast<unsigned char>(e1);
+        if (e0 > e1) {
+            for (unsigned int i = 1; i < 7; ++i) {
+                pal[i + 1] = static_cast<unsigned char>(((7 - i) * e0 + i * e1 + 3) / 7);
+            }
+        }
+        else {
+            for (unsigned int i = 1; i < 5; ++i) {
+                pal[i + 1] = static_cast<unsigned char>(((5 - i) * e0 + i * e1 + 2) / 5);
+            }
+            pal[6] = 0;
+            pal[7] = 255;
+        }
+    }
+
+    float evaluateBC4(const BlockPixels& block, unsigned int e0, unsigned int e1, unsigned char indices[16]) {
+        static const float weights[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+        unsigned char pal[8];
+        bc4Palette(e0, e1, pal);
+        Palette palette;
+        palette.clear();
+        for (int i = 0; i < 8; ++i) palette.set(i, pal[i], 0.0f, 0.0f, 0.0f);
+        return findIndices(block, palette, weights, indices);
+    }
+
+    void encodeBC4(const unsigned char* rgba, int channel, CompressionQuality quality, unsigned char* out) {
+        BlockPixels block;
+        float minValue = 255.0f, maxValue = 0.0f;
+        float minInner = 255.0f, maxInner = 0.0f; // Excluyendo 0 y 255 (modo de 6 valores)
+        for (int p = 0; p < 16; ++p) {
+            const float v = rgba[p * 4 + channel];
+            block.px[p][0] = v;
+            block.px[p][1] = block.px[p][2] = block.px[p][3] = 0.0f;
+            block.active[p] = true;
+            minValue = (std::min)(minValue, v);
+            maxValue = (std::max)(maxValue, v);
+            if (v > 0.0f && v < 255.0f) {
+                minInner = (std::min)(minInner, v);
+                maxInner = (std::max)(maxInner, v);
+            }
+        }
+
+        // Modo de 8 valores: e0 > e1
+        unsigned int best0 = static_cast<unsigned int>(maxValue), best1 = static_cast<unsigned int>(minValue);
+        unsigned char bestIndices[16] = {};
+        float bestError = evaluateBC4(block, best0, best1, bestIndices);
+
+        if (quality != QUALITY_FAST && best0 > best1) {
+            const float t8[8] = { 0.0f, 1.0f, 1.0f / 7, 2.0f / 7, 3.0f / 7, 4.0f / 7, 5.0f / 7, 6.0f / 7 };
+            const int passes = quality == QUALITY_NORMAL ? 1 : 2;
+            for (int pass = 0; pass < passes; ++pass) {
+                float e0[4] = {}, e1[4] = {};
+                if (!refineEndpoints(block, 1, bestIndices, t8, e0, e1)) break;
+                unsigned int c0 = static_cast<unsigned int>(e0[0] + 0.5f), c1 = static_cast<unsigned int>(e1[0] + 0.5f);
+                if (c0 < c1) std::swap(c0, c1);
+                if (c0 == c1) break;
+                unsigned char indices[16];
+                const float error = evaluateBC4(block, c0, c1, indices);
+                if (error >= bestError) break;
+                bestError = error;
+                best0 = c0;
+                best1 = c1;
+                std::memcpy(bestIndices, indices, 16);
+            }
+        }
+
+        // Modo de 6 valores (0 y 255 explicitos): util cuando hay extremos puros
+        if (quality == QUALITY_HIGH && minInner <= maxInner) {
+            const unsigned int c0 = static_cast<unsigned int>(minInner), c1 = static_cast<unsigned int>(maxInner);
+            unsigned char indices[16];
+            const float error = evaluateBC4(block, c0, c1, indices);
+            if (error < bestError) {
+                bestError = error;
+                best0 = c0;
+                best1 = c1;
+                std::memcpy(bestIndices, indices, 16);
+            }
+        }
+
+        std::memset(out, 0, 8);
+        out[0] = static_cast<unsigned char>(best0);
+        out[1] = static_cast<unsigned char>(best1);
+        BitWriter writer{ out, 16 };
+        for (int p = 0; p < 16; ++p) writer.write(bestIndices[p], 3);
+    }
+
+    // ------------------------------------------------------------------------------
+    // BC7 modo 6: RGBA 7.7.7.7 + p-bit por extremo, indices de 4 bits
+    // ------------------------------------------------------------------------------
+    struct BC7Endpoints {
+        unsigned int q[2][4]; // Componentes de 7 bits
+        unsigned int p[2];    // p-bits
+    };
+
+    void quantizeBC7(const float e[4], unsigned int pbit, unsigned int q[4]) {
+        for (int c = 0; c < 4; ++c) {
+            const int v = static_cast<int>((e[c] - static_cast<float>(pbit)) / 2.0f + 0.5f);
+            q[c] = static_cast<unsigned int>((std::min)((std::max)(v, 0), 127));
+        }
+    }
+
+    float quantizationError(const float e[4], const unsigned int q[4], unsigned int pbit) {
+        float error = 0.0f;
+        for (int c = 0; c < 4; ++c) {
+            const float d = static_cast<float>((q[c] << 1) | pbit) - e[c];
+            error += d * d;
+        }
+        return error;
+    }
+
+    float evaluateBC7(const BlockPixels& block, const BC7Endpoints& ep, unsigned char indices[16]) {
+        static const float weights[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        Palette palette;
+        palette.clear();
+        for (int i = 0; i < 16; ++i) {
+            float v[4];
+            for (int c = 0; c < 4; ++c) {
+                const int a = static_cast<int>((ep.q[0][c] << 1) | ep.p[0]);
+                const int b = static_cast<int>((ep.q[1][c] << 1) | ep.p[1]);
+                v[c] = static_cast<float>(((64 - kBC7Weights[i]) * a + kBC7Weights[i] * b + 32) >> 6);
+            }
+            palette.set(i, v[0], v[1], v[2], v[3]);
+        }
+        return findIndices(block, palette, weights, indices);
+    }
+
+    void encodeBC7(const unsigned char* rgba, CompressionQuality quality, unsigned char* out) {
+        BlockPixels block;
+        for (int p = 0; p < 16; ++p) {
+            for (int c = 0; c < 4; ++c) block.px[p][c] = rgba[p * 4 + c];
+            block.active[p] = true;
+        }
+
+        float e0[4], e1[4];
+        if (quality == QUALITY_FAST) boundingBox(block, 4, e0, e1);
+        else principalAxis(block, 4, e0, e1);
+
+        // Cuantizar con p-bits: alta calidad prueba las cuatro combinaciones completas
+        auto quantizeBest = [&](const float a[4], const float b[4], BC7Endpoints& ep,
+            unsigned char indices[16]) -> float {
+                float best = kHugeError;
+                for (unsigned int p0 = 0; p0 < 2; ++p0) {
+                    for (unsigned int p1 = 0; p1 < 2; ++p1) {
+                        BC7Endpoints candidate;
+                        candidate.p[0] = p0;
+                        candidate.p[1] = p1;
+                        quantizeBC7(a, p0, candidate.q[0]);
+                        quantizeBC7(b, p1, candidate.q[1]);
+                        if (quality != QUALITY_HIGH) {
+                            // Rapido: elegir cada p-bit solo por error de cuantizacion
+                            BC7Endpoints alt = candidate;
+                            alt.p[0] = 1 - p0;
+                            quantizeBC7(a, alt.p[0], alt.q[0]);
+                            if (quantizationError(a, alt.q[0], alt.p[0]) < quantizationError(a, candidate.q[0], p0)) continue;
+                            alt = candidate;
+                            alt.p[1] = 1 - p1;
+                            quantizeBC7(b, alt.p[1], alt.q[1]);
+                            if (quantizationError(b, alt.q[1], alt.p[1]) < quantizationError(b, candidate.q[1], p1)) continue;
+                        }
+                        unsigned char candidateIndices[16];
+                        const float error = evaluateBC7(block, candidate, candidateIndices);
+                        if (error < best) {
+                            best = error;
+                            ep = candidate;
+                            std::memcpy(indices, candidateIndices, 16);
+                        }
+                    }
+                }
+                return best;
+            };
+
+        BC7Endpoints best;
+        unsigned char bestIndices[16] = {};
+        float bestError = quantizeBest(e0, e1, best, bestIndices);
+
+        float t16[16];
+        for (int i = 0; i < 16; ++i) t16[i] = kBC7Weights[i] / 64.0f;
+        const int refinePasses = quality == QUALITY_FAST ? 0 : (quality == QUALITY_NORMAL ? 1 : 2);
+        for (int pass = 0; pass < refinePasses && bestError > 0.0f; ++pass) {
+            if (!refineEndpoints(block, 4, bestIndices, t16, e0, e1)) break;
+            BC7Endpoints candidate;
+            unsigned char indices[16];
+            const float error = quantizeBest(e0, e1, candidate, indices);
+            if (error >= bestError) break;
+            bestError = error;
+            best = candidate;
+            std::memcpy(bestIndices, indices, 16);
+        }
+
+        if (quality == QUALITY_HIGH) {
+            for (int round = 0; round < 4 && bestError > 0.0f; ++round) {
+                bool improved = false;
+                for (int endpoint = 0; endpoint < 2; ++endpoint) {
+                    for (int c = 0; c < 4; ++c) {
+                        for (int delta = -1; delta <= 1; delta += 2) {
+                            BC7Endpoints candidate = best;
+                            const int v = static_cast<int>(candidate.q[endpoint][c]) + delta;
+                            if (v < 0 || v > 127) continue;
+                            candidate.q[endpoint][c] = static_cast<unsigned int>(v);
+                            unsigned char indices[16];
+                            const float error = evaluateBC7(block, candidate, indices);
+                            if (error < bestError) {
+                                bestError = error;
+                                best = candidate;
+                                std::memcpy(bestIndices, indices, 16);
+                                improved = true;
+                            }
+                        }
+                    }
+                }
+                if (!improved) break;
+            }
+        }
+
+        // El indice ancla (texel 0) guarda solo 3 bits: su bit alto debe ser 0
+        if (bestIndices[0] & 8) {
+            std::swap(best.q[0], best.q[1]);
+            std::swap(best.p[0], best.p[1]);
+            for (int p = 0; p < 16; ++p) bestIndices[p] = static_cast<unsigned char>(15 - bestIndices[p]);
+        }
+
+        std::memset(out, 0, 16);
+        BitWriter writer{ out, 0 };
+        writer.write(1u << 6, 7); // Modo 6
+        for (int c = 0; c < 4; ++c) {
+            writer.write(best.q[0][c], 7);
+            writer.write(best.q[1][c], 7);
+        }
+        writer.write(best.p[0], 1);
+        writer.write(best.p[1], 1);
+        for (int p = 0; p < 16; ++p) writer.write(bestIndices[p], p == 0 ? 3 : 4);
+    }
+
+    // ------------------------------------------------------------------------------
+    // Decodificadores de referencia
+    // ------------------------------------------------------------------------------
+    void decodeColorBlock(const unsigned char* block, bool forceFourColor, unsigned char* rgba) {
+        const unsigned int c0 = block[0] | (block[1] << 8);
+        const unsigned int c1 = block[2] | (block[3] << 8);
+        unsigned char pal[4][4];
+        bc1Palette(c0, c1, forceFourColor, pal);
+        const unsigned int bits = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<unsigned int>(block[7]) << 24);
+        for (int p = 0; p < 16; ++p) {
+            std::memcpy(rgba + p * 4, pal[(bits >> (p * 2)) & 3], 4);
+        }
+    }
+
+    void decodeBC4(const unsigned char* block, unsigned char* rgba, int channel) {
+        unsigned char pal[8];
+        bc4Palette(block[0], block[1], pal);
+        BitReader reader{ block, 16 };
+        for (int p = 0; p < 16; ++p) {
+            rgba[p * 4 + channel] = pal[reader.read(3)];
+        }
+    }
+
+    bool decodeBC7(const unsigned char* block, unsigned char* rgba) {
+        BitReader reader{ block, 0 };
+        if (reader.read(7) != (1u << 6)) return false;
+        unsigned int q[2][4];
+        for (int c = 0; c < 4; ++c) {
+            q[0][c] = reader.read(7);
+            q[1][c] = reader.read(7);
+        }
+        const unsigned int p0 = reader.read(1), p1 = reader.read(1);
+        for (int p = 0; p < 16; ++p) {
+            const int w = kBC7Weights[reader.read(p == 0 ? 3 : 4)];
+            for (int c = 0; c < 4; ++c) {
+                const int a = static_cast<int>((q[0][c] << 1) | p0);
+                const int b = static_cast<int>((q[1][c] << 1) | p1);
+                rgba[p * 4 + c] = static_cast<unsigned char>(((64 - w) * a + w * b + 32) >> 6);
+            }
+        }
+        return true;
+    }
+}
+
+unsigned int
+BlockCompressor::blockSize(BlockFormat format) {
+    return (format == BC1_FORMAT || format == BC4_FORMAT) ? 8u : 16u;
+}
+
+void
+BlockCompressor::compressBlock(const unsigned char* rgba, BlockFormat format,
+    CompressionQuality quality, unsigned char* block) {
+    switch (format) {
+    case BC1_FORMAT:
+        encodeColorBlock(rgba, quality, false, block);
+        break;
+    case BC3_FORMAT:
+        encodeBC4(rgba, 3, quality, block);
+        encodeColorBlock(rgba, quality, true, block + 8);
+        break;
+    case BC4_FORMAT:
+        encodeBC4(rgba, 0, quality, block);
+        break;
+    case BC5_FORMAT:
+        encodeBC4(rgba, 0, quality, block);
+        encodeBC4(rgba, 1, quality, block + 8);
+        break;
+    case BC7_FORMAT:
+        encodeBC7(rgba, quality, block);
+        break;
+    }
+}
+
+bool
+BlockCompressor::decompressBlock(const unsigned char* block, BlockFormat format, unsigned char* rgba) {
+    switch (format) {
+    case BC1_FORMAT:
+        decodeColorBlock(block, false, rgba);
+        return true;
+    case BC3_FORMAT:
+        decodeColorBlock(block + 8, true, rgba);
+        decodeBC4(block, rgba, 3);
+        return true;
+    case BC4_FORMAT:
+    case BC5_FORMAT:
+        for (int p = 0; p < 16; ++p) {
+            rgba[p * 4 + 0] = 0;
+            rgba[p * 4 + 1] = 0;
+            rgba[p * 4 + 2] = 0;
+            rgba[p * 4 + 3] = 255;
+        }
+        decodeBC4(block, rgba, 0);
+        if (format == BC5_FORMAT) decodeBC4(block + 8, rgba, 1);
+        return true;
+    case BC7_FORMAT:
+        return decodeBC7(block, rgba);
+    }
+    return false;
+}
+
+bool
+BlockCompressor::compress(const ImageLevel& source,
+    BlockFormat format,
+    CompressionQuality quality,
+    CompressedImage& output,
+    unsigned int threadCount) const {
+    if (source.width == 0 || source.height == 0 || source.pixels.empty()) {
+        return false;
+    }
+
+    output.format = format;
+    output.width = source.width;
+    output.height = source.height;
+    output.blocksX = (source.width + 3) / 4;
+    output.blocksY = (source.height + 3) / 4;
+    output.rowPitch = output.blocksX * blockSize(format);
+    output.data.assign(static_cast<size_t>(output.rowPitch) * output.blocksY, 0);
+
+    if (threadCount == 0) {
+        threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = (std::min)(threadCount, output.blocksY);
+
+    // Cada hilo toma filas de bloques de un contador compartido
+    std::atomic<unsigned int> nextRow(0);
+    auto worker = [&]() {
+        unsigned char rgba[64];
+        for (unsigned int by = nextRow++; by < output.blocksY; by = nextRow++) {
+            unsigned char* rowOut = &output.data[static_cast<size_t>(by) * output.rowPitch];
+            for (unsigned int bx = 0; bx < output.blocksX; ++bx) {
+                for (unsigned int y = 0; y < 4; ++y) {
+                    const unsigned int sy = (std::min)(by * 4 + y, source.height - 1);
+                    for (unsigned int x = 0; x < 4; ++x) {
+                        const unsigned int sx = (std::min)(bx * 4 + x, source.width - 1);
+                        std::memcpy(&rgba[(y * 4 + x) * 4],
+                            &source.pixels[static_cast<size_t>(sy) * source.rowPitch + sx * 4], 4);
+                    }
+                }
+                compressBlock(rgba, format, quality, rowOut + bx * blockSize(format));
+            }
+        }
+        };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return true;
+}
+
+bool
+BlockCompressor::decompress(const CompressedImage& source, ImageLevel& output) const {
+    output.width = source.width;
+    output.height = source.height;
+    output.rowPitch = source.width * 4;
+    output.pixels.assign(static_cast<size_t>(output.rowPitch) * output.height, 0);
+
+    unsigned char rgba[64];
+    for (unsigned int by = 0; by < source.blocksY; ++by) {
+        for (unsigned int bx = 0; bx < source.blocksX; ++bx) {
+            const unsigned char* block = &source.data[static_cast<size_t>(by) * source.rowPitch + bx * blockSize(source.format)];
+            if (!decompressBlock(block, source.format, rgba)) {
+                return false;
+            }
+            for (unsigned int y = 0; y < 4 && by * 4 + y < source.height; ++y) {
+                for (unsigned int x = 0; x < 4 && bx * 4 + x < source.width; ++x) {
+                    std::memcpy(&output.pixels[static_cast<size_t>(by * 4 + y) * output.rowPitch + (bx * 4 + x) * 4],
+                        &rgba[(y * 4 + x) * 4], 4);
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -1,14 +1,13 @@
 #include "Buffer.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "BufferPool.h"
+#include <climits>
+#include <cstring>
 
 
 HRESULT
 Buffer::init(Device& device, const MeshComponent& mesh, unsigned int bindFlag) {
-	if (!device.m_device) {
-		ERROR("ShaderProgram", "init", "Device is null.");
-		return E_POINTER;
-	}
 	if ((bindFlag & D3D11_BIND_VERTEX_BUFFER) && mesh.m_vertex.empty()) {
 		ERROR("Buffer", "init", "Vertex buffer is empty");
 		return E_INVALIDARG;
@@ -18,33 +17,68 @@ Buffer::init(Device& device, const MeshComponent& mesh, unsigned int bindFlag) {
 		return E_INVALIDARG;
 	}
 
-	D3D11_BUFFER_DESC desc = {};
-	D3D11_SUBRESOURCE_DATA data = {};
+	if (bindFlag & D3D11_BIND_VERTEX_BUFFER) {
+		return init(device, mesh.m_vertex, bindFlag);
+	}
+	return init(device, mesh.m_index, bindFlag);
+}
 
-	desc.Usage = D3D11_USAGE_DEFAULT;
-	desc.CPUAccessFlags = 0;
-	m_bindFlag = bindFlag;
+HRESULT
+Buffer::init(Device& device,
+	const void* data,
+	unsigned int stride,
+	unsigned int count,
+	unsigned int bindFlag,
+	const BufferOptions& options) {
+	if (!device.m_device) {
+		ERROR("Buffer", "init", "Device is null.");
+		return E_POINTER;
+	}
+	if (stride == 0 || count == 0) {
+		ERROR("Buffer", "init", "Stride and count must be non-zero");
+		return E_INVALIDARG;
+	}
+	if (count > UINT_MAX / stride) {
+		ERROR("Buffer", "init", "Buffer size overflows ByteWidth");
+		return E_INVALIDARG;
+	}
+	if (options.usage == D3D11_USAGE_IMMUTABLE && !data) {
+		ERROR("Buffer", "init", "Immutable buffer needs initial data");
+		return E_INVALIDARG;
+	}
 
-	if (bindFlag & D3D11_BIND_VERTEX_BUFFER) {
-		m_stride = sizeof(SimpleVertex);
-		desc.ByteWidth = m_stride * static_cast<unsigned int>(mesh.m_vertex.size());
-		desc.BindFlags = (D3D11_BIND_FLAG)bindFlag;
-		data.pSysMem = mesh.m_vertex.data();
+	D3D11_BUFFER_DESC desc = {};
+	desc.Usage = options.usage;
+	desc.ByteWidth = stride * count;
+	desc.BindFlags = bindFlag;
+	desc.CPUAccessFlags = options.cpuAccessFlags;
+	desc.MiscFlags = options.miscFlags;
+	if (desc.Usage == D3D11_USAGE_DYNAMIC) {
+		desc.CPUAccessFlags |= D3D11_CPU_ACCESS_WRITE;
+	}
+	if (desc.MiscFlags & D3D11_RESOURCE_MISC_BUFFER_STRUCTURED) {
+		desc.StructureByteStride = stride;
 	}
-	else if (bindFlag & D3D11_BIND_INDEX_BUFFER) {
-		m_stride = sizeof(unsigned int);
-		desc.ByteWidth = m_stride * static_cast<unsigned int>(mesh.m_index.size());
-		desc.BindFlags = (D3D11_BIND_FLAG)bindFlag;
-		data.pSysMem = mesh.m_index.data();
+	if ((desc.MiscFlags & D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS) && desc.ByteWidth % 4 != 0) {
+		ERROR("Buffer", "init", "Raw buffer size must be a multiple of 4 bytes");
+		return E_INVALIDARG;
 	}
 
-	return createBuffer(device, desc, &data);
+	m_stride = stride;
+	m_byteWidth = desc.ByteWidth;
+	m_bindFlag = bindFlag;
+	m_dynamic = desc.Usage == D3D11_USAGE_DYNAMIC;
+
+	// Sin copia intermedia: el driver lee directamente la memoria del llamador
+	D3D11_SUBRESOURCE_DATA initData = {};
+	initData.pSysMem = data;
+	return createBuffer(device, desc, data ? &initData : nullptr);
 }
 
 HRESULT
-Buffer::init(Device& device, unsigned int ByteWidth) {
+Buffer::init(Device& device, unsigned int ByteWidth, bool dynamic) {
 	if (!device.m_device) {
-		ERROR("ShaderProgram", "init", "Device is null.");
+		ERROR("Buffer", "init", "Device is null.");
 		return E_POINTER;
 	}
 	if (ByteWidth == 0) {
@@ -52,12 +86,15 @@ Buffer::init(Device& device, unsigned int ByteWidth) {
 		return E_INVALIDARG;
 	}
 	m_stride = ByteWidth;
+	m_byteWidth = ByteWidth;
 
 	D3D11_BUFFER_DESC desc = {};
-	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.Usage = dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT;
 	desc.ByteWidth = ByteWidth;
 	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	desc.CPUAccessFlags = dynamic ? D3D11_CPU_ACCESS_WRITE : 0;
 	m_bindFlag = desc.BindFlags;
+	m_dynamic = dynamic;
 
 	return createBuffer(device, desc, nullptr);
 }
@@ -78,6 +115,34 @@ Buffer::update(DeviceContext& deviceContext,
 		ERROR("ShaderProgram", "update", "pSrcData is null.");
 		return;
 	}
+	// Dinamico: sin caja se reescribe entero y el driver entrega memoria nueva sin copias
+	if (m_dynamic) {
+		unsigned int offset = 0;
+		unsigned int size = m_byteWidth;
+		if (pDstBox) {
+			if (m_bindFlag & D3D11_BIND_CONSTANT_BUFFER) {
+				ERROR("Buffer", "update", "Constant buffers must be updated whole");
+				return;
+			}
+			if (pDstBox->left >= pDstBox->right || pDstBox->right > m_byteWidth) {
+				ERROR("Buffer", "update", "Box is outside the buffer");
+				return;
+			}
+			offset = pDstBox->left;
+			size = pDstBox->right - pDstBox->left;
+		}
+		// Una escritura parcial no puede descartar el resto del buffer
+		const D3D11_MAP mapType = size == m_byteWidth ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+		D3D11_MAPPED_SUBRESOURCE mapped = {};
+		HRESULT hr = deviceContext.m_deviceContext->Map(m_buffer, 0, mapType, 0, &mapped);
+		if (FAILED(hr)) {
+			ERROR("Buffer", "update", "Failed to map dynamic buffer");
+			return;
+		}
+		std::memcpy(static_cast<unsigned char*>(mapped.pData) + offset, pSrcData, size);
+		deviceContext.m_deviceContext->Unmap(m_buffer, 0);
+		return;
+	}
 	deviceContext.m_deviceContext->UpdateSubresource(m_buffer,
 		DstSubresource,
 		pDstBox,
@@ -103,27 +168,31 @@ Buffer::render(DeviceContext& deviceContext,
 		return;
 	}
 
-	switch (m_bindFlag) {
-	case D3D11_BIND_VERTEX_BUFFER:
+	// Un buffer puede tener varios bind flags (p. ej. vertices + SRV); se enlaza por el primero
+	if (m_bindFlag & D3D11_BIND_VERTEX_BUFFER) {
 		deviceContext.m_deviceContext->IASetVertexBuffers(StartSlot, NumBuffers, &m_buffer, &m_stride, &m_offset);
-		break;
-	case D3D11_BIND_CONSTANT_BUFFER:
+	}
+	else if (m_bindFlag & D3D11_BIND_CONSTANT_BUFFER) {
 		deviceContext.m_deviceContext->VSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
 		if (setPixelShader) {
 			deviceContext.m_deviceContext->PSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
 		}
-		break;
-	case D3D11_BIND_INDEX_BUFFER:
+	}
+	else if (m_bindFlag & D3D11_BIND_INDEX_BUFFER) {
 		deviceContext.m_deviceContext->IASetIndexBuffer(m_buffer, format, m_offset);
-		break;
-	default:
+	}
+	else {
 		ERROR("Buffer", "render", "Unsupported BindFlag");
-		break;
 	}
 }
 
 void
 Buffer::destroy() {
+	if (m_pool) {
+		m_pool->release(m_buffer);
+		m_buffer = nullptr;
+		return;
+	}
 	SAFE_RELEASE(m_buffer);
 }
 
@@ -136,7 +205,8 @@ Buffer::createBuffer(Device& device,
 		return E_POINTER;
 	}
 
-	HRESULT hr = device.CreateBuffer(&desc, initData, &m_buffer);
+	HRESULT hr = m_pool ? m_pool->acquire(desc, initData, &m_buffer)
+		: device.CreateBuffer(&desc, initData, &m_buffer);
 	if (FAILED(hr)) {
 		ERROR("Buffer", "createBuffer", "Failed to create buffer");
 		return hr;
@@ -0,0 +1,124 @@
+#include "BufferPool.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <cstring>
+
+namespace {
+    void releaseAll(const std::vector<void*>& buffers) {
+        for (void* buffer : buffers) {
+            static_cast<ID3D11Buffer*>(buffer)->Release();
+        }
+    }
+}
+
+BufferPool::~BufferPool() {
+    destroy();
+}
+
+void
+BufferPool::init(Device& device, DeviceContext& deviceContext, const BufferRecyclerOptions& options) {
+    destroy();
+    m_device = &device;
+    m_deviceContext = &deviceContext;
+    m_recycler.init(options);
+}
+
+HRESULT
+BufferPool::acquire(const D3D11_BUFFER_DESC& desc, const D3D11_SUBRESOURCE_DATA* initData, ID3D11Buffer** buffer) {
+    if (!m_device || !m_device->m_device || !buffer) {
+        ERROR("BufferPool", "acquire", "Pool is not initialized.");
+        return E_POINTER;
+    }
+
+    BufferPoolKey key;
+    if (!poolKey(desc, key)) {
+        return m_device->CreateBuffer(&desc, initData, buffer);
+    }
+
+    void* recycled = m_recycler.acquire(key, desc.ByteWidth);
+    if (recycled) {
+        *buffer = static_cast<ID3D11Buffer*>(recycled);
+        if (initData && initData->pSysMem) {
+            // DYNAMIC se reescribe entero; DEFAULT solo en el rango pedido
+            if (desc.Usage == D3D11_USAGE_DYNAMIC) {
+                D3D11_MAPPED_SUBRESOURCE mapped = {};
+                if (SUCCEEDED(m_deviceContext->m_deviceContext->Map(*buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+                    std::memcpy(mapped.pData, initData->pSysMem, desc.ByteWidth);
+                    m_deviceContext->m_deviceContext->Unmap(*buffer, 0);
+                }
+            }
+            else if (desc.BindFlags & D3D11_BIND_CONSTANT_BUFFER) {
+                // Los buffers de constantes no admiten cajas: se sube el buffer completo
+                std::vector<unsigned char> padded(static_cast<size_t>(1) << key.sizeClass);
+                std::memcpy(padded.data(), initData->pSysMem, desc.ByteWidth);
+                m_deviceContext->UpdateSubresource(*buffer, 0, nullptr, padded.data(), 0, 0);
+            }
+            else {
+                D3D11_BOX box = {};
+                box.right = desc.ByteWidth;
+                box.bottom = 1;
+                box.back = 1;
+                m_deviceContext->UpdateSubresource(*buffer, 0, &box, initData->pSysMem, 0, 0);
+            }
+        }
+        return S_OK;
+    }
+
+    // Fallo: se crea con el tamano de la clase para que sirva a cualquier peticion del cubo
+    D3D11_BUFFER_DESC classDesc = desc;
+    classDesc.ByteWidth = static_cast<unsigned int>(static_cast<size_t>(1) << key.sizeClass);
+    std::vector<unsigned char> padded;
+    D3D11_SUBRESOURCE_DATA classData = {};
+    if (initData && initData->pSysMem) {
+        padded.resize(classDesc.ByteWidth);
+        std::memcpy(padded.data(), initData->pSysMem, desc.ByteWidth);
+        classData.pSysMem = padded.data();
+    }
+    HRESULT hr = m_device->CreateBuffer(&classDesc, classData.pSysMem ? &classData : nullptr, buffer);
+    if (FAILED(hr)) {
+        ERROR("BufferPool", "acquire", "Failed to create pooled buffer");
+        return hr;
+    }
+    m_recycler.track(*buffer, key, desc.ByteWidth);
+    return S_OK;
+}
+
+void
+BufferPool::release(ID3D11Buffer* buffer) {
+    if (!buffer) {
+        return;
+    }
+    // Tras destroy (o si no es del pool) se libera en el acto
+    if (!m_device || !m_recycler.release(buffer)) {
+        buffer->Release();
+    }
+}
+
+void
+BufferPool::beginFrame() {
+    std::vector<void*> expired;
+    m_recycler.beginFrame(expired);
+    releaseAll(expired);
+}
+
+void
+BufferPool::destroy() {
+    std::vector<void*> expired;
+    m_recycler.clear(expired);
+    releaseAll(expired);
+    m_device = nullptr;
+    m_deviceContext = nullptr;
+}
+
+bool
+BufferPool::poolKey(const D3D11_BUFFER_DESC& desc, BufferPoolKey& key) const {
+    if (desc.ByteWidth == 0 || desc.MiscFlags != 0 ||
+        desc.Usage == D3D11_USAGE_IMMUTABLE || desc.Usage == D3D11_USAGE_STAGING) {
+        return false;
+    }
+    key.bindFlags = desc.BindFlags;
+    key.usage = desc.Usage;
+    key.cpuAccessFlags = desc.CPUAccessFlags;
+    key.sizeClass = m_recycler.sizeClassOf(desc.ByteWidth);
+    return true;
+}
@@ -0,0 +1,134 @@
+#include "BufferRecycler.h"
+
+void
+BufferRecycler::init(const BufferRecyclerOptions& options) {
+    m_options = options;
+    m_live.clear();
+    m_pending.clear();
+    m_free.clear();
+    m_frame = 0;
+    m_stats = BufferRecyclerStats();
+}
+
+unsigned int
+BufferRecycler::sizeClassOf(size_t size) const {
+    unsigned int sizeClass = m_options.minSizeClass;
+    while ((static_cast<size_t>(1) << sizeClass) < size) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+void*
+BufferRecycler::acquire(const BufferPoolKey& key, size_t requested) {
+    auto bucket = m_free.find(key);
+    if (bucket == m_free.end() || bucket->second.empty()) {
+        ++m_stats.misses;
+        return nullptr;
+    }
+
+    // El mas reciente: es el que con mas probabilidad sigue en memoria de video
+    const PooledBuffer entry = bucket->second.back();
+    bucket->second.pop_back();
+    --m_stats.pooled;
+    m_stats.pooledBytes -= classBytes(key);
+
+    ++m_stats.hits;
+    track(entry.buffer, key, requested);
+    return entry.buffer;
+}
+
+void
+BufferRecycler::track(void* buffer, const BufferPoolKey& key, size_t requested) {
+    LiveBuffer live;
+    live.key = key;
+    live.requested = requested;
+    m_live[buffer] = live;
+    ++m_stats.live;
+    m_stats.liveBytes += classBytes(key);
+    m_stats.wastedBytes += classBytes(key) - requested;
+}
+
+bool
+BufferRecycler::release(void* buffer) {
+    auto it = m_live.find(buffer);
+    if (it == m_live.end()) {
+        return false;
+    }
+    const LiveBuffer live = it->second;
+    m_live.erase(it);
+    --m_stats.live;
+    m_stats.liveBytes -= classBytes(live.key);
+    m_stats.wastedBytes -= classBytes(live.key) - live.requested;
+
+    PooledBuffer entry;
+    entry.buffer = buffer;
+    entry.key = live.key;
+    entry.frame = m_frame;
+    m_pending.push_back(entry);
+    ++m_stats.pooled;
+    m_stats.pooledBytes += classBytes(live.key);
+    return true;
+}
+
+void
+BufferRecycler::beginFrame(std::vector<void*>& expired) {
+    ++m_frame;
+
+    // Las esperas cumplidas pasan a sus cubos
+    while (!m_pending.empty() && m_pending.front().frame + m_options.frameDelay <= m_frame) {
+        m_free[m_pending.front().key].push_back(m_pending.front());
+        m_pending.pop_front();
+    }
+
+    // Cada cubo esta ordenado por frame: los inactivos estan al principio
+    for (auto& bucket : m_free) {
+        std::vector<PooledBuffer>& entries = bucket.second;
+        size_t stale = 0;
+        while (stale < entries.size() && m_frame - entries[stale].frame > m_options.trimFrames) {
+            unpool(entries[stale]);
+            expired.push_back(entries[stale].buffer);
+            ++stale;
+        }
+        entries.erase(entries.begin(), entries.begin() + stale);
+    }
+
+    // Por encima del limite se destruye el libre mas antiguo de cualquier cubo
+    while (m_stats.pooledBytes > m_options.maxPooledBytes) {
+        std::vector<PooledBuffer>* oldest = nullptr;
+        for (auto& bucket : m_free) {
+            if (!bucket.second.empty() && (!oldest || bucket.second.front().frame < oldest->front().frame)) {
+                oldest = &bucket.second;
+            }
+        }
+        if (!oldest) {
+            break; // Solo quedan buffers en espera
+        }
+        unpool(oldest->front());
+        expired.push_back(oldest->front().buffer);
+        oldest->erase(oldest->begin());
+    }
+}
+
+void
+BufferRecycler::clear(std::vector<void*>& expired) {
+    for (const PooledBuffer& entry : m_pending) {
+        expired.push_back(entry.buffer);
+    }
+    for (const auto& bucket : m_free) {
+        for (const PooledBuffer& entry : bucket.second) {
+            expired.push_back(entry.buffer);
+        }
+    }
+    m_pending.clear();
+    m_free.clear();
+    m_stats.pooled = 0;
+    m_stats.pooledBytes = 0;
+}
+
+void
+BufferRecycler::unpool(const PooledBuffer& entry) {
+    --m_stats.pooled;
+    m_stats.pooledBytes -= classBytes(entry.key);
+    ++m_stats.trimmed;
+}
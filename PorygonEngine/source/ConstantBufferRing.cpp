@@ -0,0 +1,124 @@
+#include "ConstantBufferRing.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <cstring>
+#if PORYGON_D3D11_1
+#include <d3d11_1.h>
+#endif
+
+namespace {
+    const unsigned int kConstantBytes = 16;
+    const unsigned int kMaxConstants = 4096;
+}
+
+ConstantBufferRing::~ConstantBufferRing() {
+    destroy();
+}
+
+HRESULT
+ConstantBufferRing::init(Device& device, DeviceContext& deviceContext, unsigned int capacity) {
+    destroy();
+    if (!device.m_device || !deviceContext.m_deviceContext) {
+        ERROR("ConstantBufferRing", "init", "Device or DeviceContext is null.");
+        return E_POINTER;
+    }
+    if (capacity == 0) {
+        ERROR("ConstantBufferRing", "init", "Capacity is zero");
+        return E_INVALIDARG;
+    }
+
+#if PORYGON_D3D11_1
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+    HRESULT hr = device.m_device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+    if (FAILED(hr) || !options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer ||
+        FAILED(deviceContext.m_deviceContext->QueryInterface(__uuidof(ID3D11DeviceContext1),
+            reinterpret_cast<void**>(&m_context1)))) {
+        MESSAGE("ConstantBufferRing", "init", "Constant buffer offsets not supported, ring disabled");
+        return S_OK;
+    }
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.ByteWidth = (capacity + 255) & ~255u;
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    hr = device.CreateBuffer(&desc, nullptr, &m_buffer);
+    if (FAILED(hr)) {
+        ERROR("ConstantBufferRing", "init", "Failed to create dynamic constant buffer");
+        destroy();
+        return hr;
+    }
+    m_ring.init(desc.ByteWidth, 16 * kConstantBytes);
+    return S_OK;
+#else
+    MESSAGE("ConstantBufferRing", "init", "Built without Direct3D 11.1 headers, ring disabled");
+    return S_OK;
+#endif
+}
+
+bool
+ConstantBufferRing::write(DeviceContext& deviceContext,
+    const void* data,
+    unsigned int size,
+    ConstantBufferRange& range) {
+    if (!m_buffer || !data || size > kMaxConstants * kConstantBytes) {
+        return false;
+    }
+    ConstantRingAllocation allocation;
+    if (!m_ring.allocate(size, allocation)) {
+        return false;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    const D3D11_MAP mapType = allocation.discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+    HRESULT hr = deviceContext.m_deviceContext->Map(m_buffer, 0, mapType, 0, &mapped);
+    if (FAILED(hr)) {
+        ERROR("ConstantBufferRing", "write", "Failed to map constant ring");
+        // Sin reset: un DISCARD a mitad de frame borraria bloques que los draws
+        // ya enlazaron. Si el que fallo era el DISCARD, el siguiente bloque lo repite
+        if (allocation.discard) {
+            m_ring.repeatDiscard();
+        }
+        return false;
+    }
+    std::memcpy(static_cast<unsigned char*>(mapped.pData) + allocation.offset, data, size);
+    deviceContext.m_deviceContext->Unmap(m_buffer, 0);
+
+    range.firstConstant = static_cast<unsigned int>(allocation.offset / kConstantBytes);
+    range.numConstants = static_cast<unsigned int>(allocation.size / kConstantBytes);
+    range.generation = allocation.generation;
+    return true;
+}
+
+void
+ConstantBufferRing::bind(DeviceContext& deviceContext,
+    unsigned int slot,
+    const ConstantBufferRange& range,
+    bool setPixelShader) {
+#if PORYGON_D3D11_1
+    if (!m_buffer || !m_context1) {
+        ERROR("ConstantBufferRing", "bind", "Ring is not initialized.");
+        return;
+    }
+    m_context1->VSSetConstantBuffers1(slot, 1, &m_buffer, &range.firstConstant, &range.numConstants);
+    if (setPixelShader) {
+        m_context1->PSSetConstantBuffers1(slot, 1, &m_buffer, &range.firstConstant, &range.numConstants);
+    }
+#else
+    (void)deviceContext;
+    (void)slot;
+    (void)range;
+    (void)setPixelShader;
+    ERROR("ConstantBufferRing", "bind", "Ring is not supported.");
+#endif
+}
+
+void
+ConstantBufferRing::destroy() {
+    SAFE_RELEASE(m_buffer);
+#if PORYGON_D3D11_1
+    SAFE_RELEASE(m_context1);
+#endif
+    m_context1 = nullptr;
+    m_ring.init(0);
+}
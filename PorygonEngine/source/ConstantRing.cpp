@@ -0,0 +1,59 @@
+#include "ConstantRing.h"
+
+void
+ConstantRing::init(size_t capacity, size_t alignment) {
+    m_capacity = capacity;
+    m_alignment = alignment > 1 ? alignment : 1;
+    m_frameDemand = 0;
+    m_stats = ConstantRingStats();
+    reset();
+}
+
+bool
+ConstantRing::allocate(size_t size, ConstantRingAllocation& allocation) {
+    const size_t mask = m_alignment - 1;
+    const size_t aligned = (size + mask) & ~mask;
+    if (size == 0 || aligned > m_capacity) {
+        ++m_stats.failures;
+        return false;
+    }
+
+    // Sin sitio hasta el final: la vuelta se deja para el siguiente frame
+    m_frameDemand += aligned;
+    if (aligned > m_capacity - m_head) {
+        ++m_stats.overflows;
+        return false;
+    }
+
+    allocation.offset = m_head;
+    allocation.size = aligned;
+    allocation.discard = m_discardPending;
+    allocation.generation = m_generation;
+    m_discardPending = false;
+    m_head += aligned;
+
+    ++m_stats.allocations;
+    m_stats.requested += size;
+    m_stats.allocated += aligned;
+    return true;
+}
+
+void
+ConstantRing::beginFrame() {
+    // Se preve que el frame pida tanto como el mayor de los anteriores (con lo que no cupo)
+    if (m_frameDemand > m_stats.peakFrameDemand) {
+        m_stats.peakFrameDemand = m_frameDemand;
+    }
+    if (m_head > 0 && m_stats.peakFrameDemand > m_capacity - m_head) {
+        reset();
+        ++m_stats.wraps;
+    }
+    m_frameDemand = 0;
+}
+
+void
+ConstantRing::reset() {
+    m_head = 0;
+    m_discardPending = true;
+    ++m_generation;
+}
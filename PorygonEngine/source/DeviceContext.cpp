@@ -127,6 +127,35 @@ DeviceContext::UpdateSubresource(ID3D11Resource* pDstResource,
 		SrcDepthPitch);
 }
 
+//
+// `CopySubresourceRegion` copia texeles entre dos recursos sin pasar por la CPU.
+// Se usa, por ejemplo, para rehacer una textura sin sus mips mas grandes.
+//
+void
+DeviceContext::CopySubresourceRegion(ID3D11Resource* pDstResource,
+	unsigned int DstSubresource,
+	unsigned int DstX,
+	unsigned int DstY,
+	unsigned int DstZ,
+	ID3D11Resource* pSrcResource,
+	unsigned int SrcSubresource,
+	const D3D11_BOX* pSrcBox) {
+	// Verificacion para evitar punteros nulos.
+	if (!pDstResource || !pSrcResource) {
+		ERROR("DeviceContext", "CopySubresourceRegion",
+			"Invalid arguments: pDstResource or pSrcResource is nullptr");
+		return;
+	}
+	m_deviceContext->CopySubresourceRegion(pDstResource,
+		DstSubresource,
+		DstX,
+		DstY,
+		DstZ,
+		pSrcResource,
+		SrcSubresource,
+		pSrcBox);
+}
+
 //
 // `IASetVertexBuffers` asigna b�feres de v�rtices a la etapa de Ensamblador de Entrada.
 // Estos b�feres contienen los datos de los v�rtices (posiciones, normales, coordenadas de textura, etc.).
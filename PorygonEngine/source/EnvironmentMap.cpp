@@ -0,0 +1,272 @@
+#include "EnvironmentMap.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include "HdrPacker.h"
+#include <cstring>
+
+namespace {
+    const uint64_t kIrradianceKind = 0x9E3779B97F4A7C15ull;
+    const uint64_t kBrdfLutKey = 0x504F5259424C5554ull; // "PORYBLUT"
+
+    /**
+     * @brief Combina la clave de una cara con la de las anteriores (FNV-1a por palabra).
+     */
+    uint64_t
+        combineKey(uint64_t key, uint64_t faceKey) {
+        return (key ^ faceKey) * 1099511628211ull;
+    }
+
+    const char*
+        sourceExtension(ExtensionType extensionType) {
+        switch (extensionType) {
+        case PNG: return ".png";
+        case HDR: return ".hdr";
+        default: return ".jpg";
+        }
+    }
+}
+
+HRESULT
+EnvironmentMap::init(Device& device,
+    const std::string& textureName,
+    ExtensionType extensionType,
+    const EnvironmentMapOptions& options) {
+    if (extensionType == DDS) {
+        ERROR("EnvironmentMap", "init", "Environment maps only support PNG, JPG and HDR");
+        return E_INVALIDARG;
+    }
+    const std::string fileName = textureName + sourceExtension(extensionType);
+
+    uint64_t key = 0;
+    const bool cacheable = !options.cacheDirectory.empty() &&
+        TextureCache::makeKey(fileName, cacheSalt(options), key);
+    m_specular.m_textureName = fileName;
+
+    return initEnvironment(device, key, cacheable, options, [&](CubeImage& cube) -> HRESULT {
+        std::vector<float> linear;
+        unsigned int width = 0, height = 0, channels = 0;
+        HRESULT hr = Texture::decodeLinear(fileName, options.srgb, options.decodeThreads,
+            linear, width, height, channels);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        if (!EnvironmentPrefilter::fromEquirect(linear.data(), width, height,
+            options.faceSize, cube, options.prefilter.threadCount)) {
+            ERROR("EnvironmentMap", "init", ("Failed to project equirectangular image: " + fileName).c_str());
+            return E_FAIL;
+        }
+        return S_OK;
+        });
+}
+
+HRESULT
+EnvironmentMap::init(Device& device,
+    const std::vector<std::string>& faceNames,
+    ExtensionType extensionType,
+    const EnvironmentMapOptions& options) {
+    if (extensionType == DDS) {
+        ERROR("EnvironmentMap", "init", "Environment maps only support PNG, JPG and HDR");
+        return E_INVALIDARG;
+    }
+    if (faceNames.size() != CUBE_FACE_COUNT) {
+        ERROR("EnvironmentMap", "init", "Environment map needs exactly six faces");
+        return E_INVALIDARG;
+    }
+    std::vector<std::string> fileNames;
+    for (const std::string& faceName : faceNames) {
+        fileNames.push_back(faceName + sourceExtension(extensionType));
+    }
+
+    uint64_t key = 0;
+    bool cacheable = !options.cacheDirectory.empty();
+    for (size_t i = 0; cacheable && i < fileNames.size(); ++i) {
+        uint64_t faceKey = 0;
+        cacheable = TextureCache::makeKey(fileNames[i], cacheSalt(options), faceKey);
+        key = combineKey(key, faceKey);
+    }
+    m_specular.m_textureName = fileNames[0];
+
+    return initEnvironment(device, key, cacheable, options, [&](CubeImage& cube) -> HRESULT {
+        // Cada cara se decodifica a float lineal (HDR tal cual, PNG/JPG desde sRGB)
+        for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+            std::vector<float> linear;
+            unsigned int width = 0, height = 0, channels = 0;
+            HRESULT hr = Texture::decodeLinear(fileNames[f], options.srgb, options.decodeThreads,
+                linear, width, height, channels);
+            if (FAILED(hr)) {
+                return hr;
+            }
+            if (width != height || (f > 0 && width != cube.size)) {
+                ERROR("EnvironmentMap", "init", "Cubemap faces must be square and share their size");
+                return E_INVALIDARG;
+            }
+            if (f == 0) {
+                cube.size = width;
+                cube.texels.resize(static_cast<size_t>(width) * width * 4 * CUBE_FACE_COUNT);
+            }
+            std::memcpy(cube.face(f), linear.data(), linear.size() * sizeof(float));
+        }
+        return S_OK;
+        });
+}
+
+template <typename LoadSource>
+HRESULT
+EnvironmentMap::initEnvironment(Device& device,
+    uint64_t sourceKey,
+    bool cacheable,
+    const EnvironmentMapOptions& options,
+    LoadSource loadSource) {
+    if (!device.m_device) {
+        ERROR("EnvironmentMap", "init", "Device is null.");
+        return E_POINTER;
+    }
+    const std::string name = m_specular.m_textureName;
+    destroy();
+    m_specular.m_textureName = name;
+
+    HRESULT hr = initBrdfLut(device, options);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    // Con la cache llena no se decodifica ni se prefiltra nada
+    const TextureCache cache(options.cacheDirectory);
+    const uint64_t irradianceKey = sourceKey ^ kIrradianceKind;
+    TextureCacheEntry specularEntry, irradianceEntry;
+    if (cacheable && cache.load(sourceKey, specularEntry) && cache.load(irradianceKey, irradianceEntry) &&
+        specularEntry.format == DXGI_FORMAT_R16G16B16A16_FLOAT &&
+        specularEntry.levels.size() % CUBE_FACE_COUNT == 0 &&
+        irradianceEntry.levels[0].size == sizeof(m_irradiance)) {
+        hr = m_specular.initCube(device, specularEntry.width, DXGI_FORMAT_R16G16B16A16_FLOAT, specularEntry.levels);
+        if (SUCCEEDED(hr)) {
+            std::memcpy(m_irradiance, irradianceEntry.levels[0].data, sizeof(m_irradiance));
+            m_specularMips = static_cast<unsigned int>(specularEntry.levels.size()) / CUBE_FACE_COUNT;
+            m_fromCache = true;
+            return S_OK;
+        }
+        ERROR("EnvironmentMap", "init", "Failed to create environment from cache entry, prefiltering source");
+    }
+
+    CubeImage source;
+    hr = loadSource(source);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    std::vector<CubeImage> mips;
+    if (!EnvironmentPrefilter::specular(source, options.prefilter, mips) ||
+        !EnvironmentPrefilter::irradiance(source, m_irradiance, options.prefilter.threadCount)) {
+        ERROR("EnvironmentMap", "init", ("Failed to prefilter " + name).c_str());
+        return E_FAIL;
+    }
+
+    // Niveles en orden de subrecursos: cara * numMips + mip
+    size_t halfCount = 0;
+    for (const CubeImage& mip : mips) {
+        halfCount += mip.texels.size();
+    }
+    std::vector<uint16_t> halves(halfCount);
+    std::vector<TextureCacheLevel> levels;
+    levels.reserve(mips.size() * CUBE_FACE_COUNT);
+    size_t offset = 0;
+    for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+        for (const CubeImage& mip : mips) {
+            const size_t count = static_cast<size_t>(mip.size) * mip.size * 4;
+            HdrPacker::packHalf(mip.face(f), count, &halves[offset]);
+            TextureCacheLevel level;
+            level.width = level.height = mip.size;
+            level.rowPitch = mip.size * 4 * sizeof(uint16_t);
+            level.data = reinterpret_cast<const unsigned char*>(&halves[offset]);
+            level.size = count * sizeof(uint16_t);
+            levels.push_back(level);
+            offset += count;
+        }
+    }
+
+    hr = m_specular.initCube(device, mips[0].size, DXGI_FORMAT_R16G16B16A16_FLOAT, levels);
+    if (FAILED(hr)) {
+        ERROR("EnvironmentMap", "init", "Failed to create specular cubemap");
+        return hr;
+    }
+    m_specularMips = static_cast<unsigned int>(mips.size());
+
+    if (cacheable) {
+        TextureCacheLevel irradianceLevel;
+        irradianceLevel.width = 9;
+        irradianceLevel.height = 1;
+        irradianceLevel.rowPitch = sizeof(m_irradiance);
+        irradianceLevel.data = reinterpret_cast<const unsigned char*>(m_irradiance);
+        irradianceLevel.size = sizeof(m_irradiance);
+        if (!cache.store(sourceKey, DXGI_FORMAT_R16G16B16A16_FLOAT, levels) ||
+            !cache.store(irradianceKey, DXGI_FORMAT_R32G32B32A32_FLOAT, { irradianceLevel })) {
+            MESSAGE("EnvironmentMap", "init", "Could not write environment cache entry");
+        }
+    }
+    return S_OK;
+}
+
+HRESULT
+EnvironmentMap::initBrdfLut(Device& device, const EnvironmentMapOptions& options) {
+    const TextureCache cache(options.cacheDirectory);
+    const uint64_t key = kBrdfLutKey ^ (static_cast<uint64_t>(options.lutSize) << 32) ^ options.lutSamples;
+    const bool cacheable = !options.cacheDirectory.empty();
+
+    TextureCacheEntry entry;
+    if (cacheable && cache.load(key, entry) && entry.format == DXGI_FORMAT_R16G16_FLOAT &&
+        SUCCEEDED(m_brdfLut.init(device, entry))) {
+        return S_OK;
+    }
+
+    std::vector<float> lut;
+    EnvironmentPrefilter::brdfLut(options.lutSize, options.lutSamples, lut, options.prefilter.threadCount);
+    std::vector<uint16_t> halves(lut.size());
+    HdrPacker::packHalf(lut.data(), lut.size(), halves.data());
+
+    PreparedTexture prepared;
+    prepared.width = prepared.height = options.lutSize;
+    prepared.format = DXGI_FORMAT_R16G16_FLOAT;
+    TextureCacheLevel level;
+    level.width = level.height = options.lutSize;
+    level.rowPitch = options.lutSize * 2 * sizeof(uint16_t);
+    level.data = reinterpret_cast<const unsigned char*>(halves.data());
+    level.size = halves.size() * sizeof(uint16_t);
+    prepared.levels.push_back(level);
+
+    HRESULT hr = m_brdfLut.init(device, prepared);
+    if (FAILED(hr)) {
+        ERROR("EnvironmentMap", "initBrdfLut", "Failed to create BRDF lookup table");
+        return hr;
+    }
+    m_brdfLut.m_textureName = "BRDF LUT";
+    if (cacheable && !cache.store(key, prepared.format, prepared.levels)) {
+        MESSAGE("EnvironmentMap", "initBrdfLut", "Could not write BRDF cache entry");
+    }
+    return S_OK;
+}
+
+void
+EnvironmentMap::render(DeviceContext& deviceContext, unsigned int startSlot) {
+    m_specular.render(deviceContext, startSlot, 1);
+    m_brdfLut.render(deviceContext, startSlot + 1, 1);
+}
+
+void
+EnvironmentMap::destroy() {
+    m_specular.destroy();
+    m_brdfLut.destroy();
+    std::memset(m_irradiance, 0, sizeof(m_irradiance));
+    m_specularMips = 0;
+    m_fromCache = false;
+}
+
+uint64_t
+EnvironmentMap::cacheSalt(const EnvironmentMapOptions& options) {
+    const uint64_t version = 1;
+    return version |
+        (static_cast<uint64_t>(options.srgb) << 8) |
+        (static_cast<uint64_t>(options.prefilter.specularMips & 0xFF) << 9) |
+        (static_cast<uint64_t>(options.prefilter.specularSize & 0xFFFF) << 17) |
+        (static_cast<uint64_t>(options.prefilter.sampleCount & 0xFFFF) << 33) |
+        (static_cast<uint64_t>(options.faceSize & 0x7FFF) << 49);
+}
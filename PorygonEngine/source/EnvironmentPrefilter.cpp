@@ -0,0 +1,546 @@
+#include "EnvironmentPrefilter.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace {
+    const float kPi = 3.14159265358979f;
+
+    /**
+     * @brief Reparte [0, count) entre hilos que toman indices de un contador compartido.
+     */
+    template <typename Work>
+    void parallelFor(unsigned int count, unsigned int threadCount, Work work) {
+        if (threadCount == 0) {
+            threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+        }
+        threadCount = (std::min)(threadCount, count);
+        std::atomic<unsigned int> next(0);
+        auto worker = [&]() {
+            for (unsigned int i = next++; i < count; i = next++) {
+                work(i);
+            }
+            };
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief acc += color * weight sobre los cuatro canales.
+     */
+    inline void addWeighted(float* acc, const float* color, float weight) {
+#if PORYGON_SSE2
+        _mm_storeu_ps(acc, _mm_add_ps(_mm_loadu_ps(acc), _mm_mul_ps(_mm_loadu_ps(color), _mm_set1_ps(weight))));
+#else
+        for (int c = 0; c < 4; ++c) {
+            acc[c] += color[c] * weight;
+        }
+#endif
+    }
+
+    /**
+     * @brief Direccion (sin normalizar) del centro del texel (x, y) de una cara.
+     */
+    void texelDirection(unsigned int face, unsigned int x, unsigned int y, unsigned int size, float dir[3]) {
+        const float u = 2.0f * (x + 0.5f) / size - 1.0f;
+        const float v = 2.0f * (y + 0.5f) / size - 1.0f;
+        switch (face) {
+        case CUBE_POSITIVE_X: dir[0] = 1.0f;  dir[1] = -v;    dir[2] = -u;    break;
+        case CUBE_NEGATIVE_X: dir[0] = -1.0f; dir[1] = -v;    dir[2] = u;     break;
+        case CUBE_POSITIVE_Y: dir[0] = u;     dir[1] = 1.0f;  dir[2] = v;     break;
+        case CUBE_NEGATIVE_Y: dir[0] = u;     dir[1] = -1.0f; dir[2] = -v;    break;
+        case CUBE_POSITIVE_Z: dir[0] = u;     dir[1] = -v;    dir[2] = 1.0f;  break;
+        default:              dir[0] = -u;    dir[1] = -v;    dir[2] = -1.0f; break;
+        }
+    }
+
+    /**
+     * @brief Cara y coordenadas [0, 1] de una direccion.
+     */
+    unsigned int directionToFace(float x, float y, float z, float& u, float& v) {
+        const float ax = std::fabs(x), ay = std::fabs(y), az = std::fabs(z);
+        unsigned int face;
+        float sc, tc, ma;
+        if (ax >= ay && ax >= az) {
+            face = x > 0.0f ? CUBE_POSITIVE_X : CUBE_NEGATIVE_X;
+            sc = x > 0.0f ? -z : z;
+            tc = -y;
+            ma = ax;
+        }
+        else if (ay >= az) {
+            face = y > 0.0f ? CUBE_POSITIVE_Y : CUBE_NEGATIVE_Y;
+            sc = x;
+            tc = y > 0.0f ? z : -z;
+            ma = ay;
+        }
+        else {
+            face = z > 0.0f ? CUBE_POSITIVE_Z : CUBE_NEGATIVE_Z;
+            sc = z > 0.0f ? x : -x;
+            tc = -y;
+            ma = az;
+        }
+        u = 0.5f * (sc / ma + 1.0f);
+        v = 0.5f * (tc / ma + 1.0f);
+        return face;
+    }
+
+    /**
+     * @brief Lectura bilineal de una cara (sujeta al borde de la cara).
+     */
+    void sampleBilinear(const CubeImage& image, float x, float y, float z, float* out) {
+        float u, v;
+        const float* face = image.face(directionToFace(x, y, z, u, v));
+        const int size = static_cast<int>(image.size);
+        const float fx = (std::min)((std::max)(u * size - 0.5f, 0.0f), static_cast<float>(size - 1));
+        const float fy = (std::min)((std::max)(v * size - 0.5f, 0.0f), static_cast<float>(size - 1));
+        const int x0 = static_cast<int>(fx), y0 = static_cast<int>(fy);
+        const int x1 = (std::min)(x0 + 1, size - 1), y1 = (std::min)(y0 + 1, size - 1);
+        const float tx = fx - x0, ty = fy - y0;
+        std::memset(out, 0, sizeof(float) * 4);
+        addWeighted(out, face + (static_cast<size_t>(y0) * size + x0) * 4, (1.0f - tx) * (1.0f - ty));
+        addWeighted(out, face + (static_cast<size_t>(y0) * size + x1) * 4, tx * (1.0f - ty));
+        addWeighted(out, face + (static_cast<size_t>(y1) * size + x0) * 4, (1.0f - tx) * ty);
+        addWeighted(out, face + (static_cast<size_t>(y1) * size + x1) * 4, tx * ty);
+    }
+
+    /**
+     * @brief Lectura trilineal de una cadena de mips en un nivel fraccionario.
+     */
+    void sampleLod(const std::vector<CubeImage>& chain, float x, float y, float z, float lod, float* out) {
+        lod = (std::min)((std::max)(lod, 0.0f), static_cast<float>(chain.size() - 1));
+        const unsigned int level = static_cast<unsigned int>(lod);
+        const float t = lod - level;
+        sampleBilinear(chain[level], x, y, z, out);
+        if (t > 0.0f && level + 1 < chain.size()) {
+            float upper[4];
+            sampleBilinear(chain[level + 1], x, y, z, upper);
+            for (int c = 0; c < 4; ++c) {
+                out[c] += (upper[c] - out[c]) * t;
+            }
+        }
+    }
+
+    /**
+     * @brief Reduce un cubemap a la mitad promediando 2x2 en cada cara.
+     */
+    void downsample(const CubeImage& source, CubeImage& result) {
+        result.size = (std::max)(1u, source.size / 2);
+        result.texels.assign(static_cast<size_t>(CUBE_FACE_COUNT) * result.size * result.size * 4, 0.0f);
+        const unsigned int step = source.size > 1 ? 2 : 1;
+        const float weight = 1.0f / (step * step);
+        for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+            const float* src = source.face(f);
+            float* dst = result.face(f);
+            for (unsigned int y = 0; y < result.size; ++y) {
+                for (unsigned int x = 0; x < result.size; ++x) {
+                    float* out = dst + (static_cast<size_t>(y) * result.size + x) * 4;
+                    for (unsigned int sy = 0; sy < step; ++sy) {
+                        for (unsigned int sx = 0; sx < step; ++sx) {
+                            addWeighted(out, src + (static_cast<size_t>(y * step + sy) * source.size + x * step + sx) * 4, weight);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Punto i de la secuencia de Hammersley de n puntos.
+     */
+    void hammersley(unsigned int i, unsigned int n, float& e1, float& e2) {
+        uint32_t bits = i;
+        bits = (bits << 16) | (bits >> 16);
+        bits = ((bits & 0x55555555u) << 1) | ((bits & 0xAAAAAAAAu) >> 1);
+        bits = ((bits & 0x33333333u) << 2) | ((bits & 0xCCCCCCCCu) >> 2);
+        bits = ((bits & 0x0F0F0F0Fu) << 4) | ((bits & 0xF0F0F0F0u) >> 4);
+        bits = ((bits & 0x00FF00FFu) << 8) | ((bits & 0xFF00FF00u) >> 8);
+        e1 = static_cast<float>(i) / n;
+        e2 = static_cast<float>(bits) * 2.3283064365386963e-10f;
+    }
+
+    /**
+     * @brief Semivector GGX muestreado por importancia en espacio tangente (N = +Z).
+     */
+    void importanceSampleGgx(float e1, float e2, float alpha, float h[3]) {
+        const float phi = 2.0f * kPi * e1;
+        const float cosTheta = std::sqrt((1.0f - e2) / (1.0f + (alpha * alpha - 1.0f) * e2));
+        const float sinTheta = std::sqrt((std::max)(0.0f, 1.0f - cosTheta * cosTheta));
+        h[0] = sinTheta * std::cos(phi);
+        h[1] = sinTheta * std::sin(phi);
+        h[2] = cosTheta;
+    }
+
+    /**
+     * @brief Muestras de un nivel especular en estructura de arreglos (de cuatro en cuatro).
+     *
+     * Con N = V la direccion de luz en espacio tangente, su peso (NdotL) y el
+     * mip de la fuente no dependen del texel, asi que se calculan una vez.
+     */
+    struct SampleSet {
+        std::vector<float> x, y, z;  /**< Direccion de luz en espacio tangente. */
+        std::vector<float> weight;   /**< NdotL (0 = muestra descartada). */
+        std::vector<float> lod;      /**< Mip de la fuente que cubre el angulo solido de la muestra. */
+        float totalWeight = 0.0f;
+    };
+
+    void buildSampleSet(float roughness, unsigned int count, unsigned int sourceSize, SampleSet& set) {
+        set.x.assign(count, 0.0f);
+        set.y.assign(count, 0.0f);
+        set.z.assign(count, 1.0f);
+        set.weight.assign(count, 0.0f);
+        set.lod.assign(count, 0.0f);
+        set.totalWeight = 0.0f;
+
+        const float alpha = roughness * roughness;
+        const float texelSolidAngle = 4.0f * kPi / (6.0f * sourceSize * sourceSize);
+        for (unsigned int i = 0; i < count; ++i) {
+            float e1, e2, h[3];
+            hammersley(i, count, e1, e2);
+            importanceSampleGgx(e1, e2, alpha, h);
+            const float nDotH = h[2];
+            const float lz = 2.0f * nDotH * nDotH - 1.0f;
+            if (lz <= 0.0f) {
+                continue;
+            }
+            set.x[i] = 2.0f * nDotH * h[0];
+            set.y[i] = 2.0f * nDotH * h[1];
+            set.z[i] = lz;
+            set.weight[i] = lz;
+            set.totalWeight += lz;
+
+            // pdf = D * NdotH / (4 * VdotH) = D / 4 con N = V
+            const float a2 = alpha * alpha;
+            const float d = nDotH * nDotH * (a2 - 1.0f) + 1.0f;
+            const float pdf = a2 / (kPi * d * d) / 4.0f;
+            const float sampleSolidAngle = 1.0f / (count * pdf + 1e-6f);
+            set.lod[i] = (std::max)(0.0f, 0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f);
+        }
+    }
+
+    /**
+     * @brief Integra la radiancia de un texel con las muestras del nivel.
+     */
+    void integrateTexel(const std::vector<CubeImage>& chain, const SampleSet& set, const float n[3], float* out) {
+        // Base tangente alrededor de la normal
+        const float up[3] = { std::fabs(n[2]) < 0.999f ? 0.0f : 1.0f, 0.0f, std::fabs(n[2]) < 0.999f ? 1.0f : 0.0f };
+        float t[3] = { up[1] * n[2] - up[2] * n[1], up[2] * n[0] - up[0] * n[2], up[0] * n[1] - up[1] * n[0] };
+        const float invLength = 1.0f / std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+        t[0] *= invLength; t[1] *= invLength; t[2] *= invLength;
+        const float b[3] = { n[1] * t[2] - n[2] * t[1], n[2] * t[0] - n[0] * t[2], n[0] * t[1] - n[1] * t[0] };
+
+        float acc[4] = {};
+        alignas(16) float wx[4], wy[4], wz[4];
+        const unsigned int count = static_cast<unsigned int>(set.weight.size());
+        for (unsigned int i = 0; i < count; i += 4) {
+            // Cuatro muestras a la vez: L = T * x + B * y + N * z
+#if PORYGON_SSE2
+            const __m128 lx = _mm_loadu_ps(&set.x[i]);
+            const __m128 ly = _mm_loadu_ps(&set.y[i]);
+            const __m128 lz = _mm_loadu_ps(&set.z[i]);
+            _mm_store_ps(wx, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(t[0]), lx), _mm_mul_ps(_mm_set1_ps(b[0]), ly)), _mm_mul_ps(_mm_set1_ps(n[0]), lz)));
+            _mm_store_ps(wy, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(t[1]), lx), _mm_mul_ps(_mm_set1_ps(b[1]), ly)), _mm_mul_ps(_mm_set1_ps(n[1]), lz)));
+            _mm_store_ps(wz, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(t[2]), lx), _mm_mul_ps(_mm_set1_ps(b[2]), ly)), _mm_mul_ps(_mm_set1_ps(n[2]), lz)));
+#else
+            for (unsigned int k = 0; k < 4; ++k) {
+                wx[k] = t[0] * set.x[i + k] + b[0] * set.y[i + k] + n[0] * set.z[i + k];
+                wy[k] = t[1] * set.x[i + k] + b[1] * set.y[i + k] + n[1] * set.z[i + k];
+                wz[k] = t[2] * set.x[i + k] + b[2] * set.y[i + k] + n[2] * set.z[i + k];
+            }
+#endif
+            for (unsigned int k = 0; k < 4; ++k) {
+                const float weight = set.weight[i + k];
+                if (weight <= 0.0f) continue;
+                float color[4];
+                sampleLod(chain, wx[k], wy[k], wz[k], set.lod[i + k], color);
+                addWeighted(acc, color, weight);
+            }
+        }
+        const float scale = set.totalWeight > 0.0f ? 1.0f / set.totalWeight : 0.0f;
+        for (int c = 0; c < 3; ++c) {
+            out[c] = acc[c] * scale;
+        }
+        out[3] = 1.0f;
+    }
+
+    /**
+     * @brief Termino de visibilidad de Smith-Schlick con k = alpha / 2 (para IBL).
+     */
+    float geometrySmith(float nDotV, float nDotL, float roughness) {
+        const float k = roughness * roughness / 2.0f;
+        return (nDotV / (nDotV * (1.0f - k) + k)) * (nDotL / (nDotL * (1.0f - k) + k));
+    }
+
+    float srgbToLinear(float c) {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(float l) {
+        return l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+    }
+}
+
+bool
+EnvironmentPrefilter::fromFaces(const ImageLevel faces[CUBE_FACE_COUNT], bool srgb, CubeImage& cube) {
+    const unsigned int size = faces[0].width;
+    for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+        if (size == 0 || faces[f].width != size || faces[f].height != size || faces[f].pixels.empty()) {
+            return false;
+        }
+    }
+    cube.size = size;
+    cube.texels.resize(static_cast<size_t>(CUBE_FACE_COUNT) * size * size * 4);
+    std::vector<float> linear;
+    for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+        toLinear(faces[f], srgb, linear);
+        std::copy(linear.begin(), linear.end(), cube.face(f));
+    }
+    return true;
+}
+
+bool
+EnvironmentPrefilter::fromEquirect(const float* rgba,
+    unsigned int width,
+    unsigned int height,
+    unsigned int faceSize,
+    CubeImage& cube,
+    unsigned int threadCount) {
+    if (!rgba || width == 0 || height == 0) {
+        return false;
+    }
+    cube.size = faceSize ? faceSize : (std::max)(1u, width / 4);
+    cube.texels.assign(static_cast<size_t>(CUBE_FACE_COUNT) * cube.size * cube.size * 4, 0.0f);
+
+    parallelFor(CUBE_FACE_COUNT * cube.size, threadCount, [&](unsigned int row) {
+        const unsigned int face = row / cube.size;
+        const unsigned int y = row % cube.size;
+        float* out = cube.face(face) + static_cast<size_t>(y) * cube.size * 4;
+        for (unsigned int x = 0; x < cube.size; ++x, out += 4) {
+            float dir[3];
+            texelDirection(face, x, y, cube.size, dir);
+            const float length = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+
+            // Longitud alrededor de Y con +Z en el centro; latitud desde +Y
+            const float u = 0.5f + std::atan2(dir[0], dir[2]) / (2.0f * kPi);
+            const float v = std::acos((std::min)(1.0f, (std::max)(-1.0f, dir[1] / length))) / kPi;
+            const float fx = u * width - 0.5f;
+            const float fy = (std::min)((std::max)(v * height - 0.5f, 0.0f), static_cast<float>(height - 1));
+            const int x0 = static_cast<int>(std::floor(fx));
+            const int y0 = static_cast<int>(fy);
+            const float tx = fx - x0, ty = fy - y0;
+            const unsigned int cx0 = static_cast<unsigned int>((x0 % static_cast<int>(width) + width) % width);
+            const unsigned int cx1 = (cx0 + 1) % width;
+            const unsigned int cy1 = (std::min)(static_cast<unsigned int>(y0) + 1, height - 1);
+            addWeighted(out, rgba + (static_cast<size_t>(y0) * width + cx0) * 4, (1.0f - tx) * (1.0f - ty));
+            addWeighted(out, rgba + (static_cast<size_t>(y0) * width + cx1) * 4, tx * (1.0f - ty));
+            addWeighted(out, rgba + (static_cast<size_t>(cy1) * width + cx0) * 4, (1.0f - tx) * ty);
+            addWeighted(out, rgba + (static_cast<size_t>(cy1) * width + cx1) * 4, tx * ty);
+        }
+        });
+    return true;
+}
+
+void
+EnvironmentPrefilter::toLinear(const ImageLevel& image, bool srgb, std::vector<float>& rgba) {
+    float table[256];
+    for (int i = 0; i < 256; ++i) {
+        table[i] = srgb ? srgbToLinear(i / 255.0f) : i / 255.0f;
+    }
+    rgba.resize(static_cast<size_t>(image.width) * image.height * 4);
+    for (unsigned int y = 0; y < image.height; ++y) {
+        const unsigned char* src = image.pixels.data() + static_cast<size_t>(y) * image.rowPitch;
+        float* dst = rgba.data() + static_cast<size_t>(y) * image.width * 4;
+        for (unsigned int i = 0; i < image.width * 4; ++i) {
+            dst[i] = (i & 3) == 3 ? src[i] / 255.0f : table[src[i]];
+        }
+    }
+}
+
+void
+EnvironmentPrefilter::toFaces(const CubeImage& cube, bool srgb, ImageLevel faces[CUBE_FACE_COUNT]) {
+    for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+        ImageLevel& face = faces[f];
+        face.width = face.height = cube.size;
+        face.rowPitch = cube.size * 4;
+        face.pixels.resize(static_cast<size_t>(face.rowPitch) * cube.size);
+        const float* src = cube.face(f);
+        for (size_t i = 0; i < face.pixels.size(); ++i) {
+            float value = (std::min)((std::max)(src[i], 0.0f), 1.0f);
+            if (srgb && (i & 3) != 3) {
+                value = linearToSrgb(value);
+            }
+            face.pixels[i] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+        }
+    }
+}
+
+bool
+EnvironmentPrefilter::specular(const CubeImage& source, const EnvironmentPrefilterOptions& options, std::vector<CubeImage>& mips) {
+    if (source.size == 0 || source.texels.empty()) {
+        return false;
+    }
+
+    // Cadena de mips de la fuente: cada muestra lee el nivel que cubre su angulo solido
+    std::vector<CubeImage> chain(1, source);
+    while (chain.back().size > 1) {
+        CubeImage next;
+        downsample(chain.back(), next);
+        chain.push_back(std::move(next));
+    }
+
+    const unsigned int size = (std::max)(1u, (std::min)(options.specularSize, source.size));
+    const unsigned int levelCount = (std::max)(1u, (std::min)(options.specularMips, MipGenerator::calcMipCount(size, size)));
+    const unsigned int sampleCount = (std::max)(4u, (options.sampleCount + 3) & ~3u);
+    mips.assign(levelCount, CubeImage());
+
+    std::vector<SampleSet> sets(levelCount);
+    unsigned int rows = 0;
+    for (unsigned int m = 0; m < levelCount; ++m) {
+        mips[m].size = (std::max)(1u, size >> m);
+        mips[m].texels.assign(static_cast<size_t>(CUBE_FACE_COUNT) * mips[m].size * mips[m].size * 4, 0.0f);
+        const float roughness = levelCount > 1 ? static_cast<float>(m) / (levelCount - 1) : 0.0f;
+        if (m > 0) {
+            buildSampleSet(roughness, sampleCount, source.size, sets[m]);
+        }
+        rows += CUBE_FACE_COUNT * mips[m].size;
+    }
+
+    // Una tarea por fila de cualquier cara y nivel: los niveles rugosos (pequenos) tambien se reparten
+    const float sourceLod0 = std::log2(static_cast<float>(source.size) / size);
+    parallelFor(rows, options.threadCount, [&](unsigned int row) {
+        unsigned int m = 0;
+        while (row >= CUBE_FACE_COUNT * mips[m].size) {
+            row -= CUBE_FACE_COUNT * mips[m].size;
+            ++m;
+        }
+        CubeImage& level = mips[m];
+        const unsigned int face = row / level.size;
+        const unsigned int y = row % level.size;
+        float* out = level.face(face) + static_cast<size_t>(y) * level.size * 4;
+        for (unsigned int x = 0; x < level.size; ++x, out += 4) {
+            float n[3];
+            texelDirection(face, x, y, level.size, n);
+            const float invLength = 1.0f / std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            n[0] *= invLength; n[1] *= invLength; n[2] *= invLength;
+            if (m == 0) {
+                // Rugosidad 0: reflejo perfecto, solo se reduce la fuente
+                sampleLod(chain, n[0], n[1], n[2], sourceLod0, out);
+                out[3] = 1.0f;
+            }
+            else {
+                integrateTexel(chain, sets[m], n, out);
+            }
+        }
+        });
+    return true;
+}
+
+bool
+EnvironmentPrefilter::irradiance(const CubeImage& source, float coefficients[9][4], unsigned int threadCount) {
+    std::memset(coefficients, 0, sizeof(float) * 9 * 4);
+    if (source.size == 0 || source.texels.empty()) {
+        return false;
+    }
+
+    // La irradiancia es de baja frecuencia: basta con un nivel de 64 o menos
+    const CubeImage* image = &source;
+    CubeImage reduced;
+    while (image->size > 64) {
+        CubeImage next;
+        downsample(*image, next);
+        reduced = std::move(next);
+        image = &reduced;
+    }
+
+    // Cada cara acumula por separado y se suman al final
+    double partial[CUBE_FACE_COUNT][9][3] = {};
+    double weights[CUBE_FACE_COUNT] = {};
+    parallelFor(CUBE_FACE_COUNT, threadCount, [&](unsigned int face) {
+        const float* texels = image->face(face);
+        const unsigned int size = image->size;
+        for (unsigned int y = 0; y < size; ++y) {
+            for (unsigned int x = 0; x < size; ++x) {
+                float dir[3];
+                texelDirection(face, x, y, size, dir);
+                const float lengthSquared = dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2];
+                const float invLength = 1.0f / std::sqrt(lengthSquared);
+                const float nx = dir[0] * invLength, ny = dir[1] * invLength, nz = dir[2] * invLength;
+
+                // Angulo solido del texel: (2 / size)^2 / (1 + u^2 + v^2)^(3/2)
+                const float solidAngle = 4.0f / (size * size * lengthSquared * std::sqrt(lengthSquared));
+                const float basis[9] = {
+                    0.282095f,
+                    0.488603f * ny, 0.488603f * nz, 0.488603f * nx,
+                    1.092548f * nx * ny, 1.092548f * ny * nz, 0.315392f * (3.0f * nz * nz - 1.0f),
+                    1.092548f * nx * nz, 0.546274f * (nx * nx - ny * ny)
+                };
+                const float* color = texels + (static_cast<size_t>(y) * size + x) * 4;
+                for (int i = 0; i < 9; ++i) {
+                    for (int c = 0; c < 3; ++c) {
+                        partial[face][i][c] += color[c] * basis[i] * solidAngle;
+                    }
+                }
+                weights[face] += solidAngle;
+            }
+        }
+        });
+
+    double totalWeight = 0.0;
+    for (double weight : weights) {
+        totalWeight += weight;
+    }
+    // Convolucion con el coseno (pi, 2pi/3, pi/4 por banda) y division por pi
+    const double band[9] = { 1.0, 2.0 / 3.0, 2.0 / 3.0, 2.0 / 3.0, 0.25, 0.25, 0.25, 0.25, 0.25 };
+    const double normalize = 4.0 * kPi / totalWeight;
+    for (int i = 0; i < 9; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            double sum = 0.0;
+            for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+                sum += partial[f][i][c];
+            }
+            coefficients[i][c] = static_cast<float>(sum * normalize * band[i]);
+        }
+    }
+    return true;
+}
+
+void
+EnvironmentPrefilter::brdfLut(unsigned int size, unsigned int sampleCount, std::vector<float>& lut, unsigned int threadCount) {
+    lut.assign(static_cast<size_t>(size) * size * 2, 0.0f);
+    if (size == 0 || sampleCount == 0) {
+        return;
+    }
+    parallelFor(size, threadCount, [&](unsigned int y) {
+        const float roughness = (y + 0.5f) / size;
+        const float alpha = roughness * roughness;
+        for (unsigned int x = 0; x < size; ++x) {
+            const float nDotV = (x + 0.5f) / size;
+            const float v[3] = { std::sqrt(1.0f - nDotV * nDotV), 0.0f, nDotV };
+            float scale = 0.0f, bias = 0.0f;
+            for (unsigned int i = 0; i < sampleCount; ++i) {
+                float e1, e2, h[3];
+                hammersley(i, sampleCount, e1, e2);
+                importanceSampleGgx(e1, e2, alpha, h);
+                const float vDotH = v[0] * h[0] + v[1] * h[1] + v[2] * h[2];
+                const float nDotL = 2.0f * vDotH * h[2] - v[2];
+                if (nDotL <= 0.0f) continue;
+                const float nDotH = (std::max)(h[2], 0.0f);
+                const float visibility = geometrySmith(nDotV, nDotL, roughness) * vDotH / (nDotH * nDotV);
+                const float fresnel = std::pow(1.0f - (std::max)(vDotH, 0.0f), 5.0f);
+                scale += (1.0f - fresnel) * visibility;
+                bias += fresnel * visibility;
+            }
+            float* out = &lut[(static_cast<size_t>(y) * size + x) * 2];
+            out[0] = scale / sampleCount;
+            out[1] = bias / sampleCount;
+        }
+        });
+}
@@ -0,0 +1,260 @@
+#include "GeometryPool.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include "MeshComponent.h"
+#include "UploadManager.h"
+#include <algorithm>
+
+GeometryPool::~GeometryPool() {
+    destroy();
+}
+
+HRESULT
+GeometryPool::init(Device& device, const GeometryPoolOptions& options) {
+    destroy();
+    if (!device.m_device) {
+        ERROR("GeometryPool", "init", "Device is null.");
+        return E_POINTER;
+    }
+    if (options.vertexCapacity == 0 || options.indexCapacity == 0) {
+        ERROR("GeometryPool", "init", "Capacity is zero");
+        return E_INVALIDARG;
+    }
+    m_device = &device;
+    m_options = options;
+
+    HRESULT hr = createBuffer(options.vertexCapacity * sizeof(SimpleVertex), D3D11_BIND_VERTEX_BUFFER, &m_vertexBuffer);
+    if (SUCCEEDED(hr)) {
+        hr = createBuffer(options.indexCapacity * sizeof(unsigned int), D3D11_BIND_INDEX_BUFFER, &m_indexBuffer);
+    }
+    if (FAILED(hr)) {
+        ERROR("GeometryPool", "init", "Failed to create shared geometry buffers");
+        destroy();
+        return hr;
+    }
+    m_vertexRanges.init(options.vertexCapacity);
+    m_indexRanges.init(options.indexCapacity);
+    return S_OK;
+}
+
+HRESULT
+GeometryPool::add(DeviceContext& deviceContext,
+    const std::vector<SimpleVertex>& vertex,
+    const std::vector<unsigned int>& index,
+    unsigned int& meshId) {
+    if (!m_vertexBuffer || !m_indexBuffer) {
+        ERROR("GeometryPool", "add", "Pool is not initialized.");
+        return E_POINTER;
+    }
+    if (vertex.empty() || index.empty()) {
+        ERROR("GeometryPool", "add", "Mesh has no vertices or indices");
+        return E_INVALIDARG;
+    }
+
+    const size_t vertexCount = vertex.size();
+    const size_t indexCount = index.size();
+    size_t vertexOffset = 0, indexOffset = 0;
+    auto allocate = [&]() {
+        if (!m_vertexRanges.allocate(vertexCount, vertexOffset)) {
+            return false;
+        }
+        if (!m_indexRanges.allocate(indexCount, indexOffset)) {
+            m_vertexRanges.free(vertexOffset, vertexCount);
+            return false;
+        }
+        return true;
+    };
+
+    bool allocated = allocate();
+    // Hay sitio pero fragmentado: compactar y reintentar
+    if (!allocated && m_vertexRanges.freeSpace() >= vertexCount && m_indexRanges.freeSpace() >= indexCount &&
+        SUCCEEDED(defragment(deviceContext))) {
+        allocated = allocate();
+    }
+    if (!allocated) {
+        ++m_failures;
+        ERROR("GeometryPool", "add", "Mesh does not fit in the geometry pool");
+        return E_OUTOFMEMORY;
+    }
+
+    if (m_freeIds.empty()) {
+        meshId = static_cast<unsigned int>(m_meshes.size());
+        m_meshes.push_back(Mesh());
+    }
+    else {
+        meshId = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+    Mesh& mesh = m_meshes[meshId];
+    mesh.live = true;
+    mesh.range.baseVertex = static_cast<unsigned int>(vertexOffset);
+    mesh.range.vertexCount = static_cast<unsigned int>(vertexCount);
+    mesh.range.startIndex = static_cast<unsigned int>(indexOffset);
+    mesh.range.indexCount = static_cast<unsigned int>(indexCount);
+
+    upload(deviceContext, m_vertexBuffer, mesh.range.baseVertex * sizeof(SimpleVertex),
+        vertex.data(), mesh.range.vertexCount * sizeof(SimpleVertex));
+    upload(deviceContext, m_indexBuffer, mesh.range.startIndex * sizeof(unsigned int),
+        index.data(), mesh.range.indexCount * sizeof(unsigned int));
+    return S_OK;
+}
+
+HRESULT
+GeometryPool::add(DeviceContext& deviceContext, const MeshComponent& mesh, unsigned int& meshId) {
+    return add(deviceContext, mesh.m_vertex, mesh.m_index, meshId);
+}
+
+void
+GeometryPool::remove(unsigned int meshId) {
+    if (meshId >= m_meshes.size() || !m_meshes[meshId].live) {
+        return;
+    }
+    Mesh& mesh = m_meshes[meshId];
+    m_vertexRanges.free(mesh.range.baseVertex, mesh.range.vertexCount);
+    m_indexRanges.free(mesh.range.startIndex, mesh.range.indexCount);
+    mesh = Mesh();
+    m_freeIds.push_back(meshId);
+}
+
+HRESULT
+GeometryPool::defragment(DeviceContext& deviceContext) {
+    if (!m_device || !m_vertexBuffer || !m_indexBuffer) {
+        ERROR("GeometryPool", "defragment", "Pool is not initialized.");
+        return E_POINTER;
+    }
+    // Las subidas pendientes apuntan a los buffers actuales: deben llegar antes de copiarlos
+    if (m_uploadManager) {
+        m_uploadManager->flush(deviceContext);
+    }
+
+    ID3D11Buffer* vertexBuffer = nullptr;
+    ID3D11Buffer* indexBuffer = nullptr;
+    HRESULT hr = createBuffer(m_options.vertexCapacity * sizeof(SimpleVertex), D3D11_BIND_VERTEX_BUFFER, &vertexBuffer);
+    if (SUCCEEDED(hr)) {
+        hr = createBuffer(m_options.indexCapacity * sizeof(unsigned int), D3D11_BIND_INDEX_BUFFER, &indexBuffer);
+    }
+    if (FAILED(hr)) {
+        ERROR("GeometryPool", "defragment", "Failed to create compacted buffers");
+        SAFE_RELEASE(vertexBuffer);
+        SAFE_RELEASE(indexBuffer);
+        return hr;
+    }
+
+    // Se conserva el orden de los vertices para que las copias sigan siendo secuenciales
+    std::vector<unsigned int> live;
+    for (unsigned int id = 0; id < m_meshes.size(); ++id) {
+        if (m_meshes[id].live) {
+            live.push_back(id);
+        }
+    }
+    std::sort(live.begin(), live.end(), [this](unsigned int a, unsigned int b) {
+        return m_meshes[a].range.baseVertex < m_meshes[b].range.baseVertex;
+        });
+
+    m_vertexRanges.init(m_options.vertexCapacity);
+    m_indexRanges.init(m_options.indexCapacity);
+    for (unsigned int id : live) {
+        GeometryRange& range = m_meshes[id].range;
+        size_t vertexOffset = 0, indexOffset = 0;
+        m_vertexRanges.allocate(range.vertexCount, vertexOffset);
+        m_indexRanges.allocate(range.indexCount, indexOffset);
+
+        // Buffers distintos: las regiones de origen y destino nunca se solapan
+        D3D11_BOX box = {};
+        box.left = range.baseVertex * sizeof(SimpleVertex);
+        box.right = box.left + range.vertexCount * sizeof(SimpleVertex);
+        box.bottom = 1;
+        box.back = 1;
+        deviceContext.CopySubresourceRegion(vertexBuffer, 0, static_cast<unsigned int>(vertexOffset * sizeof(SimpleVertex)),
+            0, 0, m_vertexBuffer, 0, &box);
+        box.left = range.startIndex * sizeof(unsigned int);
+        box.right = box.left + range.indexCount * sizeof(unsigned int);
+        deviceContext.CopySubresourceRegion(indexBuffer, 0, static_cast<unsigned int>(indexOffset * sizeof(unsigned int)),
+            0, 0, m_indexBuffer, 0, &box);
+
+        range.baseVertex = static_cast<unsigned int>(vertexOffset);
+        range.startIndex = static_cast<unsigned int>(indexOffset);
+    }
+
+    SAFE_RELEASE(m_vertexBuffer);
+    SAFE_RELEASE(m_indexBuffer);
+    m_vertexBuffer = vertexBuffer;
+    m_indexBuffer = indexBuffer;
+    ++m_defragmentations;
+    return S_OK;
+}
+
+void
+GeometryPool::bind(DeviceContext& deviceContext) {
+    if (!m_vertexBuffer || !m_indexBuffer) {
+        ERROR("GeometryPool", "bind", "Pool is not initialized.");
+        return;
+    }
+    const unsigned int stride = sizeof(SimpleVertex);
+    const unsigned int offset = 0;
+    deviceContext.IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
+    deviceContext.IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+}
+
+void
+GeometryPool::draw(DeviceContext& deviceContext, unsigned int meshId) {
+    if (meshId >= m_meshes.size() || !m_meshes[meshId].live) {
+        ERROR("GeometryPool", "draw", "Invalid mesh id");
+        return;
+    }
+    const GeometryRange& range = m_meshes[meshId].range;
+    deviceContext.DrawIndexed(range.indexCount, range.startIndex, static_cast<INT>(range.baseVertex));
+}
+
+GeometryPoolStats
+GeometryPool::stats() const {
+    GeometryPoolStats stats;
+    stats.meshes = static_cast<unsigned int>(m_meshes.size() - m_freeIds.size());
+    stats.vertexUsed = m_vertexRanges.capacity() - m_vertexRanges.freeSpace();
+    stats.indexUsed = m_indexRanges.capacity() - m_indexRanges.freeSpace();
+    stats.vertexFreeBlocks = m_vertexRanges.freeBlocks();
+    stats.indexFreeBlocks = m_indexRanges.freeBlocks();
+    stats.defragmentations = m_defragmentations;
+    stats.failures = m_failures;
+    return stats;
+}
+
+void
+GeometryPool::destroy() {
+    SAFE_RELEASE(m_vertexBuffer);
+    SAFE_RELEASE(m_indexBuffer);
+    m_vertexRanges.init(0);
+    m_indexRanges.init(0);
+    m_meshes.clear();
+    m_freeIds.clear();
+    m_device = nullptr;
+    m_defragmentations = 0;
+    m_failures = 0;
+}
+
+HRESULT
+GeometryPool::createBuffer(unsigned int byteWidth, unsigned int bindFlags, ID3D11Buffer** buffer) {
+    D3D11_BUFFER_DESC desc = {};
+    desc.ByteWidth = byteWidth;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = bindFlags;
+    return m_device->CreateBuffer(&desc, nullptr, buffer);
+}
+
+void
+GeometryPool::upload(DeviceContext& deviceContext,
+    ID3D11Buffer* buffer,
+    unsigned int offset,
+    const void* data,
+    unsigned int size) {
+    if (m_uploadManager) {
+        m_uploadManager->uploadBuffer(deviceContext, buffer, offset, data, size);
+        return;
+    }
+    D3D11_BOX box = {};
+    box.left = offset;
+    box.right = offset + size;
+    box.bottom = 1;
+    box.back = 1;
+    deviceContext.UpdateSubresource(buffer, 0, &box, data, size, 0);
+}
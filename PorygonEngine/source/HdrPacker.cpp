@@ -0,0 +1,187 @@
+#include "HdrPacker.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const float kMaxHalf = 65504.0f;
+    const float kMaxRgb9e5 = 65408.0f;  // (2^9 - 1) / 2^9 * 2^16
+    const int kRgb9e5Bias = 15;
+    const int kRgb9e5MantissaBits = 9;
+
+    uint32_t floatBits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    float bitsFloat(uint32_t bits) {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    uint16_t floatToHalf(float value) {
+        const uint32_t bits = floatBits(value);
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+        if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+            return static_cast<uint16_t>(sign | 0x7E00u);
+        }
+        const uint32_t abs = floatBits((std::min)(bitsFloat(bits & 0x7FFFFFFFu), kMaxHalf));
+        if (abs < 0x38800000u) {
+            // Subnormal: la suma alinea la mantisa y redondea como la FPU
+            return static_cast<uint16_t>(sign | (floatBits(bitsFloat(abs) + 0.5f) - 0x3F000000u));
+        }
+        // Normal: rebase del exponente y redondeo al par con el bit 13
+        const uint32_t odd = (abs >> 13) & 1u;
+        return static_cast<uint16_t>(sign | ((abs + 0xFFFu + odd - 0x38000000u) >> 13));
+    }
+
+    float halfToFloat(uint16_t half) {
+        const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+        const uint32_t exponent = (half >> 10) & 0x1Fu;
+        const uint32_t mantissa = half & 0x3FFu;
+        if (exponent == 0) {
+            const float value = mantissa * (1.0f / 16777216.0f); // 2^-24
+            return sign ? -value : value;
+        }
+        if (exponent == 31) {
+            return bitsFloat(sign | 0x7F800000u | (mantissa << 13));
+        }
+        return bitsFloat(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+    }
+
+    uint32_t packTexelRgb9e5(const float* rgba) {
+        float c[3];
+        for (int i = 0; i < 3; ++i) {
+            // max(x, 0) devuelve 0 con NaN, igual que _mm_max_ps(x, 0)
+            c[i] = (std::min)(rgba[i] > 0.0f ? rgba[i] : 0.0f, kMaxRgb9e5);
+        }
+        const float maxComponent = (std::max)(c[0], (std::max)(c[1], c[2]));
+
+        // floor(log2(max)) desde los bits del exponente, al menos -16
+        const int floorLog2 = (std::max)(-kRgb9e5Bias - 1, static_cast<int>(floatBits(maxComponent) >> 23) - 127);
+        int exponent = floorLog2 + 1 + kRgb9e5Bias;
+        float scale = bitsFloat(static_cast<uint32_t>(127 + kRgb9e5Bias + kRgb9e5MantissaBits - exponent) << 23);
+        if (static_cast<int>(maxComponent * scale + 0.5f) == (1 << kRgb9e5MantissaBits)) {
+            ++exponent;
+            scale *= 0.5f;
+        }
+        const uint32_t r = static_cast<uint32_t>(c[0] * scale + 0.5f);
+        const uint32_t g = static_cast<uint32_t>(c[1] * scale + 0.5f);
+        const uint32_t b = static_cast<uint32_t>(c[2] * scale + 0.5f);
+        return r | (g << 9) | (b << 18) | (static_cast<uint32_t>(exponent) << 27);
+    }
+}
+
+void
+HdrPacker::packRgb9e5(const float* rgba, size_t count, uint32_t* packed) {
+    size_t i = 0;
+#if PORYGON_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxValue = _mm_set1_ps(kMaxRgb9e5);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128i minLog2 = _mm_set1_epi32(-kRgb9e5Bias - 1);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i scaleBase = _mm_set1_epi32(127 + kRgb9e5Bias + kRgb9e5MantissaBits);
+    const __m128i overflow = _mm_set1_epi32(1 << kRgb9e5MantissaBits);
+    for (; i + 4 <= count; i += 4) {
+        // Cuatro texeles a la vez: se trasponen a vectores R, G, B
+        __m128 r = _mm_loadu_ps(rgba + i * 4);
+        __m128 g = _mm_loadu_ps(rgba + i * 4 + 4);
+        __m128 b = _mm_loadu_ps(rgba + i * 4 + 8);
+        __m128 a = _mm_loadu_ps(rgba + i * 4 + 12);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+        r = _mm_min_ps(_mm_max_ps(r, zero), maxValue);
+        g = _mm_min_ps(_mm_max_ps(g, zero), maxValue);
+        b = _mm_min_ps(_mm_max_ps(b, zero), maxValue);
+        const __m128 maxComponent = _mm_max_ps(r, _mm_max_ps(g, b));
+
+        __m128i floorLog2 = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(maxComponent), 23), _mm_set1_epi32(127));
+        const __m128i belowMin = _mm_cmplt_epi32(floorLog2, minLog2);
+        floorLog2 = _mm_or_si128(_mm_and_si128(belowMin, minLog2), _mm_andnot_si128(belowMin, floorLog2));
+        __m128i exponent = _mm_add_epi32(floorLog2, _mm_set1_epi32(1 + kRgb9e5Bias));
+        __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(scaleBase, exponent), 23));
+
+        // Si el maximo redondea a 512 se sube el exponente
+        const __m128i maxMantissa = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(maxComponent, scale), half));
+        const __m128i bump = _mm_cmpeq_epi32(maxMantissa, overflow);
+        exponent = _mm_add_epi32(exponent, _mm_and_si128(bump, one));
+        scale = _mm_mul_ps(scale, _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(bump), half),
+            _mm_andnot_ps(_mm_castsi128_ps(bump), _mm_set1_ps(1.0f))));
+
+        const __m128i rm = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(r, scale), half));
+        const __m128i gm = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(g, scale), half));
+        const __m128i bm = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(b, scale), half));
+        const __m128i result = _mm_or_si128(_mm_or_si128(rm, _mm_slli_epi32(gm, 9)),
+            _mm_or_si128(_mm_slli_epi32(bm, 18), _mm_slli_epi32(exponent, 27)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i), result);
+    }
+#endif
+    for (; i < count; ++i) {
+        packed[i] = packTexelRgb9e5(rgba + i * 4);
+    }
+}
+
+void
+HdrPacker::unpackRgb9e5(const uint32_t* packed, size_t count, float* rgba) {
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t value = packed[i];
+        const int exponent = static_cast<int>(value >> 27);
+        const float scale = bitsFloat(static_cast<uint32_t>(127 + exponent - kRgb9e5Bias - kRgb9e5MantissaBits) << 23);
+        rgba[i * 4 + 0] = (value & 0x1FFu) * scale;
+        rgba[i * 4 + 1] = ((value >> 9) & 0x1FFu) * scale;
+        rgba[i * 4 + 2] = ((value >> 18) & 0x1FFu) * scale;
+        rgba[i * 4 + 3] = 1.0f;
+    }
+}
+
+void
+HdrPacker::packHalf(const float* values, size_t count, uint16_t* halves) {
+    size_t i = 0;
+#if PORYGON_SSE2
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 maxHalf = _mm_set1_ps(kMaxHalf);
+    const __m128i minNormal = _mm_set1_epi32(0x38800000);
+    const __m128 subnormalMagic = _mm_set1_ps(0.5f);
+    const __m128i normalBias = _mm_set1_epi32(0xFFF - 0x38000000);
+    const __m128i nanHalf = _mm_set1_epi32(0x7E00);
+    for (; i + 8 <= count; i += 8) {
+        __m128i packed[2];
+        for (int half = 0; half < 2; ++half) {
+            const __m128 value = _mm_loadu_ps(values + i + half * 4);
+            const __m128 sign = _mm_and_ps(value, signMask);
+            const __m128 abs = _mm_xor_ps(value, sign);
+            const __m128 isNan = _mm_cmpunord_ps(abs, abs);
+            const __m128i clamped = _mm_castps_si128(_mm_min_ps(abs, maxHalf));
+
+            // Subnormal: la suma alinea la mantisa y redondea
+            const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(clamped), subnormalMagic)),
+                _mm_castps_si128(subnormalMagic));
+            // Normal: rebase del exponente y redondeo al par con el bit 13
+            const __m128i odd = _mm_and_si128(_mm_srli_epi32(clamped, 13), _mm_set1_epi32(1));
+            const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(clamped, normalBias), odd), 13);
+
+            const __m128i isSubnormal = _mm_cmplt_epi32(clamped, minNormal);
+            __m128i result = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+            result = _mm_or_si128(_mm_and_si128(_mm_castps_si128(isNan), nanHalf),
+                _mm_andnot_si128(_mm_castps_si128(isNan), result));
+            packed[half] = _mm_or_si128(result, _mm_srli_epi32(_mm_castps_si128(sign), 16));
+        }
+        // Los resultados caben en 16 bits sin signo: se empaquetan con signo tras centrar en 0
+        const __m128i bias = _mm_set1_epi32(0x8000);
+        const __m128i narrow = _mm_packs_epi32(_mm_sub_epi32(packed[0], bias), _mm_sub_epi32(packed[1], bias));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(halves + i), _mm_add_epi16(narrow, _mm_set1_epi16(static_cast<short>(0x8000))));
+    }
+#endif
+    for (; i < count; ++i) {
+        halves[i] = floatToHalf(values[i]);
+    }
+}
+
+void
+HdrPacker::unpackHalf(const uint16_t* halves, size_t count, float* values) {
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = halfToFloat(halves[i]);
+    }
+}
@@ -0,0 +1,452 @@
+#include "JpegDecoder.h"
+#include "TextureCache.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Copia privada de stb_image limitada a JPEG: da acceso a sus estructuras y
+// kernels internos sin chocar con la implementacion publica de Texture.cpp.
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_JPEG
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4505) // funciones estaticas de stb_image sin usar
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+#include "stb_image.h"
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+    /**
+     * @brief Reparte [0, count) en tramos contiguos entre hilos.
+     *
+     * El hilo que llama tambien trabaja. Cada tramo se entrega completo a
+     * `work(begin, end)` para que pueda preparar su estado una sola vez.
+     */
+    template <typename Work>
+    void parallelFor(unsigned int count, unsigned int threadCount, Work work) {
+        if (count == 0) return;
+        threadCount = (std::min)(threadCount, count);
+        if (threadCount <= 1) {
+            work(0u, count);
+            return;
+        }
+
+        const unsigned int chunkCount = (std::min)(count, threadCount * 4);
+        std::atomic<unsigned int> nextChunk(0);
+        auto worker = [&]() {
+            for (unsigned int chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+                const unsigned int begin = static_cast<unsigned int>(static_cast<unsigned long long>(count) * chunk / chunkCount);
+                const unsigned int end = static_cast<unsigned int>(static_cast<unsigned long long>(count) * (chunk + 1) / chunkCount);
+                work(begin, end);
+            }
+            };
+
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Localiza los intervalos de reinicio de un escaneo.
+     *
+     * `starts` recibe el primer byte de cada intervalo y `scanEnd` el 0xFF del
+     * marcador que cierra el escaneo (o el final del archivo si esta truncado).
+     */
+    void findRestartSegments(const stbi_uc* begin, const stbi_uc* limit,
+        std::vector<const stbi_uc*>& starts, const stbi_uc*& scanEnd) {
+        starts.assign(1, begin);
+        const stbi_uc* p = begin;
+        while (p < limit) {
+            p = static_cast<const stbi_uc*>(std::memchr(p, 0xFF, static_cast<size_t>(limit - p)));
+            if (!p || p + 1 >= limit) break;
+            const stbi_uc next = p[1];
+            if (next == 0x00) {      // 0xFF de datos con su cero de relleno
+                p += 2;
+            }
+            else if (next == 0xFF) { // bytes de relleno antes de un marcador
+                ++p;
+            }
+            else if (STBI__RESTART(next)) {
+                p += 2;
+                starts.push_back(p);
+            }
+            else {
+                scanEnd = p;
+                return;
+            }
+        }
+        scanEnd = limit;
+    }
+
+    /**
+     * @brief MCUs del escaneo actual; en un escaneo de un solo componente cada bloque es una MCU.
+     */
+    int scanMcuCount(const stbi__jpeg* z) {
+        if (z->scan_n == 1) {
+            const int n = z->order[0];
+            return ((z->img_comp[n].x + 7) >> 3) * ((z->img_comp[n].y + 7) >> 3);
+        }
+        return z->img_mcu_x * z->img_mcu_y;
+    }
+
+    /**
+     * @brief Decodifica las MCUs [first, last) de un escaneo baseline.
+     *
+     * Es el bucle de stbi__parse_entropy_coded_data sin la cuenta de reinicios:
+     * quien llama ya coloco el lector al principio de un intervalo.
+     */
+    bool decodeMcuRange(stbi__jpeg* z, int first, int last) {
+        STBI_SIMD_ALIGN(short, data[64]);
+        if (z->scan_n == 1) {
+            const int n = z->order[0];
+            const int blocksX = (z->img_comp[n].x + 7) >> 3;
+            const int ha = z->img_comp[n].ha;
+            for (int block = first; block < last; ++block) {
+                const int i = block % blocksX;
+                const int j = block / blocksX;
+                if (!stbi__jpeg_decode_block(z, data, z->huff_dc + z->img_comp[n].hd, z->huff_ac + ha,
+                    z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) {
+                    return false;
+                }
+                z->idct_block_kernel(z->img_comp[n].data + z->img_comp[n].w2 * j * 8 + i * 8, z->img_comp[n].w2, data);
+            }
+            return true;
+        }
+
+        for (int mcu = first; mcu < last; ++mcu) {
+            const int i = mcu % z->img_mcu_x;
+            const int j = mcu / z->img_mcu_x;
+            for (int k = 0; k < z->scan_n; ++k) {
+                const int n = z->order[k];
+                for (int y = 0; y < z->img_comp[n].v; ++y) {
+                    for (int x = 0; x < z->img_comp[n].h; ++x) {
+                        const int x2 = (i * z->img_comp[n].h + x) * 8;
+                        const int y2 = (j * z->img_comp[n].v + y) * 8;
+                        const int ha = z->img_comp[n].ha;
+                        if (!stbi__jpeg_decode_block(z, data, z->huff_dc + z->img_comp[n].hd, z->huff_ac + ha,
+                            z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) {
+                            return false;
+                        }
+                        z->idct_block_kernel(z->img_comp[n].data + z->img_comp[n].w2 * y2 + x2, z->img_comp[n].w2, data);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    enum
+        ScanResult {
+        SCAN_NOT_SPLIT = 0, /**< El escaneo no se puede repartir; el lector no se movio. */
+        SCAN_DECODED = 1,   /**< Decodificado en paralelo; el lector queda tras el escaneo. */
+        SCAN_FAILED = 2     /**< Datos corruptos. */
+    };
+
+    /**
+     * @brief Decodifica el escaneo actual repartiendo sus intervalos de reinicio entre hilos.
+     */
+    ScanResult decodeScanParallel(stbi__jpeg* z, unsigned int threadCount, unsigned int& segmentCount) {
+        segmentCount = 0;
+        if (threadCount < 2 || z->progressive || z->restart_interval <= 0 ||
+            z->marker != STBI__MARKER_none) {
+            return SCAN_NOT_SPLIT;
+        }
+
+        std::vector<const stbi_uc*> starts;
+        const stbi_uc* scanEnd = nullptr;
+        findRestartSegments(z->s->img_buffer, z->s->img_buffer_end, starts, scanEnd);
+
+        // Si los marcadores no cuadran con las MCUs, stb_image sabe degradarse mejor
+        const int totalMcus = scanMcuCount(z);
+        const int interval = z->restart_interval;
+        const size_t expected = static_cast<size_t>((totalMcus + interval - 1) / interval);
+        if (expected < 2 || starts.size() != expected) {
+            return SCAN_NOT_SPLIT;
+        }
+
+        std::atomic<bool> failed(false);
+        parallelFor(static_cast<unsigned int>(expected), threadCount,
+            [&](unsigned int begin, unsigned int end) {
+                // Cada tramo lleva su propio lector y estado de entropia;
+                // los bloques de salida de cada MCU no se solapan
+                stbi__context context;
+                std::unique_ptr<stbi__jpeg> local(new stbi__jpeg(*z));
+                local->s = &context;
+                for (unsigned int segment = begin; segment < end && !failed; ++segment) {
+                    const stbi_uc* segmentEnd = segment + 1 < expected ? starts[segment + 1] : scanEnd;
+                    stbi__start_mem(&context, starts[segment], static_cast<int>(segmentEnd - starts[segment]));
+                    stbi__jpeg_reset(local.get());
+                    const int first = static_cast<int>(segment) * interval;
+                    if (!decodeMcuRange(local.get(), first, (std::min)(first + interval, totalMcus))) {
+                        failed = true;
+                    }
+                }
+            });
+        if (failed) {
+            stbi__err("bad huffman", "Corrupt JPEG");
+            return SCAN_FAILED;
+        }
+
+        z->s->img_buffer = const_cast<stbi_uc*>(scanEnd);
+        z->marker = STBI__MARKER_none;
+        segmentCount = static_cast<unsigned int>(expected);
+        return SCAN_DECODED;
+    }
+
+    /**
+     * @brief stbi__decode_jpeg_image con los escaneos baseline repartidos entre hilos.
+     */
+    bool decodeComponents(stbi__jpeg* z, unsigned int& threadCount, JpegDecodeInfo& info) {
+        for (int m = 0; m < 4; ++m) {
+            z->img_comp[m].raw_data = NULL;
+            z->img_comp[m].raw_coeff = NULL;
+        }
+        z->restart_interval = 0;
+        if (!stbi__decode_jpeg_header(z, STBI__SCAN_load)) return false;
+        info.progressive = z->progressive != 0;
+
+        // Con imagenes pequenas arrancar hilos cuesta mas de lo que ahorra
+        const unsigned int pixelsPerThread = 64 * 1024;
+        threadCount = (std::min)(threadCount, (std::max)(1u, z->s->img_x * z->s->img_y / pixelsPerThread));
+        info.threads = threadCount;
+
+        int m = stbi__get_marker(z);
+        while (!stbi__EOI(m)) {
+            if (stbi__SOS(m)) {
+                if (!stbi__process_scan_header(z)) return false;
+                info.restartInterval = (std::max)(info.restartInterval, static_cast<unsigned int>(z->restart_interval));
+
+                unsigned int segments = 0;
+                const ScanResult result = decodeScanParallel(z, threadCount, segments);
+                if (result == SCAN_FAILED) return false;
+                if (result == SCAN_NOT_SPLIT && !stbi__parse_entropy_coded_data(z)) return false;
+                info.segments += segments;
+
+                if (z->marker == STBI__MARKER_none) {
+                    z->marker = stbi__skip_jpeg_junk_at_end(z);
+                }
+                m = stbi__get_marker(z);
+                if (STBI__RESTART(m)) {
+                    m = stbi__get_marker(z);
+                }
+            }
+            else if (stbi__DNL(m)) {
+                const int length = stbi__get16be(z->s);
+                const stbi__uint32 lines = stbi__get16be(z->s);
+                if (length != 4) return stbi__err("bad DNL len", "Corrupt JPEG") != 0;
+                if (lines != z->s->img_y) return stbi__err("bad DNL height", "Corrupt JPEG") != 0;
+                m = stbi__get_marker(z);
+            }
+            else {
+                if (!stbi__process_marker(z, m)) return true;
+                m = stbi__get_marker(z);
+            }
+        }
+        if (z->progressive) {
+            stbi__jpeg_finish(z);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Convierte una fila sobremuestreada a RGBA8 (rama n == 4 de load_jpeg_image).
+     */
+    void convertRow(stbi__jpeg* z, stbi_uc* const* coutput, bool isRgb, stbi_uc* out) {
+        const unsigned int width = z->s->img_x;
+        if (z->s->img_n == 3) {
+            if (isRgb) {
+                for (unsigned int i = 0; i < width; ++i, out += 4) {
+                    out[0] = coutput[0][i];
+                    out[1] = coutput[1][i];
+                    out[2] = coutput[2][i];
+                    out[3] = 255;
+                }
+            }
+            else {
+                z->YCbCr_to_RGB_kernel(out, coutput[0], coutput[1], coutput[2], width, 4);
+            }
+        }
+        else if (z->s->img_n == 4) {
+            if (z->app14_color_transform == 0) { // CMYK
+                for (unsigned int i = 0; i < width; ++i, out += 4) {
+                    const stbi_uc k = coutput[3][i];
+                    out[0] = stbi__blinn_8x8(coutput[0][i], k);
+                    out[1] = stbi__blinn_8x8(coutput[1][i], k);
+                    out[2] = stbi__blinn_8x8(coutput[2][i], k);
+                    out[3] = 255;
+                }
+            }
+            else if (z->app14_color_transform == 2) { // YCCK
+                z->YCbCr_to_RGB_kernel(out, coutput[0], coutput[1], coutput[2], width, 4);
+                for (unsigned int i = 0; i < width; ++i, out += 4) {
+                    const stbi_uc k = coutput[3][i];
+                    out[0] = stbi__blinn_8x8(255 - out[0], k);
+                    out[1] = stbi__blinn_8x8(255 - out[1], k);
+                    out[2] = stbi__blinn_8x8(255 - out[2], k);
+                }
+            }
+            else { // YCbCr + canal extra: se ignora como en stb_image
+                z->YCbCr_to_RGB_kernel(out, coutput[0], coutput[1], coutput[2], width, 4);
+            }
+        }
+        else {
+            for (unsigned int i = 0; i < width; ++i, out += 4) {
+                out[0] = out[1] = out[2] = coutput[0][i];
+                out[3] = 255;
+            }
+        }
+    }
+
+    /**
+     * @brief Avanza el estado de sobremuestreo una fila de salida, como load_jpeg_image.
+     */
+    void advanceResample(stbi__jpeg* z, int component, stbi__resample& r) {
+        if (++r.ystep >= r.vs) {
+            r.ystep = 0;
+            r.line0 = r.line1;
+            if (++r.ypos < z->img_comp[component].y) {
+                r.line1 += z->img_comp[component].w2;
+            }
+        }
+    }
+
+    /**
+     * @brief Sobremuestreo y conversion de color por bandas de filas en paralelo.
+     */
+    void convertImage(stbi__jpeg* z, unsigned int threadCount, ImageLevel& image) {
+        const int componentCount = z->s->img_n;
+        const bool isRgb = componentCount == 3 && (z->rgb == 3 || (z->app14_color_transform == 0 && !z->jfif));
+
+        stbi__resample initial[4];
+        for (int k = 0; k < componentCount; ++k) {
+            stbi__resample& r = initial[k];
+            r.hs = z->img_h_max / z->img_comp[k].h;
+            r.vs = z->img_v_max / z->img_comp[k].v;
+            r.ystep = r.vs >> 1;
+            r.w_lores = (z->s->img_x + r.hs - 1) / r.hs;
+            r.ypos = 0;
+            r.line0 = r.line1 = z->img_comp[k].data;
+
+            if (r.hs == 1 && r.vs == 1) r.resample = resample_row_1;
+            else if (r.hs == 1 && r.vs == 2) r.resample = stbi__resample_row_v_2;
+            else if (r.hs == 2 && r.vs == 1) r.resample = stbi__resample_row_h_2;
+            else if (r.hs == 2 && r.vs == 2) r.resample = z->resample_row_hv_2_kernel;
+            else r.resample = stbi__resample_row_generic;
+        }
+
+        image.width = z->s->img_x;
+        image.height = z->s->img_y;
+        image.rowPitch = image.width * 4;
+        image.pixels.resize(static_cast<size_t>(image.rowPitch) * image.height);
+
+        // Bandas de al menos 32 filas para que cada hilo amortice su arranque
+        const unsigned int bandRows = 32;
+        const unsigned int bandCount = (image.height + bandRows - 1) / bandRows;
+        parallelFor(bandCount, threadCount, [&](unsigned int firstBand, unsigned int lastBand) {
+            const unsigned int firstRow = firstBand * bandRows;
+            const unsigned int lastRow = (std::min)(lastBand * bandRows, image.height);
+
+            stbi__resample state[4];
+            std::vector<stbi_uc> lineBuffers[4];
+            for (int k = 0; k < componentCount; ++k) {
+                state[k] = initial[k];
+                for (unsigned int row = 0; row < firstRow; ++row) {
+                    advanceResample(z, k, state[k]);
+                }
+                // Margen para sobremuestrear fuera del borde con factor 4
+                lineBuffers[k].resize(static_cast<size_t>(image.width) + 3);
+            }
+
+            stbi_uc* coutput[4] = { NULL, NULL, NULL, NULL };
+            for (unsigned int row = firstRow; row < lastRow; ++row) {
+                for (int k = 0; k < componentCount; ++k) {
+                    stbi__resample& r = state[k];
+                    const int yBottom = r.ystep >= (r.vs >> 1);
+                    coutput[k] = r.resample(lineBuffers[k].data(),
+                        yBottom ? r.line1 : r.line0,
+                        yBottom ? r.line0 : r.line1,
+                        r.w_lores, r.hs);
+                    advanceResample(z, k, r);
+                }
+                convertRow(z, coutput, isRgb, &image.pixels[static_cast<size_t>(row) * image.rowPitch]);
+            }
+            });
+    }
+}
+
+bool
+JpegDecoder::decode(const unsigned char* data,
+    size_t size,
+    ImageLevel& image,
+    unsigned int& channels,
+    unsigned int threadCount,
+    JpegDecodeInfo* info) const {
+    if (!data || size == 0 || size > static_cast<size_t>(INT_MAX)) {
+        stbi__err("bad size", "Invalid JPEG buffer");
+        return false;
+    }
+    if (threadCount == 0) {
+        threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+    JpegDecodeInfo decodeInfo;
+
+    stbi__context context;
+    stbi__start_mem(&context, data, static_cast<int>(size));
+    std::unique_ptr<stbi__jpeg> z(new stbi__jpeg());
+    z->s = &context;
+    stbi__setup_jpeg(z.get());
+    context.img_n = 0; // Deja stbi__cleanup_jpeg seguro si falla la cabecera
+
+    bool decoded = decodeComponents(z.get(), threadCount, decodeInfo);
+    if (decoded && context.img_n <= 0) {
+        decoded = stbi__err("bad component count", "Corrupt JPEG") != 0;
+    }
+    if (decoded) {
+        convertImage(z.get(), threadCount, image);
+        channels = context.img_n >= 3 ? 3 : 1;
+    }
+    stbi__cleanup_jpeg(z.get());
+
+    if (info) {
+        *info = decodeInfo;
+    }
+    return decoded;
+}
+
+bool
+JpegDecoder::decodeFile(const std::string& fileName,
+    ImageLevel& image,
+    unsigned int& channels,
+    unsigned int threadCount,
+    JpegDecodeInfo* info) const {
+    MappedFile file;
+    if (!file.open(fileName)) {
+        stbi__err("can't fopen", "Unable to open file");
+        return false;
+    }
+    return decode(file.data(), file.size(), image, channels, threadCount, info);
+}
+
+const char*
+JpegDecoder::failureReason() {
+    return stbi_failure_reason();
+}
@@ -0,0 +1,212 @@
+#include "MeshInstancer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+    XMFLOAT3 sub(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+    float dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    float length(const XMFLOAT3& a) { return std::sqrt(dot(a, a)); }
+    XMFLOAT3 scale(const XMFLOAT3& a, float s) { return XMFLOAT3(a.x * s, a.y * s, a.z * s); }
+    XMFLOAT3 cross(const XMFLOAT3& a, const XMFLOAT3& b) {
+        return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+
+    /**
+     * @brief Mezcla un valor de 32 bits en un hash FNV-1a de 64 bits.
+     */
+    void hashCombine(unsigned long long& hash, unsigned int value) {
+        for (int i = 0; i < 4; ++i) {
+            hash ^= (value >> (i * 8)) & 0xFFu;
+            hash *= 1099511628211ull;
+        }
+    }
+
+    bool nearlyEqual(const XMFLOAT3& a, const XMFLOAT3& b, float epsilon) {
+        return std::fabs(a.x - b.x) <= epsilon && std::fabs(a.y - b.y) <= epsilon && std::fabs(a.z - b.z) <= epsilon;
+    }
+}
+
+InstancedModel
+MeshInstancer::build(const LoadData& data, float tolerance) {
+    InstancedModel model;
+    model.sourceVertexCount = data.vertex.size();
+    model.sourceIndexCount = data.index.size();
+
+    // Buckets de prototipos por hash de topologia; varios prototipos pueden compartir hash
+    std::unordered_map<unsigned long long, std::vector<unsigned int>> buckets;
+    std::vector<float> prototypeRadius;
+
+    for (const LoadObject& object : data.objects) {
+        if (object.indexCount == 0) continue;
+
+        CanonicalMesh mesh = canonicalize(data, object);
+        // Lejos del origen el redondeo de float al centrar y rotar supera la tolerancia
+        // relativa: se anaden unos ulps de la magnitud de las coordenadas originales
+        const XMFLOAT4X4& m = mesh.transform;
+        const float magnitude = (std::max)((std::max)(std::fabs(m._41), std::fabs(m._42)), std::fabs(m._43)) + mesh.radius;
+        const float quantum = tolerance * (mesh.radius > 0.0f ? mesh.radius : 1.0f) + 8.0f * FLT_EPSILON * magnitude;
+        const unsigned long long hash = hashMesh(mesh);
+
+        unsigned int prototypeIndex = static_cast<unsigned int>(model.prototypes.size());
+        std::vector<unsigned int>& candidates = buckets[hash];
+        for (unsigned int candidate : candidates) {
+            // El radio descarta casi todos los candidatos sin recorrer sus vertices
+            if (std::fabs(prototypeRadius[candidate] - mesh.radius) > quantum) {
+                continue;
+            }
+            if (matches(mesh, model.prototypes[candidate], quantum)) {
+                prototypeIndex = candidate;
+                break;
+            }
+        }
+
+        if (prototypeIndex == model.prototypes.size()) {
+            MeshPrototype prototype;
+            prototype.name = object.name;
+            prototype.vertex = std::move(mesh.vertex);
+            prototype.index = std::move(mesh.index);
+            model.uniqueVertexCount += prototype.vertex.size();
+            model.uniqueIndexCount += prototype.index.size();
+            model.prototypes.push_back(std::move(prototype));
+            prototypeRadius.push_back(mesh.radius);
+            candidates.push_back(prototypeIndex);
+        }
+
+        model.prototypes[prototypeIndex].instanceCount++;
+        model.instances.push_back({ object.name, prototypeIndex, mesh.transform });
+    }
+
+    MESSAGE("MeshInstancer", "build", ("Objetos: " + std::to_string(model.instances.size()) +
+        ", prototipos unicos: " + std::to_string(model.prototypes.size()) +
+        ", vertices: " + std::to_string(model.sourceVertexCount) + " -> " +
+        std::to_string(model.uniqueVertexCount)).c_str());
+
+    return model;
+}
+
+MeshInstancer::CanonicalMesh
+MeshInstancer::canonicalize(const LoadData& data, const LoadObject& object) const {
+    CanonicalMesh mesh;
+
+    // 1. Extraer vertices locales en orden de primer uso
+    std::unordered_map<unsigned int, unsigned int> remap;
+    mesh.index.reserve(object.indexCount);
+    for (unsigned int i = object.startIndex; i < object.startIndex + object.indexCount; ++i) {
+        const unsigned int globalIndex = data.index[i];
+        auto it = remap.find(globalIndex);
+        if (it == remap.end()) {
+            it = remap.emplace(globalIndex, static_cast<unsigned int>(mesh.vertex.size())).first;
+            mesh.vertex.push_back(data.vertex[globalIndex]);
+        }
+        mesh.index.push_back(it->second);
+    }
+
+    // 2. Centroide (normalizacion de traslacion)
+    XMFLOAT3 center(0.0f, 0.0f, 0.0f);
+    for (const SimpleVertex& v : mesh.vertex) {
+        center.x += v.Pos.x;
+        center.y += v.Pos.y;
+        center.z += v.Pos.z;
+    }
+    center = scale(center, 1.0f / static_cast<float>(mesh.vertex.size()));
+
+    float maxDist = 0.0f;
+    for (const SimpleVertex& v : mesh.vertex) {
+        maxDist = (std::max)(maxDist, length(sub(v.Pos, center)));
+    }
+    mesh.radius = maxDist;
+
+    // 3. Marco de referencia (normalizacion de rotacion). Los ejes se toman de los
+    // primeros vertices suficientemente alejados, por lo que dos copias con el mismo
+    // orden de vertices producen el mismo marco sin importar su rotacion.
+    XMFLOAT3 axis0(1.0f, 0.0f, 0.0f);
+    XMFLOAT3 axis1(0.0f, 1.0f, 0.0f);
+    if (maxDist > 0.0f) {
+        for (const SimpleVertex& v : mesh.vertex) {
+            const XMFLOAT3 d = sub(v.Pos, center);
+            const float len = length(d);
+            if (len >= 0.5f * maxDist) {
+                axis0 = scale(d, 1.0f / len);
+                break;
+            }
+        }
+
+        float maxOrtho = 0.0f;
+        for (const SimpleVertex& v : mesh.vertex) {
+            const XMFLOAT3 d = sub(v.Pos, center);
+            maxOrtho = (std::max)(maxOrtho, length(sub(d, scale(axis0, dot(d, axis0)))));
+        }
+
+        if (maxOrtho > 1.0e-6f * maxDist) {
+            for (const SimpleVertex& v : mesh.vertex) {
+                const XMFLOAT3 d = sub(v.Pos, center);
+                const XMFLOAT3 ortho = sub(d, scale(axis0, dot(d, axis0)));
+                const float len = length(ortho);
+                if (len >= 0.5f * maxOrtho) {
+                    axis1 = scale(ortho, 1.0f / len);
+                    break;
+                }
+            }
+        }
+        else {
+            // Geometria colineal: cualquier perpendicular sirve
+            const XMFLOAT3 helper = std::fabs(axis0.x) < 0.9f ? XMFLOAT3(1.0f, 0.0f, 0.0f) : XMFLOAT3(0.0f, 1.0f, 0.0f);
+            const XMFLOAT3 perp = cross(axis0, helper);
+            axis1 = scale(perp, 1.0f / length(perp));
+        }
+    }
+    const XMFLOAT3 axis2 = cross(axis0, axis1);
+
+    // 4. Llevar posiciones y normales al espacio canonico
+    for (SimpleVertex& v : mesh.vertex) {
+        const XMFLOAT3 d = sub(v.Pos, center);
+        v.Pos = XMFLOAT3(dot(d, axis0), dot(d, axis1), dot(d, axis2));
+        const XMFLOAT3 n = v.Normal;
+        v.Normal = XMFLOAT3(dot(n, axis0), dot(n, axis1), dot(n, axis2));
+    }
+
+    // 5. Transformacion canonico -> mundo: filas = ejes, ultima fila = centroide
+    XMFLOAT4X4& m = mesh.transform;
+    m._11 = axis0.x;  m._12 = axis0.y;  m._13 = axis0.z;  m._14 = 0.0f;
+    m._21 = axis1.x;  m._22 = axis1.y;  m._23 = axis1.z;  m._24 = 0.0f;
+    m._31 = axis2.x;  m._32 = axis2.y;  m._33 = axis2.z;  m._34 = 0.0f;
+    m._41 = center.x; m._42 = center.y; m._43 = center.z; m._44 = 1.0f;
+
+    return mesh;
+}
+
+unsigned long long
+MeshInstancer::hashMesh(const CanonicalMesh& mesh) const {
+    // Solo datos exactos: cuantizar posiciones separaria copias identicas cuyo
+    // ruido de canonicalizacion cae a ambos lados de un limite de redondeo
+    unsigned long long hash = 14695981039346656037ull;
+    hashCombine(hash, static_cast<unsigned int>(mesh.vertex.size()));
+    hashCombine(hash, static_cast<unsigned int>(mesh.index.size()));
+    for (unsigned int index : mesh.index) {
+        hashCombine(hash, index);
+    }
+    return hash;
+}
+
+bool
+MeshInstancer::matches(const CanonicalMesh& mesh, const MeshPrototype& prototype, float epsilon) const {
+    if (mesh.vertex.size() != prototype.vertex.size() || mesh.index != prototype.index) {
+        return false;
+    }
+
+    // Normales y UV son independientes de la escala del objeto
+    const float attributeEpsilon = 1.0e-3f;
+    for (size_t i = 0; i < mesh.vertex.size(); ++i) {
+        const SimpleVertex& a = mesh.vertex[i];
+        const SimpleVertex& b = prototype.vertex[i];
+        if (!nearlyEqual(a.Pos, b.Pos, epsilon) ||
+            !nearlyEqual(a.Normal, b.Normal, attributeEpsilon) ||
+            std::fabs(a.Tex.x - b.Tex.x) > attributeEpsilon ||
+            std::fabs(a.Tex.y - b.Tex.y) > attributeEpsilon) {
+            return false;
+        }
+    }
+    return true;
+}
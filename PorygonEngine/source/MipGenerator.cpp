@@ -0,0 +1,445 @@
+#include "MipGenerator.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    const float kPi = 3.14159265358979f;
+    const float kFilterRadius = 3.0f;   // Radio de Kaiser y Lanczos
+    const float kKaiserAlpha = 4.0f;
+    const int kLinearToSrgbSize = 8192; // Error < 0.5 LSB en la zona oscura
+
+    /**
+     * @brief Imagen RGBA en float (lineal) usada entre niveles.
+     */
+    struct FloatImage {
+        unsigned int width = 0;
+        unsigned int height = 0;
+        std::vector<float> texels;
+    };
+
+    /**
+     * @brief Pesos de un filtro 1D para cada texel de salida.
+     *
+     * Cada salida usa `taps` entradas consecutivas a partir de first[o];
+     * los indices fuera de rango ya estan recortados al borde.
+     */
+    struct FilterTable {
+        int taps = 0;
+        std::vector<int> first;
+        std::vector<int> index;     // taps * salidas
+        std::vector<float> weight;  // taps * salidas
+    };
+
+    float sinc(float x) {
+        if (std::fabs(x) < 1.0e-6f) return 1.0f;
+        const float px = kPi * x;
+        return std::sin(px) / px;
+    }
+
+    // Funcion de Bessel modificada de primera especie, orden 0
+    float besselI0(float x) {
+        float sum = 1.0f, term = 1.0f;
+        const float halfSq = 0.25f * x * x;
+        for (int k = 1; k < 32; ++k) {
+            term *= halfSq / static_cast<float>(k * k);
+            sum += term;
+            if (term < 1.0e-8f * sum) break;
+        }
+        return sum;
+    }
+
+    float filterSupport(MipFilter filter) {
+        return filter == BOX_FILTER ? 0.5f : kFilterRadius;
+    }
+
+    float evalFilter(MipFilter filter, float x) {
+        const float ax = std::fabs(x);
+        switch (filter) {
+        case BOX_FILTER:
+            return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+        case KAISER_FILTER: {
+            if (ax >= kFilterRadius) return 0.0f;
+            const float t = ax / kFilterRadius;
+            return sinc(x) * besselI0(kKaiserAlpha * std::sqrt(1.0f - t * t)) / besselI0(kKaiserAlpha);
+        }
+        case LANCZOS_FILTER:
+            if (ax >= kFilterRadius) return 0.0f;
+            return sinc(x) * sinc(x / kFilterRadius);
+        }
+        return 0.0f;
+    }
+
+    FilterTable buildFilterTable(unsigned int srcSize, unsigned int dstSize, MipFilter filter) {
+        FilterTable table;
+        const float scale = (std::max)(1.0f, static_cast<float>(srcSize) / static_cast<float>(dstSize));
+        const float radius = filterSupport(filter) * scale;
+        const float ratio = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+
+        // Solo las entradas cuyo centro cae dentro del soporte: para el box 2:1
+        // son exactamente 2 taps en lugar de 3.
+        table.first.resize(dstSize);
+        std::vector<int> last(dstSize);
+        for (unsigned int o = 0; o < dstSize; ++o) {
+            const float center = (static_cast<float>(o) + 0.5f) * ratio;
+            table.first[o] = static_cast<int>(std::floor(center - radius - 0.5f)) + 1;
+            last[o] = static_cast<int>(std::ceil(center + radius - 0.5f)) - 1;
+            table.taps = (std::max)(table.taps, last[o] - table.first[o] + 1);
+        }
+        table.index.resize(static_cast<size_t>(table.taps) * dstSize);
+        table.weight.resize(static_cast<size_t>(table.taps) * dstSize);
+
+        for (unsigned int o = 0; o < dstSize; ++o) {
+            const float center = (static_cast<float>(o) + 0.5f) * ratio;
+            const int first = table.first[o];
+
+            float sum = 0.0f;
+            for (int t = 0; t < table.taps; ++t) {
+                const int i = first + t;
+                const float w = i <= last[o] ? evalFilter(filter, (static_cast<float>(i) + 0.5f - center) / scale) : 0.0f;
+                const int clamped = (std::min)((std::max)(i, 0), static_cast<int>(srcSize) - 1);
+                table.index[o * table.taps + t] = clamped;
+                table.weight[o * table.taps + t] = w;
+                sum += w;
+            }
+            const float norm = sum != 0.0f ? 1.0f / sum : 0.0f;
+            for (int t = 0; t < table.taps; ++t) {
+                table.weight[o * table.taps + t] *= norm;
+            }
+        }
+        return table;
+    }
+
+    /**
+     * @brief Tablas de conversion sRGB <-> lineal.
+     */
+    struct SrgbTables {
+        float toLinear[256];
+        float identity[256];
+        unsigned char toSrgb[kLinearToSrgbSize + 1];
+
+        SrgbTables() {
+            for (int i = 0; i < 256; ++i) {
+                const float c = static_cast<float>(i) / 255.0f;
+                toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                identity[i] = c;
+            }
+            for (int i = 0; i <= kLinearToSrgbSize; ++i) {
+                const float l = static_cast<float>(i) / kLinearToSrgbSize;
+                const float s = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                toSrgb[i] = static_cast<unsigned char>(s * 255.0f + 0.5f);
+            }
+        }
+    };
+
+    const SrgbTables& srgbTables() {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    /**
+     * @brief Convierte una fila RGBA8 a float lineal.
+     */
+    void decodeRow(const unsigned char* src, unsigned int width, bool srgb, float* dst) {
+        const SrgbTables& tables = srgbTables();
+        const float* colorTable = srgb ? tables.toLinear : tables.identity;
+        for (unsigned int x = 0; x < width; ++x) {
+            dst[x * 4 + 0] = colorTable[src[x * 4 + 0]];
+            dst[x * 4 + 1] = colorTable[src[x * 4 + 1]];
+            dst[x * 4 + 2] = colorTable[src[x * 4 + 2]];
+            dst[x * 4 + 3] = tables.identity[src[x * 4 + 3]];
+        }
+    }
+
+    /**
+     * @brief Convierte una imagen float lineal a RGBA8 (recodificando sRGB si aplica).
+     */
+    void encodeLevel(const FloatImage& src, bool srgb, ImageLevel& dst) {
+        const SrgbTables& tables = srgbTables();
+        dst.width = src.width;
+        dst.height = src.height;
+        dst.rowPitch = src.width * 4;
+        dst.pixels.resize(static_cast<size_t>(dst.rowPitch) * dst.height);
+
+        const size_t count = static_cast<size_t>(src.width) * src.height * 4;
+        for (size_t i = 0; i < count; ++i) {
+            const float v = (std::min)((std::max)(src.texels[i], 0.0f), 1.0f);
+            if (srgb && (i & 3) != 3) {
+                dst.pixels[i] = tables.toSrgb[static_cast<int>(v * kLinearToSrgbSize + 0.5f)];
+            }
+            else {
+                dst.pixels[i] = static_cast<unsigned char>(v * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    /**
+     * @brief Filtra horizontalmente una fila RGBA float.
+     */
+    void filterRow(const float* src, const FilterTable& table, unsigned int dstWidth, float* dst) {
+        const int taps = table.taps;
+        for (unsigned int o = 0; o < dstWidth; ++o) {
+            const int* idx = &table.index[o * taps];
+            const float* w = &table.weight[o * taps];
+#if PORYGON_SSE2
+            __m128 acc = _mm_setzero_ps();
+            for (int t = 0; t < taps; ++t) {
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[t]), _mm_loadu_ps(src + idx[t] * 4)));
+            }
+            _mm_storeu_ps(dst + o * 4, acc);
+#else
+            float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+            for (int t = 0; t < taps; ++t) {
+                const float* p = src + idx[t] * 4;
+                r += w[t] * p[0];
+                g += w[t] * p[1];
+                b += w[t] * p[2];
+                a += w[t] * p[3];
+            }
+            dst[o * 4 + 0] = r;
+            dst[o * 4 + 1] = g;
+            dst[o * 4 + 2] = b;
+            dst[o * 4 + 3] = a;
+#endif
+        }
+    }
+
+    /**
+     * @brief Acumula dst += weight * src sobre `count` floats.
+     */
+    void accumulateRow(const float* src, float weight, size_t count, float* dst) {
+        size_t i = 0;
+#if PORYGON_SSE2
+        const __m128 w = _mm_set1_ps(weight);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(w, _mm_loadu_ps(src + i))));
+        }
+#endif
+        for (; i < count; ++i) {
+            dst[i] += weight * src[i];
+        }
+    }
+
+    /**
+     * @brief Reduce una imagen con un filtro separable.
+     *
+     * Las filas filtradas en horizontal se guardan en un anillo del tamano del
+     * filtro vertical, asi que solo la imagen de salida vive completa en memoria.
+     * `loadRow` devuelve la fila `y` de la fuente como RGBA float.
+     */
+    template <typename RowLoader>
+    void downsample(unsigned int srcWidth, unsigned int srcHeight, RowLoader loadRow,
+        MipFilter filter, FloatImage& dst) {
+        const FilterTable horizontal = buildFilterTable(srcWidth, dst.width, filter);
+        const FilterTable vertical = buildFilterTable(srcHeight, dst.height, filter);
+        const size_t dstRowFloats = static_cast<size_t>(dst.width) * 4;
+
+        const int ringSize = vertical.taps;
+        std::vector<float> ring(ringSize * dstRowFloats);
+        std::vector<int> ringRow(ringSize, -1);
+        dst.texels.assign(dstRowFloats * dst.height, 0.0f);
+
+        for (unsigned int y = 0; y < dst.height; ++y) {
+            float* out = &dst.texels[y * dstRowFloats];
+            for (int t = 0; t < vertical.taps; ++t) {
+                const float w = vertical.weight[y * vertical.taps + t];
+                if (w == 0.0f) continue;
+
+                // La ventana de filas [first, first + taps) es contigua, por lo que
+                // sus posiciones en el anillo no colisionan entre si.
+                const int sourceRow = vertical.index[y * vertical.taps + t];
+                const int slot = (vertical.first[y] + t + ringSize * 4) % ringSize;
+                float* filtered = &ring[slot * dstRowFloats];
+                if (ringRow[slot] != sourceRow) {
+                    filterRow(loadRow(sourceRow), horizontal, dst.width, filtered);
+                    ringRow[slot] = sourceRow;
+                }
+                accumulateRow(filtered, w, dstRowFloats, out);
+            }
+        }
+    }
+}
+
+unsigned int
+MipGenerator::calcMipCount(unsigned int width, unsigned int height) {
+    unsigned int count = 1;
+    unsigned int size = (std::max)(width, height);
+    while (size > 1) {
+        size >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+bool
+MipGenerator::generate(const unsigned char* pixels,
+    unsigned int width,
+    unsigned int height,
+    unsigned int rowPitch,
+    MipFilter filter,
+    bool srgb,
+    std::vector<ImageLevel>& levels,
+    unsigned int maxLevels) const {
+    levels.clear();
+    if (!pixels || width == 0 || height == 0 || rowPitch < width * 4) {
+        return false;
+    }
+
+    unsigned int levelCount = calcMipCount(width, height);
+    if (maxLevels > 0) levelCount = (std::min)(levelCount, maxLevels);
+    levels.resize(levelCount);
+
+    // Nivel 0: copia compacta de la imagen original
+    ImageLevel& base = levels[0];
+    base.width = width;
+    base.height = height;
+    base.rowPitch = width * 4;
+    base.pixels.resize(static_cast<size_t>(base.rowPitch) * height);
+    for (unsigned int y = 0; y < height; ++y) {
+        std::memcpy(&base.pixels[y * base.rowPitch], pixels + static_cast<size_t>(y) * rowPitch, base.rowPitch);
+    }
+    if (levelCount == 1) return true;
+
+    // Nivel 1 desde los bytes originales, decodificando fila por fila
+    std::vector<float> decoded(static_cast<size_t>(width) * 4);
+    FloatImage previous;
+    previous.width = (std::max)(1u, width >> 1);
+    previous.height = (std::max)(1u, height >> 1);
+    downsample(width, height, [&](int y) {
+        decodeRow(pixels + static_cast<size_t>(y) * rowPitch, width, srgb, decoded.data());
+        return decoded.data();
+        }, filter, previous);
+    encodeLevel(previous, srgb, levels[1]);
+
+    // Niveles siguientes: cada uno a partir del anterior en float
+    for (unsigned int level = 2; level < levelCount; ++level) {
+        FloatImage next;
+        next.width = (std::max)(1u, previous.width >> 1);
+        next.height = (std::max)(1u, previous.height >> 1);
+        const FloatImage& source = previous;
+        downsample(source.width, source.height, [&](int y) {
+            return &source.texels[static_cast<size_t>(y) * source.width * 4];
+            }, filter, next);
+        encodeLevel(next, srgb, levels[level]);
+        previous = std::move(next);
+    }
+    return true;
+}
+
+bool
+MipGenerator::resize(const unsigned char* pixels,
+    unsigned int width,
+    unsigned int height,
+    unsigned int rowPitch,
+    unsigned int targetWidth,
+    unsigned int targetHeight,
+    MipFilter filter,
+    bool srgb,
+    ImageLevel& result) const {
+    if (!pixels || width == 0 || height == 0 || rowPitch < width * 4 ||
+        targetWidth == 0 || targetHeight == 0 || targetWidth > width || targetHeight > height) {
+        return false;
+    }
+
+    std::vector<float> decoded(static_cast<size_t>(width) * 4);
+    FloatImage resized;
+    resized.width = targetWidth;
+    resized.height = targetHeight;
+    downsample(width, height, [&](int y) {
+        decodeRow(pixels + static_cast<size_t>(y) * rowPitch, width, srgb, decoded.data());
+        return decoded.data();
+        }, filter, resized);
+    encodeLevel(resized, srgb, result);
+    return true;
+}
+
+namespace {
+    /**
+     * @brief Pasa un nivel intermedio a HdrImageLevel recortando los negativos del filtro.
+     */
+    void storeHdrLevel(const FloatImage& src, HdrImageLevel& dst) {
+        dst.width = src.width;
+        dst.height = src.height;
+        dst.texels.resize(src.texels.size());
+        size_t i = 0;
+#if PORYGON_SSE2
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= src.texels.size(); i += 4) {
+            _mm_storeu_ps(&dst.texels[i], _mm_max_ps(_mm_loadu_ps(&src.texels[i]), zero));
+        }
+#endif
+        for (; i < src.texels.size(); ++i) {
+            dst.texels[i] = (std::max)(src.texels[i], 0.0f);
+        }
+    }
+}
+
+bool
+MipGenerator::generateHdr(const float* rgba,
+    unsigned int width,
+    unsigned int height,
+    MipFilter filter,
+    std::vector<HdrImageLevel>& levels,
+    unsigned int maxLevels) const {
+    levels.clear();
+    if (!rgba || width == 0 || height == 0) {
+        return false;
+    }
+
+    unsigned int levelCount = calcMipCount(width, height);
+    if (maxLevels > 0) levelCount = (std::min)(levelCount, maxLevels);
+    levels.resize(levelCount);
+
+    HdrImageLevel& base = levels[0];
+    base.width = width;
+    base.height = height;
+    base.texels.assign(rgba, rgba + static_cast<size_t>(width) * height * 4);
+
+    if (levelCount == 1) return true;
+
+    // Nivel 1 desde la fuente; los siguientes desde el anterior sin recortar, como en generate
+    FloatImage previous;
+    previous.width = (std::max)(1u, width >> 1);
+    previous.height = (std::max)(1u, height >> 1);
+    downsample(width, height, [&](int y) {
+        return rgba + static_cast<size_t>(y) * width * 4;
+        }, filter, previous);
+    storeHdrLevel(previous, levels[1]);
+
+    for (unsigned int level = 2; level < levelCount; ++level) {
+        FloatImage next;
+        next.width = (std::max)(1u, previous.width >> 1);
+        next.height = (std::max)(1u, previous.height >> 1);
+        const FloatImage& source = previous;
+        downsample(source.width, source.height, [&](int y) {
+            return &source.texels[static_cast<size_t>(y) * source.width * 4];
+            }, filter, next);
+        storeHdrLevel(next, levels[level]);
+        previous = std::move(next);
+    }
+    return true;
+}
+
+bool
+MipGenerator::resizeHdr(const float* rgba,
+    unsigned int width,
+    unsigned int height,
+    unsigned int targetWidth,
+    unsigned int targetHeight,
+    MipFilter filter,
+    HdrImageLevel& result) const {
+    if (!rgba || width == 0 || height == 0 ||
+        targetWidth == 0 || targetHeight == 0 || targetWidth > width || targetHeight > height) {
+        return false;
+    }
+
+    FloatImage resized;
+    resized.width = targetWidth;
+    resized.height = targetHeight;
+    downsample(width, height, [&](int y) {
+        return rgba + static_cast<size_t>(y) * width * 4;
+        }, filter, resized);
+    storeHdrLevel(resized, result);
+    return true;
+}
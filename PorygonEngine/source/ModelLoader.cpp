@@ -1,12 +1,13 @@
 ﻿// ModelLoader.cpp
 
 #include "ModelLoader.h"
-#include <fstream> 
-#include <sstream> 
+#include <fstream>
+#include <sstream>
 #include <vector>
 #include <string>
 #include <map>
-#include <tuple> 
+#include <tuple>
+#include <chrono>
 
 // #include "OBJ_Loader.h" <-- La dependencia ha sido ELIMINADA y reemplazada
 
@@ -14,6 +15,15 @@
 // Funciones Auxiliares para el Parsing (implementadas en un namespace anónimo)
 // ----------------------------------------------------------------------------------
 namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Milisegundos transcurridos entre dos instantes.
+     */
+    double elapsedMs(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
     /**
      * @brief Parsea un token de cara (ej: "1/2/3") y extrae los índices v, vt, vn.
      * @param token String del vértice de la cara.
@@ -40,6 +50,60 @@ namespace {
 
         return std::make_tuple(v, vt, vn);
     }
+
+    /**
+     * @brief Escapa comillas, barras y caracteres de control para un string JSON.
+     */
+    std::string jsonEscape(const std::string& text) {
+        std::string out;
+        out.reserve(text.size());
+        for (char c : text) {
+            if (c == '"' || c == '\\') { out += '\\'; out += c; }
+            else if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+            else out += c;
+        }
+        return out;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+// Estadísticas de carga
+// ----------------------------------------------------------------------------------
+double
+ModelLoadStats::cacheHitRate() const {
+    return cacheLookups > 0 ? static_cast<double>(cacheHits) / cacheLookups : 0.0;
+}
+
+std::string
+ModelLoadStats::toJson(const std::string& fileName) const {
+    std::ostringstream os;
+    os << "{\"file\":\"" << jsonEscape(fileName) << "\""
+        << ",\"timingsMs\":{"
+        << "\"io\":" << ioMs
+        << ",\"tokenize\":" << tokenizeMs
+        << ",\"floatParse\":" << floatParseMs
+        << ",\"dedup\":" << dedupMs
+        << ",\"triangulation\":" << triangulationMs
+        << ",\"finalize\":" << finalizeMs
+        << ",\"total\":" << totalMs << "}"
+        << ",\"bytesRead\":" << bytesRead
+        << ",\"lines\":{"
+        << "\"total\":" << linesTotal
+        << ",\"v\":" << linesPosition
+        << ",\"vt\":" << linesTexCoord
+        << ",\"vn\":" << linesNormal
+        << ",\"f\":" << linesFace
+        << ",\"o\":" << linesObject
+        << ",\"skipped\":" << linesSkipped << "}"
+        << ",\"cache\":{"
+        << "\"lookups\":" << cacheLookups
+        << ",\"hits\":" << cacheHits
+        << ",\"hitRate\":" << cacheHitRate() << "}"
+        << ",\"ngonsTriangulated\":" << ngonsTriangulated
+        << ",\"triangles\":" << trianglesEmitted
+        << ",\"invalidIndices\":" << invalidIndices
+        << "}";
+    return os.str();
 }
 
 // ... [Aquí irían tus funciones init, update, render, destroy si las tienes] ...
@@ -50,6 +114,16 @@ namespace {
 LoadData
 ModelLoader::Load(const std::string& objFileName)
 {
+    ModelLoadStats stats;
+    return Load(objFileName, stats);
+}
+
+LoadData
+ModelLoader::Load(const std::string& objFileName, ModelLoadStats& stats)
+{
+    stats = ModelLoadStats();
+    const Clock::time_point loadStart = Clock::now();
+
     LoadData LD;
     LD.name = objFileName;
 
@@ -67,8 +141,9 @@ ModelLoader::Load(const std::string& objFileName)
     std::map<VertexIndices, unsigned int> vertex_cache;
     unsigned int next_index = 0; // índice para el próximo SimpleVertex único
 
-    std::ifstream file(objFileName);
-    std::string line;
+    // 3. Lectura del archivo completo a memoria (etapa de I/O)
+    Clock::time_point stageStart = Clock::now();
+    std::ifstream file(objFileName, std::ios::binary);
 
     if (!file.is_open()) {
         ERROR("ModelLoader", "Load", ("No se pudo abrir el archivo .obj: " + objFileName).c_str());
@@ -77,18 +152,51 @@ ModelLoader::Load(const std::string& objFileName)
 
     MESSAGE("ModelLoader", "Load", ("Iniciando parsing manual de: " + objFileName).c_str());
 
-    // 3. Lectura línea por línea
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
+    std::string content;
+    file.seekg(0, std::ios::end);
+    const std::streamoff fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (fileSize > 0) {
+        content.resize(static_cast<size_t>(fileSize));
+        file.read(&content[0], fileSize);
+        content.resize(static_cast<size_t>(file.gcount()));
+    }
+    file.close();
+    stats.bytesRead = content.size();
+    stats.ioMs = elapsedMs(stageStart, Clock::now());
+
+    // 4. Procesamiento línea por línea
+    std::vector<VertexIndices> face_vertices;
+    size_t lineStart = 0;
+    while (lineStart < content.size()) {
+        stageStart = Clock::now();
+
+        size_t lineEnd = content.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = content.size();
+        size_t lineLength = lineEnd - lineStart;
+        if (lineLength > 0 && content[lineStart + lineLength - 1] == '\r') --lineLength;
+        std::string line = content.substr(lineStart, lineLength);
+        lineStart = lineEnd + 1;
+        ++stats.linesTotal;
+
+        if (line.empty() || line[0] == '#') {
+            ++stats.linesSkipped;
+            stats.tokenizeMs += elapsedMs(stageStart, Clock::now());
+            continue;
+        }
 
         std::stringstream ss(line);
         std::string token;
         ss >> token;
+        Clock::time_point tokenEnd = Clock::now();
+        stats.tokenizeMs += elapsedMs(stageStart, tokenEnd);
 
         if (token == "v") { // Posiciones
             XMFLOAT3 pos;
             ss >> pos.x >> pos.y >> pos.z;
             temp_positions.push_back(pos);
+            ++stats.linesPosition;
+            stats.floatParseMs += elapsedMs(tokenEnd, Clock::now());
         }
         else if (token == "vt") { // Coordenadas de textura
             XMFLOAT2 tc;
@@ -96,25 +204,33 @@ ModelLoader::Load(const std::string& objFileName)
             // Invertir la coordenada V (o Y) para la convención de DirectX/D3DX (V=0 arriba)
             tc.y = 1.0f - tc.y;
             temp_texCoords.push_back(tc);
+            ++stats.linesTexCoord;
+            stats.floatParseMs += elapsedMs(tokenEnd, Clock::now());
         }
         else if (token == "vn") { // Normales
             XMFLOAT3 norm;
             ss >> norm.x >> norm.y >> norm.z;
             temp_normals.push_back(norm);
+            ++stats.linesNormal;
+            stats.floatParseMs += elapsedMs(tokenEnd, Clock::now());
         }
         else if (token == "f") { // Caras y Triangulación
-            std::vector<VertexIndices> face_vertices;
+            ++stats.linesFace;
+            face_vertices.clear();
             std::string face_token;
             while (ss >> face_token) {
-                face_vertices.push_back({
-                    std::get<0>(parseFaceIndex(face_token)),
-                    std::get<1>(parseFaceIndex(face_token)),
-                    std::get<2>(parseFaceIndex(face_token))
-                    });
+                VertexIndices key;
+                std::tie(key.v, key.vt, key.vn) = parseFaceIndex(face_token);
+                face_vertices.push_back(key);
             }
+            Clock::time_point triStart = Clock::now();
+            stats.tokenizeMs += elapsedMs(tokenEnd, triStart);
 
             // Triangulación "Fan" para N-gons (N > 3)
             if (face_vertices.size() < 3) continue;
+            if (face_vertices.size() > 3) ++stats.ngonsTriangulated;
+
+            double faceDedupMs = 0.0;
 
             // Un N-gon se divide en N-2 triángulos, todos pivotando en el primer vértice (indice 0)
             for (size_t i = 0; i < face_vertices.size() - 2; ++i) {
@@ -124,6 +240,7 @@ ModelLoader::Load(const std::string& objFileName)
                     face_vertices[i + 1],
                     face_vertices[i + 2]
                 };
+                ++stats.trianglesEmitted;
 
                 // Procesar cada vértice del triángulo para indexación
                 for (int j = 0; j < 3; ++j) {
@@ -134,14 +251,18 @@ ModelLoader::Load(const std::string& objFileName)
                         (current_key.vt > 0 && current_key.vt >= temp_texCoords.size()) ||
                         (current_key.vn > 0 && current_key.vn >= temp_normals.size())) {
                         ERROR("ModelLoader", "Load", "Índice de vértice fuera de rango o inválido en cara.");
+                        ++stats.invalidIndices;
                         continue;
                     }
 
-                    // 4. Indexación con Cache
+                    // 5. Indexación con Cache
+                    Clock::time_point lookupStart = Clock::now();
+                    ++stats.cacheLookups;
                     auto it = vertex_cache.find(current_key);
                     if (it != vertex_cache.end()) {
                         // Vértice ya existe: reusar índice
                         LD.index.push_back(it->second);
+                        ++stats.cacheHits;
                     }
                     else {
                         // Nuevo vértice: crear SimpleVertex
@@ -159,15 +280,41 @@ ModelLoader::Load(const std::string& objFileName)
                         LD.index.push_back(next_index);
                         next_index++;
                     }
+                    faceDedupMs += elapsedMs(lookupStart, Clock::now());
                 }
             }
+
+            stats.dedupMs += faceDedupMs;
+            stats.triangulationMs += elapsedMs(triStart, Clock::now()) - faceDedupMs;
+        }
+        else if (token == "o") { // Objetos: cierran el rango del objeto anterior
+            ++stats.linesObject;
+            if (LD.objects.empty() && !LD.index.empty()) {
+                // Caras anteriores al primer 'o' forman un objeto sin nombre
+                LD.objects.push_back({ std::string(), 0, 0 });
+            }
+            if (!LD.objects.empty()) {
+                LD.objects.back().indexCount =
+                    static_cast<unsigned int>(LD.index.size()) - LD.objects.back().startIndex;
+            }
+            std::string objectName;
+            std::getline(ss >> std::ws, objectName);
+            LD.objects.push_back({ objectName, static_cast<unsigned int>(LD.index.size()), 0 });
+        }
+        else {
+            // Se ignoran comandos como 'g', 'usemtl', 's', etc.
+            ++stats.linesSkipped;
         }
-        // Se ignoran comandos como 'g', 'usemtl', 's', etc.
     }
 
-    file.close();
-
-    // 5. Finalización
+    // 6. Finalización
+    stageStart = Clock::now();
+    if (LD.objects.empty()) {
+        // Archivo sin 'o': todo el modelo es un unico objeto
+        LD.objects.push_back({ objFileName, 0, 0 });
+    }
+    LD.objects.back().indexCount =
+        static_cast<unsigned int>(LD.index.size()) - LD.objects.back().startIndex;
     LD.numVertex = static_cast<int>(LD.vertex.size());
     LD.numIndex = static_cast<int>(LD.index.size());
 
@@ -176,5 +323,13 @@ ModelLoader::Load(const std::string& objFileName)
     MESSAGE("ModelLoader", "Load", ("Parsing OBJ finalizado. Vertices unicos: " + std::to_string(LD.numVertex) +
         ", Indices: " + std::to_string(LD.numIndex)).c_str());
 
+    const Clock::time_point loadEnd = Clock::now();
+    stats.finalizeMs = elapsedMs(stageStart, loadEnd);
+    stats.totalMs = elapsedMs(loadStart, loadEnd);
+
+    if (m_emitStatsJson) {
+        OutputDebugStringA((stats.toJson(objFileName) + "\n").c_str());
+    }
+
     return LD;
-}
\ No newline at end of file
+}
@@ -0,0 +1,73 @@
+#include "RangeAllocator.h"
+#include <iterator>
+
+void
+RangeAllocator::init(size_t capacity) {
+    m_free.clear();
+    m_capacity = capacity;
+    m_freeSpace = capacity;
+    if (capacity > 0) {
+        m_free[0] = capacity;
+    }
+}
+
+bool
+RangeAllocator::allocate(size_t size, size_t& offset) {
+    if (size == 0 || size > m_freeSpace) {
+        return false;
+    }
+
+    auto best = m_free.end();
+    for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+        if (it->second >= size && (best == m_free.end() || it->second < best->second)) {
+            best = it;
+            if (it->second == size) break;
+        }
+    }
+    if (best == m_free.end()) {
+        return false;
+    }
+
+    offset = best->first;
+    const size_t remaining = best->second - size;
+    m_free.erase(best);
+    if (remaining > 0) {
+        m_free[offset + size] = remaining;
+    }
+    m_freeSpace -= size;
+    return true;
+}
+
+void
+RangeAllocator::free(size_t offset, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    m_freeSpace += size;
+
+    // Unir con el hueco siguiente y con el anterior si se tocan
+    auto next = m_free.lower_bound(offset);
+    if (next != m_free.end() && offset + size == next->first) {
+        size += next->second;
+        next = m_free.erase(next);
+    }
+    if (next != m_free.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            previous->second += size;
+            return;
+        }
+    }
+    m_free[offset] = size;
+}
+
+size_t
+RangeAllocator::largestFreeBlock() const {
+    size_t largest = 0;
+    for (const auto& block : m_free) {
+        if (block.second > largest) {
+            largest = block.second;
+        }
+    }
+    return largest;
+}
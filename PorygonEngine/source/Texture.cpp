@@ -3,6 +3,49 @@
 #include "Texture.h"
 #include "Device.h"
 #include "DeviceContext.h"
+#include "EnvironmentPrefilter.h"
+#include "HdrPacker.h"
+#include "JpegDecoder.h"
+#include "TextureResidency.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+
+namespace {
+    /**
+     * @brief Extension del archivo fuente de los tipos que se decodifican en CPU.
+     */
+    const char*
+        sourceExtension(ExtensionType extensionType) {
+        switch (extensionType) {
+        case PNG: return ".png";
+        case HDR: return ".hdr";
+        default: return ".jpg";
+        }
+    }
+
+    /**
+     * @brief Tamano que respeta el lado maximo conservando la proporcion.
+     *
+     * Con blockAligned se redondea hacia abajo a multiplos de 4 para que el
+     * resultado siga siendo compresible por bloques.
+     */
+    void
+        cappedSize(unsigned int width,
+            unsigned int height,
+            unsigned int maxSize,
+            bool blockAligned,
+            unsigned int& targetWidth,
+            unsigned int& targetHeight) {
+        const double scale = static_cast<double>(maxSize) / (std::max)(width, height);
+        targetWidth = (std::min)(maxSize, (std::max)(1u, static_cast<unsigned int>(width * scale + 0.5)));
+        targetHeight = (std::min)(maxSize, (std::max)(1u, static_cast<unsigned int>(height * scale + 0.5)));
+        if (blockAligned && targetWidth >= 4 && targetHeight >= 4) {
+            targetWidth &= ~3u;
+            targetHeight &= ~3u;
+        }
+    }
+}
 
 //
 // La primera funci�n `init` est� dise�ada para cargar una textura desde un archivo,
@@ -12,6 +55,14 @@ HRESULT
 Texture::init(Device& device,
     const std::string& textureName,
     ExtensionType extensionType) {
+    return init(device, textureName, extensionType, TextureImportOptions());
+}
+
+HRESULT
+Texture::init(Device& device,
+    const std::string& textureName,
+    ExtensionType extensionType,
+    const TextureImportOptions& options) {
     //return E_NOTIMPL;
     if (!device.m_device) {
         ERROR("Texture", "init", "Device is null.");
@@ -24,14 +75,59 @@ Texture::init(Device& device,
 
     HRESULT hr = S_OK;
 
+    // Con cache activada, una entrada valida evita decodificar la imagen
+    uint64_t cacheKey = 0;
+    bool cacheable = false;
+    if (extensionType != DDS && !options.cacheDirectory.empty()) {
+        const std::string sourceName = textureName + sourceExtension(extensionType);
+        cacheable = TextureCache::makeKey(sourceName, Texture::cacheSalt(options), cacheKey);
+
+        TextureCacheEntry entry;
+        if (cacheable && TextureCache(options.cacheDirectory).load(cacheKey, entry)) {
+            m_textureName = sourceName;
+            hr = init(device, entry);
+            if (SUCCEEDED(hr)) {
+                return hr;
+            }
+            ERROR("Texture", "init", "Failed to create texture from cache entry, decoding source");
+        }
+    }
+
     switch (extensionType) {
     case DDS: {
         m_textureName = textureName + ".dds";
+
+        // Los DDS traen sus mips: con lado maximo se empieza en el primero que cabe
+        D3DX11_IMAGE_LOAD_INFO loadInfo;
+        D3DX11_IMAGE_LOAD_INFO* pLoadInfo = nullptr;
+        D3DX11_IMAGE_INFO imageInfo;
+        const unsigned int maxSize = maxImportSize(options);
+        if (maxSize > 0 &&
+            SUCCEEDED(D3DX11GetImageInfoFromFile(m_textureName.c_str(), nullptr, &imageInfo, nullptr)) &&
+            (std::max)(imageInfo.Width, imageInfo.Height) > maxSize) {
+            unsigned int skip = 0;
+            while (skip + 1 < imageInfo.MipLevels &&
+                (std::max)(imageInfo.Width >> skip, imageInfo.Height >> skip) > maxSize) {
+                ++skip;
+            }
+            if ((std::max)(imageInfo.Width >> skip, imageInfo.Height >> skip) <= maxSize) {
+                loadInfo.FirstMipLevel = skip;
+                loadInfo.MipLevels = imageInfo.MipLevels - skip;
+            }
+            else {
+                // Sin mips suficientes: D3DX reescala el nivel 0 al cargar
+                cappedSize(imageInfo.Width, imageInfo.Height, maxSize, true, loadInfo.Width, loadInfo.Height);
+                loadInfo.Filter = D3DX11_FILTER_TRIANGLE;
+                loadInfo.MipLevels = D3DX11_FROM_FILE;
+            }
+            pLoadInfo = &loadInfo;
+        }
+
         // Cargar textura DDS
         hr = D3DX11CreateShaderResourceViewFromFile(
             device.m_device,
             m_textureName.c_str(),
-            nullptr,
+            pLoadInfo,
             nullptr,
             &m_textureFromImg,
             nullptr
@@ -45,100 +141,26 @@ Texture::init(Device& device,
         break;
     }
 
-    case PNG: {
-        m_textureName = textureName + ".png";
-        int width, height, channels;
-        unsigned char* data = stbi_load(m_textureName.c_str(), &width, &height, &channels, 4);
-        if (!data) {
-            ERROR("Texture", "init",
-                ("Failed to load PNG texture: " + std::string(stbi_failure_reason())).c_str());
-            return E_FAIL;
-        }
-
-        //Crear descirpcion de textura
-        D3D11_TEXTURE2D_DESC textureDesc = {};
-        textureDesc.Width = width;
-        textureDesc.Height = height;
-        textureDesc.MipLevels = 1;
-        textureDesc.ArraySize = 1;
-        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        textureDesc.SampleDesc.Count = 1;
-        textureDesc.Usage = D3D11_USAGE_DEFAULT;
-        textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-
-        //Crear datos de descarga
-        D3D11_SUBRESOURCE_DATA initData = {};
-        initData.pSysMem = data;
-        initData.SysMemPitch = width * 4;
-
-        hr = device.CreateTexture2D(&textureDesc, &initData, &m_texture);
-        stbi_image_free(data); //libera los datos de imagen inmediatamente
-
+    case PNG:
+    case JPG:
+    case HDR: {
+        // PNG, JPG y HDR comparten el mismo camino: decodificar, preparar y subir
+        m_textureName = textureName + sourceExtension(extensionType);
+        PreparedTexture prepared;
+        hr = decodeFile(m_textureName, options, prepared);
         if (FAILED(hr)) {
-            ERROR("Texture", "init", "Failed to create texture from PNG data");
+            ERROR("Texture", "init", ("Failed to load texture: " + m_textureName).c_str());
             return hr;
         }
 
-        //Crear vista del recurso de la textura
-        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-        srvDesc.Format = textureDesc.Format;
-        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
-
-        hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
-        SAFE_RELEASE(m_texture); //Liberar texturra inmediatamente
-
-        if (FAILED(hr)) {
-            ERROR("Texture", "init", "Failed to create shader resoucrce view for PNG texture ");
-            return hr;
-        }
-        break;
-    }
-    case JPG: {
-        m_textureName = textureName + ".jpg";
-        int width, height, channels;
-        unsigned char* data = stbi_load(m_textureName.c_str(), &width, &height, &channels, 4);
-        if (!data) {
-            ERROR("Texture", "init",
-                ("Failed to load JPG texture: " + std::string(stbi_failure_reason())).c_str());
-            return E_FAIL;
-        }
-
-        //Crear descripcion de textrurea
-        D3D11_TEXTURE2D_DESC textureDesc = {};
-        textureDesc.Width = width;
-        textureDesc.Height = height;
-        textureDesc.MipLevels = 1;
-        textureDesc.ArraySize = 1;
-        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        textureDesc.SampleDesc.Count = 1;
-        textureDesc.Usage = D3D11_USAGE_DEFAULT;
-        textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-
-        //Crear datos de subcarga
-        D3D11_SUBRESOURCE_DATA initData = {};
-        initData.pSysMem = data;
-        initData.SysMemPitch = width * 4;
-
-        hr = device.CreateTexture2D(&textureDesc, &initData, &m_texture);
-        stbi_image_free(data); //Liberar los datos de imagen inmediatamente
-
-        if (FAILED(hr)) {
-            ERROR("Texture", "init", "Failed to create texture from JPG data");
-            return hr;
+        if (cacheable &&
+            !TextureCache(options.cacheDirectory).store(cacheKey, prepared.format, prepared.levels)) {
+            MESSAGE("Texture", "init", "Could not write texture cache entry");
         }
 
-        //Crear vista de recurso de la textura
-        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-        srvDesc.Format = textureDesc.Format;
-        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = 1;
-
-        hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
-        SAFE_RELEASE(m_texture); //Liberar texturra inmediatamente
-
+        hr = init(device, prepared);
         if (FAILED(hr)) {
-            ERROR("Texture", "init", "Failed to create shader resoucrce view for JPG texture ");
+            ERROR("Texture", "init", ("Failed to create texture from " + m_textureName).c_str());
             return hr;
         }
         break;
@@ -266,6 +288,11 @@ Texture::render(DeviceContext& deviceContext,
         return;
     }
 
+    // Una textura expulsada por el gestor de residencia se recarga aqui
+    if (m_residency) {
+        m_residency->touch(*this);
+    }
+
     // Se asigna el recurso si la vista de recurso de sombreador es v�lida.
     if (m_textureFromImg) {
         deviceContext.PSSetShaderResources(StartSlot,
@@ -286,4 +313,756 @@ Texture::destroy() {
     if (m_textureFromImg) {
         SAFE_RELEASE(m_textureFromImg);
     }
-}
\ No newline at end of file
+    m_memoryBytes = 0;
+    // Una textura reutilizada tras destroy (residencia, mapas de entorno) no
+    // debe heredar la forma del recurso anterior
+    m_arraySize = 0;
+    m_cubemap = false;
+    m_sliceNames.clear();
+}
+
+namespace {
+    /**
+     * @brief Formato final de una importacion segun el uso y los canales de la fuente.
+     */
+    struct TextureLayout {
+        unsigned int channels = 4;                       /**< Canales guardados (1, 2 o 4). */
+        DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM; /**< Formato sin compresion. */
+        bool srgbFormat = false;                         /**< Usar la variante _SRGB del formato. */
+        bool srgbFilter = false;                         /**< Promediar los mips en lineal. */
+        bool alphaToGreen = false;                       /**< Fuente gris + alfa: el alfa pasa a G. */
+    };
+
+    TextureLayout
+        resolveLayout(const TextureImportOptions& options, unsigned int sourceChannels) {
+        TextureUsage usage = options.usage;
+        if (usage == AUTO_USAGE) {
+            usage = sourceChannels <= 2 ? DATA_USAGE : COLOR_USAGE;
+        }
+
+        TextureLayout layout;
+        switch (usage) {
+        case SRGB_COLOR_USAGE:
+            layout.format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+            layout.srgbFormat = true;
+            layout.srgbFilter = true;
+            break;
+        case DATA_USAGE:
+            if (sourceChannels == 1) {
+                layout.channels = 1;
+                layout.format = DXGI_FORMAT_R8_UNORM;
+            }
+            else if (sourceChannels == 2) {
+                layout.channels = 2;
+                layout.format = DXGI_FORMAT_R8G8_UNORM;
+                layout.alphaToGreen = true;
+            }
+            break;
+        case NORMAL_USAGE:
+            layout.channels = 2;
+            layout.format = DXGI_FORMAT_R8G8_UNORM;
+            layout.alphaToGreen = sourceChannels == 2;
+            break;
+        default:
+            layout.srgbFilter = options.srgb;
+            break;
+        }
+        return layout;
+    }
+
+    DXGI_FORMAT
+        blockFormatToDXGI(BlockFormat format, bool srgb) {
+        switch (format) {
+        case BC1_FORMAT: return srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+        case BC3_FORMAT: return srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+        case BC4_FORMAT: return DXGI_FORMAT_BC4_UNORM;
+        case BC5_FORMAT: return DXGI_FORMAT_BC5_UNORM;
+        default: return srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+        }
+    }
+}
+
+TextureSizeCaps
+TextureSizeCaps::desktop() {
+    return TextureSizeCaps();
+}
+
+TextureSizeCaps
+TextureSizeCaps::lowEnd() {
+    TextureSizeCaps caps;
+    caps.maxSize[GENERIC_CATEGORY] = 2048;
+    caps.maxSize[PROP_CATEGORY] = 1024;
+    caps.maxSize[CHARACTER_CATEGORY] = 1024;
+    caps.maxSize[ENVIRONMENT_CATEGORY] = 2048;
+    caps.maxSize[UI_CATEGORY] = 512;
+    return caps;
+}
+
+unsigned int
+Texture::maxImportSize(const TextureImportOptions& options) {
+    if (options.maxSize > 0) {
+        return options.maxSize;
+    }
+    return options.category < TEXTURE_CATEGORY_COUNT ? options.sizeCaps.maxSize[options.category] : 0;
+}
+
+//
+// `cacheSalt` codifica las opciones que cambian el payload guardado en la cache.
+// El filtro de reduccion solo cuenta cuando hay lado maximo, asi que las
+// entradas de las importaciones sin limite conservan su clave.
+//
+uint64_t
+Texture::cacheSalt(const TextureImportOptions& options) {
+    const uint64_t version = 1;
+    const uint64_t maxSize = maxImportSize(options);
+    return version |
+        (maxSize << 24) |
+        (maxSize > 0 ? static_cast<uint64_t>(options.downscaleFilter) << 48 : 0) |
+        (static_cast<uint64_t>(options.generateMips) << 8) |
+        (static_cast<uint64_t>(options.mipFilter) << 9) |
+        (static_cast<uint64_t>(options.srgb) << 12) |
+        (static_cast<uint64_t>(options.compress) << 13) |
+        (static_cast<uint64_t>(options.compressFormat) << 14) |
+        (static_cast<uint64_t>(options.compressQuality) << 18) |
+        (static_cast<uint64_t>(options.usage) << 20) |
+        (static_cast<uint64_t>(options.hdrFormat) << 52);
+}
+
+//
+// `prepare` hace todo el trabajo de CPU de una importacion: genera la cadena de mips
+// y, si se pide, comprime cada nivel por bloques. No usa DirectX, asi que puede
+// ejecutarse en hilos de trabajo.
+//
+HRESULT
+Texture::prepare(const unsigned char* pixels,
+    unsigned int width,
+    unsigned int height,
+    const TextureImportOptions& options,
+    PreparedTexture& prepared,
+    unsigned int sourceChannels) {
+    if (!pixels || width == 0 || height == 0) {
+        ERROR("Texture", "prepare", "Invalid source pixels");
+        return E_INVALIDARG;
+    }
+
+    prepared = PreparedTexture();
+    const TextureLayout layout = resolveLayout(options, sourceChannels);
+
+    // Reducir antes de todo lo demas: los mips, la compresion, la subida y la
+    // memoria de video trabajan ya con el tamano final
+    ImageLevel capped;
+    const unsigned int maxSize = maxImportSize(options);
+    if (maxSize > 0 && (std::max)(width, height) > maxSize) {
+        unsigned int targetWidth = 0, targetHeight = 0;
+        cappedSize(width, height, maxSize, options.compress, targetWidth, targetHeight);
+        MipGenerator resampler;
+        if (!resampler.resize(pixels, width, height, width * 4, targetWidth, targetHeight,
+            options.downscaleFilter, layout.srgbFilter, capped)) {
+            ERROR("Texture", "prepare", "Failed to downscale texture");
+            return E_FAIL;
+        }
+        pixels = capped.pixels.data();
+        width = targetWidth;
+        height = targetHeight;
+    }
+    prepared.width = width;
+    prepared.height = height;
+
+    if (options.generateMips) {
+        MipGenerator mipGenerator;
+        if (!mipGenerator.generate(pixels, width, height, width * 4,
+            options.mipFilter, layout.srgbFilter, prepared.mipLevels)) {
+            ERROR("Texture", "prepare", "Failed to generate mip chain");
+            return E_FAIL;
+        }
+    }
+    else {
+        ImageLevel level;
+        level.width = width;
+        level.height = height;
+        level.rowPitch = width * 4;
+        level.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+        prepared.mipLevels.push_back(std::move(level));
+    }
+
+    // Llevar los canales utiles a las primeras posiciones (gris + alfa -> R, G)
+    if (layout.alphaToGreen) {
+        for (ImageLevel& level : prepared.mipLevels) {
+            for (size_t i = 0; i < level.pixels.size(); i += 4) {
+                level.pixels[i + 1] = level.pixels[i + 3];
+            }
+        }
+    }
+
+    // Los formatos BC exigen que el nivel 0 sea multiplo de 4
+    bool compressed = false;
+    if (options.compress) {
+        if (width % 4 != 0 || height % 4 != 0) {
+            MESSAGE("Texture", "prepare",
+                "Size is not a multiple of 4, uploading uncompressed");
+        }
+        else {
+            // Uno y dos canales siempre van a BC4 / BC5
+            const BlockFormat blockFormat = layout.channels == 1 ? BC4_FORMAT :
+                (layout.channels == 2 ? BC5_FORMAT : options.compressFormat);
+            BlockCompressor compressor;
+            prepared.compressed.resize(prepared.mipLevels.size());
+            for (size_t i = 0; i < prepared.mipLevels.size(); ++i) {
+                if (!compressor.compress(prepared.mipLevels[i], blockFormat,
+                    options.compressQuality, prepared.compressed[i], options.compressThreads)) {
+                    ERROR("Texture", "prepare", "Failed to block-compress texture");
+                    return E_FAIL;
+                }
+            }
+            // Los niveles RGBA8 ya no hacen falta
+            prepared.mipLevels.clear();
+            prepared.format = blockFormatToDXGI(blockFormat, layout.srgbFormat);
+            compressed = true;
+        }
+    }
+
+    // Sin compresion: empaquetar a 1 o 2 canales cuando el formato lo permite
+    if (!compressed) {
+        prepared.format = layout.format;
+        if (layout.channels < 4) {
+            for (ImageLevel& level : prepared.mipLevels) {
+                std::vector<unsigned char> packed(static_cast<size_t>(level.width) * level.height * layout.channels);
+                for (size_t src = 0, dst = 0; dst < packed.size(); src += 4, dst += layout.channels) {
+                    for (unsigned int c = 0; c < layout.channels; ++c) {
+                        packed[dst + c] = level.pixels[src + c];
+                    }
+                }
+                level.pixels.swap(packed);
+                level.rowPitch = level.width * layout.channels;
+            }
+        }
+    }
+
+    for (const CompressedImage& image : prepared.compressed) {
+        TextureCacheLevel level;
+        level.width = image.width;
+        level.height = image.height;
+        level.rowPitch = image.rowPitch;
+        level.data = image.data.data();
+        level.size = image.data.size();
+        prepared.levels.push_back(level);
+    }
+    for (const ImageLevel& image : prepared.mipLevels) {
+        TextureCacheLevel level;
+        level.width = image.width;
+        level.height = image.height;
+        level.rowPitch = image.rowPitch;
+        level.data = image.pixels.data();
+        level.size = image.pixels.size();
+        prepared.levels.push_back(level);
+    }
+    return S_OK;
+}
+
+//
+// `prepareHdr` es el equivalente de `prepare` para imagenes en float: mismo
+// recorte de tamano y mismos filtros de mips, sin sRGB ni compresion. Cada
+// nivel se empaqueta a 4 bytes (RGB9E5) u 8 bytes (half) por texel en lugar
+// de los 16 de RGBA float.
+//
+HRESULT
+Texture::prepareHdr(const float* rgba,
+    unsigned int width,
+    unsigned int height,
+    const TextureImportOptions& options,
+    PreparedTexture& prepared,
+    unsigned int sourceChannels) {
+    if (!rgba || width == 0 || height == 0) {
+        ERROR("Texture", "prepareHdr", "Invalid source texels");
+        return E_INVALIDARG;
+    }
+
+    prepared = PreparedTexture();
+    const bool shared = options.hdrFormat == HDR_RGB9E5_FORMAT ||
+        (options.hdrFormat == HDR_AUTO_FORMAT && sourceChannels < 4);
+    prepared.format = shared ? DXGI_FORMAT_R9G9B9E5_SHAREDEXP : DXGI_FORMAT_R16G16B16A16_FLOAT;
+
+    MipGenerator mipGenerator;
+    HdrImageLevel capped;
+    const unsigned int maxSize = maxImportSize(options);
+    if (maxSize > 0 && (std::max)(width, height) > maxSize) {
+        unsigned int targetWidth = 0, targetHeight = 0;
+        cappedSize(width, height, maxSize, false, targetWidth, targetHeight);
+        if (!mipGenerator.resizeHdr(rgba, width, height, targetWidth, targetHeight,
+            options.downscaleFilter, capped)) {
+            ERROR("Texture", "prepareHdr", "Failed to downscale texture");
+            return E_FAIL;
+        }
+        rgba = capped.texels.data();
+        width = targetWidth;
+        height = targetHeight;
+    }
+    prepared.width = width;
+    prepared.height = height;
+
+    std::vector<HdrImageLevel> levels;
+    if (!mipGenerator.generateHdr(rgba, width, height, options.mipFilter, levels,
+        options.generateMips ? 0 : 1)) {
+        ERROR("Texture", "prepareHdr", "Failed to generate mip chain");
+        return E_FAIL;
+    }
+
+    const unsigned int texelBytes = shared ? 4 : 8;
+    prepared.mipLevels.resize(levels.size());
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const HdrImageLevel& source = levels[i];
+        ImageLevel& level = prepared.mipLevels[i];
+        const size_t texels = static_cast<size_t>(source.width) * source.height;
+        level.width = source.width;
+        level.height = source.height;
+        level.rowPitch = source.width * texelBytes;
+        level.pixels.resize(texels * texelBytes);
+        if (shared) {
+            HdrPacker::packRgb9e5(source.texels.data(), texels, reinterpret_cast<uint32_t*>(level.pixels.data()));
+        }
+        else {
+            HdrPacker::packHalf(source.texels.data(), texels * 4, reinterpret_cast<uint16_t*>(level.pixels.data()));
+        }
+
+        TextureCacheLevel view;
+        view.width = level.width;
+        view.height = level.height;
+        view.rowPitch = level.rowPitch;
+        view.data = level.pixels.data();
+        view.size = level.pixels.size();
+        prepared.levels.push_back(view);
+    }
+    return S_OK;
+}
+
+//
+// `decodeFile` decodifica un PNG/JPG a RGBA8 y lo procesa con `prepare`, que recibe
+// el numero de canales original para elegir el formato final. Un HDR se decodifica
+// a RGBA float y pasa por `prepareHdr`.
+// Los JPEG pasan por JpegDecoder (mismo resultado que stb_image, repartido entre
+// options.decodeThreads hilos). Ambos decodificadores son reentrantes, asi que
+// tambien puede llamarse desde hilos de trabajo.
+//
+HRESULT
+Texture::decodeFile(const std::string& fileName,
+    const TextureImportOptions& options,
+    PreparedTexture& prepared) {
+    std::string extension = std::filesystem::path(fileName).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    // HDR: stb_image lo entrega en float lineal y prepareHdr lo empaqueta
+    if (extension == ".hdr" || stbi_is_hdr(fileName.c_str())) {
+        int width, height, channels;
+        float* data = stbi_loadf(fileName.c_str(), &width, &height, &channels, 4);
+        if (!data) {
+            ERROR("Texture", "decodeFile",
+                ("Failed to decode " + fileName + ": " + std::string(stbi_failure_reason())).c_str());
+            return E_FAIL;
+        }
+        HRESULT hr = prepareHdr(data, width, height, options, prepared, channels);
+        stbi_image_free(data);
+        return hr;
+    }
+
+    if (extension == ".jpg" || extension == ".jpeg") {
+        JpegDecoder decoder;
+        ImageLevel image;
+        unsigned int channels = 0;
+        if (!decoder.decodeFile(fileName, image, channels, options.decodeThreads)) {
+            ERROR("Texture", "decodeFile",
+                ("Failed to decode " + fileName + ": " + std::string(JpegDecoder::failureReason())).c_str());
+            return E_FAIL;
+        }
+        return prepare(image.pixels.data(), image.width, image.height, options, prepared, channels);
+    }
+
+    int width, height, channels;
+    unsigned char* data = stbi_load(fileName.c_str(), &width, &height, &channels, 4);
+    if (!data) {
+        ERROR("Texture", "decodeFile",
+            ("Failed to decode " + fileName + ": " + std::string(stbi_failure_reason())).c_str());
+        return E_FAIL;
+    }
+
+    HRESULT hr = prepare(data, width, height, options, prepared, channels);
+    stbi_image_free(data); //Liberar los datos de imagen inmediatamente
+    return hr;
+}
+
+HRESULT
+Texture::decodeImage(const std::string& fileName,
+    unsigned int decodeThreads,
+    ImageLevel& image,
+    unsigned int& channels) {
+    std::string extension = std::filesystem::path(fileName).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (extension == ".jpg" || extension == ".jpeg") {
+        if (!JpegDecoder().decodeFile(fileName, image, channels, decodeThreads)) {
+            ERROR("Texture", "decodeImage",
+                ("Failed to decode " + fileName + ": " + std::string(JpegDecoder::failureReason())).c_str());
+            return E_FAIL;
+        }
+        return S_OK;
+    }
+
+    int width, height, sourceChannels;
+    unsigned char* data = stbi_load(fileName.c_str(), &width, &height, &sourceChannels, 4);
+    if (!data) {
+        ERROR("Texture", "decodeImage",
+            ("Failed to decode " + fileName + ": " + std::string(stbi_failure_reason())).c_str());
+        return E_FAIL;
+    }
+    image.width = static_cast<unsigned int>(width);
+    image.height = static_cast<unsigned int>(height);
+    image.rowPitch = image.width * 4;
+    image.pixels.assign(data, data + static_cast<size_t>(image.rowPitch) * image.height);
+    channels = static_cast<unsigned int>(sourceChannels);
+    stbi_image_free(data);
+    return S_OK;
+}
+
+HRESULT
+Texture::decodeLinear(const std::string& fileName,
+    bool srgb,
+    unsigned int decodeThreads,
+    std::vector<float>& rgba,
+    unsigned int& width,
+    unsigned int& height,
+    unsigned int& channels) {
+    if (stbi_is_hdr(fileName.c_str())) {
+        int w, h, c;
+        float* data = stbi_loadf(fileName.c_str(), &w, &h, &c, 4);
+        if (!data) {
+            ERROR("Texture", "decodeLinear",
+                ("Failed to decode " + fileName + ": " + std::string(stbi_failure_reason())).c_str());
+            return E_FAIL;
+        }
+        width = static_cast<unsigned int>(w);
+        height = static_cast<unsigned int>(h);
+        channels = static_cast<unsigned int>(c);
+        rgba.assign(data, data + static_cast<size_t>(width) * height * 4);
+        stbi_image_free(data);
+        return S_OK;
+    }
+
+    ImageLevel image;
+    HRESULT hr = decodeImage(fileName, decodeThreads, image, channels);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    EnvironmentPrefilter::toLinear(image, srgb, rgba);
+    width = image.width;
+    height = image.height;
+    return S_OK;
+}
+
+//
+// Crea la textura a partir de un resultado de `prepare`.
+//
+HRESULT
+Texture::init(Device& device, const PreparedTexture& prepared) {
+    if (!device.m_device) {
+        ERROR("Texture", "init", "Device is null.");
+        return E_POINTER;
+    }
+    return createShaderResource(device, prepared.width, prepared.height,
+        prepared.format, prepared.levels);
+}
+
+//
+// Crea la textura desde una entrada de la cache sin decodificar nada:
+// los punteros de D3D11_SUBRESOURCE_DATA apuntan al archivo proyectado.
+//
+HRESULT
+Texture::init(Device& device, const TextureCacheEntry& entry) {
+    if (!device.m_device) {
+        ERROR("Texture", "init", "Device is null.");
+        return E_POINTER;
+    }
+    return createShaderResource(device, entry.width, entry.height,
+        static_cast<DXGI_FORMAT>(entry.format), entry.levels);
+}
+
+//
+// Crea un Texture2DArray: una capa por textura preparada. Todas deben tener
+// el mismo tamano, formato y numero de mips.
+//
+HRESULT
+Texture::init(Device& device, const std::vector<PreparedTexture>& slices) {
+    if (!device.m_device) {
+        ERROR("Texture", "init", "Device is null.");
+        return E_POINTER;
+    }
+    if (slices.empty()) {
+        ERROR("Texture", "init", "Texture array needs at least one slice");
+        return E_INVALIDARG;
+    }
+
+    const PreparedTexture& first = slices[0];
+    std::vector<TextureCacheLevel> levels;
+    levels.reserve(slices.size() * first.levels.size());
+    for (const PreparedTexture& slice : slices) {
+        if (slice.width != first.width || slice.height != first.height ||
+            slice.format != first.format || slice.levels.size() != first.levels.size()) {
+            ERROR("Texture", "init", "Texture array slices must share size, format and mip count");
+            return E_INVALIDARG;
+        }
+        levels.insert(levels.end(), slice.levels.begin(), slice.levels.end());
+    }
+
+    // Siempre TEXTURE2DARRAY, aunque haya una sola capa: el shader declara Texture2DArray
+    HRESULT hr = createShaderResource(device, first.width, first.height, first.format,
+        levels, static_cast<unsigned int>(slices.size()), false, true);
+    if (SUCCEEDED(hr)) {
+        m_arraySize = static_cast<unsigned int>(slices.size());
+    }
+    return hr;
+}
+
+//
+// Carga varias imagenes del mismo tamano como capas de un Texture2DArray.
+// La capa de cada imagen es su posicion en `textureNames` (ver `findSlice`).
+//
+HRESULT
+Texture::init(Device& device,
+    const std::vector<std::string>& textureNames,
+    ExtensionType extensionType,
+    const TextureImportOptions& options) {
+    if (extensionType == DDS) {
+        ERROR("Texture", "init", "Texture arrays only support PNG, JPG and HDR");
+        return E_INVALIDARG;
+    }
+
+    std::vector<PreparedTexture> slices(textureNames.size());
+    m_sliceNames.clear();
+    for (size_t i = 0; i < textureNames.size(); ++i) {
+        const std::string fileName = textureNames[i] + sourceExtension(extensionType);
+        HRESULT hr = decodeFile(fileName, options, slices[i]);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        m_sliceNames.push_back(textureNames[i]);
+    }
+
+    HRESULT hr = init(device, slices);
+    if (FAILED(hr)) {
+        m_sliceNames.clear();
+    }
+    return hr;
+}
+
+//
+// Crea un cubemap con seis caras preparadas. Es el mismo camino que un arreglo
+// de seis capas, con la bandera de cubemap en la textura y en la vista.
+//
+HRESULT
+Texture::initCube(Device& device, const std::vector<PreparedTexture>& faces) {
+    if (!device.m_device) {
+        ERROR("Texture", "initCube", "Device is null.");
+        return E_POINTER;
+    }
+    if (faces.size() != CUBE_FACE_COUNT) {
+        ERROR("Texture", "initCube", "Cubemap needs exactly six faces");
+        return E_INVALIDARG;
+    }
+
+    const PreparedTexture& first = faces[0];
+    std::vector<TextureCacheLevel> levels;
+    levels.reserve(faces.size() * first.levels.size());
+    for (const PreparedTexture& face : faces) {
+        if (face.width != first.width || face.height != first.height ||
+            face.format != first.format || face.levels.size() != first.levels.size()) {
+            ERROR("Texture", "initCube", "Cubemap faces must share size, format and mip count");
+            return E_INVALIDARG;
+        }
+        levels.insert(levels.end(), face.levels.begin(), face.levels.end());
+    }
+    if (first.width != first.height) {
+        ERROR("Texture", "initCube", "Cubemap faces must be square");
+        return E_INVALIDARG;
+    }
+    return initCube(device, first.width, first.format, levels);
+}
+
+HRESULT
+Texture::initCube(Device& device,
+    unsigned int size,
+    DXGI_FORMAT format,
+    const std::vector<TextureCacheLevel>& levels) {
+    if (!device.m_device) {
+        ERROR("Texture", "initCube", "Device is null.");
+        return E_POINTER;
+    }
+    HRESULT hr = createShaderResource(device, size, size, format, levels, CUBE_FACE_COUNT, true);
+    if (SUCCEEDED(hr)) {
+        m_cubemap = true;
+        m_arraySize = 0;
+    }
+    return hr;
+}
+
+HRESULT
+Texture::initCube(Device& device,
+    const std::vector<std::string>& faceNames,
+    ExtensionType extensionType,
+    const TextureImportOptions& options) {
+    if (extensionType == DDS) {
+        ERROR("Texture", "initCube", "Cubemaps only support PNG, JPG and HDR");
+        return E_INVALIDARG;
+    }
+    if (faceNames.size() != CUBE_FACE_COUNT) {
+        ERROR("Texture", "initCube", "Cubemap needs exactly six faces");
+        return E_INVALIDARG;
+    }
+
+    std::vector<PreparedTexture> faces(faceNames.size());
+    for (size_t i = 0; i < faceNames.size(); ++i) {
+        const std::string fileName = faceNames[i] + sourceExtension(extensionType);
+        HRESULT hr = decodeFile(fileName, options, faces[i]);
+        if (FAILED(hr)) {
+            return hr;
+        }
+    }
+    m_textureName = faceNames[0] + sourceExtension(extensionType);
+    return initCube(device, faces);
+}
+
+//
+// Proyecta una imagen equirectangular sobre las seis caras en espacio lineal
+// (ver EnvironmentPrefilter::fromEquirect) y prepara cada cara con las opciones.
+// Las caras de un HDR se empaquetan directamente desde float.
+//
+HRESULT
+Texture::initCube(Device& device,
+    const std::string& textureName,
+    ExtensionType extensionType,
+    unsigned int faceSize,
+    const TextureImportOptions& options) {
+    if (extensionType == DDS) {
+        ERROR("Texture", "initCube", "Cubemaps only support PNG, JPG and HDR");
+        return E_INVALIDARG;
+    }
+    m_textureName = textureName + sourceExtension(extensionType);
+
+    std::vector<float> linear;
+    unsigned int width = 0, height = 0, channels = 0;
+    HRESULT hr = decodeLinear(m_textureName, options.srgb, options.decodeThreads, linear, width, height, channels);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    CubeImage cube;
+    if (!EnvironmentPrefilter::fromEquirect(linear.data(), width, height, faceSize, cube)) {
+        ERROR("Texture", "initCube", ("Failed to project equirectangular image: " + m_textureName).c_str());
+        return E_FAIL;
+    }
+
+    std::vector<PreparedTexture> faces(CUBE_FACE_COUNT);
+    if (extensionType == HDR) {
+        for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+            hr = prepareHdr(cube.face(f), cube.size, cube.size, options, faces[f], channels);
+            if (FAILED(hr)) {
+                return hr;
+            }
+        }
+        return initCube(device, faces);
+    }
+
+    ImageLevel faceImages[CUBE_FACE_COUNT];
+    EnvironmentPrefilter::toFaces(cube, options.srgb, faceImages);
+    for (unsigned int f = 0; f < CUBE_FACE_COUNT; ++f) {
+        hr = prepare(faceImages[f].pixels.data(), cube.size, cube.size, options, faces[f], channels);
+        if (FAILED(hr)) {
+            return hr;
+        }
+    }
+    return initCube(device, faces);
+}
+
+int
+Texture::findSlice(const std::string& textureName) const {
+    for (size_t i = 0; i < m_sliceNames.size(); ++i) {
+        if (m_sliceNames[i] == textureName) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+//
+// `createShaderResource` crea la textura 2D (o arreglo 2D) con todos sus niveles y una SRV que los cubre.
+// Los niveles van ordenados por capa: capa * numMips + mip, que es el orden de subrecursos de D3D11.
+// La textura se libera en cuanto existe la vista; la SRV mantiene viva la referencia.
+//
+HRESULT
+Texture::createShaderResource(Device& device,
+    unsigned int width,
+    unsigned int height,
+    DXGI_FORMAT format,
+    const std::vector<TextureCacheLevel>& levels,
+    unsigned int arraySize,
+    bool cube,
+    bool array) {
+    if (arraySize == 0 || levels.empty() || levels.size() % arraySize != 0 ||
+        (cube && arraySize != CUBE_FACE_COUNT)) {
+        ERROR("Texture", "createShaderResource", "Invalid level count for texture");
+        return E_INVALIDARG;
+    }
+
+    std::vector<D3D11_SUBRESOURCE_DATA> initData(levels.size());
+    for (size_t i = 0; i < levels.size(); ++i) {
+        initData[i].pSysMem = levels[i].data;
+        initData[i].SysMemPitch = levels[i].rowPitch;
+        initData[i].SysMemSlicePitch = 0;
+    }
+
+    //Crear descripcion de textura
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = width;
+    textureDesc.Height = height;
+    textureDesc.MipLevels = static_cast<unsigned int>(initData.size()) / arraySize;
+    textureDesc.ArraySize = arraySize;
+    textureDesc.Format = format;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    textureDesc.MiscFlags = cube ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0;
+
+    HRESULT hr = device.CreateTexture2D(&textureDesc, initData.data(), &m_texture);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    //Crear vista del recurso de la textura (todos los niveles y capas)
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = textureDesc.Format;
+    if (cube) {
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+        srvDesc.TextureCube.MipLevels = textureDesc.MipLevels;
+    }
+    else if (array || arraySize > 1) {
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        srvDesc.Texture2DArray.MipLevels = textureDesc.MipLevels;
+        srvDesc.Texture2DArray.ArraySize = arraySize;
+    }
+    else {
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MipLevels = textureDesc.MipLevels;
+    }
+
+    hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
+    SAFE_RELEASE(m_texture); //Liberar texturra inmediatamente
+
+    if (FAILED(hr)) {
+        ERROR("Texture", "createShaderResource", "Failed to create shader resource view");
+        return hr;
+    }
+
+    m_memoryBytes = 0;
+    for (const TextureCacheLevel& level : levels) {
+        m_memoryBytes += level.size;
+    }
+    return S_OK;
+}
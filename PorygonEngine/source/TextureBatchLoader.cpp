@@ -0,0 +1,284 @@
+#include "TextureBatchLoader.h"
+#include "Device.h"
+#include "stb_image.h"
+#include <filesystem>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    std::string sourceFileName(const TextureLoadRequest& request) {
+        switch (request.extensionType) {
+        case DDS: return request.textureName + ".dds";
+        case PNG: return request.textureName + ".png";
+        case HDR: return request.textureName + ".hdr";
+        default: return request.textureName + ".jpg";
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------
+// Metricas
+// ------------------------------------------------------------------------------
+double
+TextureBatchStats::imagesPerSecond() const {
+    return wallMs > 0.0 ? (created + failed) * 1000.0 / wallMs : 0.0;
+}
+
+double
+TextureBatchStats::megabytesPerSecond() const {
+    return wallMs > 0.0 ? (decodedBytes / (1024.0 * 1024.0)) * 1000.0 / wallMs : 0.0;
+}
+
+// ------------------------------------------------------------------------------
+// TextureBatchLoader
+// ------------------------------------------------------------------------------
+TextureBatchLoader::TextureBatchLoader(ThreadPool& pool, size_t memoryBudget)
+    : m_pool(pool), m_memoryBudget(memoryBudget) {
+}
+
+TextureBatchLoader::~TextureBatchLoader() {
+    // Las tareas en vuelo usan `this`: las que esperan presupuesto no llegan a
+    // encolarse y se descartan los resultados listos hasta que todas terminen.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_inFlight -= static_cast<unsigned int>(m_waiting.size());
+        m_waiting.clear();
+        for (const ReadyTexture& item : m_ready) {
+            m_budgetInUse -= item.budgetBytes;
+        }
+        m_ready.clear();
+        if (m_inFlight == 0) {
+            break;
+        }
+        m_readyAvailable.wait(lock);
+    }
+}
+
+void
+TextureBatchLoader::submit(const TextureLoadRequest& request) {
+    if (!request.target) {
+        ERROR("TextureBatchLoader", "submit", "Target texture is null");
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pending == 0) {
+            m_batchStart = Clock::now();
+        }
+        ++m_pending;
+        ++m_stats.submitted;
+
+        // DDS no se decodifica en CPU: se carga directamente en el hilo de render
+        if (request.extensionType == DDS) {
+            ReadyTexture ready;
+            ready.request = request;
+            m_ready.push_back(std::move(ready));
+            m_readyAvailable.notify_all();
+            return;
+        }
+        ++m_inFlight;
+    }
+
+    m_pool.submit([this, request]() { probe(request); });
+}
+
+void
+TextureBatchLoader::probe(const TextureLoadRequest& request) {
+    const Clock::time_point start = Clock::now();
+    const std::string fileName = sourceFileName(request);
+    std::shared_ptr<PendingDecode> pending = std::make_shared<PendingDecode>();
+    pending->ready.request = request;
+
+    // Una entrada de la cache evita decodificar y no consume presupuesto
+    if (!request.options.cacheDirectory.empty()) {
+        pending->cacheable = TextureCache::makeKey(fileName, Texture::cacheSalt(request.options), pending->cacheKey);
+        if (pending->cacheable && TextureCache(request.options.cacheDirectory).load(pending->cacheKey, pending->ready.cacheEntry)) {
+            pending->ready.fromCache = true;
+            publish(*pending, elapsedMs(start, Clock::now()), 0);
+            return;
+        }
+    }
+
+    int width = 0, height = 0, channels = 0;
+    if (!stbi_info(fileName.c_str(), &width, &height, &channels)) {
+        ERROR("TextureBatchLoader", "probe", ("Failed to read image header: " + fileName).c_str());
+        pending->ready.result = E_FAIL;
+        publish(*pending, elapsedMs(start, Clock::now()), 0);
+        return;
+    }
+
+    // Reserva: imagen RGBA8 (RGBA float si es HDR) mas, con mips, un tercio extra de la cadena
+    const size_t texelBytes = stbi_is_hdr(fileName.c_str()) ? 16 : 4;
+    pending->decodedBytes = static_cast<size_t>(width) * height * texelBytes;
+    pending->ready.budgetBytes = request.options.generateMips ?
+        pending->decodedBytes + pending->decodedBytes / 3 : pending->decodedBytes;
+
+    // La decodificacion se encola cuando cabe en el presupuesto: ningun hilo del grupo espera
+    const Clock::time_point end = Clock::now();
+    pending->workerMs = elapsedMs(start, end);
+    pending->queued = end;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_waiting.push_back(std::move(pending));
+    dispatchWaiting();
+    // El destructor puede estar esperando para descartar lo que no se encolo
+    m_readyAvailable.notify_all();
+}
+
+void
+TextureBatchLoader::dispatchWaiting() {
+    // En orden FIFO: una imagen grande no queda relegada por las pequenas que llegan detras
+    while (!m_waiting.empty()) {
+        const size_t budgetBytes = m_waiting.front()->ready.budgetBytes;
+        if (m_budgetInUse != 0 && m_budgetInUse + budgetBytes > m_memoryBudget) {
+            break;
+        }
+        std::shared_ptr<PendingDecode> pending = std::move(m_waiting.front());
+        m_waiting.pop_front();
+        m_budgetInUse += budgetBytes;
+        m_stats.peakBudgetBytes = (std::max)(m_stats.peakBudgetBytes, m_budgetInUse);
+        m_stats.budgetWaitMs += elapsedMs(pending->queued, Clock::now());
+        m_pool.submit([this, pending]() { decode(*pending); });
+    }
+}
+
+void
+TextureBatchLoader::decode(PendingDecode& pending) {
+    const Clock::time_point start = Clock::now();
+    const TextureLoadRequest& request = pending.ready.request;
+    const std::string fileName = sourceFileName(request);
+
+    // Las imagenes ya se decodifican en paralelo: un hilo por imagen
+    TextureImportOptions options = request.options;
+    options.decodeThreads = 1;
+    options.compressThreads = 1;
+    pending.ready.result = Texture::decodeFile(fileName, options, pending.ready.prepared);
+    if (SUCCEEDED(pending.ready.result) && pending.cacheable) {
+        TextureCache(request.options.cacheDirectory).store(pending.cacheKey,
+            pending.ready.prepared.format, pending.ready.prepared.levels);
+    }
+
+    std::error_code error;
+    size_t sourceBytes = static_cast<size_t>(std::filesystem::file_size(fileName, error));
+    if (error) {
+        sourceBytes = 0;
+    }
+    publish(pending, pending.workerMs + elapsedMs(start, Clock::now()), sourceBytes);
+}
+
+void
+TextureBatchLoader::publish(PendingDecode& pending, double workerMs, size_t sourceBytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.decodeMs += workerMs;
+    m_stats.sourceBytes += sourceBytes;
+    m_stats.decodedBytes += SUCCEEDED(pending.ready.result) && !pending.ready.fromCache ? pending.decodedBytes : 0;
+    m_stats.cacheHits += pending.ready.fromCache ? 1 : 0;
+    m_ready.push_back(std::move(pending.ready));
+    --m_inFlight;
+    m_readyAvailable.notify_all();
+}
+
+unsigned int
+TextureBatchLoader::pump(Device& device, unsigned int maxTextures) {
+    unsigned int processed = 0;
+    while (maxTextures == 0 || processed < maxTextures) {
+        ReadyTexture item;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_ready.empty()) {
+                break;
+            }
+            item = std::move(m_ready.front());
+            m_ready.pop_front();
+        }
+
+        const Clock::time_point start = Clock::now();
+        Texture& target = *item.request.target;
+        HRESULT hr = item.result;
+        if (SUCCEEDED(hr)) {
+            if (item.request.extensionType == DDS) {
+                hr = target.init(device, item.request.textureName, DDS, item.request.options);
+            }
+            else {
+                target.m_textureName = sourceFileName(item.request);
+                hr = item.fromCache ? target.init(device, item.cacheEntry) : target.init(device, item.prepared);
+            }
+        }
+        if (FAILED(hr)) {
+            ERROR("TextureBatchLoader", "pump", ("Failed to create texture: " + item.request.textureName).c_str());
+        }
+
+        // Liberar los texeles antes de devolver el presupuesto
+        item.prepared = PreparedTexture();
+        item.cacheEntry = TextureCacheEntry();
+        const Clock::time_point end = Clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_budgetInUse -= item.budgetBytes;
+            m_stats.createMs += elapsedMs(start, end);
+            if (SUCCEEDED(hr)) {
+                ++m_stats.created;
+            }
+            else {
+                ++m_stats.failed;
+                if (m_firstError == S_OK) {
+                    m_firstError = hr;
+                }
+            }
+            if (--m_pending == 0) {
+                m_stats.wallMs += elapsedMs(m_batchStart, end);
+            }
+            dispatchWaiting();
+        }
+        ++processed;
+    }
+    return processed;
+}
+
+HRESULT
+TextureBatchLoader::loadAll(Device& device, const std::vector<TextureLoadRequest>& requests) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_firstError = S_OK;
+    }
+    for (const TextureLoadRequest& request : requests) {
+        submit(request);
+    }
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_readyAvailable.wait(lock, [this]() { return !m_ready.empty() || m_pending == 0; });
+            if (m_pending == 0) {
+                break;
+            }
+        }
+        pump(device);
+    }
+
+    const TextureBatchStats batch = stats();
+    MESSAGE("TextureBatchLoader", "loadAll",
+        ("Texturas: " + std::to_string(batch.created) + "/" + std::to_string(batch.submitted) +
+            ", img/s: " + std::to_string(batch.imagesPerSecond()) +
+            ", MB/s: " + std::to_string(batch.megabytesPerSecond())).c_str());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_firstError;
+}
+
+bool
+TextureBatchLoader::done() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending == 0;
+}
+
+TextureBatchStats
+TextureBatchLoader::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
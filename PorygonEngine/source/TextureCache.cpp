@@ -0,0 +1,333 @@
+#include "TextureCache.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char kMagic[4] = { 'P', 'T', 'X', 'C' };
+    const uint32_t kVersion = 1;
+    const uint64_t kAlignment = 16;
+
+    /**
+     * @brief Cabecera del archivo de cache (32 bytes).
+     */
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipCount;
+    };
+
+    /**
+     * @brief Entrada de la tabla de niveles (32 bytes).
+     */
+    struct FileLevel {
+        uint64_t offset;
+        uint64_t size;
+        uint32_t width;
+        uint32_t height;
+        uint32_t rowPitch;
+        uint32_t reserved;
+    };
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    /**
+     * @brief Lado del bloque y bytes por bloque (o por texel) de un valor de DXGI_FORMAT.
+     * @return false si la cache no conoce el formato.
+     */
+    bool formatLayout(uint32_t format, uint32_t& blockSize, uint32_t& elementBytes) {
+        blockSize = 1;
+        switch (format) {
+        case 2:  elementBytes = 16; return true;                         // R32G32B32A32_FLOAT
+        case 10: elementBytes = 8; return true;                          // R16G16B16A16_FLOAT
+        case 28: case 29: case 67: elementBytes = 4; return true;       // R8G8B8A8, R9G9B9E5
+        case 49: elementBytes = 2; return true;                          // R8G8
+        case 61: elementBytes = 1; return true;                          // R8
+        default: break;
+        }
+        blockSize = 4;
+        if ((format >= 70 && format <= 72) || (format >= 79 && format <= 81)) {
+            elementBytes = 8;                                            // BC1, BC4
+            return true;
+        }
+        if ((format >= 73 && format <= 78) || (format >= 82 && format <= 84) || (format >= 94 && format <= 99)) {
+            elementBytes = 16;                                           // BC2, BC3, BC5, BC6H, BC7
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Comprueba que el pitch cubre una fila y que el tamano cubre todas las filas.
+     *
+     * D3D lee rowPitch * filas bytes desde pSysMem: un nivel truncado o de otro
+     * formato se leeria fuera de la proyeccion.
+     */
+    bool levelIsComplete(uint32_t format, uint32_t width, uint32_t height, uint32_t rowPitch, uint64_t size) {
+        uint32_t blockSize = 1;
+        uint32_t elementBytes = 0;
+        if (width == 0 || height == 0 || !formatLayout(format, blockSize, elementBytes)) {
+            return false;
+        }
+        const uint64_t columns = (static_cast<uint64_t>(width) + blockSize - 1) / blockSize;
+        const uint64_t rows = (static_cast<uint64_t>(height) + blockSize - 1) / blockSize;
+        return rowPitch >= columns * elementBytes && size >= static_cast<uint64_t>(rowPitch) * rows;
+    }
+}
+
+// ------------------------------------------------------------------------------
+// MappedFile
+// ------------------------------------------------------------------------------
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile&
+MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_data = nullptr;
+        other.m_size = 0;
+#ifdef _WIN32
+        m_file = other.m_file;
+        m_mapping = other.m_mapping;
+        other.m_file = nullptr;
+        other.m_mapping = nullptr;
+#endif
+    }
+    return *this;
+}
+
+bool
+MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const unsigned char*>(view);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // La proyeccion sigue valida sin el descriptor
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    m_data = static_cast<const unsigned char*>(view);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+void
+MappedFile::close() {
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_file = nullptr;
+    m_mapping = nullptr;
+#else
+    if (m_data) munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+// ------------------------------------------------------------------------------
+// TextureCache
+// ------------------------------------------------------------------------------
+bool
+TextureCache::makeKey(const std::string& sourcePath, uint64_t salt, uint64_t& key) {
+    std::ifstream file(sourcePath, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char* saltBytes = reinterpret_cast<const unsigned char*>(&salt);
+    for (size_t i = 0; i < sizeof(salt); ++i) {
+        hash = (hash ^ saltBytes[i]) * 1099511628211ull;
+    }
+
+    std::vector<char> buffer(1 << 20);
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const std::streamsize count = file.gcount();
+        for (std::streamsize i = 0; i < count; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(buffer[static_cast<size_t>(i)])) * 1099511628211ull;
+        }
+    }
+    key = hash;
+    return true;
+}
+
+std::string
+TextureCache::entryPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.ptc", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_directory) / name).string();
+}
+
+bool
+TextureCache::load(uint64_t key, TextureCacheEntry& entry) const {
+    MappedFile file;
+    if (!file.open(entryPath(key)) || file.size() < sizeof(FileHeader)) {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, 4) != 0 || header.version != kVersion ||
+        header.key != key || header.mipCount == 0 ||
+        sizeof(FileHeader) + static_cast<uint64_t>(header.mipCount) * sizeof(FileLevel) > file.size()) {
+        return false;
+    }
+
+    entry.levels.clear();
+    entry.levels.reserve(header.mipCount);
+    const unsigned char* table = file.data() + sizeof(FileHeader);
+    for (uint32_t i = 0; i < header.mipCount; ++i) {
+        FileLevel level;
+        std::memcpy(&level, table + i * sizeof(FileLevel), sizeof(level));
+        if (level.offset > file.size() || level.size > file.size() - level.offset ||
+            !levelIsComplete(header.format, level.width, level.height, level.rowPitch, level.size)) {
+            entry.levels.clear();
+            return false;
+        }
+        TextureCacheLevel out;
+        out.width = level.width;
+        out.height = level.height;
+        out.rowPitch = level.rowPitch;
+        out.data = file.data() + level.offset;
+        out.size = static_cast<size_t>(level.size);
+        entry.levels.push_back(out);
+    }
+
+    entry.format = header.format;
+    entry.width = header.width;
+    entry.height = header.height;
+    entry.file = std::move(file);
+    return true;
+}
+
+bool
+TextureCache::store(uint64_t key, unsigned int format, const std::vector<TextureCacheLevel>& levels) const {
+    if (levels.empty()) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.key = key;
+    header.format = format;
+    header.width = levels[0].width;
+    header.height = levels[0].height;
+    header.mipCount = static_cast<uint32_t>(levels.size());
+
+    std::vector<FileLevel> table(levels.size());
+    uint64_t offset = alignUp(sizeof(FileHeader) + table.size() * sizeof(FileLevel));
+    for (size_t i = 0; i < levels.size(); ++i) {
+        // Una entrada que load rechazaria solo ocuparia disco
+        if (!levelIsComplete(format, levels[i].width, levels[i].height, levels[i].rowPitch, levels[i].size)) {
+            return false;
+        }
+        table[i].offset = offset;
+        table[i].size = levels[i].size;
+        table[i].width = levels[i].width;
+        table[i].height = levels[i].height;
+        table[i].rowPitch = levels[i].rowPitch;
+        table[i].reserved = 0;
+        offset = alignUp(offset + levels[i].size);
+    }
+
+    const std::string path = entryPath(key);
+    // Nombre temporal unico: varios hilos pueden escribir la misma clave a la vez
+    static std::atomic<unsigned int> tempCounter(0);
+    const std::string tempPath = path + "." + std::to_string(tempCounter++) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        const char padding[kAlignment] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(table.data()),
+            static_cast<std::streamsize>(table.size() * sizeof(FileLevel)));
+        uint64_t written = sizeof(FileHeader) + table.size() * sizeof(FileLevel);
+        for (size_t i = 0; i < levels.size(); ++i) {
+            file.write(padding, static_cast<std::streamsize>(table[i].offset - written));
+            file.write(reinterpret_cast<const char*>(levels[i].data), static_cast<std::streamsize>(levels[i].size));
+            written = table[i].offset + levels[i].size;
+        }
+        if (!file) {
+            file.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    // Reemplazar la entrada anterior solo cuando la nueva esta completa
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
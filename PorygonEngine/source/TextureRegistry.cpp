@@ -0,0 +1,138 @@
+#include "TextureRegistry.h"
+#include "Device.h"
+#include "TextureResidency.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <set>
+
+namespace {
+    std::string extensionOf(ExtensionType extensionType) {
+        switch (extensionType) {
+        case DDS: return ".dds";
+        case PNG: return ".png";
+        case HDR: return ".hdr";
+        default: return ".jpg";
+        }
+    }
+}
+
+std::string
+TextureRegistry::normalizePath(const std::string& path) {
+    std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return normalized;
+}
+
+TextureHandle
+TextureRegistry::acquire(Device& device,
+    const std::string& textureName,
+    ExtensionType extensionType,
+    const TextureImportOptions& options) {
+    ++m_stats.lookups;
+    collect();
+
+    const std::string fileName = normalizePath(textureName + extensionOf(extensionType));
+    const std::string key = fileName + "|" + std::to_string(Texture::cacheSalt(options));
+
+    auto byPath = m_byPath.find(key);
+    if (byPath != m_byPath.end()) {
+        if (TextureHandle texture = byPath->second.texture.lock()) {
+            ++m_stats.pathHits;
+            return texture;
+        }
+    }
+
+    // Otra ruta al mismo archivo (con las mismas opciones) comparte la textura
+    uint64_t contentKey = 0;
+    const bool hashed = TextureCache::makeKey(textureName + extensionOf(extensionType),
+        Texture::cacheSalt(options), contentKey);
+    if (hashed) {
+        auto byContent = m_byContent.find(contentKey);
+        if (byContent != m_byContent.end()) {
+            auto shared = m_byPath.find(byContent->second);
+            if (shared != m_byPath.end()) {
+                if (TextureHandle texture = shared->second.texture.lock()) {
+                    ++m_stats.contentHits;
+                    Entry alias;
+                    alias.name = fileName;
+                    alias.contentKey = contentKey;
+                    alias.texture = texture;
+                    m_byPath[key] = alias;
+                    return texture;
+                }
+            }
+        }
+    }
+
+    TextureHandle texture(new Texture(), [](Texture* released) {
+        if (released->m_residency) {
+            released->m_residency->untrack(*released);
+        }
+        released->destroy();
+        delete released;
+        });
+    HRESULT hr = texture->init(device, textureName, extensionType, options);
+    if (FAILED(hr)) {
+        ++m_stats.failures;
+        ERROR("TextureRegistry", "acquire", ("Failed to load texture: " + fileName).c_str());
+        return nullptr;
+    }
+    ++m_stats.loads;
+
+    Entry entry;
+    entry.name = fileName;
+    entry.contentKey = hashed ? contentKey : 0;
+    entry.owner = true;
+    entry.texture = texture;
+    m_byPath[key] = entry;
+    if (hashed) {
+        m_byContent[contentKey] = key;
+    }
+    return texture;
+}
+
+void
+TextureRegistry::collect() {
+    for (auto it = m_byPath.begin(); it != m_byPath.end();) {
+        if (!it->second.texture.expired()) {
+            ++it;
+            continue;
+        }
+        auto byContent = m_byContent.find(it->second.contentKey);
+        if (byContent != m_byContent.end() && byContent->second == it->first) {
+            m_byContent.erase(byContent);
+        }
+        if (it->second.owner) {
+            ++m_stats.released;
+        }
+        it = m_byPath.erase(it);
+    }
+}
+
+std::vector<ResidentTextureInfo>
+TextureRegistry::residentTextures() {
+    collect();
+    std::vector<ResidentTextureInfo> resident;
+    std::set<const Texture*> seen;
+    for (const auto& item : m_byPath) {
+        TextureHandle texture = item.second.texture.lock();
+        if (!texture || !item.second.owner || !seen.insert(texture.get()).second) continue;
+        ResidentTextureInfo info;
+        info.name = item.second.name;
+        info.memoryBytes = texture->m_memoryBytes;
+        info.useCount = texture.use_count() - 1; // Sin contar esta copia
+        resident.push_back(info);
+    }
+    return resident;
+}
+
+size_t
+TextureRegistry::residentBytes() {
+    size_t total = 0;
+    for (const ResidentTextureInfo& info : residentTextures()) {
+        total += info.memoryBytes;
+    }
+    return total;
+}
@@ -0,0 +1,357 @@
+#include "TextureResidency.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <algorithm>
+
+namespace {
+    bool isBlockCompressed(DXGI_FORMAT format) {
+        return (format >= DXGI_FORMAT_BC1_TYPELESS && format <= DXGI_FORMAT_BC5_SNORM) ||
+            (format >= DXGI_FORMAT_BC6H_TYPELESS && format <= DXGI_FORMAT_BC7_UNORM_SRGB);
+    }
+
+    /**
+     * @brief Bytes de un nivel; los formatos no listados se cuentan como 32 bits por texel.
+     */
+    size_t levelBytes(DXGI_FORMAT format, unsigned int width, unsigned int height) {
+        if (isBlockCompressed(format)) {
+            const bool eightByteBlocks = format <= DXGI_FORMAT_BC1_UNORM_SRGB ||
+                (format >= DXGI_FORMAT_BC4_TYPELESS && format <= DXGI_FORMAT_BC4_SNORM);
+            return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * (eightByteBlocks ? 8 : 16);
+        }
+
+        size_t bytesPerTexel = 4;
+        switch (format) {
+        case DXGI_FORMAT_R8_UNORM:
+            bytesPerTexel = 1;
+            break;
+        case DXGI_FORMAT_R8G8_UNORM:
+            bytesPerTexel = 2;
+            break;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            bytesPerTexel = 8;
+            break;
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            bytesPerTexel = 16;
+            break;
+        default:
+            break;
+        }
+        return static_cast<size_t>(width) * height * bytesPerTexel;
+    }
+
+    size_t textureBytes(const D3D11_TEXTURE2D_DESC& desc) {
+        size_t total = 0;
+        for (unsigned int level = 0; level < desc.MipLevels; ++level) {
+            total += levelBytes(desc.Format, (std::max)(1u, desc.Width >> level), (std::max)(1u, desc.Height >> level));
+        }
+        return total * desc.ArraySize;
+    }
+
+    /**
+     * @brief Textura 2D detras de la SRV, con una referencia que el llamador libera.
+     *
+     * Texture libera m_texture en cuanto crea la vista, asi que el recurso de
+     * las texturas cargadas de archivo solo se alcanza desde m_textureFromImg.
+     */
+    ID3D11Texture2D* viewTexture(const Texture& texture) {
+        if (!texture.m_textureFromImg) {
+            return nullptr;
+        }
+        ID3D11Resource* resource = nullptr;
+        texture.m_textureFromImg->GetResource(&resource);
+        if (!resource) {
+            return nullptr;
+        }
+        D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+        resource->GetType(&dimension);
+        if (dimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+            resource->Release();
+            return nullptr;
+        }
+        return static_cast<ID3D11Texture2D*>(resource);
+    }
+
+    /**
+     * @brief DDS no informa su memoria al cargarse: se calcula a partir de la descripcion.
+     */
+    void measure(Texture& texture) {
+        if (texture.m_memoryBytes != 0) {
+            return;
+        }
+        ID3D11Texture2D* resource = viewTexture(texture);
+        if (resource) {
+            D3D11_TEXTURE2D_DESC desc;
+            resource->GetDesc(&desc);
+            texture.m_memoryBytes = textureBytes(desc);
+            resource->Release();
+        }
+    }
+
+    void addStats(TextureResidencyStats& total, const TextureResidencyStats& frame) {
+        total.evictions += frame.evictions;
+        total.mipDrops += frame.mipDrops;
+        total.reloads += frame.reloads;
+        total.failedReloads += frame.failedReloads;
+    }
+}
+
+TextureResidency::~TextureResidency() {
+    for (auto& item : m_entries) {
+        item.second.texture->m_residency = nullptr;
+    }
+}
+
+void
+TextureResidency::init(Device& device, const TextureResidencyOptions& options) {
+    m_device = &device;
+    m_options = options;
+    m_frame = 0;
+    m_current = TextureResidencyStats();
+    m_frameStats = TextureResidencyStats();
+    m_totalStats = TextureResidencyStats();
+}
+
+HRESULT
+TextureResidency::load(Texture& texture,
+    const std::string& textureName,
+    ExtensionType extensionType,
+    const TextureImportOptions& options) {
+    if (!m_device) {
+        ERROR("TextureResidency", "load", "Residency manager is not initialized");
+        return E_POINTER;
+    }
+    HRESULT hr = texture.init(*m_device, textureName, extensionType, options);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    track(texture, textureName, extensionType, options);
+    return S_OK;
+}
+
+void
+TextureResidency::track(Texture& texture,
+    const std::string& textureName,
+    ExtensionType extensionType,
+    const TextureImportOptions& options) {
+    measure(texture);
+
+    Entry& entry = m_entries[&texture];
+    entry.texture = &texture;
+    entry.textureName = textureName;
+    entry.extensionType = extensionType;
+    entry.options = options;
+    entry.lastUsedFrame = m_frame;
+    entry.fullBytes = texture.m_memoryBytes;
+    entry.droppedMips = 0;
+    entry.evicted = texture.m_texture == nullptr && texture.m_textureFromImg == nullptr;
+    entry.failed = false;
+    texture.m_residency = this;
+}
+
+void
+TextureResidency::untrack(Texture& texture) {
+    if (m_entries.erase(&texture) > 0) {
+        texture.m_residency = nullptr;
+    }
+}
+
+void
+TextureResidency::release(Texture& texture) {
+    untrack(texture);
+    texture.destroy();
+}
+
+bool
+TextureResidency::touch(Texture& texture) {
+    auto it = m_entries.find(&texture);
+    if (it == m_entries.end()) {
+        return texture.m_textureFromImg != nullptr;
+    }
+    Entry& entry = it->second;
+    entry.lastUsedFrame = m_frame;
+    if (entry.evicted && !entry.failed) {
+        reload(entry);
+    }
+    return !entry.evicted;
+}
+
+void
+TextureResidency::endFrame(DeviceContext& deviceContext) {
+    // Devolver los mips a las texturas usadas en este frame si caben
+    size_t resident = residentBytes();
+    for (auto& item : m_entries) {
+        Entry& entry = item.second;
+        if (entry.droppedMips == 0 || entry.evicted || entry.lastUsedFrame != m_frame) continue;
+        const size_t extra = entry.fullBytes - (std::min)(entry.fullBytes, entry.texture->m_memoryBytes);
+        if (resident + extra <= m_options.budgetBytes) {
+            const size_t before = entry.texture->m_memoryBytes;
+            if (reload(entry)) {
+                resident = resident - before + entry.texture->m_memoryBytes;
+            }
+        }
+    }
+
+    if (resident > m_options.budgetBytes) {
+        std::vector<Entry*> lru;
+        lru.reserve(m_entries.size());
+        for (auto& item : m_entries) {
+            if (!item.second.evicted) {
+                lru.push_back(&item.second);
+            }
+        }
+        std::sort(lru.begin(), lru.end(), [](const Entry* a, const Entry* b) {
+            return a->lastUsedFrame < b->lastUsedFrame;
+            });
+
+        // 1. Expulsar las que llevan tiempo sin usarse
+        for (Entry* entry : lru) {
+            if (resident <= m_options.budgetBytes) break;
+            if (m_frame - entry->lastUsedFrame < m_options.evictAfterFrames) break;
+            resident -= entry->texture->m_memoryBytes;
+            evict(*entry);
+        }
+
+        // 2. Quitar mips en rondas, empezando por las menos usadas
+        bool dropped = true;
+        while (resident > m_options.budgetBytes && dropped) {
+            dropped = false;
+            for (Entry* entry : lru) {
+                if (resident <= m_options.budgetBytes) break;
+                if (entry->evicted) continue;
+                const size_t before = entry->texture->m_memoryBytes;
+                if (dropTopMip(*entry, deviceContext)) {
+                    resident = resident - before + entry->texture->m_memoryBytes;
+                    dropped = true;
+                }
+            }
+        }
+
+        // 3. Expulsar las que no se usaron en este frame
+        for (Entry* entry : lru) {
+            if (resident <= m_options.budgetBytes) break;
+            if (entry->evicted || entry->lastUsedFrame == m_frame) continue;
+            resident -= entry->texture->m_memoryBytes;
+            evict(*entry);
+        }
+    }
+
+    m_current.frame = m_frame;
+    m_current.budgetBytes = m_options.budgetBytes;
+    m_current.residentBytes = resident;
+    m_current.tracked = static_cast<unsigned int>(m_entries.size());
+    m_current.resident = 0;
+    for (const auto& item : m_entries) {
+        if (!item.second.evicted) {
+            ++m_current.resident;
+        }
+    }
+
+    addStats(m_totalStats, m_current);
+    m_totalStats.frame = m_current.frame;
+    m_totalStats.budgetBytes = m_current.budgetBytes;
+    m_totalStats.residentBytes = m_current.residentBytes;
+    m_totalStats.tracked = m_current.tracked;
+    m_totalStats.resident = m_current.resident;
+
+    m_frameStats = m_current;
+    m_current = TextureResidencyStats();
+    ++m_frame;
+}
+
+size_t
+TextureResidency::residentBytes() const {
+    size_t total = 0;
+    for (const auto& item : m_entries) {
+        total += item.second.texture->m_memoryBytes;
+    }
+    return total;
+}
+
+bool
+TextureResidency::reload(Entry& entry) {
+    Texture& texture = *entry.texture;
+    texture.destroy();
+    HRESULT hr = texture.init(*m_device, entry.textureName, entry.extensionType, entry.options);
+    if (FAILED(hr)) {
+        ERROR("TextureResidency", "reload", ("Failed to reload texture: " + texture.m_textureName).c_str());
+        entry.evicted = true;
+        entry.failed = true;
+        ++m_current.failedReloads;
+        return false;
+    }
+    measure(texture);
+    entry.fullBytes = texture.m_memoryBytes;
+    entry.droppedMips = 0;
+    entry.evicted = false;
+    ++m_current.reloads;
+    return true;
+}
+
+bool
+TextureResidency::dropTopMip(Entry& entry, DeviceContext& deviceContext) {
+    Texture& texture = *entry.texture;
+    ID3D11Texture2D* source = viewTexture(texture);
+    if (!source) {
+        return false;
+    }
+
+    // Solo texturas 2D simples; los arreglos y cubemaps se expulsan completos
+    D3D11_TEXTURE2D_DESC desc;
+    source->GetDesc(&desc);
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+    texture.m_textureFromImg->GetDesc(&srvDesc);
+    if (desc.MipLevels <= 1 || desc.ArraySize != 1 || srvDesc.ViewDimension != D3D11_SRV_DIMENSION_TEXTURE2D ||
+        srvDesc.Texture2D.MostDetailedMip != 0) {
+        source->Release();
+        return false;
+    }
+
+    D3D11_TEXTURE2D_DESC smaller = desc;
+    smaller.Width = (std::max)(1u, desc.Width >> 1);
+    smaller.Height = (std::max)(1u, desc.Height >> 1);
+    smaller.MipLevels = desc.MipLevels - 1;
+    // Un BC necesita un nivel 0 multiplo de 4
+    if ((std::max)(smaller.Width, smaller.Height) < m_options.minResidentSize ||
+        (isBlockCompressed(desc.Format) && (smaller.Width % 4 != 0 || smaller.Height % 4 != 0))) {
+        source->Release();
+        return false;
+    }
+
+    ID3D11Texture2D* resource = nullptr;
+    HRESULT hr = m_device->CreateTexture2D(&smaller, nullptr, &resource);
+    if (FAILED(hr)) {
+        ERROR("TextureResidency", "dropTopMip", "Failed to create reduced texture");
+        source->Release();
+        return false;
+    }
+    for (unsigned int level = 0; level < smaller.MipLevels; ++level) {
+        deviceContext.CopySubresourceRegion(resource, level, 0, 0, 0, source, level + 1, nullptr);
+    }
+    source->Release();
+
+    srvDesc.Texture2D.MipLevels = smaller.MipLevels;
+    ID3D11ShaderResourceView* view = nullptr;
+    hr = m_device->m_device->CreateShaderResourceView(resource, &srvDesc, &view);
+    // Como en Texture, la SRV mantiene viva la textura
+    SAFE_RELEASE(resource);
+    if (FAILED(hr)) {
+        ERROR("TextureResidency", "dropTopMip", "Failed to create shader resource view");
+        return false;
+    }
+
+    SAFE_RELEASE(texture.m_texture);
+    SAFE_RELEASE(texture.m_textureFromImg);
+    texture.m_textureFromImg = view;
+    texture.m_memoryBytes = textureBytes(smaller);
+    ++entry.droppedMips;
+    ++m_current.mipDrops;
+    return true;
+}
+
+void
+TextureResidency::evict(Entry& entry) {
+    entry.texture->destroy();
+    entry.evicted = true;
+    entry.droppedMips = 0;
+    ++m_current.evictions;
+}
@@ -0,0 +1,263 @@
+#include "TextureStreamer.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include "UploadManager.h"
+
+TextureStreamer::~TextureStreamer() {
+    destroy();
+}
+
+HRESULT
+TextureStreamer::request(Device& device,
+    DeviceContext& deviceContext,
+    Texture& target,
+    const std::string& textureName,
+    ExtensionType extensionType,
+    const TextureStreamingOptions& options) {
+    if (!device.m_device) {
+        ERROR("TextureStreamer", "request", "Device is null.");
+        return E_POINTER;
+    }
+
+    // DDS trae sus propios mips y HDR no pasa por la cadena RGBA8: se cargan completas
+    if (extensionType == DDS || extensionType == HDR) {
+        return target.init(device, textureName, extensionType, options.import);
+    }
+    if (extensionType != PNG && extensionType != JPG) {
+        ERROR("TextureStreamer", "request", "Unsupported extension type");
+        return E_INVALIDARG;
+    }
+
+    std::unique_ptr<StreamingEntry> entry(new StreamingEntry());
+    entry->target = &target;
+    entry->fileName = textureName + (extensionType == PNG ? ".png" : ".jpg");
+    entry->options = options;
+    entry->options.import.generateMips = true;
+    entry->options.import.decodeThreads = 1; // Ya decodifica en un hilo del grupo
+    entry->options.import.compressThreads = 1;
+    target.m_textureName = entry->fileName;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.requested;
+    }
+
+    // Con la cache, los niveles residentes se suben ya
+    uint64_t cacheKey = 0;
+    const TextureImportOptions& import = entry->options.import;
+    const bool cacheable = !import.cacheDirectory.empty() &&
+        TextureCache::makeKey(entry->fileName, Texture::cacheSalt(import), cacheKey);
+    if (cacheable && TextureCache(import.cacheDirectory).load(cacheKey, entry->cacheEntry)) {
+        entry->levels = entry->cacheEntry.levels;
+        entry->format = static_cast<DXGI_FORMAT>(entry->cacheEntry.format);
+        entry->payloadReady = true;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        HRESULT hr = activate(device, deviceContext, *entry);
+        if (FAILED(hr)) {
+            return hr;
+        }
+        ++m_stats.cacheHits;
+        m_entries.push_back(std::move(entry));
+        return S_OK;
+    }
+
+    HRESULT hr = createPlaceholder(device, target);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    StreamingEntry* pending = entry.get();
+    pending->decoding = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.push_back(std::move(entry));
+    }
+
+    m_pool.submit([this, pending, cacheable, cacheKey]() {
+        PreparedTexture prepared;
+        HRESULT result = Texture::decodeFile(pending->fileName, pending->options.import, prepared);
+        if (SUCCEEDED(result) && cacheable) {
+            TextureCache(pending->options.import.cacheDirectory).store(cacheKey, prepared.format, prepared.levels);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending->result = result;
+        pending->prepared = std::move(prepared);
+        pending->levels = pending->prepared.levels;
+        pending->format = pending->prepared.format;
+        pending->payloadReady = true;
+        pending->decoding = false;
+        m_decodeFinished.notify_all();
+        });
+    return S_OK;
+}
+
+void
+TextureStreamer::update(Device& device, DeviceContext& deviceContext) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t uploaded = 0;
+
+    for (size_t i = 0; i < m_entries.size();) {
+        StreamingEntry& entry = *m_entries[i];
+        if (!entry.payloadReady) {
+            ++i;
+            continue;
+        }
+
+        HRESULT hr = entry.result;
+        if (SUCCEEDED(hr) && !entry.texture) {
+            hr = activate(device, deviceContext, entry);
+        }
+
+        // Subir del nivel pequeno al grande mientras quede presupuesto.
+        // El primer nivel del frame siempre entra aunque supere el presupuesto.
+        bool changed = false;
+        while (SUCCEEDED(hr) && entry.residentMip > 0) {
+            const TextureCacheLevel& next = entry.levels[entry.residentMip - 1];
+            if (uploaded > 0 && uploaded + next.size > entry.options.uploadBytesPerFrame) {
+                break;
+            }
+            hr = uploadLevel(deviceContext, entry, entry.residentMip - 1);
+            uploaded += next.size;
+            --entry.residentMip;
+            changed = true;
+        }
+        if (SUCCEEDED(hr) && changed) {
+            hr = updateView(device, entry);
+        }
+
+        if (FAILED(hr)) {
+            ERROR("TextureStreamer", "update", ("Streaming failed for " + entry.fileName).c_str());
+            ++m_stats.failed;
+        }
+        else if (entry.residentMip == 0) {
+            ++m_stats.fullyResident;
+        }
+        else {
+            ++i;
+            continue;
+        }
+
+        // Terminada (o fallida): liberar los texeles de CPU
+        m_entries.erase(m_entries.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+HRESULT
+TextureStreamer::activate(Device& device, DeviceContext& deviceContext, StreamingEntry& entry) {
+    if (entry.levels.empty()) {
+        return E_FAIL;
+    }
+
+    const unsigned int mipCount = static_cast<unsigned int>(entry.levels.size());
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = entry.levels[0].width;
+    desc.Height = entry.levels[0].height;
+    desc.MipLevels = mipCount;
+    desc.ArraySize = 1;
+    desc.Format = entry.format;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    // La cadena completa se reserva sin datos; solo se llenan los niveles residentes
+    ID3D11Texture2D* texture = nullptr;
+    HRESULT hr = device.CreateTexture2D(&desc, nullptr, &texture);
+    if (FAILED(hr)) {
+        ERROR("TextureStreamer", "activate", "Failed to create streaming texture");
+        return hr;
+    }
+    entry.target->destroy(); // Suelta el marcador de posicion
+    entry.target->m_texture = texture;
+    entry.target->m_memoryBytes = 0;
+    for (const TextureCacheLevel& level : entry.levels) {
+        entry.target->m_memoryBytes += level.size;
+    }
+    entry.texture = texture;
+
+    unsigned int firstResident = mipCount - 1;
+    while (firstResident > 0 &&
+        (std::max)(entry.levels[firstResident - 1].width, entry.levels[firstResident - 1].height) <= entry.options.residentSize) {
+        --firstResident;
+    }
+    for (unsigned int level = mipCount; level-- > firstResident;) {
+        hr = uploadLevel(deviceContext, entry, level);
+        if (FAILED(hr)) {
+            return hr;
+        }
+    }
+    entry.residentMip = firstResident;
+    return updateView(device, entry);
+}
+
+HRESULT
+TextureStreamer::uploadLevel(DeviceContext& deviceContext, StreamingEntry& entry, unsigned int level) {
+    const TextureCacheLevel& data = entry.levels[level];
+    if (m_uploadManager) {
+        m_uploadManager->uploadTexture(deviceContext, entry.texture, level, entry.format,
+            data.width, data.height, data.data, data.rowPitch);
+    }
+    else {
+        deviceContext.UpdateSubresource(entry.texture, level, nullptr, data.data, data.rowPitch, 0);
+    }
+    ++m_stats.levelsUploaded;
+    m_stats.bytesUploaded += data.size;
+    return S_OK;
+}
+
+HRESULT
+TextureStreamer::updateView(Device& device, StreamingEntry& entry) {
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = entry.format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = entry.residentMip;
+    srvDesc.Texture2D.MipLevels = static_cast<unsigned int>(entry.levels.size()) - entry.residentMip;
+
+    ID3D11ShaderResourceView* view = nullptr;
+    HRESULT hr = device.m_device->CreateShaderResourceView(entry.texture, &srvDesc, &view);
+    if (FAILED(hr)) {
+        ERROR("TextureStreamer", "updateView", "Failed to create shader resource view");
+        return hr;
+    }
+    SAFE_RELEASE(entry.target->m_textureFromImg);
+    entry.target->m_textureFromImg = view;
+    return S_OK;
+}
+
+HRESULT
+TextureStreamer::createPlaceholder(Device& device, Texture& target) {
+    const unsigned char gray[4] = { 128, 128, 128, 255 };
+    PreparedTexture placeholder;
+    TextureImportOptions options;
+    options.generateMips = false;
+    HRESULT hr = Texture::prepare(gray, 1, 1, options, placeholder);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    return target.init(device, placeholder);
+}
+
+bool
+TextureStreamer::done() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.empty();
+}
+
+TextureStreamingStats
+TextureStreamer::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void
+TextureStreamer::destroy() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_decodeFinished.wait(lock, [this]() {
+        for (const std::unique_ptr<StreamingEntry>& entry : m_entries) {
+            if (entry->decoding) return false;
+        }
+        return true;
+        });
+    m_entries.clear();
+}
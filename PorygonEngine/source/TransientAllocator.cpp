@@ -0,0 +1,55 @@
+#include "TransientAllocator.h"
+
+void
+TransientAllocator::init(unsigned int frameCount, size_t frameSize) {
+    m_frameCount = frameCount;
+    m_frameSize = frameSize;
+    m_segment = 0;
+    m_head = 0;
+    m_requested = 0;
+    m_stats = TransientAllocatorStats();
+}
+
+void
+TransientAllocator::beginFrame() {
+    if (m_frameCount == 0) {
+        return;
+    }
+    m_stats.lastFrameUsed = m_head;
+    m_stats.frameUsed = 0;
+    m_segment = (m_segment + 1) % m_frameCount;
+    m_head = 0;
+    m_requested = 0;
+}
+
+bool
+TransientAllocator::allocate(size_t size, size_t alignment, TransientAllocation& allocation) {
+    if (size == 0 || m_frameCount == 0) {
+        return false;
+    }
+    m_requested += size;
+    if (m_requested > m_stats.requestedPeak) {
+        m_stats.requestedPeak = m_requested;
+    }
+
+    // La alineacion es absoluta: el segmento empieza en segment * frameSize
+    const size_t base = static_cast<size_t>(m_segment) * m_frameSize;
+    size_t offset = base + m_head;
+    if (alignment > 1) {
+        offset = (offset + alignment - 1) / alignment * alignment;
+    }
+    const size_t end = base + m_frameSize;
+    if (offset > end || size > end - offset) {
+        ++m_stats.failures;
+        return false;
+    }
+
+    allocation.offset = offset;
+    allocation.size = size;
+    m_head = offset + size - base;
+    m_stats.frameUsed = m_head;
+    if (m_head > m_stats.highWater) {
+        m_stats.highWater = m_head;
+    }
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "TransientGeometry.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <cstring>
+#include <thread>
+
+TransientGeometry::~TransientGeometry() {
+    destroy();
+}
+
+HRESULT
+TransientGeometry::init(Device& device, const TransientGeometryOptions& options) {
+    destroy();
+    if (!device.m_device) {
+        ERROR("TransientGeometry", "init", "Device is null.");
+        return E_POINTER;
+    }
+    if (options.framesInFlight == 0 || options.vertexBytesPerFrame == 0 || options.indexBytesPerFrame == 0) {
+        ERROR("TransientGeometry", "init", "Invalid transient geometry options");
+        return E_INVALIDARG;
+    }
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    desc.ByteWidth = options.vertexBytesPerFrame * options.framesInFlight;
+    desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    HRESULT hr = device.CreateBuffer(&desc, nullptr, &m_vertexBuffer);
+    if (SUCCEEDED(hr)) {
+        desc.ByteWidth = options.indexBytesPerFrame * options.framesInFlight;
+        desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+        hr = device.CreateBuffer(&desc, nullptr, &m_indexBuffer);
+    }
+    if (FAILED(hr)) {
+        ERROR("TransientGeometry", "init", "Failed to create transient buffers");
+        destroy();
+        return hr;
+    }
+
+    D3D11_QUERY_DESC queryDesc = {};
+    queryDesc.Query = D3D11_QUERY_EVENT;
+    m_frameQueries.assign(options.framesInFlight, nullptr);
+    m_queryIssued.assign(options.framesInFlight, false);
+    for (ID3D11Query*& query : m_frameQueries) {
+        hr = device.m_device->CreateQuery(&queryDesc, &query);
+        if (FAILED(hr)) {
+            ERROR("TransientGeometry", "init", "Failed to create frame query");
+            destroy();
+            return hr;
+        }
+    }
+
+    m_vertexAllocator.init(options.framesInFlight, options.vertexBytesPerFrame);
+    m_indexAllocator.init(options.framesInFlight, options.indexBytesPerFrame);
+    return S_OK;
+}
+
+void
+TransientGeometry::beginFrame(DeviceContext& deviceContext) {
+    if (!m_vertexBuffer || !deviceContext.m_deviceContext) {
+        return;
+    }
+    // La consulta del segmento actual marca el final de los draws de este frame
+    if (m_frameOpen) {
+        const unsigned int segment = m_vertexAllocator.frameSegment();
+        deviceContext.m_deviceContext->End(m_frameQueries[segment]);
+        m_queryIssued[segment] = true;
+        m_vertexAllocator.beginFrame();
+        m_indexAllocator.beginFrame();
+    }
+    m_frameOpen = true;
+
+    // El segmento que se reutiliza debe estar libre en la GPU antes de escribirlo sin DISCARD
+    const unsigned int segment = m_vertexAllocator.frameSegment();
+    if (m_queryIssued[segment]) {
+        if (deviceContext.m_deviceContext->GetData(m_frameQueries[segment], nullptr, 0, 0) == S_FALSE) {
+            ++m_stalls;
+            while (deviceContext.m_deviceContext->GetData(m_frameQueries[segment], nullptr, 0, 0) == S_FALSE) {
+                std::this_thread::yield();
+            }
+        }
+        m_queryIssued[segment] = false;
+    }
+}
+
+bool
+TransientGeometry::writeVertices(DeviceContext& deviceContext,
+    const void* data,
+    unsigned int stride,
+    unsigned int count,
+    TransientBufferRange& range) {
+    return write(deviceContext, m_vertexAllocator, m_vertexBuffer, m_vertexDiscard,
+        data, stride * count, stride, range);
+}
+
+bool
+TransientGeometry::writeIndices(DeviceContext& deviceContext,
+    const void* data,
+    DXGI_FORMAT format,
+    unsigned int count,
+    TransientBufferRange& range) {
+    unsigned int indexSize = 0;
+    switch (format) {
+    case DXGI_FORMAT_R16_UINT: indexSize = 2; break;
+    case DXGI_FORMAT_R32_UINT: indexSize = 4; break;
+    default:
+        ERROR("TransientGeometry", "writeIndices", "Index format must be R16_UINT or R32_UINT");
+        return false;
+    }
+    return write(deviceContext, m_indexAllocator, m_indexBuffer, m_indexDiscard,
+        data, indexSize * count, indexSize, range);
+}
+
+bool
+TransientGeometry::write(DeviceContext& deviceContext,
+    TransientAllocator& allocator,
+    ID3D11Buffer* buffer,
+    bool& discardPending,
+    const void* data,
+    unsigned int size,
+    unsigned int alignment,
+    TransientBufferRange& range) {
+    if (!buffer || !m_frameOpen || !data || size == 0) {
+        return false;
+    }
+    TransientAllocation allocation;
+    if (!allocator.allocate(size, alignment, allocation)) {
+        return false;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    const D3D11_MAP mapType = discardPending ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+    HRESULT hr = deviceContext.m_deviceContext->Map(buffer, 0, mapType, 0, &mapped);
+    if (FAILED(hr)) {
+        ERROR("TransientGeometry", "write", "Failed to map transient buffer");
+        return false;
+    }
+    discardPending = false;
+    std::memcpy(static_cast<unsigned char*>(mapped.pData) + allocation.offset, data, size);
+    deviceContext.m_deviceContext->Unmap(buffer, 0);
+
+    range.buffer = buffer;
+    range.offset = static_cast<unsigned int>(allocation.offset);
+    range.size = size;
+    return true;
+}
+
+TransientGeometryStats
+TransientGeometry::stats() const {
+    TransientGeometryStats stats;
+    stats.vertex = m_vertexAllocator.stats();
+    stats.index = m_indexAllocator.stats();
+    stats.stalls = m_stalls;
+    return stats;
+}
+
+void
+TransientGeometry::destroy() {
+    SAFE_RELEASE(m_vertexBuffer);
+    SAFE_RELEASE(m_indexBuffer);
+    for (ID3D11Query*& query : m_frameQueries) {
+        SAFE_RELEASE(query);
+    }
+    m_frameQueries.clear();
+    m_queryIssued.clear();
+    m_vertexAllocator.init(0, 0);
+    m_indexAllocator.init(0, 0);
+    m_frameOpen = false;
+    m_vertexDiscard = true;
+    m_indexDiscard = true;
+    m_stalls = 0;
+}
@@ -0,0 +1,376 @@
+#include "UploadManager.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    /**
+     * @brief Lado del bloque y bytes por bloque; false si el formato no se sube por el anillo.
+     */
+    bool blockLayout(DXGI_FORMAT format, unsigned int& blockSize, unsigned int& bytesPerBlock) {
+        blockSize = 1;
+        switch (format) {
+        case DXGI_FORMAT_R8_UNORM:
+            bytesPerBlock = 1;
+            return true;
+        case DXGI_FORMAT_R8G8_UNORM:
+            bytesPerBlock = 2;
+            return true;
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+            bytesPerBlock = 4;
+            return true;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            bytesPerBlock = 8;
+            return true;
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            bytesPerBlock = 16;
+            return true;
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            blockSize = 4;
+            bytesPerBlock = 8;
+            return true;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            blockSize = 4;
+            bytesPerBlock = 16;
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+UploadManager::~UploadManager() {
+    destroy();
+}
+
+HRESULT
+UploadManager::init(Device& device, const UploadManagerOptions& options) {
+    destroy();
+    if (!device.m_device) {
+        ERROR("UploadManager", "init", "Device is null.");
+        return E_POINTER;
+    }
+    m_device = &device;
+    m_options = options;
+    m_stats = UploadManagerStats();
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.ByteWidth = static_cast<unsigned int>(options.bufferPageSize);
+    desc.Usage = D3D11_USAGE_STAGING;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+    m_bufferPages.resize(options.bufferPages);
+    for (StagingPage& page : m_bufferPages) {
+        ID3D11Buffer* buffer = nullptr;
+        HRESULT hr = device.CreateBuffer(&desc, nullptr, &buffer);
+        if (FAILED(hr)) {
+            ERROR("UploadManager", "init", "Failed to create staging buffer");
+            destroy();
+            return hr;
+        }
+        page.resource = buffer;
+    }
+    m_bufferRing.init(options.bufferPages, options.bufferPageSize);
+    return S_OK;
+}
+
+void
+UploadManager::uploadBuffer(DeviceContext& deviceContext,
+    ID3D11Buffer* destination,
+    unsigned int destinationOffset,
+    const void* data,
+    unsigned int size) {
+    if (!destination || !data || size == 0) {
+        return;
+    }
+
+    // 16 bytes: memcpy alineado para cualquier tipo de vertice o indice
+    UploadRingAllocation allocation;
+    if (m_device && m_bufferRing.allocate(size, 16, allocation) &&
+        mapPage(deviceContext, m_bufferPages[allocation.page])) {
+        StagingPage& page = m_bufferPages[allocation.page];
+        std::memcpy(static_cast<unsigned char*>(page.mapped.pData) + allocation.offset, data, size);
+
+        PendingCopy copy;
+        copy.destination = destination;
+        copy.destination->AddRef();
+        copy.x = destinationOffset;
+        copy.source = page.resource;
+        copy.box.left = static_cast<unsigned int>(allocation.offset);
+        copy.box.right = static_cast<unsigned int>(allocation.offset) + size;
+        copy.box.bottom = 1;
+        copy.box.back = 1;
+        m_pending.push_back(copy);
+
+        ++m_stats.bufferUploads;
+        m_stats.bytesStaged += size;
+        return;
+    }
+
+    D3D11_BOX box = { destinationOffset, 0, 0, destinationOffset + size, 1, 1 };
+    deviceContext.UpdateSubresource(destination, 0, &box, data, 0, 0);
+    ++m_stats.fallbacks;
+}
+
+void
+UploadManager::uploadTexture(DeviceContext& deviceContext,
+    ID3D11Texture2D* destination,
+    unsigned int subresource,
+    DXGI_FORMAT format,
+    unsigned int width,
+    unsigned int height,
+    const void* data,
+    unsigned int rowPitch,
+    unsigned int x,
+    unsigned int y) {
+    if (!destination || !data || width == 0 || height == 0) {
+        return;
+    }
+
+    // En BC el recuadro de origen debe cubrir bloques completos: los mips
+    // menores que un bloque van por UpdateSubresource
+    TextureRing* ring = m_device ? textureRing(format) : nullptr;
+    const bool fits = ring && width <= m_options.texturePageWidth &&
+        width % ring->blockSize == 0 && height % ring->blockSize == 0;
+
+    UploadRingAllocation allocation;
+    if (fits && ring->ring.allocate(height / ring->blockSize, 1, allocation) &&
+        mapPage(deviceContext, ring->pages[allocation.page])) {
+        StagingPage& page = ring->pages[allocation.page];
+        const size_t rowBytes = static_cast<size_t>(width / ring->blockSize) * ring->bytesPerBlock;
+        const unsigned char* source = static_cast<const unsigned char*>(data);
+        unsigned char* target = static_cast<unsigned char*>(page.mapped.pData) +
+            allocation.offset * page.mapped.RowPitch;
+        for (size_t row = 0; row < allocation.size; ++row) {
+            std::memcpy(target + row * page.mapped.RowPitch, source + row * rowPitch, rowBytes);
+        }
+
+        PendingCopy copy;
+        copy.destination = destination;
+        copy.destination->AddRef();
+        copy.subresource = subresource;
+        copy.x = x;
+        copy.y = y;
+        copy.source = page.resource;
+        copy.box.top = static_cast<unsigned int>(allocation.offset) * ring->blockSize;
+        copy.box.right = width;
+        copy.box.bottom = copy.box.top + height;
+        copy.box.back = 1;
+        m_pending.push_back(copy);
+
+        ++m_stats.textureUploads;
+        m_stats.bytesStaged += rowBytes * allocation.size;
+        return;
+    }
+
+    // Sin recuadro D3D copia el subrecurso entero: solo vale si el rectangulo lo
+    // cubre (asi un mip BC menor que un bloque no necesita un recuadro alineado)
+    D3D11_TEXTURE2D_DESC desc = {};
+    destination->GetDesc(&desc);
+    const unsigned int mip = desc.MipLevels > 0 ? subresource % desc.MipLevels : 0;
+    const unsigned int mipWidth = (std::max)(1u, desc.Width >> mip);
+    const unsigned int mipHeight = (std::max)(1u, desc.Height >> mip);
+    const bool wholeSubresource = x == 0 && y == 0 && width >= mipWidth && height >= mipHeight;
+
+    const D3D11_BOX box = { x, y, 0, x + width, y + height, 1 };
+    deviceContext.UpdateSubresource(destination, subresource, wholeSubresource ? nullptr : &box,
+        data, rowPitch, 0);
+    ++m_stats.fallbacks;
+}
+
+void
+UploadManager::flush(DeviceContext& deviceContext) {
+    if (!m_device) {
+        return;
+    }
+
+    if (!m_pending.empty()) {
+        // Las copias leen de las paginas: primero se desmapean
+        for (StagingPage& page : m_bufferPages) {
+            if (page.isMapped) {
+                deviceContext.m_deviceContext->Unmap(page.resource, 0);
+                page.isMapped = false;
+            }
+        }
+        for (auto& item : m_textureRings) {
+            for (StagingPage& page : item.second.pages) {
+                if (page.isMapped) {
+                    deviceContext.m_deviceContext->Unmap(page.resource, 0);
+                    page.isMapped = false;
+                }
+            }
+        }
+
+        for (PendingCopy& copy : m_pending) {
+            deviceContext.CopySubresourceRegion(copy.destination, copy.subresource, copy.x, copy.y, 0,
+                copy.source, 0, &copy.box);
+            SAFE_RELEASE(copy.destination);
+        }
+        m_pending.clear();
+
+        Fence fence;
+        fence.value = ++m_nextFence;
+        if (!m_freeQueries.empty()) {
+            fence.query = m_freeQueries.back();
+            m_freeQueries.pop_back();
+        }
+        else {
+            D3D11_QUERY_DESC queryDesc = {};
+            queryDesc.Query = D3D11_QUERY_EVENT;
+            HRESULT hr = m_device->m_device->CreateQuery(&queryDesc, &fence.query);
+            if (FAILED(hr)) {
+                ERROR("UploadManager", "flush", "Failed to create event query");
+                fence.query = nullptr;
+            }
+        }
+        if (fence.query) {
+            deviceContext.m_deviceContext->End(fence.query);
+        }
+        m_inFlight.push_back(fence);
+
+        m_bufferRing.close(fence.value);
+        for (auto& item : m_textureRings) {
+            item.second.ring.close(fence.value);
+        }
+        m_stats.submittedFence = fence.value;
+        ++m_stats.flushes;
+    }
+
+    retire(deviceContext);
+}
+
+void
+UploadManager::destroy() {
+    for (PendingCopy& copy : m_pending) {
+        SAFE_RELEASE(copy.destination);
+    }
+    m_pending.clear();
+
+    for (StagingPage& page : m_bufferPages) {
+        SAFE_RELEASE(page.resource);
+    }
+    m_bufferPages.clear();
+    for (auto& item : m_textureRings) {
+        for (StagingPage& page : item.second.pages) {
+            SAFE_RELEASE(page.resource);
+        }
+    }
+    m_textureRings.clear();
+
+    for (Fence& fence : m_inFlight) {
+        SAFE_RELEASE(fence.query);
+    }
+    m_inFlight.clear();
+    for (ID3D11Query*& query : m_freeQueries) {
+        SAFE_RELEASE(query);
+    }
+    m_freeQueries.clear();
+
+    m_bufferRing.init(0, 0);
+    m_nextFence = 0;
+    m_device = nullptr;
+}
+
+bool
+UploadManager::mapPage(DeviceContext& deviceContext, StagingPage& page) {
+    if (page.isMapped) {
+        return true;
+    }
+    // La pagina esta libre: la GPU ya no la lee y Map no espera
+    HRESULT hr = deviceContext.m_deviceContext->Map(page.resource, 0, D3D11_MAP_WRITE, 0, &page.mapped);
+    if (FAILED(hr)) {
+        ERROR("UploadManager", "mapPage", "Failed to map staging resource");
+        return false;
+    }
+    page.isMapped = true;
+    return true;
+}
+
+UploadManager::TextureRing*
+UploadManager::textureRing(DXGI_FORMAT format) {
+    auto it = m_textureRings.find(format);
+    if (it != m_textureRings.end()) {
+        return it->second.pages.empty() ? nullptr : &it->second;
+    }
+
+    // Un formato sin soporte o que no se pudo crear se recuerda con el anillo vacio
+    TextureRing& ring = m_textureRings[format];
+    if (!blockLayout(format, ring.blockSize, ring.bytesPerBlock)) {
+        return nullptr;
+    }
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = m_options.texturePageWidth;
+    desc.Height = m_options.texturePageHeight;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = format;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_STAGING;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+    for (unsigned int i = 0; i < m_options.texturePages; ++i) {
+        ID3D11Texture2D* texture = nullptr;
+        HRESULT hr = m_device->CreateTexture2D(&desc, nullptr, &texture);
+        if (FAILED(hr)) {
+            ERROR("UploadManager", "textureRing", "Failed to create staging texture");
+            for (StagingPage& page : ring.pages) {
+                SAFE_RELEASE(page.resource);
+            }
+            ring.pages.clear();
+            return nullptr;
+        }
+        StagingPage page;
+        page.resource = texture;
+        ring.pages.push_back(page);
+    }
+    ring.ring.init(m_options.texturePages, m_options.texturePageHeight / ring.blockSize);
+    return &ring;
+}
+
+void
+UploadManager::retire(DeviceContext& deviceContext) {
+    uint64_t completed = m_stats.completedFence;
+    while (!m_inFlight.empty()) {
+        Fence& fence = m_inFlight.front();
+        if (fence.query) {
+            HRESULT hr = deviceContext.m_deviceContext->GetData(fence.query, nullptr, 0,
+                D3D11_ASYNC_GETDATA_DONOTFLUSH);
+            if (hr != S_OK) {
+                break;
+            }
+            m_freeQueries.push_back(fence.query);
+        }
+        // Sin consulta no hay forma de saber cuando termino: se da por leida
+        // cuando una consulta posterior se completa
+        else if (m_inFlight.size() > 1) {
+            m_inFlight.pop_front();
+            continue;
+        }
+        else {
+            break;
+        }
+        completed = fence.value;
+        m_inFlight.pop_front();
+    }
+
+    if (completed != m_stats.completedFence) {
+        m_stats.completedFence = completed;
+        m_bufferRing.retire(completed);
+        for (auto& item : m_textureRings) {
+            item.second.ring.retire(completed);
+        }
+    }
+}
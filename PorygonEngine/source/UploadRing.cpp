@@ -0,0 +1,92 @@
+#include "UploadRing.h"
+
+void
+UploadRing::init(unsigned int pageCount, size_t pageSize) {
+    m_pages.assign(pageCount, Page());
+    m_open.clear();
+    m_pageSize = pageSize;
+    m_next = 0;
+    m_hasCurrent = false;
+    m_current = 0;
+    m_stats = UploadRingStats();
+}
+
+bool
+UploadRing::allocate(size_t size, size_t alignment, UploadRingAllocation& allocation) {
+    if (size == 0 || size > m_pageSize) {
+        ++m_stats.failures;
+        return false;
+    }
+    const size_t mask = alignment > 1 ? alignment - 1 : 0;
+
+    if (m_hasCurrent) {
+        Page& page = m_pages[m_current];
+        const size_t offset = (page.used + mask) & ~mask;
+        if (offset <= m_pageSize && size <= m_pageSize - offset) {
+            page.used = offset + size;
+            allocation.page = m_current;
+            allocation.offset = offset;
+            allocation.size = size;
+            ++m_stats.allocations;
+            m_stats.allocated += size;
+            return true;
+        }
+    }
+
+    // La pagina abierta se queda como esta hasta el cierre; se abre la siguiente libre
+    const unsigned int count = pageCount();
+    for (unsigned int i = 0; i < count; ++i) {
+        const unsigned int index = (m_next + i) % count;
+        Page& page = m_pages[index];
+        if (page.state != FREE_PAGE) continue;
+
+        page.state = OPEN_PAGE;
+        page.used = size;
+        m_open.push_back(index);
+        m_current = index;
+        m_hasCurrent = true;
+        m_next = (index + 1) % count;
+
+        allocation.page = index;
+        allocation.offset = 0;
+        allocation.size = size;
+        ++m_stats.pagesOpened;
+        ++m_stats.allocations;
+        m_stats.allocated += size;
+        return true;
+    }
+
+    ++m_stats.failures;
+    return false;
+}
+
+void
+UploadRing::close(uint64_t fence) {
+    for (unsigned int index : m_open) {
+        m_pages[index].state = IN_FLIGHT_PAGE;
+        m_pages[index].fence = fence;
+    }
+    m_open.clear();
+    m_hasCurrent = false;
+}
+
+void
+UploadRing::retire(uint64_t completedFence) {
+    for (Page& page : m_pages) {
+        if (page.state == IN_FLIGHT_PAGE && page.fence <= completedFence) {
+            page.state = FREE_PAGE;
+            page.used = 0;
+        }
+    }
+}
+
+unsigned int
+UploadRing::freePages() const {
+    unsigned int count = 0;
+    for (const Page& page : m_pages) {
+        if (page.state == FREE_PAGE) {
+            ++count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,244 @@
+#include "VirtualTexture.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include "UploadManager.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    /**
+     * @brief Crea una textura de uso DEFAULT con su SRV y la entrega a target.
+     */
+    HRESULT createTexture(Device& device,
+        Texture& target,
+        unsigned int width,
+        unsigned int height,
+        unsigned int mipLevels,
+        DXGI_FORMAT format,
+        size_t memoryBytes) {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.Width = width;
+        desc.Height = height;
+        desc.MipLevels = mipLevels;
+        desc.ArraySize = 1;
+        desc.Format = format;
+        desc.SampleDesc.Count = 1;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        ID3D11Texture2D* texture = nullptr;
+        HRESULT hr = device.CreateTexture2D(&desc, nullptr, &texture);
+        if (FAILED(hr)) {
+            return hr;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = format;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MostDetailedMip = 0;
+        srvDesc.Texture2D.MipLevels = mipLevels;
+        ID3D11ShaderResourceView* view = nullptr;
+        hr = device.m_device->CreateShaderResourceView(texture, &srvDesc, &view);
+        if (FAILED(hr)) {
+            SAFE_RELEASE(texture);
+            return hr;
+        }
+
+        target.destroy();
+        target.m_texture = texture;
+        target.m_textureFromImg = view;
+        target.m_memoryBytes = memoryBytes;
+        return S_OK;
+    }
+}
+
+VirtualTexture::~VirtualTexture() {
+    destroy();
+}
+
+HRESULT
+VirtualTexture::init(Device& device, const std::string& fileName, const VirtualTextureOptions& options) {
+    destroy();
+    if (!device.m_device) {
+        ERROR("VirtualTexture", "init", "Device is null.");
+        return E_POINTER;
+    }
+    if (!m_file.open(fileName)) {
+        ERROR("VirtualTexture", "init", ("Failed to open virtual texture: " + fileName).c_str());
+        return E_FAIL;
+    }
+    m_options = options;
+
+    const VirtualTextureLayout& layout = m_file.layout();
+    if (!m_cache.init(layout, options.cacheTilesX, options.cacheTilesY)) {
+        ERROR("VirtualTexture", "init", "Page table or physical cache size is out of range");
+        m_file.close();
+        return E_INVALIDARG;
+    }
+
+    // Cache fisica: una rejilla de paginas con bordes, sin mips
+    const unsigned int padded = layout.paddedTileSize();
+    m_physicalFormat = m_file.srgb() ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+    HRESULT hr = createTexture(device, m_physical, options.cacheTilesX * padded, options.cacheTilesY * padded,
+        1, m_physicalFormat, static_cast<size_t>(options.cacheTilesX) * options.cacheTilesY * m_file.pageBytes());
+    if (FAILED(hr)) {
+        ERROR("VirtualTexture", "init", "Failed to create physical page cache");
+        destroy();
+        return hr;
+    }
+    m_physical.m_textureName = fileName;
+
+    size_t tableBytes = 0;
+    for (unsigned int mip = 0; mip < layout.mipCount; ++mip) {
+        tableBytes += static_cast<size_t>(layout.tilesX(mip)) * layout.tilesY(mip) * 4;
+    }
+    hr = createTexture(device, m_pageTable, layout.tilesX(0), layout.tilesY(0),
+        layout.mipCount, DXGI_FORMAT_R8G8B8A8_UNORM, tableBytes);
+    if (FAILED(hr)) {
+        ERROR("VirtualTexture", "init", "Failed to create page table");
+        destroy();
+        return hr;
+    }
+    m_pageTable.m_textureName = fileName;
+
+    // El ultimo nivel es el respaldo de todas las paginas: se pide ya
+    const unsigned int last = layout.mipCount - 1;
+    std::vector<uint32_t> root;
+    for (unsigned int y = 0; y < layout.tilesY(last); ++y) {
+        for (unsigned int x = 0; x < layout.tilesX(last); ++x) {
+            VirtualPage page;
+            page.mip = last;
+            page.x = x;
+            page.y = y;
+            root.push_back(VirtualTextureCache::packPage(page));
+        }
+    }
+    m_cache.analyzeFeedback(root.data(), root.size(), static_cast<unsigned int>(root.size()), m_requests);
+    submitLoads(m_requests);
+    return S_OK;
+}
+
+void
+VirtualTexture::feedback(const uint32_t* entries, size_t count) {
+    if (!m_physical.m_texture) {
+        return;
+    }
+    m_cache.analyzeFeedback(entries, count, m_options.requestsPerFrame, m_requests);
+    submitLoads(m_requests);
+}
+
+void
+VirtualTexture::update(DeviceContext& deviceContext, UploadManager* uploadManager) {
+    if (!m_physical.m_texture || !m_pageTable.m_texture) {
+        return;
+    }
+
+    std::vector<LoadedPage> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const size_t count = (std::min)(m_loaded.size(), static_cast<size_t>(m_options.uploadsPerFrame));
+        ready.assign(std::make_move_iterator(m_loaded.begin()),
+            std::make_move_iterator(m_loaded.begin() + static_cast<std::ptrdiff_t>(count)));
+        m_loaded.erase(m_loaded.begin(), m_loaded.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+
+    const unsigned int padded = m_file.layout().paddedTileSize();
+    for (const LoadedPage& loaded : ready) {
+        if (!loaded.ok) {
+            ERROR("VirtualTexture", "update", ("Failed to read page of " + m_physical.m_textureName).c_str());
+            m_cache.cancel(loaded.page);
+            ++m_failedLoads;
+            continue;
+        }
+        unsigned int slot = 0;
+        if (!m_cache.insert(loaded.page, slot)) {
+            continue; // Sin sitio: el feedback la volvera a pedir
+        }
+        unsigned int slotX = 0, slotY = 0;
+        m_cache.slotPosition(slot, slotX, slotY);
+        if (uploadManager) {
+            uploadManager->uploadTexture(deviceContext, m_physical.m_texture, 0, m_physicalFormat,
+                padded, padded, loaded.pixels.data(), padded * 4, slotX * padded, slotY * padded);
+        }
+        else {
+            const D3D11_BOX box = { slotX * padded, slotY * padded, 0, (slotX + 1) * padded, (slotY + 1) * padded, 1 };
+            deviceContext.UpdateSubresource(m_physical.m_texture, 0, &box, loaded.pixels.data(), padded * 4, 0);
+        }
+        ++m_pagesUploaded;
+    }
+
+    // Subir solo el rectangulo modificado de cada nivel de la tabla
+    const VirtualTextureLayout& layout = m_file.layout();
+    for (unsigned int mip = 0; mip < layout.mipCount; ++mip) {
+        const VirtualTableRegion& region = m_cache.dirtyRegion(mip);
+        if (region.width == 0) continue;
+        const unsigned int pitch = layout.tilesX(mip) * 4;
+        const uint32_t* data = m_cache.pageTable(mip) + static_cast<size_t>(region.y) * layout.tilesX(mip) + region.x;
+        if (uploadManager) {
+            uploadManager->uploadTexture(deviceContext, m_pageTable.m_texture, mip, DXGI_FORMAT_R8G8B8A8_UNORM,
+                region.width, region.height, data, pitch, region.x, region.y);
+        }
+        else {
+            const D3D11_BOX box = { region.x, region.y, 0, region.x + region.width, region.y + region.height, 1 };
+            deviceContext.UpdateSubresource(m_pageTable.m_texture, mip, &box, data, pitch, 0);
+        }
+    }
+    m_cache.clearDirty();
+    m_cache.endFrame();
+}
+
+void
+VirtualTexture::render(DeviceContext& deviceContext, unsigned int startSlot) {
+    m_pageTable.render(deviceContext, startSlot, 1);
+    m_physical.render(deviceContext, startSlot + 1, 1);
+}
+
+VirtualTextureStats
+VirtualTexture::stats() const {
+    VirtualTextureStats stats;
+    stats.cache = m_cache.stats();
+    stats.pagesUploaded = m_pagesUploaded;
+    stats.failedLoads = m_failedLoads;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.loadsInFlight = m_loadsInFlight;
+    stats.loadsWaiting = static_cast<unsigned int>(m_loaded.size());
+    return stats;
+}
+
+void
+VirtualTexture::destroy() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_loadFinished.wait(lock, [this]() { return m_loadsInFlight == 0; });
+        m_loaded.clear();
+    }
+    m_requests.clear();
+    m_pageTable.destroy();
+    m_physical.destroy();
+    m_file.close();
+    m_pagesUploaded = 0;
+    m_failedLoads = 0;
+}
+
+void
+VirtualTexture::submitLoads(const std::vector<VirtualPage>& pages) {
+    if (pages.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loadsInFlight += static_cast<unsigned int>(pages.size());
+    }
+    for (const VirtualPage& page : pages) {
+        m_pool.submit([this, page]() {
+            LoadedPage loaded;
+            loaded.page = page;
+            loaded.ok = m_file.readPage(page, loaded.pixels);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_loaded.push_back(std::move(loaded));
+            --m_loadsInFlight;
+            m_loadFinished.notify_all();
+            });
+    }
+}
@@ -0,0 +1,332 @@
+#include "VirtualTextureCache.h"
+#include <algorithm>
+#include <unordered_map>
+
+const uint32_t VirtualTextureCache::EMPTY_FEEDBACK;
+const uint32_t VirtualTextureCache::NO_SLOT;
+
+// ------------------------------------------------------------------------------
+// VirtualTextureLayout
+// ------------------------------------------------------------------------------
+
+unsigned int
+VirtualTextureLayout::tilesX(unsigned int mip) const {
+    const unsigned int levelWidth = (std::max)(1u, width >> mip);
+    return (levelWidth + tileSize - 1) / tileSize;
+}
+
+unsigned int
+VirtualTextureLayout::tilesY(unsigned int mip) const {
+    const unsigned int levelHeight = (std::max)(1u, height >> mip);
+    return (levelHeight + tileSize - 1) / tileSize;
+}
+
+unsigned int
+VirtualTextureLayout::calcMipCount(unsigned int width, unsigned int height, unsigned int tileSize) {
+    unsigned int count = 1;
+    while ((std::max)(width >> (count - 1), height >> (count - 1)) > tileSize) {
+        ++count;
+    }
+    return count;
+}
+
+// ------------------------------------------------------------------------------
+// VirtualTextureCache
+// ------------------------------------------------------------------------------
+
+bool
+VirtualTextureCache::init(const VirtualTextureLayout& layout, unsigned int slotsX, unsigned int slotsY) {
+    if (layout.width == 0 || layout.height == 0 || layout.tileSize == 0 ||
+        layout.mipCount == 0 || layout.mipCount > 127 ||
+        layout.tilesX(0) > 4096 || layout.tilesY(0) > 4096 ||
+        slotsX == 0 || slotsY == 0 || slotsX > 256 || slotsY > 256) {
+        return false;
+    }
+    // Las paginas del ultimo nivel quedan fijas y debe sobrar sitio para las demas
+    const unsigned int last = layout.mipCount - 1;
+    if (layout.tilesX(last) * layout.tilesY(last) >= slotsX * slotsY) {
+        return false;
+    }
+
+    m_layout = layout;
+    m_slotsX = slotsX;
+    m_slotsY = slotsY;
+
+    m_mipOffsets.resize(layout.mipCount);
+    m_dirty.resize(layout.mipCount);
+    size_t total = 0;
+    for (unsigned int mip = 0; mip < layout.mipCount; ++mip) {
+        m_mipOffsets[mip] = total;
+        total += static_cast<size_t>(layout.tilesX(mip)) * layout.tilesY(mip);
+
+        // La tabla empieza sin datos: se sube completa la primera vez
+        m_dirty[mip].x = 0;
+        m_dirty[mip].y = 0;
+        m_dirty[mip].width = layout.tilesX(mip);
+        m_dirty[mip].height = layout.tilesY(mip);
+    }
+    m_slotOf.assign(total, NO_SLOT);
+    m_pending.assign(total, 0);
+    m_table.assign(total, 0);
+
+    m_slots.assign(static_cast<size_t>(slotsX) * slotsY, Slot());
+    m_freeSlots.clear();
+    for (unsigned int slot = static_cast<unsigned int>(m_slots.size()); slot-- > 0;) {
+        m_freeSlots.push_back(slot);
+    }
+    m_frame = 1;
+    m_stats = VirtualTextureCacheStats();
+    return true;
+}
+
+void
+VirtualTextureCache::analyzeFeedback(const uint32_t* entries,
+    size_t count,
+    unsigned int maxRequests,
+    std::vector<VirtualPage>& requests) {
+    requests.clear();
+    if (m_slots.empty()) {
+        return;
+    }
+
+    // Ordenar agrupa las repeticiones; el feedback suele tener pocas paginas distintas
+    m_scratch.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (entries[i] != EMPTY_FEEDBACK) {
+            m_scratch.push_back(entries[i]);
+        }
+    }
+    std::sort(m_scratch.begin(), m_scratch.end());
+    m_stats.feedbackEntries += m_scratch.size();
+
+    struct Candidate {
+        VirtualPage page;
+        size_t index = 0;
+        size_t hits = 0;
+    };
+    std::vector<Candidate> candidates;
+    std::unordered_map<size_t, size_t> candidateOf;
+
+    const unsigned int last = m_layout.mipCount - 1;
+    for (size_t i = 0; i < m_scratch.size();) {
+        size_t end = i + 1;
+        while (end < m_scratch.size() && m_scratch[end] == m_scratch[i]) {
+            ++end;
+        }
+        const size_t hits = end - i;
+        VirtualPage page = unpackPage(m_scratch[i]);
+        i = end;
+
+        size_t index = 0;
+        if (!pageIndex(page, index)) {
+            continue;
+        }
+        ++m_stats.uniquePages;
+
+        // Subir por la cadena de antecesores: los residentes se marcan como
+        // usados (son el respaldo de la pagina) y los que faltan se piden
+        while (true) {
+            if (m_slotOf[index] != NO_SLOT) {
+                m_slots[m_slotOf[index]].lastUsed = m_frame;
+            }
+            else if (!m_pending[index]) {
+                auto it = candidateOf.find(index);
+                if (it == candidateOf.end()) {
+                    candidateOf[index] = candidates.size();
+                    Candidate candidate;
+                    candidate.page = page;
+                    candidate.index = index;
+                    candidate.hits = hits;
+                    candidates.push_back(candidate);
+                }
+                else {
+                    candidates[it->second].hits += hits;
+                }
+            }
+            if (page.mip == last) {
+                break;
+            }
+            ++page.mip;
+            page.x = (std::min)(page.x >> 1, m_layout.tilesX(page.mip) - 1);
+            page.y = (std::min)(page.y >> 1, m_layout.tilesY(page.mip) - 1);
+            pageIndex(page, index);
+        }
+    }
+
+    // Primero los niveles gruesos: dan respaldo a todas las paginas que cubren
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.page.mip != b.page.mip) return a.page.mip > b.page.mip;
+        if (a.hits != b.hits) return a.hits > b.hits;
+        return a.index < b.index;
+        });
+
+    const size_t requestCount = (std::min)(candidates.size(), static_cast<size_t>(maxRequests));
+    for (size_t i = 0; i < requestCount; ++i) {
+        m_pending[candidates[i].index] = 1;
+        requests.push_back(candidates[i].page);
+    }
+    m_stats.requested += static_cast<unsigned int>(requestCount);
+}
+
+bool
+VirtualTextureCache::insert(const VirtualPage& page, unsigned int& slot) {
+    size_t index = 0;
+    if (!pageIndex(page, index)) {
+        return false;
+    }
+    m_pending[index] = 0;
+    if (m_slotOf[index] != NO_SLOT) {
+        slot = m_slotOf[index];
+        return true;
+    }
+
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else {
+        // LRU entre las paginas no usadas en este frame; el ultimo nivel queda fijo
+        const size_t pinnedStart = m_mipOffsets[m_layout.mipCount - 1];
+        size_t victim = m_slots.size();
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            const Slot& candidate = m_slots[i];
+            if (candidate.page >= pinnedStart || candidate.lastUsed >= m_frame) continue;
+            if (victim == m_slots.size() || candidate.lastUsed < m_slots[victim].lastUsed) {
+                victim = i;
+            }
+        }
+        if (victim == m_slots.size()) {
+            ++m_stats.rejected;
+            return false;
+        }
+
+        const uint32_t evictedIndex = m_slots[victim].page;
+        m_slotOf[evictedIndex] = NO_SLOT;
+        unsigned int mip = 0;
+        while (mip + 1 < m_layout.mipCount && m_mipOffsets[mip + 1] <= evictedIndex) {
+            ++mip;
+        }
+        const size_t local = evictedIndex - m_mipOffsets[mip];
+        VirtualPage evicted;
+        evicted.mip = mip;
+        evicted.x = static_cast<unsigned int>(local % m_layout.tilesX(mip));
+        evicted.y = static_cast<unsigned int>(local / m_layout.tilesX(mip));
+        refreshFootprint(evicted);
+        ++m_stats.evictions;
+        slot = static_cast<unsigned int>(victim);
+    }
+
+    m_slots[slot].page = static_cast<uint32_t>(index);
+    m_slots[slot].lastUsed = m_frame;
+    m_slotOf[index] = slot;
+    refreshFootprint(page);
+    ++m_stats.inserted;
+    return true;
+}
+
+void
+VirtualTextureCache::cancel(const VirtualPage& page) {
+    size_t index = 0;
+    if (pageIndex(page, index)) {
+        m_pending[index] = 0;
+    }
+}
+
+bool
+VirtualTextureCache::isResident(const VirtualPage& page) const {
+    size_t index = 0;
+    return pageIndex(page, index) && m_slotOf[index] != NO_SLOT;
+}
+
+bool
+VirtualTextureCache::isPending(const VirtualPage& page) const {
+    size_t index = 0;
+    return pageIndex(page, index) && m_pending[index] != 0;
+}
+
+void
+VirtualTextureCache::clearDirty() {
+    for (VirtualTableRegion& region : m_dirty) {
+        region = VirtualTableRegion();
+    }
+}
+
+VirtualTextureCacheStats
+VirtualTextureCache::stats() const {
+    VirtualTextureCacheStats stats = m_stats;
+    stats.resident = static_cast<unsigned int>(m_slots.size() - m_freeSlots.size());
+    stats.pending = static_cast<unsigned int>(std::count(m_pending.begin(), m_pending.end(), 1));
+    return stats;
+}
+
+bool
+VirtualTextureCache::pageIndex(const VirtualPage& page, size_t& index) const {
+    if (page.mip >= m_layout.mipCount) {
+        return false;
+    }
+    const unsigned int tilesX = m_layout.tilesX(page.mip);
+    if (page.x >= tilesX || page.y >= m_layout.tilesY(page.mip)) {
+        return false;
+    }
+    index = m_mipOffsets[page.mip] + static_cast<size_t>(page.y) * tilesX + page.x;
+    return true;
+}
+
+void
+VirtualTextureCache::refreshFootprint(const VirtualPage& page) {
+    const unsigned int last = m_layout.mipCount - 1;
+    // La ultima columna o fila tambien respalda a las que se salen por el redondeo
+    const bool lastColumn = page.x + 1 == m_layout.tilesX(page.mip);
+    const bool lastRow = page.y + 1 == m_layout.tilesY(page.mip);
+
+    for (unsigned int mip = page.mip + 1; mip-- > 0;) {
+        const unsigned int shift = page.mip - mip;
+        const unsigned int tilesX = m_layout.tilesX(mip);
+        const unsigned int tilesY = m_layout.tilesY(mip);
+        const unsigned int x0 = (std::min)(page.x << shift, tilesX);
+        const unsigned int y0 = (std::min)(page.y << shift, tilesY);
+        const unsigned int x1 = lastColumn ? tilesX : (std::min)((page.x + 1) << shift, tilesX);
+        const unsigned int y1 = lastRow ? tilesY : (std::min)((page.y + 1) << shift, tilesY);
+        if (x0 >= x1 || y0 >= y1) {
+            break;
+        }
+
+        uint32_t* table = m_table.data() + m_mipOffsets[mip];
+        const uint32_t* parent = mip < last ? m_table.data() + m_mipOffsets[mip + 1] : nullptr;
+        const unsigned int parentTilesX = mip < last ? m_layout.tilesX(mip + 1) : 0;
+        const unsigned int parentTilesY = mip < last ? m_layout.tilesY(mip + 1) : 0;
+        for (unsigned int y = y0; y < y1; ++y) {
+            for (unsigned int x = x0; x < x1; ++x) {
+                const size_t local = static_cast<size_t>(y) * tilesX + x;
+                const uint32_t slot = m_slotOf[m_mipOffsets[mip] + local];
+                if (slot != NO_SLOT) {
+                    table[local] = (slot % m_slotsX) | ((slot / m_slotsX) << 8) | (mip << 16) | 0xFF000000u;
+                }
+                else if (parent) {
+                    const unsigned int px = (std::min)(x >> 1, parentTilesX - 1);
+                    const unsigned int py = (std::min)(y >> 1, parentTilesY - 1);
+                    table[local] = parent[static_cast<size_t>(py) * parentTilesX + px];
+                }
+                else {
+                    table[local] = 0;
+                }
+            }
+        }
+
+        VirtualTableRegion& dirty = m_dirty[mip];
+        if (dirty.width == 0) {
+            dirty.x = x0;
+            dirty.y = y0;
+            dirty.width = x1 - x0;
+            dirty.height = y1 - y0;
+        }
+        else {
+            const unsigned int right = (std::max)(dirty.x + dirty.width, x1);
+            const unsigned int bottom = (std::max)(dirty.y + dirty.height, y1);
+            dirty.x = (std::min)(dirty.x, x0);
+            dirty.y = (std::min)(dirty.y, y0);
+            dirty.width = right - dirty.x;
+            dirty.height = bottom - dirty.y;
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#include "VirtualTextureFile.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    const char kMagic[4] = { 'P', 'V', 'T', 'X' };
+    const uint32_t kVersion = 1;
+    const uint64_t kAlignment = 16;
+    const uint32_t kSrgbFlag = 1;
+
+    /**
+     * @brief Cabecera del archivo (32 bytes).
+     */
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t tileSize;
+        uint32_t border;
+        uint32_t mipCount;
+        uint32_t flags;
+    };
+
+    /**
+     * @brief Entrada de la tabla de paginas (16 bytes).
+     */
+    struct FilePage {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    /**
+     * @brief Copia una pagina con bordes; las coordenadas fuera de la imagen se fijan al borde.
+     */
+    void cutPage(const ImageLevel& level,
+        const VirtualTextureLayout& layout,
+        unsigned int pageX,
+        unsigned int pageY,
+        std::vector<unsigned char>& out) {
+        const unsigned int padded = layout.paddedTileSize();
+        out.resize(static_cast<size_t>(padded) * padded * 4);
+        const int originX = static_cast<int>(pageX * layout.tileSize) - static_cast<int>(layout.border);
+        const int originY = static_cast<int>(pageY * layout.tileSize) - static_cast<int>(layout.border);
+        const int maxX = static_cast<int>(level.width) - 1;
+        const int maxY = static_cast<int>(level.height) - 1;
+
+        for (unsigned int y = 0; y < padded; ++y) {
+            const int sourceY = (std::min)((std::max)(originY + static_cast<int>(y), 0), maxY);
+            const unsigned char* row = level.pixels.data() + static_cast<size_t>(sourceY) * level.rowPitch;
+            unsigned char* target = out.data() + static_cast<size_t>(y) * padded * 4;
+            for (unsigned int x = 0; x < padded; ++x) {
+                const int sourceX = (std::min)((std::max)(originX + static_cast<int>(x), 0), maxX);
+                std::memcpy(target + x * 4, row + sourceX * 4, 4);
+            }
+        }
+    }
+}
+
+bool
+VirtualTextureFile::build(const unsigned char* pixels,
+    unsigned int width,
+    unsigned int height,
+    unsigned int rowPitch,
+    unsigned int tileSize,
+    unsigned int border,
+    bool srgb,
+    MipFilter filter,
+    const std::string& path) {
+    if (!pixels || width == 0 || height == 0 || tileSize == 0) {
+        return false;
+    }
+
+    VirtualTextureLayout layout;
+    layout.width = width;
+    layout.height = height;
+    layout.tileSize = tileSize;
+    layout.border = border;
+    layout.mipCount = VirtualTextureLayout::calcMipCount(width, height, tileSize);
+
+    std::vector<ImageLevel> levels;
+    if (!MipGenerator().generate(pixels, width, height, rowPitch, filter, srgb, levels, layout.mipCount) ||
+        levels.size() != layout.mipCount) {
+        return false;
+    }
+
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.width = width;
+    header.height = height;
+    header.tileSize = tileSize;
+    header.border = border;
+    header.mipCount = layout.mipCount;
+    header.flags = srgb ? kSrgbFlag : 0;
+
+    const uint64_t pageSize = static_cast<uint64_t>(layout.paddedTileSize()) * layout.paddedTileSize() * 4;
+    std::vector<FilePage> table;
+    for (unsigned int mip = 0; mip < layout.mipCount; ++mip) {
+        table.resize(table.size() + static_cast<size_t>(layout.tilesX(mip)) * layout.tilesY(mip));
+    }
+    uint64_t offset = alignUp(sizeof(FileHeader) + table.size() * sizeof(FilePage));
+    for (FilePage& page : table) {
+        page.offset = offset;
+        page.size = pageSize;
+        offset = alignUp(offset + pageSize);
+    }
+
+    std::error_code error;
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    static std::atomic<unsigned int> tempCounter(0);
+    const std::string tempPath = path + "." + std::to_string(tempCounter++) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        const char padding[kAlignment] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(table.data()),
+            static_cast<std::streamsize>(table.size() * sizeof(FilePage)));
+        uint64_t written = sizeof(FileHeader) + table.size() * sizeof(FilePage);
+
+        std::vector<unsigned char> page;
+        size_t index = 0;
+        for (unsigned int mip = 0; mip < layout.mipCount; ++mip) {
+            for (unsigned int y = 0; y < layout.tilesY(mip); ++y) {
+                for (unsigned int x = 0; x < layout.tilesX(mip); ++x, ++index) {
+                    cutPage(levels[mip], layout, x, y, page);
+                    file.write(padding, static_cast<std::streamsize>(table[index].offset - written));
+                    file.write(reinterpret_cast<const char*>(page.data()), static_cast<std::streamsize>(page.size()));
+                    written = table[index].offset + page.size();
+                }
+            }
+            // El nivel ya esta escrito: liberar su memoria antes del siguiente
+            std::vector<unsigned char>().swap(levels[mip].pixels);
+        }
+        if (!file) {
+            file.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool
+VirtualTextureFile::open(const std::string& path) {
+    close();
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(FileHeader)) {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, 4) != 0 || header.version != kVersion ||
+        header.width == 0 || header.height == 0 || header.tileSize == 0 ||
+        header.mipCount != VirtualTextureLayout::calcMipCount(header.width, header.height, header.tileSize)) {
+        return false;
+    }
+
+    VirtualTextureLayout layout;
+    layout.width = header.width;
+    layout.height = header.height;
+    layout.tileSize = header.tileSize;
+    layout.border = header.border;
+    layout.mipCount = header.mipCount;
+
+    std::vector<size_t> mipOffsets(layout.mipCount);
+    size_t pageCount = 0;
+    for (unsigned int mip = 0; mip < layout.mipCount; ++mip) {
+        mipOffsets[mip] = pageCount;
+        pageCount += static_cast<size_t>(layout.tilesX(mip)) * layout.tilesY(mip);
+    }
+    if (sizeof(FileHeader) + static_cast<uint64_t>(pageCount) * sizeof(FilePage) > file.size()) {
+        return false;
+    }
+
+    // Validar la tabla una vez para que readPage no tenga que hacerlo
+    const unsigned char* table = file.data() + sizeof(FileHeader);
+    const uint64_t pageSize = static_cast<uint64_t>(layout.paddedTileSize()) * layout.paddedTileSize() * 4;
+    for (size_t i = 0; i < pageCount; ++i) {
+        FilePage page;
+        std::memcpy(&page, table + i * sizeof(FilePage), sizeof(page));
+        if (page.size != pageSize || page.offset > file.size() || page.size > file.size() - page.offset) {
+            return false;
+        }
+    }
+
+    m_layout = layout;
+    m_srgb = (header.flags & kSrgbFlag) != 0;
+    m_mipOffsets = std::move(mipOffsets);
+    m_file = std::move(file);
+    m_table = m_file.data() + sizeof(FileHeader);
+    return true;
+}
+
+void
+VirtualTextureFile::close() {
+    m_file.close();
+    m_layout = VirtualTextureLayout();
+    m_srgb = false;
+    m_mipOffsets.clear();
+    m_table = nullptr;
+}
+
+bool
+VirtualTextureFile::readPage(const VirtualPage& page, std::vector<unsigned char>& pixels) const {
+    if (!m_table || page.mip >= m_layout.mipCount ||
+        page.x >= m_layout.tilesX(page.mip) || page.y >= m_layout.tilesY(page.mip)) {
+        return false;
+    }
+    const size_t index = m_mipOffsets[page.mip] +
+        static_cast<size_t>(page.y) * m_layout.tilesX(page.mip) + page.x;
+    FilePage entry;
+    std::memcpy(&entry, m_table + index * sizeof(FilePage), sizeof(entry));
+
+    pixels.resize(static_cast<size_t>(entry.size));
+    std::memcpy(pixels.data(), m_file.data() + entry.offset, static_cast<size_t>(entry.size));
+    return true;
+}
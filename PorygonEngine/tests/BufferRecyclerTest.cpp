@@ -0,0 +1,251 @@
+#include "Check.h"
+#include "BufferRecycler.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Dispositivo falso: los "buffers" son direcciones de un arreglo y
+     *        solo se cuenta cuantos se crean y se destruyen.
+     */
+    struct FakeDevice {
+        char handles[256] = {};
+        unsigned int created = 0;
+        unsigned int destroyed = 0;
+
+        void*
+            create() { return &handles[created++]; }
+
+        void
+            destroy(const std::vector<void*>& expired) { destroyed += static_cast<unsigned int>(expired.size()); }
+    };
+
+    /**
+     * @brief Como BufferPool::acquire: recicla o crea y registra.
+     */
+    void*
+        acquire(BufferRecycler& recycler, FakeDevice& device, const BufferPoolKey& key, size_t requested) {
+        void* buffer = recycler.acquire(key, requested);
+        if (!buffer) {
+            buffer = device.create();
+            recycler.track(buffer, key, requested);
+        }
+        return buffer;
+    }
+
+    /**
+     * @brief Avanza frames destruyendo lo que el recycler expulsa.
+     */
+    void
+        advance(BufferRecycler& recycler, FakeDevice& device, unsigned int frames, std::vector<void*>* expiredOut = nullptr) {
+        for (unsigned int i = 0; i < frames; ++i) {
+            std::vector<void*> expired;
+            recycler.beginFrame(expired);
+            device.destroy(expired);
+            if (expiredOut) {
+                expiredOut->insert(expiredOut->end(), expired.begin(), expired.end());
+            }
+        }
+    }
+
+    BufferPoolKey
+        dynamicKey(const BufferRecycler& recycler, size_t size) {
+        BufferPoolKey key;
+        key.bindFlags = 0x4;          // D3D11_BIND_CONSTANT_BUFFER
+        key.usage = 2;                // D3D11_USAGE_DYNAMIC
+        key.cpuAccessFlags = 0x10000; // D3D11_CPU_ACCESS_WRITE
+        key.sizeClass = recycler.sizeClassOf(size);
+        return key;
+    }
+
+    void
+        testSizeClassesRoundUpToAPowerOfTwo() {
+        BufferRecycler recycler;
+        recycler.init();
+        CHECK(recycler.sizeClassOf(1) == 8); // minSizeClass: 256 bytes
+        CHECK(recycler.sizeClassOf(256) == 8);
+        CHECK(recycler.sizeClassOf(257) == 9);
+        CHECK(recycler.sizeClassOf(4096) == 12);
+
+        BufferRecyclerOptions options;
+        options.minSizeClass = 4;
+        recycler.init(options);
+        CHECK(recycler.sizeClassOf(1) == 4);
+        CHECK(recycler.sizeClassOf(17) == 5);
+    }
+
+    void
+        testReleasedBufferWaitsFrameDelayBeforeReuse() {
+        BufferRecycler recycler;
+        recycler.init();
+        FakeDevice device;
+        const BufferPoolKey key = dynamicKey(recycler, 80);
+
+        void* first = acquire(recycler, device, key, 80);
+        CHECK(recycler.stats().misses == 1);
+        CHECK(recycler.stats().live == 1);
+        CHECK(recycler.stats().liveBytes == 256);
+        CHECK(recycler.stats().wastedBytes == 176);
+
+        CHECK(recycler.release(first));
+        CHECK(!recycler.release(first)); // Ya no esta entregado
+        CHECK(recycler.stats().live == 0);
+        CHECK(recycler.stats().wastedBytes == 0);
+        CHECK(recycler.stats().pooled == 1);
+
+        // La GPU puede seguir leyendolo: durante frameDelay - 1 frames se crea otro
+        advance(recycler, device, 2);
+        void* second = acquire(recycler, device, key, 64);
+        CHECK(second != first);
+        CHECK(recycler.stats().misses == 2);
+        recycler.release(second);
+
+        // Cumplido el retraso del primero, se entrega ese
+        advance(recycler, device, 1);
+        void* third = acquire(recycler, device, key, 64);
+        CHECK(third == first);
+        CHECK(recycler.stats().hits == 1);
+        CHECK(recycler.stats().wastedBytes == 192);
+        CHECK(device.created == 2);
+        CHECK(recycler.stats().hitRate() > 0.33 && recycler.stats().hitRate() < 0.34);
+    }
+
+    void
+        testBucketsDoNotMix() {
+        BufferRecycler recycler;
+        recycler.init();
+        FakeDevice device;
+        BufferPoolKey small = dynamicKey(recycler, 100);
+        BufferPoolKey large = dynamicKey(recycler, 1000);
+        BufferPoolKey vertex = small;
+        vertex.bindFlags = 0x1; // D3D11_BIND_VERTEX_BUFFER
+
+        recycler.release(acquire(recycler, device, small, 100));
+        advance(recycler, device, 3);
+        CHECK(recycler.acquire(large, 1000) == nullptr);
+        CHECK(recycler.acquire(vertex, 100) == nullptr);
+        CHECK(recycler.acquire(small, 200) != nullptr);
+    }
+
+    void
+        testIdleBuffersAreTrimmed() {
+        BufferRecyclerOptions options;
+        options.trimFrames = 10;
+        BufferRecycler recycler;
+        recycler.init(options);
+        FakeDevice device;
+        const BufferPoolKey key = dynamicKey(recycler, 256);
+
+        void* buffer = acquire(recycler, device, key, 256);
+        recycler.release(buffer);
+
+        std::vector<void*> expired;
+        advance(recycler, device, 10, &expired);
+        CHECK(expired.empty());
+        advance(recycler, device, 1, &expired);
+        CHECK(expired.size() == 1 && expired[0] == buffer);
+        CHECK(recycler.stats().trimmed == 1);
+        CHECK(recycler.stats().pooled == 0);
+        CHECK(recycler.stats().pooledBytes == 0);
+        CHECK(recycler.acquire(key, 256) == nullptr);
+    }
+
+    void
+        testPooledBytesCapEvictsTheOldest() {
+        BufferRecyclerOptions options;
+        options.maxPooledBytes = 1024;
+        BufferRecycler recycler;
+        recycler.init(options);
+        FakeDevice device;
+        const BufferPoolKey small = dynamicKey(recycler, 256);
+        const BufferPoolKey large = dynamicKey(recycler, 1024);
+
+        void* oldest = acquire(recycler, device, small, 256);
+        void* newer = acquire(recycler, device, small, 256);
+        void* big = acquire(recycler, device, large, 1024);
+        recycler.release(oldest);
+        advance(recycler, device, 1);
+        recycler.release(newer);
+        advance(recycler, device, 1);
+        recycler.release(big);
+
+        // 1536 > 1024, pero solo oldest esta libre: los que esperan su retraso no se expulsan
+        std::vector<void*> expired;
+        advance(recycler, device, 1, &expired);
+        CHECK(expired.size() == 1 && expired[0] == oldest);
+        CHECK(recycler.stats().pooledBytes == 1280);
+
+        // Al quedar libre newer sigue por encima del limite y se expulsa; big cabe justo
+        expired.clear();
+        advance(recycler, device, 2, &expired);
+        CHECK(expired.size() == 1 && expired[0] == newer);
+        CHECK(recycler.stats().pooledBytes == 1024);
+        CHECK(recycler.stats().trimmed == 2);
+        CHECK(recycler.acquire(large, 1024) == big);
+    }
+
+    void
+        testClearHandsBackEveryPooledBuffer() {
+        BufferRecycler recycler;
+        recycler.init();
+        FakeDevice device;
+        const BufferPoolKey key = dynamicKey(recycler, 64);
+
+        void* a = acquire(recycler, device, key, 64);
+        void* b = acquire(recycler, device, key, 64);
+        void* live = acquire(recycler, device, key, 64);
+        recycler.release(a);
+        advance(recycler, device, 3);
+        recycler.release(b);
+
+        std::vector<void*> expired;
+        recycler.clear(expired);
+        CHECK(expired.size() == 2);
+        CHECK(std::find(expired.begin(), expired.end(), a) != expired.end());
+        CHECK(std::find(expired.begin(), expired.end(), b) != expired.end());
+        CHECK(recycler.stats().pooled == 0);
+        CHECK(recycler.stats().live == 1);
+        CHECK(recycler.release(live)); // Lo entregado sigue siendo del llamador
+    }
+
+    /**
+     * @brief Buffers de vida corta con tamanos variables: tras el arranque casi
+     *        todo sale del pool y no se crean buffers nuevos por frame.
+     */
+    void
+        testSteadyStreamingReachesAHighHitRate() {
+        BufferRecycler recycler;
+        recycler.init();
+        FakeDevice device;
+
+        std::vector<void*> inFlight;
+        for (unsigned int frame = 0; frame < 200; ++frame) {
+            advance(recycler, device, 1);
+            for (void* buffer : inFlight) {
+                recycler.release(buffer);
+            }
+            inFlight.clear();
+            for (unsigned int i = 0; i < 4; ++i) {
+                const size_t size = 200 + ((frame * 37 + i * 101) % 800);
+                inFlight.push_back(acquire(recycler, device, dynamicKey(recycler, size), size));
+            }
+        }
+
+        CHECK(recycler.stats().hitRate() > 0.9);
+        CHECK(device.created < 40);
+        CHECK(device.destroyed == 0);
+        CHECK(recycler.stats().live == 4);
+    }
+}
+
+int
+main() {
+    testSizeClassesRoundUpToAPowerOfTwo();
+    testReleasedBufferWaitsFrameDelayBeforeReuse();
+    testBucketsDoNotMix();
+    testIdleBuffersAreTrimmed();
+    testPooledBytesCapEvictsTheOldest();
+    testClearHandsBackEveryPooledBuffer();
+    testSteadyStreamingReachesAHighHitRate();
+    return checkFailures();
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdio>
+
+/**
+ * @brief Fallos acumulados por CHECK; main devuelve este valor.
+ */
+inline int&
+    checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+/**
+ * @brief Comprueba una condicion y anota el fallo sin abortar la prueba.
+ */
+#define CHECK(condition)                                                        \
+{                                                                               \
+    if (!(condition)) {                                                         \
+        std::fprintf(stderr, "%s:%d: CHECK(%s)\n", __FILE__, __LINE__, #condition); \
+        ++checkFailures();                                                      \
+    }                                                                           \
+}
@@ -0,0 +1,172 @@
+#include "Check.h"
+#include "ConstantRing.h"
+
+namespace {
+    void
+        testAllocationsAreAlignedAndFirstOneDiscards() {
+        ConstantRing ring;
+        ring.init(1024, 256);
+
+        ConstantRingAllocation a, b, c;
+        CHECK(ring.allocate(64, a));
+        CHECK(ring.allocate(300, b));
+        CHECK(ring.allocate(256, c));
+        CHECK(a.offset == 0 && a.size == 256);
+        CHECK(b.offset == 256 && b.size == 512);
+        CHECK(c.offset == 768 && c.size == 256);
+        CHECK(a.discard);
+        CHECK(!b.discard && !c.discard);
+        CHECK(a.generation == b.generation && b.generation == c.generation);
+        CHECK(ring.used() == 1024);
+        CHECK(ring.stats().requested == 620);
+        CHECK(ring.stats().allocated == 1024);
+    }
+
+    void
+        testOversizeAndZeroFail() {
+        ConstantRing ring;
+        ring.init(1024, 256);
+
+        ConstantRingAllocation allocation;
+        CHECK(!ring.allocate(1025, allocation));
+        CHECK(!ring.allocate(0, allocation));
+        CHECK(ring.stats().failures == 2);
+        CHECK(ring.used() == 0);
+    }
+
+    void
+        testRingNeverWrapsInsideAFrame() {
+        ConstantRing ring;
+        ring.init(1024, 256);
+        ring.beginFrame();
+
+        ConstantRingAllocation first, allocation;
+        CHECK(ring.allocate(256, first));
+        const uint64_t generation = ring.generation();
+        CHECK(ring.allocate(512, allocation));
+
+        // No cabe: falla en lugar de dar la vuelta y perder `first`
+        CHECK(!ring.allocate(512, allocation));
+        CHECK(ring.stats().overflows == 1);
+        CHECK(ring.stats().wraps == 0);
+        CHECK(ring.generation() == generation);
+        CHECK(first.generation == ring.generation());
+    }
+
+    void
+        testWrapHappensAtBeginFrameAndInvalidatesOldBlocks() {
+        ConstantRing ring;
+        ring.init(1024, 256);
+
+        ring.beginFrame();
+        ConstantRingAllocation persistent, perFrame;
+        CHECK(ring.allocate(256, persistent));
+        CHECK(ring.allocate(256, perFrame));
+
+        // El frame mas exigente pidio 512 y quedan 512: no hace falta dar la vuelta
+        ring.beginFrame();
+        CHECK(ring.stats().wraps == 0);
+        CHECK(persistent.generation == ring.generation());
+        CHECK(ring.allocate(256, perFrame));
+        CHECK(!perFrame.discard);
+
+        // Quedan 256 y el frame mas exigente pidio 512: la vuelta ocurre aqui, antes de cualquier comprobacion
+        ring.beginFrame();
+        CHECK(ring.stats().wraps == 1);
+        CHECK(persistent.generation != ring.generation());
+        CHECK(ring.allocate(256, perFrame));
+        CHECK(perFrame.discard);
+        CHECK(perFrame.offset == 0);
+        CHECK(perFrame.generation == ring.generation());
+    }
+
+    void
+        testResetInvalidatesEveryBlock() {
+        ConstantRing ring;
+        ring.init(1024, 256);
+
+        ConstantRingAllocation allocation;
+        CHECK(ring.allocate(16, allocation));
+        ring.reset();
+        CHECK(allocation.generation != ring.generation());
+        CHECK(ring.allocate(16, allocation));
+        CHECK(allocation.discard);
+        CHECK(allocation.offset == 0);
+    }
+
+    void
+        testRepeatDiscardKeepsTheGeneration() {
+        ConstantRing ring;
+        ring.init(1024, 256);
+        ring.beginFrame();
+
+        // Fallo el Map del DISCARD: el siguiente bloque lo repite sin invalidar nada
+        ConstantRingAllocation failed, retry, next;
+        CHECK(ring.allocate(64, failed));
+        CHECK(failed.discard);
+        const uint64_t generation = ring.generation();
+        ring.repeatDiscard();
+        CHECK(ring.allocate(64, retry));
+        CHECK(retry.discard);
+        CHECK(retry.offset == 256);
+        CHECK(ring.generation() == generation);
+        CHECK(ring.allocate(64, next));
+        CHECK(!next.discard);
+        CHECK(ring.stats().wraps == 0);
+    }
+
+    /**
+     * @brief Reproduce BaseApp::update: constantes que nunca cambian, por
+     *        cambio de tamano y por frame, subidas solo si no son validas.
+     *
+     * Lo que se enlaza en cada frame debe seguir siendo valido tras la ultima
+     * reserva del frame, sin importar cuando da la vuelta el anillo.
+     */
+    void
+        testSkippedConstantsStayValidUntilBound() {
+        ConstantRing ring;
+        ring.init(4096, 256);
+
+        const size_t sizes[3] = { 64, 64, 80 };
+        ConstantRingAllocation blocks[3];
+        bool written[3] = { false, false, false };
+        unsigned int invalidBinds = 0;
+        unsigned int fallbacks = 0;
+
+        for (unsigned int frame = 0; frame < 1000; ++frame) {
+            ring.beginFrame();
+            for (int i = 0; i < 3; ++i) {
+                const bool changed = i == 2 || (i == 1 && frame % 97 == 0);
+                if (!changed && written[i] && blocks[i].generation == ring.generation()) {
+                    continue; // Subida evitada: el bloque sigue en el anillo
+                }
+                written[i] = ring.allocate(sizes[i], blocks[i]);
+                if (!written[i]) {
+                    ++fallbacks; // Buffer propio del ConstantBuffer
+                }
+            }
+            for (int i = 0; i < 3; ++i) {
+                if (written[i] && blocks[i].generation != ring.generation()) {
+                    ++invalidBinds;
+                }
+            }
+        }
+
+        CHECK(invalidBinds == 0);
+        CHECK(fallbacks == 0);
+        CHECK(ring.stats().wraps > 0);
+        CHECK(ring.stats().overflows == 0);
+    }
+}
+
+int
+main() {
+    testAllocationsAreAlignedAndFirstOneDiscards();
+    testOversizeAndZeroFail();
+    testRingNeverWrapsInsideAFrame();
+    testWrapHappensAtBeginFrameAndInvalidatesOldBlocks();
+    testResetInvalidatesEveryBlock();
+    testRepeatDiscardKeepsTheGeneration();
+    testSkippedConstantsStayValidUntilBound();
+    return checkFailures();
+}
@@ -0,0 +1,122 @@
+#include "Check.h"
+#include "MeshInstancer.h"
+#include <cmath>
+
+namespace {
+    const XMFLOAT3 kShape[] = {
+        XMFLOAT3(3.0f, 0.1f, 0.2f),
+        XMFLOAT3(0.2f, 1.7f, -0.3f),
+        XMFLOAT3(-0.4f, -0.3f, 0.9f),
+        XMFLOAT3(-0.6f, 0.2f, -0.5f),
+        XMFLOAT3(0.4f, -0.8f, 0.1f),
+    };
+    const unsigned int kTriangles[] = { 0, 1, 2, 0, 2, 3, 0, 3, 4, 1, 3, 2, 1, 4, 3 };
+
+    /**
+     * @brief Rota v un angulo alrededor de un eje unitario (Rodrigues).
+     */
+    XMFLOAT3
+        rotate(const XMFLOAT3& v, const XMFLOAT3& axis, float angle) {
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        const float d = axis.x * v.x + axis.y * v.y + axis.z * v.z;
+        const XMFLOAT3 k(axis.y * v.z - axis.z * v.y, axis.z * v.x - axis.x * v.z, axis.x * v.y - axis.y * v.x);
+        return XMFLOAT3(v.x * c + k.x * s + axis.x * d * (1.0f - c),
+            v.y * c + k.y * s + axis.y * d * (1.0f - c),
+            v.z * c + k.z * s + axis.z * d * (1.0f - c));
+    }
+
+    XMFLOAT3
+        normalize(const XMFLOAT3& v) {
+        const float len = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        return XMFLOAT3(v.x / len, v.y / len, v.z / len);
+    }
+
+    /**
+     * @brief Anade una copia de la figura escalada, rotada y trasladada como objeto nuevo.
+     */
+    void
+        addCopy(LoadData& data, const char* name, float scaleFactor,
+            const XMFLOAT3& axis, float angle, const XMFLOAT3& offset) {
+        const unsigned int base = static_cast<unsigned int>(data.vertex.size());
+        for (const XMFLOAT3& p : kShape) {
+            const XMFLOAT3 r = rotate(XMFLOAT3(p.x * scaleFactor, p.y * scaleFactor, p.z * scaleFactor), axis, angle);
+            SimpleVertex v;
+            v.Pos = XMFLOAT3(r.x + offset.x, r.y + offset.y, r.z + offset.z);
+            v.Tex = XMFLOAT2(p.x * 0.25f, p.y * 0.5f);
+            v.Normal = rotate(normalize(p), axis, angle);
+            data.vertex.push_back(v);
+        }
+
+        LoadObject object;
+        object.name = name;
+        object.startIndex = static_cast<unsigned int>(data.index.size());
+        object.indexCount = sizeof(kTriangles) / sizeof(kTriangles[0]);
+        for (unsigned int index : kTriangles) {
+            data.index.push_back(base + index);
+        }
+        data.objects.push_back(object);
+    }
+
+    /**
+     * @brief Error maximo al llevar el prototipo al mundo con la matriz de cada instancia.
+     */
+    float
+        reconstructionError(const LoadData& data, const InstancedModel& model) {
+        float error = 0.0f;
+        for (size_t i = 0; i < model.instances.size(); ++i) {
+            const MeshInstance& instance = model.instances[i];
+            const MeshPrototype& prototype = model.prototypes[instance.prototype];
+            const LoadObject& object = data.objects[i];
+            const XMFLOAT4X4& m = instance.transform;
+            for (unsigned int k = 0; k < object.indexCount; ++k) {
+                const XMFLOAT3& world = data.vertex[data.index[object.startIndex + k]].Pos;
+                const XMFLOAT3& local = prototype.vertex[prototype.index[k]].Pos;
+                const float x = local.x * m._11 + local.y * m._21 + local.z * m._31 + m._41;
+                const float y = local.x * m._12 + local.y * m._22 + local.z * m._32 + m._42;
+                const float z = local.x * m._13 + local.y * m._23 + local.z * m._33 + m._43;
+                error = std::fmax(error, std::fabs(x - world.x) + std::fabs(y - world.y) + std::fabs(z - world.z));
+            }
+        }
+        return error;
+    }
+
+    void
+        testRotatedAndTranslatedCopiesShareOnePrototype() {
+        LoadData data;
+        addCopy(data, "a", 1.0f, normalize(XMFLOAT3(0.0f, 0.0f, 1.0f)), 0.0f, XMFLOAT3(0.0f, 0.0f, 0.0f));
+        addCopy(data, "b", 1.0f, normalize(XMFLOAT3(0.3f, 1.0f, -0.2f)), 0.7f, XMFLOAT3(512.25f, -3.5f, 77.0f));
+        addCopy(data, "c", 1.0f, normalize(XMFLOAT3(-1.0f, 0.4f, 0.9f)), 2.9f, XMFLOAT3(-1024.0f, 2048.5f, -0.125f));
+        addCopy(data, "d", 1.0f, normalize(XMFLOAT3(0.8f, -0.6f, 0.1f)), -1.3f, XMFLOAT3(0.001f, 333.3f, -999.9f));
+        addCopy(data, "e", 1.0f, normalize(XMFLOAT3(1.0f, 1.0f, 1.0f)), 4.4f, XMFLOAT3(12.0f, 13.0f, 14.0f));
+
+        MeshInstancer instancer;
+        const InstancedModel model = instancer.build(data);
+
+        CHECK(model.instances.size() == 5);
+        CHECK(model.prototypes.size() == 1);
+        CHECK(model.prototypes.size() == 1 && model.prototypes[0].instanceCount == 5);
+        CHECK(model.uniqueVertexCount == sizeof(kShape) / sizeof(kShape[0]));
+        CHECK(reconstructionError(data, model) < 1.0e-2f);
+    }
+
+    void
+        testScaledCopyIsADifferentPrototype() {
+        LoadData data;
+        addCopy(data, "a", 1.0f, XMFLOAT3(0.0f, 1.0f, 0.0f), 0.5f, XMFLOAT3(1.0f, 2.0f, 3.0f));
+        addCopy(data, "b", 1.5f, XMFLOAT3(0.0f, 1.0f, 0.0f), 0.5f, XMFLOAT3(1.0f, 2.0f, 3.0f));
+
+        MeshInstancer instancer;
+        const InstancedModel model = instancer.build(data);
+
+        CHECK(model.prototypes.size() == 2);
+        CHECK(reconstructionError(data, model) < 1.0e-3f);
+    }
+}
+
+int
+main() {
+    testRotatedAndTranslatedCopiesShareOnePrototype();
+    testScaledCopyIsADifferentPrototype();
+    return checkFailures();
+}
@@ -0,0 +1,274 @@
+#include "Check.h"
+#include "TextureResidency.h"
+#include "Device.h"
+#include "DeviceContext.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+    int g_liveObjects = 0;
+
+    /**
+     * @brief Objeto COM falso con cuenta de referencias; g_liveObjects detecta fugas.
+     */
+    template <typename Interface>
+    struct FakeObject : Interface {
+        unsigned long refs = 1;
+
+        FakeObject() { ++g_liveObjects; }
+        virtual ~FakeObject() { --g_liveObjects; }
+
+        unsigned long
+            AddRef() override { return ++refs; }
+
+        unsigned long
+            Release() override {
+            const unsigned long left = --refs;
+            if (left == 0) {
+                delete this;
+            }
+            return left;
+        }
+    };
+
+    struct FakeTexture2D : FakeObject<ID3D11Texture2D> {
+        D3D11_TEXTURE2D_DESC desc = {};
+
+        void
+            GetType(D3D11_RESOURCE_DIMENSION* dimension) override { *dimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D; }
+
+        void
+            GetDesc(D3D11_TEXTURE2D_DESC* pDesc) override { *pDesc = desc; }
+    };
+
+    struct FakeView : FakeObject<ID3D11ShaderResourceView> {
+        ID3D11Resource* resource = nullptr;
+        D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
+
+        ~FakeView() override { resource->Release(); }
+
+        void
+            GetResource(ID3D11Resource** ppResource) override {
+            resource->AddRef();
+            *ppResource = resource;
+        }
+
+        void
+            GetDesc(D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc) override { *pDesc = desc; }
+    };
+
+    struct FakeD3DDevice : FakeObject<ID3D11Device> {
+        HRESULT
+            CreateShaderResourceView(ID3D11Resource* pResource,
+                const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc,
+                ID3D11ShaderResourceView** ppSRView) override {
+            FakeView* view = new FakeView();
+            pResource->AddRef();
+            view->resource = pResource;
+            view->desc = *pDesc;
+            *ppSRView = view;
+            return S_OK;
+        }
+    };
+
+    struct Copy {
+        ID3D11Resource* destination;
+        unsigned int destinationLevel;
+        ID3D11Resource* source;
+        unsigned int sourceLevel;
+    };
+
+    std::vector<Copy> g_copies;
+    unsigned int g_loadSize = 256;
+
+    unsigned int
+        mipCount(unsigned int size) {
+        unsigned int levels = 1;
+        while (size > 1) {
+            size >>= 1;
+            ++levels;
+        }
+        return levels;
+    }
+
+    size_t
+        rgbaBytes(unsigned int size, unsigned int levels) {
+        size_t total = 0;
+        for (unsigned int level = 0; level < levels; ++level) {
+            const size_t side = (std::max)(1u, size >> level);
+            total += side * side * 4;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Textura 2D que hay detras de la SRV de `texture`.
+     */
+    D3D11_TEXTURE2D_DESC
+        viewDesc(const Texture& texture) {
+        ID3D11Resource* resource = nullptr;
+        texture.m_textureFromImg->GetResource(&resource);
+        D3D11_TEXTURE2D_DESC desc = {};
+        static_cast<ID3D11Texture2D*>(resource)->GetDesc(&desc);
+        resource->Release();
+        return desc;
+    }
+}
+
+// Sustitutos de las partes del motor que tocan DirectX: mismas reglas de
+// propiedad que las reales (Texture solo conserva la SRV).
+
+HRESULT
+Device::CreateTexture2D(const D3D11_TEXTURE2D_DESC* pDesc,
+    const D3D11_SUBRESOURCE_DATA*,
+    ID3D11Texture2D** ppTexture2D) {
+    FakeTexture2D* texture = new FakeTexture2D();
+    texture->desc = *pDesc;
+    *ppTexture2D = texture;
+    return S_OK;
+}
+
+void
+DeviceContext::CopySubresourceRegion(ID3D11Resource* pDstResource,
+    unsigned int DstSubresource,
+    unsigned int,
+    unsigned int,
+    unsigned int,
+    ID3D11Resource* pSrcResource,
+    unsigned int SrcSubresource,
+    const D3D11_BOX*) {
+    g_copies.push_back({ pDstResource, DstSubresource, pSrcResource, SrcSubresource });
+}
+
+HRESULT
+Texture::init(Device& device,
+    const std::string& textureName,
+    ExtensionType extensionType,
+    const TextureImportOptions&) {
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = g_loadSize;
+    desc.Height = g_loadSize;
+    desc.MipLevels = mipCount(g_loadSize);
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    HRESULT hr = device.CreateTexture2D(&desc, nullptr, &m_texture);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = desc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = desc.MipLevels;
+    hr = device.m_device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureFromImg);
+    SAFE_RELEASE(m_texture);
+
+    m_textureName = textureName;
+    // Como el cargador real: DDS no informa su memoria
+    m_memoryBytes = extensionType == DDS ? 0 : rgbaBytes(desc.Width, desc.MipLevels);
+    return hr;
+}
+
+void
+Texture::destroy() {
+    SAFE_RELEASE(m_texture);
+    SAFE_RELEASE(m_textureFromImg);
+    m_memoryBytes = 0;
+}
+
+namespace {
+    void
+        testDdsTexturesAreMeasuredFromTheirView() {
+        FakeD3DDevice* d3dDevice = new FakeD3DDevice();
+        Device device;
+        device.m_device = d3dDevice;
+        g_loadSize = 256;
+
+        TextureResidency residency;
+        residency.init(device);
+        Texture texture;
+        CHECK(SUCCEEDED(residency.load(texture, "stone.dds", DDS)));
+        CHECK(texture.m_texture == nullptr);
+        CHECK(texture.m_memoryBytes == rgbaBytes(256, 9));
+        CHECK(residency.residentBytes() == rgbaBytes(256, 9));
+
+        residency.release(texture);
+        d3dDevice->Release();
+        CHECK(g_liveObjects == 0);
+    }
+
+    void
+        testOverBudgetTextureLosesItsTopMip() {
+        FakeD3DDevice* d3dDevice = new FakeD3DDevice();
+        Device device;
+        device.m_device = d3dDevice;
+        DeviceContext deviceContext;
+        g_loadSize = 256;
+        g_copies.clear();
+
+        const size_t fullBytes = rgbaBytes(256, 9);
+        const size_t reducedBytes = rgbaBytes(128, 8);
+        TextureResidencyOptions options;
+        options.budgetBytes = fullBytes - 1;
+        options.minResidentSize = 128;
+
+        TextureResidency residency;
+        residency.init(device, options);
+        Texture texture;
+        CHECK(SUCCEEDED(residency.load(texture, "stone.dds", DDS)));
+        ID3D11ShaderResourceView* fullView = texture.m_textureFromImg;
+
+        // Usada en este frame: no se expulsa, se reduce
+        CHECK(residency.touch(texture));
+        residency.endFrame(deviceContext);
+        CHECK(residency.frameStats().mipDrops == 1);
+        CHECK(residency.frameStats().evictions == 0);
+        CHECK(residency.frameStats().residentBytes == reducedBytes);
+        CHECK(texture.m_memoryBytes == reducedBytes);
+        CHECK(texture.m_textureFromImg != nullptr && texture.m_textureFromImg != fullView);
+        CHECK(texture.m_texture == nullptr);
+
+        const D3D11_TEXTURE2D_DESC desc = viewDesc(texture);
+        CHECK(desc.Width == 128 && desc.Height == 128);
+        CHECK(desc.MipLevels == 8);
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+        texture.m_textureFromImg->GetDesc(&srvDesc);
+        CHECK(srvDesc.Texture2D.MipLevels == 8);
+
+        // Cada nivel de la textura nueva sale del siguiente de la original
+        CHECK(g_copies.size() == 8);
+        for (unsigned int level = 0; level < g_copies.size(); ++level) {
+            CHECK(g_copies[level].destinationLevel == level);
+            CHECK(g_copies[level].sourceLevel == level + 1);
+            CHECK(g_copies[level].source != g_copies[level].destination);
+        }
+
+        // minResidentSize impide bajar de 128: el siguiente frame no quita nada mas
+        residency.touch(texture);
+        residency.endFrame(deviceContext);
+        CHECK(residency.frameStats().mipDrops == 0);
+        CHECK(texture.m_memoryBytes == reducedBytes);
+
+        // Con presupuesto de sobra la textura usada recupera sus mips
+        options.budgetBytes = fullBytes;
+        residency.init(device, options);
+        residency.touch(texture);
+        residency.endFrame(deviceContext);
+        CHECK(residency.frameStats().reloads == 1);
+        CHECK(texture.m_memoryBytes == fullBytes);
+        CHECK(viewDesc(texture).MipLevels == 9);
+
+        residency.release(texture);
+        d3dDevice->Release();
+        CHECK(g_liveObjects == 0);
+    }
+}
+
+int
+main() {
+    testDdsTexturesAreMeasuredFromTheirView();
+    testOverBudgetTextureLosesItsTopMip();
+    return checkFailures();
+}
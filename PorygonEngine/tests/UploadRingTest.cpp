@@ -0,0 +1,188 @@
+#include "Check.h"
+#include "UploadRing.h"
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Contexto de GPU falso: paginas de staging en memoria y copias que
+     *        se ejecutan cuando se alcanza su fence.
+     */
+    struct StandInContext {
+        struct Copy {
+            unsigned int page;
+            size_t offset;
+            size_t size;
+            size_t destination;
+            uint64_t fence;
+        };
+
+        std::vector<std::vector<unsigned char>> pages;
+        std::vector<unsigned char> gpuMemory;
+        std::deque<Copy> queued;
+        uint64_t completedFence = 0;
+        unsigned int writesToInFlightPages = 0;
+
+        StandInContext(unsigned int pageCount, size_t pageSize, size_t gpuBytes)
+            : pages(pageCount, std::vector<unsigned char>(pageSize)), gpuMemory(gpuBytes) {
+        }
+
+        /**
+         * @brief Escribe en una pagina mapeada; anota si la GPU aun tiene copias pendientes de ella.
+         */
+        void
+            write(const UploadRingAllocation& allocation, const void* data) {
+            for (const Copy& copy : queued) {
+                if (copy.page == allocation.page) {
+                    ++writesToInFlightPages;
+                }
+            }
+            std::memcpy(pages[allocation.page].data() + allocation.offset, data, allocation.size);
+        }
+
+        /**
+         * @brief Ejecuta en orden las copias con fence menor o igual a `fence`.
+         */
+        void
+            execute(uint64_t fence) {
+            while (!queued.empty() && queued.front().fence <= fence) {
+                const Copy& copy = queued.front();
+                std::memcpy(gpuMemory.data() + copy.destination, pages[copy.page].data() + copy.offset, copy.size);
+                queued.pop_front();
+            }
+            completedFence = fence > completedFence ? fence : completedFence;
+        }
+    };
+
+    void
+        testAllocationsFillAPageThenOpenTheNext() {
+        UploadRing ring;
+        ring.init(3, 256);
+        CHECK(ring.freePages() == 3);
+
+        UploadRingAllocation a, b, c;
+        CHECK(ring.allocate(100, 16, a));
+        CHECK(ring.allocate(100, 16, b));
+        CHECK(a.page == b.page);
+        CHECK(a.offset == 0);
+        CHECK(b.offset == 112); // 100 alineado a 16
+
+        // 112 + 100 + relleno no cabe en 256: pasa a la pagina siguiente
+        CHECK(ring.allocate(100, 16, c));
+        CHECK(c.page != a.page);
+        CHECK(c.offset == 0);
+        CHECK(ring.openPages().size() == 2);
+        CHECK(ring.freePages() == 1);
+        CHECK(ring.stats().pagesOpened == 2);
+        CHECK(ring.stats().allocated == 300);
+    }
+
+    void
+        testClosedPagesAreRecycledOnlyAfterTheirFence() {
+        UploadRing ring;
+        ring.init(2, 64);
+
+        UploadRingAllocation first, second, third;
+        CHECK(ring.allocate(64, 1, first));
+        ring.close(1);
+        CHECK(ring.allocate(64, 1, second));
+        ring.close(2);
+        CHECK(first.page != second.page);
+        CHECK(ring.freePages() == 0);
+
+        // Fence 1 completado: solo vuelve la primera pagina
+        ring.retire(1);
+        CHECK(ring.freePages() == 1);
+        CHECK(ring.allocate(64, 1, third));
+        CHECK(third.page == first.page);
+        CHECK(third.offset == 0);
+
+        ring.close(3);
+        ring.retire(3);
+        CHECK(ring.freePages() == 2);
+        CHECK(ring.openPages().empty());
+    }
+
+    void
+        testFullRingFails() {
+        UploadRing ring;
+        ring.init(2, 64);
+
+        UploadRingAllocation allocation;
+        CHECK(!ring.allocate(65, 1, allocation)); // Mayor que una pagina
+        CHECK(!ring.allocate(0, 1, allocation));
+
+        CHECK(ring.allocate(40, 1, allocation));
+        CHECK(ring.allocate(40, 1, allocation));
+        ring.close(1);
+        CHECK(!ring.allocate(1, 1, allocation)); // Todas en vuelo
+        CHECK(ring.stats().failures == 3);
+
+        ring.retire(0); // Fence aun no alcanzado
+        CHECK(!ring.allocate(1, 1, allocation));
+        ring.retire(1);
+        CHECK(ring.allocate(1, 1, allocation));
+    }
+
+    void
+        testStreamingThroughAStandInContextNeverOverwritesInFlightPages() {
+        const unsigned int pageCount = 3;
+        const size_t pageSize = 256;
+        const size_t chunk = 96;
+        const unsigned int frames = 40;
+        const unsigned int chunksPerFrame = 3;
+        const unsigned int latency = 2; // Frames que tarda la GPU en alcanzar un fence
+
+        UploadRing ring;
+        ring.init(pageCount, pageSize);
+        StandInContext context(pageCount, pageSize, frames * chunksPerFrame * chunk);
+
+        std::vector<unsigned char> expected(context.gpuMemory.size());
+        size_t destination = 0;
+        unsigned int fallbacks = 0;
+        for (uint64_t frame = 1; frame <= frames; ++frame) {
+            if (frame > latency) {
+                context.execute(frame - latency);
+            }
+            ring.retire(context.completedFence);
+
+            // Como UploadManager: las copias se emiten al cerrar, tras desmapear las paginas
+            std::vector<StandInContext::Copy> copies;
+            for (unsigned int i = 0; i < chunksPerFrame; ++i) {
+                std::vector<unsigned char> data(chunk, static_cast<unsigned char>(frame * 7 + i));
+                std::memcpy(expected.data() + destination, data.data(), chunk);
+
+                UploadRingAllocation allocation;
+                if (ring.allocate(chunk, 16, allocation)) {
+                    context.write(allocation, data.data());
+                    copies.push_back({ allocation.page, allocation.offset, chunk, destination, frame });
+                }
+                else {
+                    // Camino alternativo del UploadManager: copia directa
+                    std::memcpy(context.gpuMemory.data() + destination, data.data(), chunk);
+                    ++fallbacks;
+                }
+                destination += chunk;
+            }
+            context.queued.insert(context.queued.end(), copies.begin(), copies.end());
+            ring.close(frame);
+        }
+        context.execute(frames);
+
+        CHECK(fallbacks > 0); // El anillo se lleno al menos una vez
+        CHECK(context.writesToInFlightPages == 0);
+        CHECK(context.gpuMemory == expected);
+        CHECK(ring.stats().failures == fallbacks);
+        CHECK(ring.stats().allocations + fallbacks == frames * chunksPerFrame);
+    }
+}
+
+int
+main() {
+    testAllocationsFillAPageThenOpenTheNext();
+    testClosedPagesAreRecycledOnlyAfterTheirFence();
+    testFullRingFails();
+    testStreamingThroughAStandInContextNeverOverwritesInFlightPages();
+    return checkFailures();
+}
@@ -0,0 +1,318 @@
+#include "Check.h"
+#include "VirtualTextureCache.h"
+#include <vector>
+
+namespace {
+    /**
+     * @brief 1024x1024 en paginas de 128: niveles de 8x8, 4x4, 2x2 y 1x1 paginas.
+     */
+    VirtualTextureLayout
+        makeLayout() {
+        VirtualTextureLayout layout;
+        layout.width = 1024;
+        layout.height = 1024;
+        layout.tileSize = 128;
+        layout.border = 4;
+        layout.mipCount = VirtualTextureLayout::calcMipCount(1024, 1024, 128);
+        return layout;
+    }
+
+    VirtualPage
+        page(unsigned int mip, unsigned int x, unsigned int y) {
+        VirtualPage result;
+        result.mip = mip;
+        result.x = x;
+        result.y = y;
+        return result;
+    }
+
+    bool
+        samePage(const VirtualPage& a, const VirtualPage& b) {
+        return a.mip == b.mip && a.x == b.x && a.y == b.y;
+    }
+
+    /**
+     * @brief Feedback sintetico: cada pagina repetida `hits` veces, con entradas vacias intercaladas.
+     */
+    void
+        addFeedback(std::vector<uint32_t>& feedback, const VirtualPage& visible, unsigned int hits) {
+        for (unsigned int i = 0; i < hits; ++i) {
+            feedback.push_back(VirtualTextureCache::packPage(visible));
+            feedback.push_back(VirtualTextureCache::EMPTY_FEEDBACK);
+        }
+    }
+
+    /**
+     * @brief Entrada de la tabla de paginas: slot, nivel residente y si hay datos.
+     */
+    struct TableEntry {
+        unsigned int slotX;
+        unsigned int slotY;
+        unsigned int mip;
+        bool valid;
+    };
+
+    TableEntry
+        tableEntry(const VirtualTextureCache& cache, const VirtualPage& at) {
+        const uint32_t texel = cache.pageTable(at.mip)[at.y * cache.layout().tilesX(at.mip) + at.x];
+        TableEntry entry;
+        entry.slotX = texel & 0xFFu;
+        entry.slotY = (texel >> 8) & 0xFFu;
+        entry.mip = (texel >> 16) & 0xFFu;
+        entry.valid = (texel >> 24) == 0xFFu;
+        return entry;
+    }
+
+    bool
+        pointsToSlot(const VirtualTextureCache& cache, const VirtualPage& at, unsigned int slot, unsigned int mip) {
+        unsigned int x = 0, y = 0;
+        cache.slotPosition(slot, x, y);
+        const TableEntry entry = tableEntry(cache, at);
+        return entry.valid && entry.mip == mip && entry.slotX == x && entry.slotY == y;
+    }
+
+    void
+        testLayout() {
+        const VirtualTextureLayout layout = makeLayout();
+        CHECK(layout.mipCount == 4);
+        CHECK(layout.tilesX(0) == 8 && layout.tilesY(0) == 8);
+        CHECK(layout.tilesX(3) == 1 && layout.tilesY(3) == 1);
+        CHECK(layout.paddedTileSize() == 136);
+
+        const VirtualPage packed = VirtualTextureCache::unpackPage(VirtualTextureCache::packPage(page(5, 4095, 17)));
+        CHECK(samePage(packed, page(5, 4095, 17)));
+
+        VirtualTextureCache cache;
+        CHECK(cache.init(layout, 4, 2));
+        CHECK(!cache.init(layout, 1, 1)); // El ultimo nivel ocuparia toda la cache
+        CHECK(!cache.init(layout, 257, 1));
+    }
+
+    void
+        testMissingPagesFallBackToTheNearestResidentAncestor() {
+        VirtualTextureCache cache;
+        CHECK(cache.init(makeLayout(), 4, 2));
+
+        // Sin nada residente la tabla no tiene datos
+        CHECK(!tableEntry(cache, page(0, 5, 3)).valid);
+
+        unsigned int coarse = 0;
+        CHECK(cache.insert(page(3, 0, 0), coarse));
+        CHECK(pointsToSlot(cache, page(0, 5, 3), coarse, 3));
+        CHECK(pointsToSlot(cache, page(0, 0, 0), coarse, 3));
+        CHECK(pointsToSlot(cache, page(2, 1, 1), coarse, 3));
+
+        // Un nivel intermedio respalda solo a las paginas que cubre
+        unsigned int middle = 0;
+        CHECK(cache.insert(page(1, 2, 1), middle));
+        CHECK(middle != coarse);
+        CHECK(pointsToSlot(cache, page(1, 2, 1), middle, 1));
+        CHECK(pointsToSlot(cache, page(0, 5, 3), middle, 1));
+        CHECK(pointsToSlot(cache, page(0, 4, 2), middle, 1));
+        CHECK(pointsToSlot(cache, page(0, 6, 3), coarse, 3));
+        CHECK(pointsToSlot(cache, page(2, 1, 0), coarse, 3));
+
+        unsigned int fine = 0;
+        CHECK(cache.insert(page(0, 5, 3), fine));
+        CHECK(pointsToSlot(cache, page(0, 5, 3), fine, 0));
+        CHECK(pointsToSlot(cache, page(0, 4, 2), middle, 1));
+        CHECK(cache.stats().resident == 3);
+    }
+
+    void
+        testRequestsAreCoarseFirstThenByHits() {
+        VirtualTextureCache cache;
+        CHECK(cache.init(makeLayout(), 4, 4));
+        unsigned int slot = 0;
+        CHECK(cache.insert(page(3, 0, 0), slot));
+
+        // A una vez, B tres veces y C (padre de A) una vez
+        std::vector<uint32_t> feedback;
+        addFeedback(feedback, page(0, 0, 0), 1);
+        addFeedback(feedback, page(0, 7, 7), 3);
+        addFeedback(feedback, page(1, 0, 0), 1);
+        addFeedback(feedback, page(9, 0, 0), 2); // Nivel fuera de rango: se ignora
+
+        std::vector<VirtualPage> requests;
+        cache.analyzeFeedback(feedback.data(), feedback.size(), 100, requests);
+        CHECK(requests.size() == 6);
+        if (requests.size() == 6) {
+            CHECK(samePage(requests[0], page(2, 1, 1))); // 3 apariciones
+            CHECK(samePage(requests[1], page(2, 0, 0))); // 2 (A + C)
+            CHECK(samePage(requests[2], page(1, 3, 3)));
+            CHECK(samePage(requests[3], page(1, 0, 0)));
+            CHECK(samePage(requests[4], page(0, 7, 7)));
+            CHECK(samePage(requests[5], page(0, 0, 0)));
+        }
+        CHECK(cache.stats().feedbackEntries == 7);
+        CHECK(cache.stats().uniquePages == 3);
+        CHECK(cache.stats().pending == 6);
+
+        // Las pendientes no se vuelven a pedir
+        cache.analyzeFeedback(feedback.data(), feedback.size(), 100, requests);
+        CHECK(requests.empty());
+    }
+
+    void
+        testMaxRequestsKeepsTheCoarsestPages() {
+        VirtualTextureCache cache;
+        CHECK(cache.init(makeLayout(), 4, 4));
+
+        std::vector<uint32_t> feedback;
+        addFeedback(feedback, page(0, 3, 3), 5);
+
+        std::vector<VirtualPage> requests;
+        cache.analyzeFeedback(feedback.data(), feedback.size(), 2, requests);
+        CHECK(requests.size() == 2);
+        if (requests.size() == 2) {
+            CHECK(samePage(requests[0], page(3, 0, 0)));
+            CHECK(samePage(requests[1], page(2, 0, 0)));
+        }
+        CHECK(!cache.isPending(page(1, 1, 1)));
+        CHECK(!cache.isPending(page(0, 3, 3)));
+
+        // El siguiente frame pide lo que quedo fuera
+        cache.analyzeFeedback(feedback.data(), feedback.size(), 2, requests);
+        CHECK(requests.size() == 2);
+        if (requests.size() == 2) {
+            CHECK(samePage(requests[0], page(1, 1, 1)));
+            CHECK(samePage(requests[1], page(0, 3, 3)));
+        }
+    }
+
+    void
+        testEvictionIsLruSkipsPagesUsedThisFrameAndKeepsTheLastMip() {
+        VirtualTextureCache cache;
+        CHECK(cache.init(makeLayout(), 2, 2));
+
+        // Frame 1: el ultimo nivel
+        unsigned int coarse = 0;
+        CHECK(cache.insert(page(3, 0, 0), coarse));
+        cache.endFrame();
+
+        // Frame 2: tres paginas de nivel 2 llenan la cache
+        unsigned int a = 0, b = 0, c = 0;
+        CHECK(cache.insert(page(2, 0, 0), a));
+        CHECK(cache.insert(page(2, 1, 0), b));
+        CHECK(cache.insert(page(2, 0, 1), c));
+        cache.endFrame();
+
+        // Frame 3: el ultimo nivel es el menos reciente, pero nunca se expulsa
+        unsigned int slot = 0;
+        CHECK(cache.insert(page(2, 1, 1), slot));
+        CHECK(slot == a);
+        CHECK(cache.isResident(page(3, 0, 0)));
+        CHECK(!cache.isResident(page(2, 0, 0)));
+        CHECK(cache.stats().evictions == 1);
+
+        // La pagina expulsada vuelve a apuntar a su antecesor
+        CHECK(pointsToSlot(cache, page(2, 0, 0), coarse, 3));
+        CHECK(pointsToSlot(cache, page(0, 1, 1), coarse, 3));
+        CHECK(pointsToSlot(cache, page(0, 6, 6), a, 2));
+        cache.endFrame();
+
+        // Frame 4: el feedback usa (1,0); la menos usada del resto es (0,1)
+        std::vector<uint32_t> feedback;
+        addFeedback(feedback, page(2, 1, 0), 1);
+        std::vector<VirtualPage> requests;
+        cache.analyzeFeedback(feedback.data(), feedback.size(), 10, requests);
+        CHECK(requests.empty());
+
+        CHECK(cache.insert(page(1, 0, 0), slot));
+        CHECK(slot == c);
+        CHECK(cache.insert(page(1, 3, 3), slot));
+        CHECK(slot == a); // (1,1), insertada en el frame 3
+        CHECK(cache.isResident(page(2, 1, 0)));
+
+        // Todo lo residente se uso en este frame o es el ultimo nivel: no hay sitio
+        CHECK(!cache.insert(page(1, 2, 2), slot));
+        CHECK(cache.stats().rejected == 1);
+        CHECK(!cache.isPending(page(1, 2, 2)));
+        CHECK(cache.stats().resident == 4);
+
+        // En el frame siguiente ya hay candidatas
+        cache.endFrame();
+        CHECK(cache.insert(page(1, 2, 2), slot));
+        CHECK(slot != coarse);
+        CHECK(cache.isResident(page(3, 0, 0)));
+        CHECK(cache.stats().evictions == 4);
+    }
+
+    void
+        testCancelReleasesThePendingPage() {
+        VirtualTextureCache cache;
+        CHECK(cache.init(makeLayout(), 4, 4));
+
+        std::vector<uint32_t> feedback;
+        addFeedback(feedback, page(3, 0, 0), 1);
+        std::vector<VirtualPage> requests;
+        cache.analyzeFeedback(feedback.data(), feedback.size(), 10, requests);
+        CHECK(requests.size() == 1);
+        CHECK(cache.isPending(page(3, 0, 0)));
+
+        // La carga fallo: deja de estar pendiente y se vuelve a pedir
+        cache.cancel(page(3, 0, 0));
+        CHECK(!cache.isPending(page(3, 0, 0)));
+        CHECK(!cache.isResident(page(3, 0, 0)));
+        CHECK(cache.stats().pending == 0);
+        cache.analyzeFeedback(feedback.data(), feedback.size(), 10, requests);
+        CHECK(requests.size() == 1);
+
+        // insert tambien la saca de las pendientes
+        unsigned int slot = 0;
+        CHECK(cache.insert(page(3, 0, 0), slot));
+        CHECK(!cache.isPending(page(3, 0, 0)));
+        cache.cancel(page(9, 0, 0)); // Fuera de rango: sin efecto
+        CHECK(cache.stats().requested == 2);
+    }
+
+    void
+        testDirtyRegionsCoverOnlyChangedTableTexels() {
+        VirtualTextureCache cache;
+        const VirtualTextureLayout layout = makeLayout();
+        CHECK(cache.init(layout, 4, 4));
+
+        // Al empezar se sube la tabla completa
+        for (unsigned int mip = 0; mip < layout.mipCount; ++mip) {
+            CHECK(cache.dirtyRegion(mip).width == layout.tilesX(mip));
+            CHECK(cache.dirtyRegion(mip).height == layout.tilesY(mip));
+        }
+        cache.clearDirty();
+        for (unsigned int mip = 0; mip < layout.mipCount; ++mip) {
+            CHECK(cache.dirtyRegion(mip).width == 0);
+        }
+
+        // Una pagina de nivel 1 cambia su texel y los 2x2 que cubre en el nivel 0
+        unsigned int slot = 0;
+        CHECK(cache.insert(page(1, 2, 1), slot));
+        const VirtualTableRegion& mip1 = cache.dirtyRegion(1);
+        const VirtualTableRegion& mip0 = cache.dirtyRegion(0);
+        CHECK(mip1.x == 2 && mip1.y == 1 && mip1.width == 1 && mip1.height == 1);
+        CHECK(mip0.x == 4 && mip0.y == 2 && mip0.width == 2 && mip0.height == 2);
+        CHECK(cache.dirtyRegion(2).width == 0);
+        CHECK(cache.dirtyRegion(3).width == 0);
+
+        // Una segunda pagina amplia la region al rectangulo que cubre ambas
+        CHECK(cache.insert(page(1, 3, 3), slot));
+        CHECK(mip1.x == 2 && mip1.y == 1 && mip1.width == 2 && mip1.height == 3);
+        CHECK(mip0.x == 4 && mip0.y == 2 && mip0.width == 4 && mip0.height == 6);
+
+        // Reinsertar una residente no cambia nada
+        cache.clearDirty();
+        CHECK(cache.insert(page(1, 3, 3), slot));
+        CHECK(cache.dirtyRegion(1).width == 0);
+        CHECK(cache.dirtyRegion(0).width == 0);
+    }
+}
+
+int
+main() {
+    testLayout();
+    testMissingPagesFallBackToTheNearestResidentAncestor();
+    testRequestsAreCoarseFirstThenByHits();
+    testMaxRequestsKeepsTheCoarsestPages();
+    testEvictionIsLruSkipsPagesUsedThisFrameAndKeepsTheLastMip();
+    testCancelReleasesThePendingPage();
+    testDirtyRegionsCoverOnlyChangedTableTexels();
+    return checkFailures();
+}
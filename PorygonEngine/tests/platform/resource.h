@@ -0,0 +1,2 @@
+#pragma once
+// Vacio: las pruebas no usan DirectX.
@@ -0,0 +1,15 @@
+#pragma once
+// Sustituto minimo de <windows.h> para compilar las pruebas fuera de Windows.
+#include <cstring>
+
+typedef long HRESULT;
+
+#define S_OK ((HRESULT)0)
+#define S_FALSE ((HRESULT)1)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define E_POINTER ((HRESULT)0x80004003L)
+#define E_INVALIDARG ((HRESULT)0x80070057L)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+
+inline void OutputDebugStringW(const wchar_t*) {}
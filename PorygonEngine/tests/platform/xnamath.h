@@ -0,0 +1,14 @@
+#pragma once
+// Sustituto minimo de <xnamath.h>: solo los tipos de almacenamiento que usa Prerequisites.h.
+
+struct XMFLOAT2 { float x, y; XMFLOAT2() {} XMFLOAT2(float a, float b) : x(a), y(b) {} };
+struct XMFLOAT3 { float x, y, z; XMFLOAT3() {} XMFLOAT3(float a, float b, float c) : x(a), y(b), z(c) {} };
+struct XMFLOAT4 { float x, y, z, w; XMFLOAT4() {} XMFLOAT4(float a, float b, float c, float d) : x(a), y(b), z(c), w(d) {} };
+struct XMFLOAT4X4 {
+    union {
+        struct { float _11, _12, _13, _14, _21, _22, _23, _24, _31, _32, _33, _34, _41, _42, _43, _44; };
+        float m[4][4];
+    };
+};
+struct XMVECTOR { float v[4]; };
+struct XMMATRIX { XMVECTOR r[4]; };
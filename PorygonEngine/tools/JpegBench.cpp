@@ -0,0 +1,125 @@
+//
+// JpegBench: compara stbi_load con JpegDecoder (1 hilo y N hilos) sobre los
+// mismos bytes en memoria y comprueba que el resultado es identico.
+// No depende de Windows ni de DirectX; en Linux se compila desde PorygonEngine/ con:
+//
+//   g++ -O2 -std=c++17 -pthread -Iinclude -o JpegBench
+//       tools/JpegBench.cpp source/JpegDecoder.cpp source/TextureCache.cpp
+//
+// Uso: JpegBench [-i iteraciones] [-t hilos] archivo.jpg...
+//
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "JpegDecoder.h"
+#include "TextureCache.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double
+        millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief Mejor tiempo de `iterations` decodificaciones con JpegDecoder.
+     */
+    double
+        timeDecoder(const MappedFile& file, unsigned int threads, int iterations,
+            ImageLevel& image, JpegDecodeInfo& info) {
+        JpegDecoder decoder;
+        double best = 1e30;
+        for (int i = 0; i < iterations; ++i) {
+            unsigned int channels = 0;
+            const Clock::time_point start = Clock::now();
+            if (!decoder.decode(file.data(), file.size(), image, channels, threads, &info)) {
+                return -1.0;
+            }
+            const double elapsed = millisecondsSince(start);
+            best = elapsed < best ? elapsed : best;
+        }
+        return best;
+    }
+}
+
+int
+main(int argc, char** argv) {
+    int iterations = 5;
+    unsigned int threads = std::thread::hardware_concurrency();
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        }
+        else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.empty() || iterations <= 0) {
+        std::printf("Uso: %s [-i iteraciones] [-t hilos] archivo.jpg...\n", argv[0]);
+        return 1;
+    }
+    threads = threads ? threads : 1;
+
+    int failures = 0;
+    std::printf("%-32s %11s %9s %9s %9s %8s %6s\n",
+        "archivo", "pixeles", "stb ms", "1 hilo", "N hilos", "RST", "igual");
+    for (const std::string& fileName : files) {
+        MappedFile file;
+        if (!file.open(fileName)) {
+            std::printf("%-32s no se pudo abrir\n", fileName.c_str());
+            ++failures;
+            continue;
+        }
+
+        // Referencia: stb_image desde memoria, mejor de N
+        int width = 0, height = 0, channels = 0;
+        double stbBest = 1e30;
+        unsigned char* reference = nullptr;
+        for (int i = 0; i < iterations; ++i) {
+            stbi_image_free(reference);
+            const Clock::time_point start = Clock::now();
+            reference = stbi_load_from_memory(file.data(), static_cast<int>(file.size()),
+                &width, &height, &channels, 4);
+            const double elapsed = millisecondsSince(start);
+            stbBest = elapsed < stbBest ? elapsed : stbBest;
+        }
+        if (!reference) {
+            std::printf("%-32s stb_image: %s\n", fileName.c_str(), stbi_failure_reason());
+            ++failures;
+            continue;
+        }
+
+        ImageLevel single, parallel;
+        JpegDecodeInfo singleInfo, parallelInfo;
+        const double singleBest = timeDecoder(file, 1, iterations, single, singleInfo);
+        const double parallelBest = timeDecoder(file, threads, iterations, parallel, parallelInfo);
+
+        const size_t bytes = static_cast<size_t>(width) * height * 4;
+        const bool identical = singleBest >= 0.0 && parallelBest >= 0.0 &&
+            single.pixels.size() == bytes && parallel.pixels.size() == bytes &&
+            std::memcmp(single.pixels.data(), reference, bytes) == 0 &&
+            std::memcmp(parallel.pixels.data(), reference, bytes) == 0;
+        if (!identical) {
+            ++failures;
+        }
+
+        std::printf("%-32s %5dx%-5d %9.2f %9.2f %9.2f %8u %6s\n",
+            fileName.c_str(), width, height, stbBest, singleBest, parallelBest,
+            parallelInfo.segments, identical ? "si" : "NO");
+        stbi_image_free(reference);
+    }
+
+    std::printf("%u hilos, mejor de %d iteraciones\n", threads, iterations);
+    return failures == 0 ? 0 : 1;
+}
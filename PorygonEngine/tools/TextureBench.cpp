@@ -0,0 +1,552 @@
+//
+// TextureBench: mide el trabajo de CPU de una importacion de texturas sobre un
+// corpus de PNG/JPG: decodificacion, cadena de mips, conversion de formato
+// (empaquetado R8G8 como NORMAL_USAGE) y compresion por bloques. Informa del
+// rendimiento por etapa, la memoria maxima y el escalado de 1 a N hilos, y
+// opcionalmente lo escribe en JSON para comparar ejecuciones.
+// No depende de Windows ni de DirectX; en Linux se compila desde PorygonEngine/ con:
+//
+//   g++ -O2 -std=c++17 -pthread -Iinclude -o TextureBench
+//       tools/TextureBench.cpp source/JpegDecoder.cpp source/TextureCache.cpp
+//       source/MipGenerator.cpp source/BlockCompressor.cpp source/ThreadPool.cpp
+//
+// Uso: TextureBench [-i iteraciones] [-t hilos] [-f bc1|bc3|bc4|bc5|bc7]
+//                   [-q fast|normal|high] [-m box|kaiser|lanczos] [-json salida.json]
+//                   archivo-o-directorio...
+//
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "BlockCompressor.h"
+#include "JpegDecoder.h"
+#include "MipGenerator.h"
+#include "TextureCache.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Etapas medidas, en el orden en que las ejecuta una importacion.
+     */
+    enum
+        BenchStage {
+        DECODE_STAGE = 0,
+        MIPS_STAGE = 1,
+        CONVERT_STAGE = 2,
+        COMPRESS_STAGE = 3,
+        STAGE_COUNT = 4
+    };
+
+    const char* const STAGE_NAMES[STAGE_COUNT] = { "decode", "mips", "convert", "compress" };
+
+    /**
+     * @brief Configuracion de la ejecucion.
+     */
+    struct
+        BenchOptions {
+        int iterations = 3;
+        unsigned int maxThreads = 0;
+        BlockFormat format = BC7_FORMAT;
+        CompressionQuality quality = QUALITY_NORMAL;
+        MipFilter filter = KAISER_FILTER;
+        std::string jsonPath;
+    };
+
+    /**
+     * @brief Resultado de un archivo del corpus.
+     */
+    struct
+        FileResult {
+        std::string name;
+        bool ok = false;
+        unsigned int width = 0;
+        unsigned int height = 0;
+        size_t fileBytes = 0;                /**< Bytes del archivo comprimido. */
+        size_t chainPixels = 0;              /**< Texeles de la cadena de mips completa. */
+        size_t peakBytes = 0;                /**< Bytes vivos en el punto mas alto de la tuberia. */
+        double stageMs[STAGE_COUNT] = {};    /**< Mejor tiempo de cada etapa con un hilo. */
+    };
+
+    /**
+     * @brief Tiempo de pared del corpus completo con un numero de hilos.
+     */
+    struct
+        ScalingResult {
+        unsigned int threads = 0;
+        double filesMs = 0.0;  /**< Archivos en paralelo, cada uno en un hilo (como TextureBatchLoader). */
+        double imageMs = 0.0;  /**< Archivos de uno en uno, decodificacion y compresion con N hilos. */
+    };
+
+    double
+        millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool
+        hasImageExtension(const std::filesystem::path& path) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg";
+    }
+
+    bool
+        isJpeg(const MappedFile& file) {
+        return file.size() >= 2 && file.data()[0] == 0xFF && file.data()[1] == 0xD8;
+    }
+
+    /**
+     * @brief Expande los directorios del corpus a sus PNG/JPG (recursivo, en orden).
+     */
+    std::vector<std::string>
+        collectCorpus(const std::vector<std::string>& inputs) {
+        std::vector<std::string> files;
+        for (const std::string& input : inputs) {
+            std::error_code error;
+            if (!std::filesystem::is_directory(input, error)) {
+                files.push_back(input);
+                continue;
+            }
+            std::vector<std::string> found;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(input, error)) {
+                if (entry.is_regular_file(error) && hasImageExtension(entry.path())) {
+                    found.push_back(entry.path().string());
+                }
+            }
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        }
+        return files;
+    }
+
+    /**
+     * @brief Decodifica a RGBA8 como lo hace Texture: JpegDecoder para JPEG, stb_image para el resto.
+     */
+    bool
+        decodeImage(const MappedFile& file, unsigned int threads, ImageLevel& image) {
+        if (isJpeg(file)) {
+            unsigned int channels = 0;
+            return JpegDecoder().decode(file.data(), file.size(), image, channels, threads);
+        }
+        int width = 0, height = 0, channels = 0;
+        unsigned char* pixels = stbi_load_from_memory(file.data(), static_cast<int>(file.size()),
+            &width, &height, &channels, 4);
+        if (!pixels) {
+            return false;
+        }
+        image.width = static_cast<unsigned int>(width);
+        image.height = static_cast<unsigned int>(height);
+        image.rowPitch = image.width * 4;
+        image.pixels.assign(pixels, pixels + static_cast<size_t>(image.rowPitch) * image.height);
+        stbi_image_free(pixels);
+        return true;
+    }
+
+    /**
+     * @brief Empaqueta RGBA8 en R8G8, el mismo bucle que Texture::prepare para NORMAL_USAGE.
+     */
+    void
+        packTwoChannels(const std::vector<ImageLevel>& levels, std::vector<std::vector<unsigned char>>& packed) {
+        packed.resize(levels.size());
+        for (size_t i = 0; i < levels.size(); ++i) {
+            const ImageLevel& level = levels[i];
+            packed[i].resize(static_cast<size_t>(level.width) * level.height * 2);
+            for (size_t src = 0, dst = 0; dst < packed[i].size(); src += 4, dst += 2) {
+                packed[i][dst] = level.pixels[src];
+                packed[i][dst + 1] = level.pixels[src + 1];
+            }
+        }
+    }
+
+    bool
+        compressChain(const std::vector<ImageLevel>& levels, const BenchOptions& options,
+            unsigned int threads, std::vector<CompressedImage>& compressed) {
+        BlockCompressor compressor;
+        compressed.resize(levels.size());
+        for (size_t i = 0; i < levels.size(); ++i) {
+            if (!compressor.compress(levels[i], options.format, options.quality, compressed[i], threads)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Tuberia completa de un archivo sin medir etapas (para el escalado).
+     */
+    bool
+        importFile(const std::string& fileName, const BenchOptions& options, unsigned int threads) {
+        MappedFile file;
+        ImageLevel image;
+        if (!file.open(fileName) || !decodeImage(file, threads, image)) {
+            return false;
+        }
+        std::vector<ImageLevel> levels;
+        if (!MipGenerator().generate(image.pixels.data(), image.width, image.height, image.rowPitch,
+            options.filter, true, levels)) {
+            return false;
+        }
+        std::vector<std::vector<unsigned char>> packed;
+        packTwoChannels(levels, packed);
+        std::vector<CompressedImage> compressed;
+        return compressChain(levels, options, threads, compressed);
+    }
+
+    /**
+     * @brief Mide cada etapa con un hilo (mejor de `iterations`).
+     */
+    FileResult
+        measureFile(const std::string& fileName, const BenchOptions& options) {
+        FileResult result;
+        result.name = fileName;
+        MappedFile file;
+        if (!file.open(fileName)) {
+            return result;
+        }
+        result.fileBytes = file.size();
+        for (double& ms : result.stageMs) {
+            ms = 1e30;
+        }
+
+        for (int i = 0; i < options.iterations; ++i) {
+            ImageLevel image;
+            Clock::time_point start = Clock::now();
+            if (!decodeImage(file, 1, image)) {
+                return result;
+            }
+            result.stageMs[DECODE_STAGE] = (std::min)(result.stageMs[DECODE_STAGE], millisecondsSince(start));
+
+            std::vector<ImageLevel> levels;
+            start = Clock::now();
+            if (!MipGenerator().generate(image.pixels.data(), image.width, image.height, image.rowPitch,
+                options.filter, true, levels)) {
+                return result;
+            }
+            result.stageMs[MIPS_STAGE] = (std::min)(result.stageMs[MIPS_STAGE], millisecondsSince(start));
+
+            std::vector<std::vector<unsigned char>> packed;
+            start = Clock::now();
+            packTwoChannels(levels, packed);
+            result.stageMs[CONVERT_STAGE] = (std::min)(result.stageMs[CONVERT_STAGE], millisecondsSince(start));
+
+            std::vector<CompressedImage> compressed;
+            start = Clock::now();
+            if (!compressChain(levels, options, 1, compressed)) {
+                return result;
+            }
+            result.stageMs[COMPRESS_STAGE] = (std::min)(result.stageMs[COMPRESS_STAGE], millisecondsSince(start));
+
+            // Todo sigue vivo aqui: es el punto mas alto de la tuberia
+            size_t bytes = file.size() + image.pixels.size();
+            result.chainPixels = 0;
+            for (size_t l = 0; l < levels.size(); ++l) {
+                bytes += levels[l].pixels.size() + packed[l].size() + compressed[l].data.size();
+                result.chainPixels += static_cast<size_t>(levels[l].width) * levels[l].height;
+            }
+            result.peakBytes = bytes;
+            result.width = image.width;
+            result.height = image.height;
+        }
+        result.ok = true;
+        return result;
+    }
+
+    /**
+     * @brief Pico de memoria residente del proceso en bytes (0 si no se conoce).
+     */
+    size_t
+        peakResidentBytes() {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage = {};
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+#if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    double
+        megaPerSecond(double amount, double ms) {
+        return ms > 0.0 ? amount / 1e6 / (ms / 1000.0) : 0.0;
+    }
+
+    std::string
+        jsonString(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+                out += escaped;
+            }
+            else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    bool
+        writeJson(const std::string& path,
+            const BenchOptions& options,
+            const std::vector<FileResult>& files,
+            const double* stageMs,
+            size_t sourcePixels,
+            size_t chainPixels,
+            size_t fileBytes,
+            const std::vector<ScalingResult>& scaling,
+            size_t peakPipeline,
+            size_t peakResident) {
+        static const char* const FORMAT_NAMES[] = { "bc1", "bc3", "bc4", "bc5", "bc7" };
+        static const char* const QUALITY_NAMES[] = { "fast", "normal", "high" };
+        static const char* const FILTER_NAMES[] = { "box", "kaiser", "lanczos" };
+
+        FILE* out = path == "-" ? stdout : std::fopen(path.c_str(), "w");
+        if (!out) {
+            return false;
+        }
+        std::fprintf(out, "{\n  \"config\": {\"iterations\": %d, \"maxThreads\": %u, \"format\": \"%s\", "
+            "\"quality\": \"%s\", \"mipFilter\": \"%s\"},\n",
+            options.iterations, options.maxThreads, FORMAT_NAMES[options.format],
+            QUALITY_NAMES[options.quality], FILTER_NAMES[options.filter]);
+        std::fprintf(out, "  \"corpus\": {\"files\": %zu, \"bytes\": %zu, \"pixels\": %zu, \"chainPixels\": %zu},\n",
+            files.size(), fileBytes, sourcePixels, chainPixels);
+
+        std::fprintf(out, "  \"stages\": [\n");
+        for (int s = 0; s < STAGE_COUNT; ++s) {
+            const double pixels = static_cast<double>(s == DECODE_STAGE ? sourcePixels : chainPixels);
+            std::fprintf(out, "    {\"name\": \"%s\", \"ms\": %.3f, \"mpixPerSec\": %.3f",
+                STAGE_NAMES[s], stageMs[s], megaPerSecond(pixels, stageMs[s]));
+            if (s == DECODE_STAGE) {
+                std::fprintf(out, ", \"mbPerSec\": %.3f", megaPerSecond(static_cast<double>(fileBytes), stageMs[s]));
+            }
+            std::fprintf(out, "}%s\n", s + 1 < STAGE_COUNT ? "," : "");
+        }
+        std::fprintf(out, "  ],\n");
+
+        std::fprintf(out, "  \"scaling\": [\n");
+        for (size_t i = 0; i < scaling.size(); ++i) {
+            std::fprintf(out, "    {\"threads\": %u, \"filesMs\": %.3f, \"filesSpeedup\": %.3f, "
+                "\"imageMs\": %.3f, \"imageSpeedup\": %.3f}%s\n",
+                scaling[i].threads, scaling[i].filesMs, scaling[0].filesMs / scaling[i].filesMs,
+                scaling[i].imageMs, scaling[0].imageMs / scaling[i].imageMs,
+                i + 1 < scaling.size() ? "," : "");
+        }
+        std::fprintf(out, "  ],\n");
+
+        std::fprintf(out, "  \"memory\": {\"peakPipelineBytes\": %zu, \"peakResidentBytes\": %zu},\n",
+            peakPipeline, peakResident);
+
+        std::fprintf(out, "  \"files\": [\n");
+        for (size_t i = 0; i < files.size(); ++i) {
+            const FileResult& file = files[i];
+            std::fprintf(out, "    {\"name\": %s, \"ok\": %s, \"width\": %u, \"height\": %u, \"bytes\": %zu, "
+                "\"peakBytes\": %zu",
+                jsonString(file.name).c_str(), file.ok ? "true" : "false",
+                file.width, file.height, file.fileBytes, file.peakBytes);
+            if (file.ok) {
+                for (int s = 0; s < STAGE_COUNT; ++s) {
+                    std::fprintf(out, ", \"%sMs\": %.3f", STAGE_NAMES[s], file.stageMs[s]);
+                }
+            }
+            std::fprintf(out, "}%s\n", i + 1 < files.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+        if (out != stdout) {
+            std::fclose(out);
+        }
+        return true;
+    }
+}
+
+int
+main(int argc, char** argv) {
+    BenchOptions options;
+    std::vector<std::string> inputs;
+    bool validArgs = true;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "-i") == 0 && hasValue) {
+            options.iterations = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(arg, "-t") == 0 && hasValue) {
+            options.maxThreads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(arg, "-f") == 0 && hasValue) {
+            const std::string value = argv[++i];
+            if (value == "bc1") options.format = BC1_FORMAT;
+            else if (value == "bc3") options.format = BC3_FORMAT;
+            else if (value == "bc4") options.format = BC4_FORMAT;
+            else if (value == "bc5") options.format = BC5_FORMAT;
+            else if (value == "bc7") options.format = BC7_FORMAT;
+            else validArgs = false;
+        }
+        else if (std::strcmp(arg, "-q") == 0 && hasValue) {
+            const std::string value = argv[++i];
+            if (value == "fast") options.quality = QUALITY_FAST;
+            else if (value == "normal") options.quality = QUALITY_NORMAL;
+            else if (value == "high") options.quality = QUALITY_HIGH;
+            else validArgs = false;
+        }
+        else if (std::strcmp(arg, "-m") == 0 && hasValue) {
+            const std::string value = argv[++i];
+            if (value == "box") options.filter = BOX_FILTER;
+            else if (value == "kaiser") options.filter = KAISER_FILTER;
+            else if (value == "lanczos") options.filter = LANCZOS_FILTER;
+            else validArgs = false;
+        }
+        else if (std::strcmp(arg, "-json") == 0 && hasValue) {
+            options.jsonPath = argv[++i];
+        }
+        else {
+            inputs.push_back(arg);
+        }
+    }
+    const std::vector<std::string> files = collectCorpus(inputs);
+    if (!validArgs || files.empty() || options.iterations <= 0) {
+        std::printf("Uso: %s [-i iteraciones] [-t hilos] [-f bc1|bc3|bc4|bc5|bc7] [-q fast|normal|high]\n"
+            "       [-m box|kaiser|lanczos] [-json salida.json] archivo-o-directorio...\n", argv[0]);
+        return 1;
+    }
+    if (options.maxThreads == 0) {
+        options.maxThreads = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+    // Con "-json -" la salida estandar queda solo para el JSON
+    FILE* report = options.jsonPath == "-" ? stderr : stdout;
+
+    // Etapas con un hilo, archivo por archivo
+    std::vector<FileResult> results;
+    double stageMs[STAGE_COUNT] = {};
+    size_t sourcePixels = 0, chainPixels = 0, fileBytes = 0, peakPipeline = 0;
+    std::vector<std::string> valid;
+    int failures = 0;
+    std::fprintf(report, "%-32s %11s %9s %9s %9s %9s %9s\n",
+        "archivo", "pixeles", "decode", "mips", "convert", "compress", "pico MB");
+    for (const std::string& fileName : files) {
+        FileResult result = measureFile(fileName, options);
+        if (!result.ok) {
+            std::fprintf(report, "%-32s no se pudo importar\n", fileName.c_str());
+            ++failures;
+            results.push_back(result);
+            continue;
+        }
+        for (int s = 0; s < STAGE_COUNT; ++s) {
+            stageMs[s] += result.stageMs[s];
+        }
+        sourcePixels += static_cast<size_t>(result.width) * result.height;
+        chainPixels += result.chainPixels;
+        fileBytes += result.fileBytes;
+        peakPipeline = (std::max)(peakPipeline, result.peakBytes);
+        valid.push_back(fileName);
+        std::fprintf(report, "%-32s %5ux%-5u %9.2f %9.2f %9.2f %9.2f %9.1f\n",
+            fileName.c_str(), result.width, result.height,
+            result.stageMs[DECODE_STAGE], result.stageMs[MIPS_STAGE],
+            result.stageMs[CONVERT_STAGE], result.stageMs[COMPRESS_STAGE],
+            result.peakBytes / (1024.0 * 1024.0));
+        results.push_back(result);
+    }
+    if (valid.empty()) {
+        return 1;
+    }
+
+    std::fprintf(report, "\n%-10s %10s %10s %10s\n", "etapa", "ms", "Mpix/s", "MB/s");
+    for (int s = 0; s < STAGE_COUNT; ++s) {
+        const double pixels = static_cast<double>(s == DECODE_STAGE ? sourcePixels : chainPixels);
+        std::fprintf(report, "%-10s %10.2f %10.2f", STAGE_NAMES[s], stageMs[s], megaPerSecond(pixels, stageMs[s]));
+        if (s == DECODE_STAGE) {
+            std::fprintf(report, " %10.2f", megaPerSecond(static_cast<double>(fileBytes), stageMs[s]));
+        }
+        std::fprintf(report, "\n");
+    }
+
+    // Escalado: 1, 2, 4... hasta maxThreads (incluido aunque no sea potencia de dos)
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < options.maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(options.maxThreads);
+
+    std::vector<ScalingResult> scaling;
+    std::fprintf(report, "\n%-7s %12s %8s %12s %8s\n", "hilos", "archivos ms", "x", "imagen ms", "x");
+    for (unsigned int threads : threadCounts) {
+        ScalingResult entry;
+        entry.threads = threads;
+        entry.filesMs = entry.imageMs = 1e30;
+        for (int i = 0; i < options.iterations; ++i) {
+            std::atomic<int> failed(0);
+            {
+                ThreadPool pool(threads);
+                const Clock::time_point start = Clock::now();
+                for (const std::string& fileName : valid) {
+                    pool.submit([&, fileName]() {
+                        if (!importFile(fileName, options, 1)) {
+                            ++failed;
+                        }
+                        });
+                }
+                pool.wait();
+                entry.filesMs = (std::min)(entry.filesMs, millisecondsSince(start));
+            }
+
+            const Clock::time_point start = Clock::now();
+            for (const std::string& fileName : valid) {
+                if (!importFile(fileName, options, threads)) {
+                    ++failed;
+                }
+            }
+            entry.imageMs = (std::min)(entry.imageMs, millisecondsSince(start));
+            failures += failed.load();
+        }
+        scaling.push_back(entry);
+        std::fprintf(report, "%-7u %12.2f %8.2f %12.2f %8.2f\n", threads,
+            entry.filesMs, scaling[0].filesMs / entry.filesMs,
+            entry.imageMs, scaling[0].imageMs / entry.imageMs);
+    }
+
+    const size_t peakResident = peakResidentBytes();
+    std::fprintf(report, "\nmemoria: pico de la tuberia %.1f MB, pico del proceso %.1f MB\n",
+        peakPipeline / (1024.0 * 1024.0), peakResident / (1024.0 * 1024.0));
+    std::fprintf(report, "%zu archivos, mejor de %d iteraciones\n", valid.size(), options.iterations);
+
+    if (!options.jsonPath.empty() &&
+        !writeJson(options.jsonPath, options, results, stageMs, sourcePixels, chainPixels, fileBytes,
+            scaling, peakPipeline, peakResident)) {
+        std::fprintf(stderr, "%s: no se pudo escribir\n", options.jsonPath.c_str());
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+//
+// VirtualTextureBuild: convierte una imagen PNG/JPG en una textura virtual
+// ".pvt" (mips cortados en paginas con borde) para VirtualTexture.
+// No depende de Windows ni de DirectX; en Linux se compila desde PorygonEngine/ con:
+//
+//   g++ -O2 -std=c++17 -Iinclude -o VirtualTextureBuild
+//       tools/VirtualTextureBuild.cpp source/VirtualTextureFile.cpp
+//       source/VirtualTextureCache.cpp source/MipGenerator.cpp source/TextureCache.cpp
+//
+// Uso: VirtualTextureBuild [-t lado] [-b borde] [-srgb] entrada salida.pvt
+//
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "VirtualTextureFile.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+int
+main(int argc, char** argv) {
+    unsigned int tileSize = 128;
+    unsigned int border = 4;
+    bool srgb = false;
+    std::string input, output;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            tileSize = static_cast<unsigned int>(std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            border = static_cast<unsigned int>(std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "-srgb") == 0) {
+            srgb = true;
+        }
+        else if (input.empty()) {
+            input = argv[i];
+        }
+        else {
+            output = argv[i];
+        }
+    }
+    if (input.empty() || output.empty() || tileSize == 0) {
+        std::printf("Uso: %s [-t lado] [-b borde] [-srgb] entrada salida.pvt\n", argv[0]);
+        return 1;
+    }
+
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels = stbi_load(input.c_str(), &width, &height, &channels, 4);
+    if (!pixels) {
+        std::printf("%s: %s\n", input.c_str(), stbi_failure_reason());
+        return 1;
+    }
+
+    const bool written = VirtualTextureFile::build(pixels, static_cast<unsigned int>(width),
+        static_cast<unsigned int>(height), static_cast<unsigned int>(width) * 4,
+        tileSize, border, srgb, BOX_FILTER, output);
+    stbi_image_free(pixels);
+    if (!written) {
+        std::printf("%s: no se pudo escribir\n", output.c_str());
+        return 1;
+    }
+
+    VirtualTextureFile file;
+    if (!file.open(output)) {
+        std::printf("%s: el archivo escrito no es valido\n", output.c_str());
+        return 1;
+    }
+    const VirtualTextureLayout& layout = file.layout();
+    unsigned int pages = 0;
+    for (unsigned int mip = 0; mip < layout.mipCount; ++mip) {
+        pages += layout.tilesX(mip) * layout.tilesY(mip);
+    }
+    std::printf("%s: %ux%u, %u niveles, %u paginas de %ux%u\n", output.c_str(),
+        layout.width, layout.height, layout.mipCount, pages,
+        layout.paddedTileSize(), layout.paddedTileSize());
+    return 0;
+}